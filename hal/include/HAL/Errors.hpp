@@ -49,6 +49,8 @@
 #define PARAMETER_OUT_OF_RANGE_MESSAGE "HAL: A parameter is out of range."
 #define RESOURCE_IS_ALLOCATED -1029
 #define RESOURCE_IS_ALLOCATED_MESSAGE "HAL: Resource already allocated"
+#define HAL_HANDLE_ERROR -1098
+#define HAL_HANDLE_ERROR_MESSAGE "HAL: A handle parameter was passed incorrectly or has already been freed"
 
 #define VI_ERROR_SYSTEM_ERROR_MESSAGE "HAL - VISA: System Error";
 #define VI_ERROR_INV_OBJECT_MESSAGE "HAL - VISA: Invalid Object"
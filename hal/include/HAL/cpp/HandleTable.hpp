@@ -0,0 +1,169 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Errors.hpp"
+#include <stdint.h>
+
+#include <atomic>
+
+namespace hal {
+
+/**
+ * The kinds of object handed out by the HAL as handles. A handle carries its
+ * type, so a handle of one type passed where another is expected is caught.
+ */
+enum class HandleType : uint8_t {
+  Undefined = 0,
+  Counter = 1,
+  Encoder = 2,
+  Interrupt = 3,
+};
+
+/**
+ * A fixed size table of objects referred to by 32-bit handles instead of by
+ * pointers.
+ *
+ * A handle holds the object's type in bits 24-31, the generation of its slot
+ * in bits 8-23 and the index of the slot in bits 0-7. The generation of a slot
+ * is advanced every time it is freed, so a handle used after being freed, a
+ * handle freed twice, or any other stale or made up value is detected by Get()
+ * and Free() in constant time, without taking a lock.
+ *
+ * The objects are stored in place in the table, in an array indexed by slot,
+ * and free slots are kept on a lock-free list.
+ *
+ * The HAL C API passes handles as void *, so HandleToPointer() and
+ * PointerToHandle() convert between the two.
+ */
+template <typename T, uint8_t size, HandleType type>
+class HandleTable {
+ public:
+  static constexpr uint32_t kInvalidHandle = 0;
+
+  HandleTable() {
+    for (uint8_t i = 0; i < size; i++) {
+      m_state[i] = 1;  // generation 1, free
+      m_next[i] = i + 1 < size ? i + 1 : kEndOfList;
+    }
+    m_freeHead = size > 0 ? 0 : kEndOfList;
+  }
+  HandleTable(const HandleTable &) = delete;
+  HandleTable &operator=(const HandleTable &) = delete;
+
+  /**
+   * Take a free slot, resetting its object.
+   * @return The handle to the slot, or kInvalidHandle if the table is full
+   */
+  uint32_t Allocate() {
+    uint32_t head = m_freeHead.load();
+    uint8_t index;
+    do {
+      index = head & 0xff;
+      if (index == kEndOfList) return kInvalidHandle;
+    } while (!m_freeHead.compare_exchange_weak(
+        head, ((head + 0x100) & ~0xffu) | m_next[index].load()));
+
+    uint32_t generation = m_state[index].load() & kGenerationMask;
+    m_objects[index] = T();
+    m_state[index].store(generation | kAllocated);
+    return MakeHandle(index, generation);
+  }
+
+  /**
+   * Get the object a handle refers to.
+   * @return The object, or nullptr if the handle isn't one from this table
+   *         that's still allocated
+   */
+  T *Get(uint32_t handle) {
+    uint8_t index = handle & 0xff;
+    uint32_t generation = (handle >> 8) & kGenerationMask;
+    if ((handle >> 24) != static_cast<uint8_t>(type) || index >= size ||
+        m_state[index].load() != (generation | kAllocated)) {
+      return nullptr;
+    }
+    return &m_objects[index];
+  }
+
+  T *Get(void *handle) { return Get(PointerToHandle(handle)); }
+
+  /**
+   * Get the object a handle refers to, setting status to HAL_HANDLE_ERROR if
+   * the handle isn't valid.
+   */
+  T *Get(void *handle, int32_t *status) {
+    T *object = Get(handle);
+    if (object == nullptr) *status = HAL_HANDLE_ERROR;
+    return object;
+  }
+
+  /**
+   * Free the slot a handle refers to, so that handle stops being valid.
+   * @return false if the handle wasn't valid
+   */
+  bool Free(uint32_t handle) {
+    uint8_t index = handle & 0xff;
+    if ((handle >> 24) != static_cast<uint8_t>(type) || index >= size) {
+      return false;
+    }
+    uint32_t generation = (handle >> 8) & kGenerationMask;
+    uint32_t allocated = generation | kAllocated;
+    // Only one of two racing frees can succeed
+    if (!m_state[index].compare_exchange_strong(
+            allocated, (generation + 1) & kGenerationMask)) {
+      return false;
+    }
+
+    uint32_t head = m_freeHead.load();
+    do {
+      m_next[index].store(head & 0xff);
+    } while (!m_freeHead.compare_exchange_weak(
+        head, ((head + 0x100) & ~0xffu) | index));
+    return true;
+  }
+
+  bool Free(void *handle) { return Free(PointerToHandle(handle)); }
+
+  /**
+   * Get the index of the slot a handle refers to, which is also the index of
+   * the hardware resource it was allocated for.
+   */
+  static uint8_t GetIndex(uint32_t handle) { return handle & 0xff; }
+  static uint8_t GetIndex(void *handle) {
+    return GetIndex(PointerToHandle(handle));
+  }
+
+  static void *HandleToPointer(uint32_t handle) {
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(handle));
+  }
+  static uint32_t PointerToHandle(void *pointer) {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(pointer));
+  }
+
+ private:
+  static_assert(size < 0xff, "Slot indices must fit in 8 bits");
+  static constexpr uint32_t kGenerationMask = 0xffff;
+  static constexpr uint32_t kAllocated = 0x10000;
+  static constexpr uint8_t kEndOfList = 0xff;
+
+  static uint32_t MakeHandle(uint8_t index, uint32_t generation) {
+    return (static_cast<uint32_t>(type) << 24) | (generation << 8) | index;
+  }
+
+  T m_objects[size];
+  // The generation of each slot, plus kAllocated while it's in use
+  std::atomic<uint32_t> m_state[size];
+  // The free list. The head holds the first free index in its low byte and a
+  // count of changes above that, so a pop can't succeed against a head that
+  // was popped and pushed back in the meantime.
+  std::atomic<uint8_t> m_next[size];
+  std::atomic<uint32_t> m_freeHead;
+};
+
+template <typename T, uint8_t size, HandleType type>
+constexpr uint32_t HandleTable<T, size, type>::kInvalidHandle;
+
+}  // namespace hal
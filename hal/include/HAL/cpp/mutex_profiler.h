@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+ * Contention profiling for priority_mutex and priority_recursive_mutex.
+ *
+ * Profiling is only built in when the HAL and the code using it are compiled
+ * with FRC_MUTEX_PROFILING defined (pass -PmutexProfiling to gradle). Without
+ * it the locks are untouched and these functions do nothing.
+ *
+ * In a profiling build, a lock records nothing until SetEnabled(true). Then
+ * each thread counts the acquisitions it makes of each lock, and how long it
+ * waited for and held them, in its own table, so threads don't share any
+ * cache lines while recording. GetStats() adds the tables up.
+ *
+ * Locks are told apart by their address. In the report, a lock that's a
+ * global or static member is named after its symbol, when the program is
+ * linked with -rdynamic; any other lock can be named with SetLockName().
+ *
+ * The simulator's locks are plain std::mutexes, and aren't profiled.
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace hal {
+namespace mutex_profiler {
+
+/**
+ * Wait and hold times are counted in log2 buckets of microseconds: bucket 0
+ * is under 1us, bucket i is [2^(i-1), 2^i) us, and the last bucket also
+ * counts everything longer.
+ */
+static const int kHistogramBuckets = 20;
+
+struct LockStats {
+  const void *lock;
+  std::string name;
+  /** Acquisitions, not counting a recursive mutex being relocked. */
+  uint64_t acquisitions;
+  /** The acquisitions that found the lock taken and had to wait. */
+  uint64_t contended;
+  uint64_t totalWaitNs;
+  uint64_t maxWaitNs;
+  uint64_t totalHoldNs;
+  uint64_t maxHoldNs;
+  /** Waits of the contended acquisitions only. */
+  uint64_t waitHistogram[kHistogramBuckets];
+  uint64_t holdHistogram[kHistogramBuckets];
+};
+
+#ifdef FRC_MUTEX_PROFILING
+
+void SetEnabled(bool enabled);
+bool IsEnabled();
+
+/** Name a lock in the report, in place of its symbol or address. */
+void SetLockName(const void *lock, const char *name);
+
+/** Forget everything recorded so far. */
+void Reset();
+
+/** Everything recorded since the last Reset(), by total wait, longest first. */
+std::vector<LockStats> GetStats();
+
+/** GetStats() as a table, one lock per line. */
+std::string FormatReport();
+
+/*
+ * Called by the locks.
+ */
+void RecordAcquire(const void *lock, bool contended, uint64_t waitNs);
+void RecordRelease(const void *lock);
+
+#else
+
+inline void SetEnabled(bool) {}
+inline bool IsEnabled() { return false; }
+inline void SetLockName(const void *, const char *) {}
+inline void Reset() {}
+inline std::vector<LockStats> GetStats() { return {}; }
+inline std::string FormatReport() {
+  return "Mutex profiling isn't built in; define FRC_MUTEX_PROFILING.\n";
+}
+
+#endif  // FRC_MUTEX_PROFILING
+
+}  // namespace mutex_profiler
+}  // namespace hal
@@ -0,0 +1,238 @@
+#pragma once
+
+/* Lightweight events and condition variables built directly on Linux futexes.
+ *
+ * priority_condition_variable takes an internal std::mutex and copies a
+ * shared_ptr on every wait and notify, and always makes a system call to
+ * notify, even when no thread is waiting. The classes here keep their state in
+ * a single 32-bit word plus a count of waiters, so signalling with nobody
+ * waiting is a couple of atomic operations and waking waiters is one
+ * FUTEX_WAKE.
+ *
+ * The kernel keeps futex waiters sorted by scheduling priority, so the
+ * highest priority real-time thread waiting is always the one woken first.
+ * priority_condition re-locks the caller's lock after waking, so waiting on a
+ * priority_mutex keeps its priority inheritance.
+ *
+ * None of these provide a native_handle(); use priority_condition_variable
+ * where a pthread_cond_t has to be handed to the network communication
+ * library.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <utility>
+
+class priority_futex {
+ protected:
+  // Sleep as long as word holds expected, for at most timeout (forever if
+  // nullptr). Returns false only if the timeout expired.
+  static bool wait(std::atomic<int32_t> &word, int32_t expected,
+                   const std::chrono::nanoseconds *timeout);
+
+  // Wake up to count threads sleeping on word.
+  static void wake(std::atomic<int32_t> &word, int32_t count);
+
+  static void wake_all(std::atomic<int32_t> &word);
+
+  // Time left until deadline, never negative.
+  static std::chrono::nanoseconds remaining(
+      std::chrono::steady_clock::time_point deadline) {
+    auto left = deadline - std::chrono::steady_clock::now();
+    return left.count() > 0 ? left : std::chrono::nanoseconds(0);
+  }
+};
+
+/**
+ * An auto-reset event. set() releases exactly one waiter, or if no thread is
+ * waiting, the next call to wait(). Sets that nobody has waited for yet
+ * don't add up.
+ */
+class priority_event : private priority_futex {
+ public:
+  priority_event() = default;
+  priority_event(const priority_event &) = delete;
+  priority_event &operator=(const priority_event &) = delete;
+
+  void set() {
+    if (m_state.exchange(1) == 0 && m_waiters.load() != 0) wake(m_state, 1);
+  }
+
+  void reset() { m_state.store(0); }
+
+  // Take the event if it is set, without waiting.
+  bool try_wait() { return m_state.exchange(0) == 1; }
+
+  void wait() {
+    if (try_wait()) return;
+    m_waiters++;
+    while (!try_wait()) priority_futex::wait(m_state, 0, nullptr);
+    m_waiters--;
+  }
+
+  // @return true if the event was taken, false if the timeout expired.
+  template <typename Rep, typename Period>
+  bool wait_for(const std::chrono::duration<Rep, Period> &rtime) {
+    if (try_wait()) return true;
+    auto deadline = std::chrono::steady_clock::now() + rtime;
+    m_waiters++;
+    bool taken;
+    while (!(taken = try_wait())) {
+      std::chrono::nanoseconds left = remaining(deadline);
+      if (left.count() == 0) break;
+      priority_futex::wait(m_state, 0, &left);
+    }
+    m_waiters--;
+    return taken;
+  }
+
+ private:
+  std::atomic<int32_t> m_state{0};
+  std::atomic<int32_t> m_waiters{0};
+};
+
+/**
+ * A generation counter that wakes every waiter when it is advanced.
+ *
+ * A waiter reads generation(), does its work and then waits for the
+ * generation to move on, so notifications that happen between the two aren't
+ * missed, and no lock is needed on either side.
+ */
+class priority_broadcast : private priority_futex {
+ public:
+  priority_broadcast() = default;
+  priority_broadcast(const priority_broadcast &) = delete;
+  priority_broadcast &operator=(const priority_broadcast &) = delete;
+
+  uint32_t generation() const { return m_generation.load(); }
+
+  // Advance the generation and wake all waiters.
+  void notify_all() {
+    m_generation++;
+    if (m_waiters.load() != 0) wake_all(m_generation);
+  }
+
+  // Wait for the next notify_all().
+  uint32_t wait() { return wait(generation()); }
+
+  // Wait until the generation is no longer the given one.
+  // @return The new generation
+  uint32_t wait(uint32_t generation) {
+    m_waiters++;
+    while (m_generation.load() == (int32_t)generation) {
+      priority_futex::wait(m_generation, (int32_t)generation, nullptr);
+    }
+    m_waiters--;
+    return m_generation.load();
+  }
+
+  // @return true if the generation moved on, false if the timeout expired.
+  template <typename Rep, typename Period>
+  bool wait_for(uint32_t generation,
+                const std::chrono::duration<Rep, Period> &rtime) {
+    auto deadline = std::chrono::steady_clock::now() + rtime;
+    m_waiters++;
+    bool changed;
+    while (!(changed = m_generation.load() != (int32_t)generation)) {
+      std::chrono::nanoseconds left = remaining(deadline);
+      if (left.count() == 0) break;
+      priority_futex::wait(m_generation, (int32_t)generation, &left);
+    }
+    m_waiters--;
+    return changed;
+  }
+
+ private:
+  std::atomic<int32_t> m_generation{0};
+  std::atomic<int32_t> m_waiters{0};
+};
+
+/**
+ * A condition variable with the same interface as priority_condition_variable
+ * (apart from native_handle()) that works with any lock, including
+ * priority_mutex and priority_recursive_mutex.
+ *
+ * Like any condition variable, waits may return spuriously, so they should be
+ * made in a loop or with a predicate.
+ */
+class priority_condition : private priority_futex {
+ public:
+  priority_condition() = default;
+  priority_condition(const priority_condition &) = delete;
+  priority_condition &operator=(const priority_condition &) = delete;
+
+  void notify_one() noexcept {
+    m_sequence++;
+    if (m_waiters.load() != 0) wake(m_sequence, 1);
+  }
+
+  void notify_all() noexcept {
+    m_sequence++;
+    if (m_waiters.load() != 0) wake_all(m_sequence);
+  }
+
+  template <typename Lock>
+  void wait(Lock &lock) {
+    wait_sequence(lock, nullptr);
+  }
+
+  template <typename Lock, typename Predicate>
+  void wait(Lock &lock, Predicate p) {
+    while (!p()) wait(lock);
+  }
+
+  template <typename Lock, typename Rep, typename Period>
+  std::cv_status wait_for(Lock &lock,
+                          const std::chrono::duration<Rep, Period> &rtime) {
+    std::chrono::nanoseconds timeout =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(rtime);
+    if (timeout.count() < 0) timeout = std::chrono::nanoseconds(0);
+    return wait_sequence(lock, &timeout);
+  }
+
+  template <typename Lock, typename Rep, typename Period, typename Predicate>
+  bool wait_for(Lock &lock, const std::chrono::duration<Rep, Period> &rtime,
+                Predicate p) {
+    return wait_until(lock, std::chrono::steady_clock::now() + rtime,
+                      std::move(p));
+  }
+
+  template <typename Lock, typename Clock, typename Duration>
+  std::cv_status wait_until(
+      Lock &lock, const std::chrono::time_point<Clock, Duration> &atime) {
+    wait_for(lock, atime - Clock::now());
+    return Clock::now() < atime ? std::cv_status::no_timeout
+                                : std::cv_status::timeout;
+  }
+
+  template <typename Lock, typename Clock, typename Duration,
+            typename Predicate>
+  bool wait_until(Lock &lock,
+                  const std::chrono::time_point<Clock, Duration> &atime,
+                  Predicate p) {
+    while (!p()) {
+      if (wait_until(lock, atime) == std::cv_status::timeout) return p();
+    }
+    return true;
+  }
+
+ private:
+  template <typename Lock>
+  std::cv_status wait_sequence(Lock &lock,
+                               const std::chrono::nanoseconds *timeout) {
+    // The sequence is read with the lock held, so a notify made after the
+    // waiter's predicate check changes it and the futex wait returns at once.
+    int32_t sequence = m_sequence.load();
+    m_waiters++;
+    lock.unlock();
+    bool notified = priority_futex::wait(m_sequence, sequence, timeout);
+    m_waiters--;
+    lock.lock();
+    return notified ? std::cv_status::no_timeout : std::cv_status::timeout;
+  }
+
+  std::atomic<int32_t> m_sequence{0};
+  std::atomic<int32_t> m_waiters{0};
+};
@@ -12,6 +12,9 @@ typedef std::recursive_mutex priority_recursive_mutex;
 
 #include <pthread.h>
 
+// When built with FRC_MUTEX_PROFILING, these locks record how contended they
+// are; see mutex_profiler.h.
+
 class priority_recursive_mutex {
  public:
   typedef pthread_mutex_t *native_handle_type;
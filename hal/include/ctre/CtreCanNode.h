@@ -2,8 +2,10 @@
 #define CtreCanNode_H_
 #include "ctre.h"				//BIT Defines + Typedefs
 #include <map>
+#include <stdint.h>
 #include <string.h> // memcpy
 #include <sys/time.h>
+#include <time.h>
 class CtreCanNode
 {
 public:
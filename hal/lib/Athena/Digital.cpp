@@ -4,6 +4,7 @@
 #include "HAL/Port.h"
 #include "HAL/HAL.hpp"
 #include "ChipObject.h"
+#include "HAL/cpp/HandleTable.hpp"
 #include "HAL/cpp/Resource.hpp"
 #include "HAL/cpp/priority_mutex.h"
 #include "FRC_NetworkCommunication/LoadOut.h"
@@ -594,35 +595,38 @@ struct counter_t {
 };
 typedef struct counter_t Counter;
 
-static hal::Resource *counters = NULL;
+static hal::HandleTable<Counter, tCounter::kNumSystems, hal::HandleType::Counter>
+    counters;
 
 void* initializeCounter(Mode mode, uint32_t *index, int32_t *status) {
-	hal::Resource::CreateResourceObject(&counters, tCounter::kNumSystems);
-	*index = counters->Allocate("Counter");
-	if (*index == ~0ul) {
+	uint32_t handle = counters.Allocate();
+	if (handle == counters.kInvalidHandle) {
 		*status = NO_AVAILABLE_RESOURCES;
 		return NULL;
 	}
-	Counter* counter = new Counter();
+	*index = counters.GetIndex(handle);
+	Counter* counter = counters.Get(handle);
 	counter->counter = tCounter::create(*index, status);
 	counter->counter->writeConfig_Mode(mode, status);
 	counter->counter->writeTimerConfig_AverageSize(1, status);
 	counter->index = *index;
-	return counter;
+	return counters.HandleToPointer(handle);
 }
 
 void freeCounter(void* counter_pointer, int32_t *status) {
   if (counter_pointer != NULL) {
-	  Counter* counter = (Counter*) counter_pointer;
+	  Counter* counter = counters.Get(counter_pointer, status);
+	  if (counter == nullptr) return;
 	  delete counter->counter;
-	  counters->Free(counter->index);
+	  counters.Free(counter_pointer);
   } else {
 	  *status = NULL_PARAMETER;
   }
 }
 
 void setCounterAverageSize(void* counter_pointer, int32_t size, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeTimerConfig_AverageSize(size, status);
 }
 
@@ -649,7 +653,8 @@ void remapDigitalSource(bool analogTrigger, uint32_t &pin, uint8_t &module) {
  * Set the up counting DigitalSource.
  */
 void setCounterUpSource(void* counter_pointer, uint32_t pin, bool analogTrigger, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
 
   uint8_t module;
 
@@ -671,7 +676,8 @@ void setCounterUpSource(void* counter_pointer, uint32_t pin, bool analogTrigger,
  * Set the up source to either detect rising edges or falling edges.
  */
 void setCounterUpSourceEdge(void* counter_pointer, bool risingEdge, bool fallingEdge, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_UpRisingEdge(risingEdge, status);
   counter->counter->writeConfig_UpFallingEdge(fallingEdge, status);
 }
@@ -680,7 +686,8 @@ void setCounterUpSourceEdge(void* counter_pointer, bool risingEdge, bool falling
  * Disable the up counting source to the counter.
  */
 void clearCounterUpSource(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_UpFallingEdge(false, status);
   counter->counter->writeConfig_UpRisingEdge(false, status);
   // Index 0 of digital is always 0.
@@ -693,7 +700,8 @@ void clearCounterUpSource(void* counter_pointer, int32_t *status) {
  * Set the down counting DigitalSource.
  */
 void setCounterDownSource(void* counter_pointer, uint32_t pin, bool analogTrigger, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   unsigned char mode = counter->counter->readConfig_Mode(status);
   if (mode != kTwoPulse && mode != kExternalDirection) {
 	// TODO: wpi_setWPIErrorWithContext(ParameterOutOfRange, "Counter only supports DownSource in TwoPulse and ExternalDirection modes.");
@@ -718,7 +726,8 @@ void setCounterDownSource(void* counter_pointer, uint32_t pin, bool analogTrigge
  * Set the down source to either detect rising edges or falling edges.
  */
 void setCounterDownSourceEdge(void* counter_pointer, bool risingEdge, bool fallingEdge, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_DownRisingEdge(risingEdge, status);
   counter->counter->writeConfig_DownFallingEdge(fallingEdge, status);
 }
@@ -727,7 +736,8 @@ void setCounterDownSourceEdge(void* counter_pointer, bool risingEdge, bool falli
  * Disable the down counting source to the counter.
  */
 void clearCounterDownSource(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_DownFallingEdge(false, status);
   counter->counter->writeConfig_DownRisingEdge(false, status);
   // Index 0 of digital is always 0.
@@ -740,7 +750,8 @@ void clearCounterDownSource(void* counter_pointer, int32_t *status) {
  * Up and down counts are sourced independently from two inputs.
  */
 void setCounterUpDownMode(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_Mode(kTwoPulse, status);
 }
 
@@ -750,7 +761,8 @@ void setCounterUpDownMode(void* counter_pointer, int32_t *status) {
  * The Down counter input represents the direction to count.
  */
 void setCounterExternalDirectionMode(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_Mode(kExternalDirection, status);
 }
 
@@ -759,7 +771,8 @@ void setCounterExternalDirectionMode(void* counter_pointer, int32_t *status) {
  * Counts up on both rising and falling edges.
  */
 void setCounterSemiPeriodMode(void* counter_pointer, bool highSemiPeriod, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_Mode(kSemiperiod, status);
   counter->counter->writeConfig_UpRisingEdge(highSemiPeriod, status);
   setCounterUpdateWhenEmpty(counter_pointer, false, status);
@@ -771,7 +784,8 @@ void setCounterSemiPeriodMode(void* counter_pointer, bool highSemiPeriod, int32_
  * @param threshold The pulse length beyond which the counter counts the opposite direction.  Units are seconds.
  */
 void setCounterPulseLengthMode(void* counter_pointer, double threshold, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeConfig_Mode(kPulseLength, status);
   counter->counter->writeConfig_PulseLengthThreshold((uint32_t)(threshold * 1.0e6) * kSystemClockTicksPerMicrosecond, status);
 }
@@ -783,7 +797,8 @@ void setCounterPulseLengthMode(void* counter_pointer, double threshold, int32_t
  * @return SamplesToAverage The number of samples being averaged (from 1 to 127)
  */
 int32_t getCounterSamplesToAverage(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return 0;
   return counter->counter->readTimerConfig_AverageSize(status);
 }
 
@@ -794,7 +809,8 @@ int32_t getCounterSamplesToAverage(void* counter_pointer, int32_t *status) {
  * @param samplesToAverage The number of samples to average from 1 to 127.
  */
 void setCounterSamplesToAverage(void* counter_pointer, int samplesToAverage, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   if (samplesToAverage < 1 || samplesToAverage > 127) {
 	*status = PARAMETER_OUT_OF_RANGE;
   }
@@ -807,7 +823,8 @@ void setCounterSamplesToAverage(void* counter_pointer, int samplesToAverage, int
  * the current value to zero.
  */
 void resetCounter(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->strobeReset(status);
 }
 
@@ -817,7 +834,8 @@ void resetCounter(void* counter_pointer, int32_t *status) {
  * time it is read, it might have a different value.
  */
 int32_t getCounter(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return 0;
   int32_t value = counter->counter->readOutput_Value(status);
   return value;
 }
@@ -829,7 +847,8 @@ int32_t getCounter(void* counter_pointer, int32_t *status) {
  * @returns The period of the last two pulses in units of seconds.
  */
 double getCounterPeriod(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return 0.0;
   tCounter::tTimerOutput output = counter->counter->readTimerOutput(status);
   double period;
   if (output.Stalled)	{
@@ -851,7 +870,8 @@ double getCounterPeriod(void* counter_pointer, int32_t *status) {
  * seconds.
  */
 void setCounterMaxPeriod(void* counter_pointer, double maxPeriod, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeTimerConfig_StallPeriod((uint32_t)(maxPeriod * 4.0e8), status);
 }
 
@@ -868,7 +888,8 @@ void setCounterMaxPeriod(void* counter_pointer, double maxPeriod, int32_t *statu
  * no samples to average).
  */
 void setCounterUpdateWhenEmpty(void* counter_pointer, bool enabled, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   counter->counter->writeTimerConfig_UpdateWhenEmpty(enabled, status);
 }
 
@@ -881,7 +902,8 @@ void setCounterUpdateWhenEmpty(void* counter_pointer, bool enabled, int32_t *sta
  * SetMaxPeriod.
  */
 bool getCounterStopped(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return false;
   return counter->counter->readTimerOutput_Stalled(status);
 }
 
@@ -890,7 +912,8 @@ bool getCounterStopped(void* counter_pointer, int32_t *status) {
  * @return The last direction the counter value changed.
  */
 bool getCounterDirection(void* counter_pointer, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return false;
   bool value = counter->counter->readOutput_Direction(status);
   return value;
 }
@@ -902,7 +925,8 @@ bool getCounterDirection(void* counter_pointer, int32_t *status) {
  * @param reverseDirection true if the value counted should be negated.
  */
 void setCounterReverseDirection(void* counter_pointer, bool reverseDirection, int32_t *status) {
-  Counter* counter = (Counter*) counter_pointer;
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
   if (counter->counter->readConfig_Mode(status) == kExternalDirection) {
 	if (reverseDirection)
 	  setCounterDownSourceEdge(counter_pointer, true, true, status);
@@ -918,22 +942,27 @@ struct encoder_t {
 typedef struct encoder_t Encoder;
 
 static const double DECODING_SCALING_FACTOR = 0.25;
-static hal::Resource *quadEncoders = NULL;
+static hal::HandleTable<Encoder, tEncoder::kNumSystems, hal::HandleType::Encoder>
+    quadEncoders;
 
 void* initializeEncoder(uint8_t port_a_module, uint32_t port_a_pin, bool port_a_analog_trigger,
 						uint8_t port_b_module, uint32_t port_b_pin, bool port_b_analog_trigger,
 						bool reverseDirection, int32_t *index, int32_t *status) {
 
+  uint32_t handle = quadEncoders.Allocate();
+  if (handle == quadEncoders.kInvalidHandle) {
+	*status = NO_AVAILABLE_RESOURCES;
+	return NULL;
+  }
+
   // Initialize encoder structure
-  Encoder* encoder = new Encoder();
+  Encoder* encoder = quadEncoders.Get(handle);
 
   remapDigitalSource(port_a_analog_trigger, port_a_pin, port_a_module);
   remapDigitalSource(port_b_analog_trigger, port_b_pin, port_b_module);
 
-  hal::Resource::CreateResourceObject(&quadEncoders, tEncoder::kNumSystems);
-  encoder->index = quadEncoders->Allocate("4X Encoder");
+  encoder->index = quadEncoders.GetIndex(handle);
   *index = encoder->index;
-  // TODO: if (index == ~0ul) { CloneError(quadEncoders); return; }
   encoder->encoder = tEncoder::create(encoder->index, status);
   encoder->encoder->writeConfig_ASource_Module(port_a_module, status);
   encoder->encoder->writeConfig_ASource_Channel(port_a_pin, status);
@@ -945,13 +974,14 @@ void* initializeEncoder(uint8_t port_a_module, uint32_t port_a_pin, bool port_a_
   encoder->encoder->writeConfig_Reverse(reverseDirection, status);
   encoder->encoder->writeTimerConfig_AverageSize(4, status);
 
-  return encoder;
+  return quadEncoders.HandleToPointer(handle);
 }
 
 void freeEncoder(void* encoder_pointer, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
-  quadEncoders->Free(encoder->index);
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
   delete encoder->encoder;
+  quadEncoders.Free(encoder_pointer);
 }
 
 /**
@@ -959,7 +989,8 @@ void freeEncoder(void* encoder_pointer, int32_t *status) {
  * Resets the current count to zero on the encoder.
  */
 void resetEncoder(void* encoder_pointer, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
   encoder->encoder->strobeReset(status);
 }
 
@@ -970,7 +1001,8 @@ void resetEncoder(void* encoder_pointer, int32_t *status) {
  * @return Current raw count from the encoder
  */
 int32_t getEncoder(void* encoder_pointer, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return 0;
   return encoder->encoder->readOutput_Value(status);
 }
 
@@ -984,7 +1016,8 @@ int32_t getEncoder(void* encoder_pointer, int32_t *status) {
  * @return Period in seconds of the most recent pulse.
  */
 double getEncoderPeriod(void* encoder_pointer, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return 0.0;
   tEncoder::tTimerOutput output = encoder->encoder->readTimerOutput(status);
   double value;
   if (output.Stalled) {
@@ -1012,7 +1045,8 @@ double getEncoderPeriod(void* encoder_pointer, int32_t *status) {
  * report the device stopped. This is expressed in seconds.
  */
 void setEncoderMaxPeriod(void* encoder_pointer, double maxPeriod, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
   encoder->encoder->writeTimerConfig_StallPeriod((uint32_t)(maxPeriod * 4.0e8 * DECODING_SCALING_FACTOR), status);
 }
 
@@ -1024,7 +1058,8 @@ void setEncoderMaxPeriod(void* encoder_pointer, double maxPeriod, int32_t *statu
  * @return True if the encoder is considered stopped.
  */
 bool getEncoderStopped(void* encoder_pointer, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return false;
   return encoder->encoder->readTimerOutput_Stalled(status) != 0;
 }
 
@@ -1033,7 +1068,8 @@ bool getEncoderStopped(void* encoder_pointer, int32_t *status) {
  * @return The last direction the encoder value changed.
  */
 bool getEncoderDirection(void* encoder_pointer, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return false;
   return encoder->encoder->readOutput_Direction(status);
 }
 
@@ -1044,7 +1080,8 @@ bool getEncoderDirection(void* encoder_pointer, int32_t *status) {
  * @param reverseDirection true if the encoder direction should be reversed
  */
 void setEncoderReverseDirection(void* encoder_pointer, bool reverseDirection, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
   encoder->encoder->writeConfig_Reverse(reverseDirection, status);
 }
 
@@ -1055,7 +1092,8 @@ void setEncoderReverseDirection(void* encoder_pointer, bool reverseDirection, in
  * @param samplesToAverage The number of samples to average from 1 to 127.
  */
 void setEncoderSamplesToAverage(void* encoder_pointer, uint32_t samplesToAverage, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
   if (samplesToAverage < 1 || samplesToAverage > 127) {
 	*status = PARAMETER_OUT_OF_RANGE;
   }
@@ -1069,7 +1107,8 @@ void setEncoderSamplesToAverage(void* encoder_pointer, uint32_t samplesToAverage
  * @return SamplesToAverage The number of samples being averaged (from 1 to 127)
  */
 uint32_t getEncoderSamplesToAverage(void* encoder_pointer, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return 0;
   return encoder->encoder->readTimerConfig_AverageSize(status);
 }
 
@@ -1079,7 +1118,8 @@ uint32_t getEncoderSamplesToAverage(void* encoder_pointer, int32_t *status) {
  */
 void setEncoderIndexSource(void *encoder_pointer, uint32_t pin, bool analogTrigger, bool activeHigh,
     bool edgeSensitive, int32_t *status) {
-  Encoder* encoder = (Encoder*) encoder_pointer;
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
   encoder->encoder->writeConfig_IndexSource_Channel((unsigned char)pin, status);
   encoder->encoder->writeConfig_IndexSource_Module((unsigned char)0, status);
   encoder->encoder->writeConfig_IndexSource_AnalogTrigger(analogTrigger, status);
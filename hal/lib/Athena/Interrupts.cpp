@@ -1,5 +1,6 @@
 #include "HAL/Interrupts.hpp"
 #include "ChipObject.h"
+#include "HAL/cpp/HandleTable.hpp"
 
 extern void remapDigitalSource(bool analogTrigger, uint32_t &pin, uint8_t &module);
 
@@ -9,24 +10,34 @@ struct Interrupt // FIXME: why is this internal?
 	tInterruptManager *manager;
 };
 
+static hal::HandleTable<Interrupt, tInterrupt::kNumSystems,
+                        hal::HandleType::Interrupt> interrupts;
+
 void* initializeInterrupts(uint32_t interruptIndex, bool watcher, int32_t *status)
 {
-	Interrupt* anInterrupt = new Interrupt();
+	uint32_t handle = interrupts.Allocate();
+	if (handle == interrupts.kInvalidHandle) {
+		*status = NO_AVAILABLE_RESOURCES;
+		return NULL;
+	}
+	Interrupt* anInterrupt = interrupts.Get(handle);
 	// Expects the calling leaf class to allocate an interrupt index.
 	anInterrupt->anInterrupt = tInterrupt::create(interruptIndex, status);
 	anInterrupt->anInterrupt->writeConfig_WaitForAck(false, status);
 	anInterrupt->manager = new tInterruptManager(
 		(1 << interruptIndex) | (1 << (interruptIndex + 8)), watcher, status);
-	return anInterrupt;
+	return interrupts.HandleToPointer(handle);
 }
 
 void cleanInterrupts(void* interrupt_pointer, int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
 	delete anInterrupt->anInterrupt;
 	delete anInterrupt->manager;
 	anInterrupt->anInterrupt = NULL;
 	anInterrupt->manager = NULL;
+	interrupts.Free(interrupt_pointer);
 }
 
 /**
@@ -39,7 +50,8 @@ void cleanInterrupts(void* interrupt_pointer, int32_t *status)
 uint32_t waitForInterrupt(void* interrupt_pointer, double timeout, bool ignorePrevious, int32_t *status)
 {
 	uint32_t result;
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return 0;
 
 	result = anInterrupt->manager->watch((int32_t)(timeout * 1e3), ignorePrevious, status);
 
@@ -59,7 +71,8 @@ uint32_t waitForInterrupt(void* interrupt_pointer, double timeout, bool ignorePr
  */
 void enableInterrupts(void* interrupt_pointer, int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
 	anInterrupt->manager->enable(status);
 }
 
@@ -68,7 +81,8 @@ void enableInterrupts(void* interrupt_pointer, int32_t *status)
  */
 void disableInterrupts(void* interrupt_pointer, int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
 	anInterrupt->manager->disable(status);
 }
 
@@ -79,7 +93,8 @@ void disableInterrupts(void* interrupt_pointer, int32_t *status)
  */
 double readRisingTimestamp(void* interrupt_pointer, int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return 0.0;
 	uint32_t timestamp = anInterrupt->anInterrupt->readRisingTimeStamp(status);
 	return timestamp * 1e-6;
 }
@@ -91,7 +106,8 @@ double readRisingTimestamp(void* interrupt_pointer, int32_t *status)
 */
 double readFallingTimestamp(void* interrupt_pointer, int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return 0.0;
 	uint32_t timestamp = anInterrupt->anInterrupt->readFallingTimeStamp(status);
 	return timestamp * 1e-6;
 }
@@ -99,7 +115,8 @@ double readFallingTimestamp(void* interrupt_pointer, int32_t *status)
 void requestInterrupts(void* interrupt_pointer, uint8_t routing_module, uint32_t routing_pin,
 		bool routing_analog_trigger, int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
 	anInterrupt->anInterrupt->writeConfig_WaitForAck(false, status);
 	remapDigitalSource(routing_analog_trigger, routing_pin, routing_module);
 	anInterrupt->anInterrupt->writeConfig_Source_AnalogTrigger(routing_analog_trigger, status);
@@ -110,14 +127,16 @@ void requestInterrupts(void* interrupt_pointer, uint8_t routing_module, uint32_t
 void attachInterruptHandler(void* interrupt_pointer, InterruptHandlerFunction handler, void* param,
 		int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
 	anInterrupt->manager->registerHandler(handler, param, status);
 }
 
 void setInterruptUpSourceEdge(void* interrupt_pointer, bool risingEdge, bool fallingEdge,
 		int32_t *status)
 {
-	Interrupt* anInterrupt = (Interrupt*)interrupt_pointer;
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
 	anInterrupt->anInterrupt->writeConfig_RisingEdge(risingEdge, status);
 	anInterrupt->anInterrupt->writeConfig_FallingEdge(fallingEdge, status);
 }
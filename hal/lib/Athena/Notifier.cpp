@@ -1,40 +1,183 @@
 #include "HAL/Notifier.hpp"
+#include "HAL/HAL.hpp"
+#include "HAL/cpp/priority_mutex.h"
 #include "ChipObject.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 static const uint32_t kTimerInterruptNumber = 28;
 
+/*
+ * The FPGA has one alarm, and its interrupt can only be reserved by one
+ * interrupt manager, so all notifiers share a single alarm and manager. They
+ * are created with the first notifier and freed with the last one.
+ *
+ * The alarm is always set to the earliest trigger time of any notifier. When
+ * it fires, the handlers of the notifiers that are due are called, one at a
+ * time from the interrupt thread with the lock released, and the alarm is set
+ * for the next one.
+ *
+ * A handler may free any notifier, its own included. One freed that way is
+ * skipped if it was still due, and only deleted once all the handlers of that
+ * alarm have returned. The manager can't be freed from its own thread, so if a
+ * handler frees the last notifier the alarm and manager are kept for the next
+ * one, and freed with it.
+ */
 struct Notifier
 {
-	tAlarm *alarm;
-	tInterruptManager *manager;
+	void (*process)(uint32_t, void*);
+	void *param;
+	bool enabled;
+	bool removed;
+	uint32_t triggerTime;
 };
 
-void* initializeNotifier(void (*ProcessQueue)(uint32_t, void*), int32_t *status)
+static priority_mutex notifierMutex;
+// Held while handlers are called, so cleanNotifier() can wait for a handler
+// of the notifier it frees to return.
+static priority_mutex handlerMutex;
+static std::vector<Notifier*> notifiers;
+// Freed by handlers, to be deleted once they have all returned
+static std::vector<Notifier*> freedByHandlers;
+static tAlarm *alarm = nullptr;
+static tInterruptManager *manager = nullptr;
+// Set on the interrupt thread while it calls handlers
+static thread_local bool inHandler = false;
+
+/**
+ * Set the alarm for the earliest enabled notifier. The FPGA time wraps every
+ * 71 minutes, so the times are compared relative to now.
+ * Must be called with notifierMutex held.
+ */
+static void updateAlarm(int32_t *status)
+{
+	uint32_t now = getFPGATime(status);
+	Notifier *next = nullptr;
+	for (Notifier *notifier : notifiers) {
+		if (!notifier->enabled) continue;
+		if (next == nullptr ||
+				(int32_t)(notifier->triggerTime - now) < (int32_t)(next->triggerTime - now))
+			next = notifier;
+	}
+	if (next == nullptr) return;
+
+	alarm->writeTriggerTime(next->triggerTime, status);
+	// Enable the alarm.  The hardware disables itself after each alarm.
+	alarm->writeEnable(true, status);
+}
+
+static void alarmCallback(uint32_t mask, void*)
+{
+	std::lock_guard<priority_mutex> handlers(handlerMutex);
+	std::vector<Notifier*> due;
+	{
+		std::lock_guard<priority_mutex> sync(notifierMutex);
+		int32_t status = 0;
+		uint32_t now = getFPGATime(&status);
+		for (Notifier *notifier : notifiers) {
+			if (notifier->enabled && (int32_t)(notifier->triggerTime - now) <= 0) {
+				notifier->enabled = false;
+				due.push_back(notifier);
+			}
+		}
+		updateAlarm(&status);
+	}
+
+	inHandler = true;
+	for (Notifier *notifier : due) {
+		{
+			// Freed by a handler called before it
+			std::lock_guard<priority_mutex> sync(notifierMutex);
+			if (notifier->removed) continue;
+		}
+		notifier->process(mask, notifier->param);
+	}
+	inHandler = false;
+
+	std::vector<Notifier*> freed;
+	{
+		std::lock_guard<priority_mutex> sync(notifierMutex);
+		freed.swap(freedByHandlers);
+	}
+	for (Notifier *notifier : freed) delete notifier;
+}
+
+/**
+ * Create a notifier that calls ProcessQueue from the interrupt thread when its
+ * alarm fires.
+ * @param param Passed through to each ProcessQueue call, so several notifiers
+ * can share one handler
+ */
+void* initializeNotifier(void (*ProcessQueue)(uint32_t, void*), void* param, int32_t *status)
 {
 	Notifier* notifier = new Notifier();
-	notifier->manager = new tInterruptManager(1 << kTimerInterruptNumber, false, status);
-	notifier->manager->registerHandler(ProcessQueue, NULL, status);
-	notifier->manager->enable(status);
-	notifier->alarm = tAlarm::create(status);
+	notifier->process = ProcessQueue;
+	notifier->param = param;
+	notifier->enabled = false;
+	notifier->removed = false;
+
+	std::lock_guard<priority_mutex> sync(notifierMutex);
+	// Still there if a handler freed the last notifier
+	if (manager == nullptr) {
+		manager = new tInterruptManager(1 << kTimerInterruptNumber, false, status);
+		manager->registerHandler(alarmCallback, nullptr, status);
+		manager->enable(status);
+		alarm = tAlarm::create(status);
+	}
+	notifiers.push_back(notifier);
 	return notifier;
 }
 
+/**
+ * Free a notifier. The alarm keeps running for the other notifiers; it and the
+ * interrupt manager are only freed with the last one, unless it is freed by a
+ * handler.
+ */
 void cleanNotifier(void* notifier_pointer, int32_t *status)
 {
 	Notifier* notifier = (Notifier*)notifier_pointer;
-	notifier->alarm->writeEnable(false, status);
-	delete notifier->alarm;
-	notifier->alarm = NULL;
-	notifier->manager->disable(status);
-	delete notifier->manager;
-	notifier->manager = NULL;
+	tAlarm *lastAlarm = nullptr;
+	tInterruptManager *lastManager = nullptr;
+	{
+		std::lock_guard<priority_mutex> sync(notifierMutex);
+		notifier->removed = true;
+		notifiers.erase(std::remove(notifiers.begin(), notifiers.end(), notifier),
+				notifiers.end());
+		if (inHandler) {
+			// alarmCallback() may still have it due, and deletes it when the
+			// handlers are done
+			freedByHandlers.push_back(notifier);
+			if (notifiers.empty()) alarm->writeEnable(false, status);
+			return;
+		}
+		if (notifiers.empty()) {
+			lastAlarm = alarm;
+			lastManager = manager;
+			alarm = nullptr;
+			manager = nullptr;
+		}
+	}
+
+	// Freed without the lock, since the interrupt thread may be waiting on it
+	if (lastAlarm != nullptr) {
+		lastAlarm->writeEnable(false, status);
+		delete lastAlarm;
+		lastManager->disable(status);
+		delete lastManager;
+	}
+
+	// Wait out a handler call that picked up this notifier before it was
+	// removed
+	std::lock_guard<priority_mutex> handlers(handlerMutex);
+	delete notifier;
 }
 
 void updateNotifierAlarm(void* notifier_pointer, uint32_t triggerTime, int32_t *status)
 {
 	Notifier* notifier = (Notifier*)notifier_pointer;
-	// write the first item in the queue into the trigger time
-	notifier->alarm->writeTriggerTime(triggerTime, status);
-	// Enable the alarm.  The hardware disables itself after each alarm.
-	notifier->alarm->writeEnable(true, status);
+	std::lock_guard<priority_mutex> sync(notifierMutex);
+	notifier->triggerTime = triggerTime;
+	notifier->enabled = true;
+	updateAlarm(status);
 }
@@ -0,0 +1,399 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "HAL/cpp/mutex_profiler.h"
+
+#ifdef FRC_MUTEX_PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <link.h>
+
+namespace hal {
+namespace mutex_profiler {
+
+/*
+ * Each thread records into a buffer only it writes to. The counters are
+ * atomics so GetStats() can read them while they're being written, but the
+ * owner updates them with plain loads and stores, which cost no more than
+ * ordinary ones.
+ *
+ * A buffer is kept when its thread exits and handed to the next new thread,
+ * so the counts of short lived threads aren't lost and there are never more
+ * buffers than threads running at once.
+ *
+ * The bookkeeping here uses std::mutex, never the priority mutexes it's
+ * profiling.
+ */
+
+// Distinct locks each thread can record; must be a power of two.
+static const int kMaxLocks = 128;
+// Locks a thread can hold at once and still time.
+static const int kMaxHeld = 16;
+
+struct LockCounters {
+  std::atomic<const void *> lock{nullptr};
+  std::atomic<uint64_t> acquisitions{0};
+  std::atomic<uint64_t> contended{0};
+  std::atomic<uint64_t> totalWaitNs{0};
+  std::atomic<uint64_t> maxWaitNs{0};
+  std::atomic<uint64_t> totalHoldNs{0};
+  std::atomic<uint64_t> maxHoldNs{0};
+  std::atomic<uint64_t> waitHistogram[kHistogramBuckets] = {};
+  std::atomic<uint64_t> holdHistogram[kHistogramBuckets] = {};
+};
+
+struct HeldLock {
+  const void *lock;
+  std::chrono::steady_clock::time_point acquired;
+  int depth;
+};
+
+struct ThreadBuffer {
+  // The Reset() generation the counters belong to.
+  std::atomic<uint32_t> generation{0};
+  // Acquisitions of locks that didn't fit in the table.
+  std::atomic<uint64_t> dropped{0};
+  LockCounters locks[kMaxLocks];
+
+  // Only ever touched by the owner.
+  HeldLock held[kMaxHeld];
+  int heldCount = 0;
+};
+
+static std::atomic<bool> profilingEnabled{false};
+static std::atomic<uint32_t> currentGeneration{1};
+
+static std::mutex registryMutex;
+static std::vector<ThreadBuffer *> buffers;
+static std::vector<ThreadBuffer *> freeBuffers;
+static std::map<const void *, std::string> lockNames;
+
+struct BufferOwner {
+  ThreadBuffer *buffer = nullptr;
+
+  ~BufferOwner();
+};
+
+static thread_local BufferOwner owner;
+// Set once the thread's owner is destroyed, so locks taken by later
+// thread_local destructors don't make a new one.
+static thread_local bool threadExiting = false;
+
+BufferOwner::~BufferOwner() {
+  threadExiting = true;
+  if (buffer == nullptr) return;
+  buffer->heldCount = 0;
+  std::lock_guard<std::mutex> sync(registryMutex);
+  freeBuffers.push_back(buffer);
+}
+
+static ThreadBuffer *GetThreadBuffer() {
+  if (owner.buffer != nullptr || threadExiting) return owner.buffer;
+  std::lock_guard<std::mutex> sync(registryMutex);
+  if (!freeBuffers.empty()) {
+    owner.buffer = freeBuffers.back();
+    freeBuffers.pop_back();
+  } else {
+    owner.buffer = new ThreadBuffer();
+    buffers.push_back(owner.buffer);
+  }
+  return owner.buffer;
+}
+
+static void Add(std::atomic<uint64_t> &counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+static void Max(std::atomic<uint64_t> &counter, uint64_t value) {
+  if (value > counter.load(std::memory_order_relaxed))
+    counter.store(value, std::memory_order_relaxed);
+}
+
+static int Bucket(uint64_t ns) {
+  uint64_t us = ns / 1000;
+  int bucket = 0;
+  while (us != 0 && bucket < kHistogramBuckets - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+/**
+ * Clear the buffer if Reset() has been called since it last recorded.
+ */
+static void CheckGeneration(ThreadBuffer &buffer) {
+  uint32_t generation = currentGeneration.load(std::memory_order_acquire);
+  if (buffer.generation.load(std::memory_order_relaxed) == generation) return;
+  for (LockCounters &counters : buffer.locks) {
+    counters.lock.store(nullptr, std::memory_order_relaxed);
+    counters.acquisitions.store(0, std::memory_order_relaxed);
+    counters.contended.store(0, std::memory_order_relaxed);
+    counters.totalWaitNs.store(0, std::memory_order_relaxed);
+    counters.maxWaitNs.store(0, std::memory_order_relaxed);
+    counters.totalHoldNs.store(0, std::memory_order_relaxed);
+    counters.maxHoldNs.store(0, std::memory_order_relaxed);
+    for (auto &count : counters.waitHistogram)
+      count.store(0, std::memory_order_relaxed);
+    for (auto &count : counters.holdHistogram)
+      count.store(0, std::memory_order_relaxed);
+  }
+  buffer.dropped.store(0, std::memory_order_relaxed);
+  buffer.generation.store(generation, std::memory_order_release);
+}
+
+static LockCounters *FindCounters(ThreadBuffer &buffer, const void *lock) {
+  size_t start = (reinterpret_cast<uintptr_t>(lock) >> 3) & (kMaxLocks - 1);
+  for (int i = 0; i < kMaxLocks; i++) {
+    LockCounters &counters = buffer.locks[(start + i) & (kMaxLocks - 1)];
+    const void *slot = counters.lock.load(std::memory_order_relaxed);
+    if (slot == lock) return &counters;
+    if (slot == nullptr) {
+      // The counters are all zero, so readers may see the slot right away.
+      counters.lock.store(lock, std::memory_order_release);
+      return &counters;
+    }
+  }
+  return nullptr;
+}
+
+void SetEnabled(bool enabled) {
+  profilingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsEnabled() { return profilingEnabled.load(std::memory_order_relaxed); }
+
+void SetLockName(const void *lock, const char *name) {
+  std::lock_guard<std::mutex> sync(registryMutex);
+  lockNames[lock] = name;
+}
+
+void Reset() { currentGeneration.fetch_add(1, std::memory_order_acq_rel); }
+
+void RecordAcquire(const void *lock, bool contended, uint64_t waitNs) {
+  ThreadBuffer *buffer = GetThreadBuffer();
+  if (buffer == nullptr) return;
+
+  // A recursive mutex the thread already holds; only the outermost lock
+  // counts.
+  for (int i = buffer->heldCount - 1; i >= 0; i--) {
+    if (buffer->held[i].lock == lock) {
+      buffer->held[i].depth++;
+      return;
+    }
+  }
+
+  CheckGeneration(*buffer);
+  LockCounters *counters = FindCounters(*buffer, lock);
+  if (counters == nullptr) {
+    Add(buffer->dropped, 1);
+    return;
+  }
+  Add(counters->acquisitions, 1);
+  if (contended) {
+    Add(counters->contended, 1);
+    Add(counters->totalWaitNs, waitNs);
+    Max(counters->maxWaitNs, waitNs);
+    Add(counters->waitHistogram[Bucket(waitNs)], 1);
+  }
+
+  if (buffer->heldCount < kMaxHeld) {
+    buffer->held[buffer->heldCount++] = {lock, std::chrono::steady_clock::now(),
+                                         1};
+  }
+}
+
+void RecordRelease(const void *lock) {
+  ThreadBuffer *buffer = owner.buffer;
+  if (buffer == nullptr || buffer->heldCount == 0) return;
+
+  // Locks are usually released in the reverse order they were taken in, so
+  // look from the top.
+  int i = buffer->heldCount - 1;
+  while (i >= 0 && buffer->held[i].lock != lock) i--;
+  if (i < 0) return;
+  HeldLock &held = buffer->held[i];
+  if (--held.depth > 0) return;
+
+  uint64_t holdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - held.acquired)
+                        .count();
+  std::copy(buffer->held + i + 1, buffer->held + buffer->heldCount,
+            buffer->held + i);
+  buffer->heldCount--;
+
+  // Counted in the generation it was acquired in, unless a Reset() came in
+  // between.
+  if (buffer->generation.load(std::memory_order_relaxed) !=
+      currentGeneration.load(std::memory_order_relaxed))
+    return;
+  LockCounters *counters = FindCounters(*buffer, lock);
+  if (counters == nullptr) return;
+  Add(counters->totalHoldNs, holdNs);
+  Max(counters->maxHoldNs, holdNs);
+  Add(counters->holdHistogram[Bucket(holdNs)], 1);
+}
+
+/**
+ * The symbol a lock is, or is a member of, if it's a global or static that
+ * the dynamic linker can see.
+ */
+static std::string SymbolName(const void *lock) {
+  Dl_info info;
+  void *entry = nullptr;
+  if (dladdr1(lock, &info, &entry, RTLD_DL_SYMENT) == 0 ||
+      info.dli_sname == nullptr || entry == nullptr) {
+    return "";
+  }
+  const ElfW(Sym) *symbol = static_cast<const ElfW(Sym) *>(entry);
+  uintptr_t offset = reinterpret_cast<uintptr_t>(lock) -
+                     reinterpret_cast<uintptr_t>(info.dli_saddr);
+  // dladdr finds the closest symbol before the address, which may end before
+  // it.
+  if (offset >= symbol->st_size) return "";
+
+  int status = 0;
+  char *demangled =
+      abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+  std::string name = status == 0 ? demangled : info.dli_sname;
+  std::free(demangled);
+  if (offset != 0) name += "+" + std::to_string(offset);
+  return name;
+}
+
+std::vector<LockStats> GetStats() {
+  std::map<const void *, LockStats> merged;
+  uint32_t generation = currentGeneration.load(std::memory_order_acquire);
+
+  std::lock_guard<std::mutex> sync(registryMutex);
+  for (ThreadBuffer *buffer : buffers) {
+    if (buffer->generation.load(std::memory_order_acquire) != generation)
+      continue;
+    for (LockCounters &counters : buffer->locks) {
+      const void *lock = counters.lock.load(std::memory_order_acquire);
+      if (lock == nullptr) continue;
+      auto inserted = merged.emplace(lock, LockStats());
+      LockStats &stats = inserted.first->second;
+      if (inserted.second) stats.lock = lock;
+      stats.acquisitions += counters.acquisitions.load(std::memory_order_relaxed);
+      stats.contended += counters.contended.load(std::memory_order_relaxed);
+      stats.totalWaitNs += counters.totalWaitNs.load(std::memory_order_relaxed);
+      stats.maxWaitNs = std::max(
+          stats.maxWaitNs, counters.maxWaitNs.load(std::memory_order_relaxed));
+      stats.totalHoldNs += counters.totalHoldNs.load(std::memory_order_relaxed);
+      stats.maxHoldNs = std::max(
+          stats.maxHoldNs, counters.maxHoldNs.load(std::memory_order_relaxed));
+      for (int i = 0; i < kHistogramBuckets; i++) {
+        stats.waitHistogram[i] +=
+            counters.waitHistogram[i].load(std::memory_order_relaxed);
+        stats.holdHistogram[i] +=
+            counters.holdHistogram[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  std::vector<LockStats> result;
+  for (auto &entry : merged) {
+    LockStats &stats = entry.second;
+    auto name = lockNames.find(stats.lock);
+    if (name != lockNames.end()) {
+      stats.name = name->second;
+    } else {
+      stats.name = SymbolName(stats.lock);
+      if (stats.name.empty()) {
+        char address[32];
+        std::snprintf(address, sizeof(address), "%p", stats.lock);
+        stats.name = address;
+      }
+    }
+    result.push_back(stats);
+  }
+  std::sort(result.begin(), result.end(),
+            [](const LockStats &a, const LockStats &b) {
+              return a.totalWaitNs > b.totalWaitNs;
+            });
+  return result;
+}
+
+static std::string FormatHistogram(const uint64_t (&histogram)[kHistogramBuckets]) {
+  std::string result;
+  char bucket[64];
+  for (int i = 0; i < kHistogramBuckets; i++) {
+    if (histogram[i] == 0) continue;
+    if (i == 0) {
+      std::snprintf(bucket, sizeof(bucket), " <1us:%llu",
+                    (unsigned long long)histogram[i]);
+    } else if (i == kHistogramBuckets - 1) {
+      std::snprintf(bucket, sizeof(bucket), " >=%lluus:%llu",
+                    1ull << (i - 1), (unsigned long long)histogram[i]);
+    } else {
+      std::snprintf(bucket, sizeof(bucket), " %llu-%lluus:%llu",
+                    1ull << (i - 1), 1ull << i,
+                    (unsigned long long)histogram[i]);
+    }
+    result += bucket;
+  }
+  return result;
+}
+
+std::string FormatReport() {
+  std::vector<LockStats> stats = GetStats();
+  std::string report;
+  char line[512];
+  std::snprintf(line, sizeof(line), "%-40s %12s %10s %12s %12s %12s %12s\n",
+                "Lock", "Acquired", "Contended", "Avg wait us", "Max wait us",
+                "Avg hold us", "Max hold us");
+  report += line;
+  for (const LockStats &lock : stats) {
+    double acquisitions = lock.acquisitions == 0 ? 1 : lock.acquisitions;
+    double contended = lock.contended == 0 ? 1 : lock.contended;
+    std::snprintf(line, sizeof(line),
+                  "%-40s %12llu %9.2f%% %12.2f %12.2f %12.2f %12.2f\n",
+                  lock.name.c_str(), (unsigned long long)lock.acquisitions,
+                  100.0 * lock.contended / acquisitions,
+                  lock.totalWaitNs / contended / 1000.0,
+                  lock.maxWaitNs / 1000.0,
+                  lock.totalHoldNs / acquisitions / 1000.0,
+                  lock.maxHoldNs / 1000.0);
+    report += line;
+    if (lock.contended != 0)
+      report += "    waits:" + FormatHistogram(lock.waitHistogram) + "\n";
+    report += "    holds:" + FormatHistogram(lock.holdHistogram) + "\n";
+  }
+
+  uint64_t dropped = 0;
+  {
+    std::lock_guard<std::mutex> sync(registryMutex);
+    uint32_t generation = currentGeneration.load(std::memory_order_acquire);
+    for (ThreadBuffer *buffer : buffers) {
+      if (buffer->generation.load(std::memory_order_acquire) == generation)
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+  }
+  if (dropped != 0) {
+    std::snprintf(line, sizeof(line),
+                  "%llu acquisitions of locks past the first %d a thread "
+                  "took weren't recorded\n",
+                  (unsigned long long)dropped, kMaxLocks);
+    report += line;
+  }
+  return report;
+}
+
+}  // namespace mutex_profiler
+}  // namespace hal
+
+#endif  // FRC_MUTEX_PROFILING
@@ -0,0 +1,40 @@
+#include "HAL/cpp/priority_event.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t),
+              "futex words must be plain 32-bit integers");
+
+static long futex(std::atomic<int32_t> &word, int op, int32_t value,
+                  const struct timespec *timeout) {
+  return syscall(SYS_futex, reinterpret_cast<int32_t *>(&word), op, value,
+                 timeout, nullptr, 0);
+}
+
+bool priority_futex::wait(std::atomic<int32_t> &word, int32_t expected,
+                          const std::chrono::nanoseconds *timeout) {
+  struct timespec ts;
+  struct timespec *tsp = nullptr;
+  if (timeout != nullptr) {
+    ts.tv_sec = timeout->count() / 1000000000;
+    ts.tv_nsec = timeout->count() % 1000000000;
+    tsp = &ts;
+  }
+  // EAGAIN (the word already changed) and EINTR are both wakeups to the
+  // caller, which checks its condition again.
+  return futex(word, FUTEX_WAIT_PRIVATE, expected, tsp) == 0 ||
+         errno != ETIMEDOUT;
+}
+
+void priority_futex::wake(std::atomic<int32_t> &word, int32_t count) {
+  futex(word, FUTEX_WAKE_PRIVATE, count, nullptr);
+}
+
+void priority_futex::wake_all(std::atomic<int32_t> &word) {
+  futex(word, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+}
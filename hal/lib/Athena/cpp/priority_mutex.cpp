@@ -1,15 +1,57 @@
 #include "HAL/cpp/priority_mutex.h"
 
+#ifdef FRC_MUTEX_PROFILING
+#include <chrono>
+
+#include "HAL/cpp/mutex_profiler.h"
+
+/**
+ * Lock, timing the wait if the lock is taken.
+ */
+static void profiledLock(const void *lock, pthread_mutex_t *mutex) {
+  if (pthread_mutex_trylock(mutex) == 0) {
+    hal::mutex_profiler::RecordAcquire(lock, false, 0);
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  pthread_mutex_lock(mutex);
+  auto wait = std::chrono::steady_clock::now() - start;
+  hal::mutex_profiler::RecordAcquire(
+      lock, true,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count());
+}
+
+static bool profiledTryLock(const void *lock, pthread_mutex_t *mutex) {
+  if (pthread_mutex_trylock(mutex) != 0) return false;
+  if (hal::mutex_profiler::IsEnabled())
+    hal::mutex_profiler::RecordAcquire(lock, false, 0);
+  return true;
+}
+#endif
+
 void priority_recursive_mutex::lock() {
+#ifdef FRC_MUTEX_PROFILING
+  if (hal::mutex_profiler::IsEnabled()) {
+    profiledLock(this, &m_mutex);
+    return;
+  }
+#endif
   pthread_mutex_lock(&m_mutex);
 }
 
 void priority_recursive_mutex::unlock() {
+#ifdef FRC_MUTEX_PROFILING
+  hal::mutex_profiler::RecordRelease(this);
+#endif
   pthread_mutex_unlock(&m_mutex);
 }
 
 bool priority_recursive_mutex::try_lock() noexcept {
+#ifdef FRC_MUTEX_PROFILING
+  return profiledTryLock(this, &m_mutex);
+#else
   return !pthread_mutex_trylock(&m_mutex);
+#endif
 }
 
 pthread_mutex_t* priority_recursive_mutex::native_handle() {
@@ -17,15 +59,28 @@ pthread_mutex_t* priority_recursive_mutex::native_handle() {
 }
 
 void priority_mutex::lock() {
+#ifdef FRC_MUTEX_PROFILING
+  if (hal::mutex_profiler::IsEnabled()) {
+    profiledLock(this, &m_mutex);
+    return;
+  }
+#endif
   pthread_mutex_lock(&m_mutex);
 }
 
 void priority_mutex::unlock() {
+#ifdef FRC_MUTEX_PROFILING
+  hal::mutex_profiler::RecordRelease(this);
+#endif
   pthread_mutex_unlock(&m_mutex);
 }
 
 bool priority_mutex::try_lock() noexcept {
+#ifdef FRC_MUTEX_PROFILING
+  return profiledTryLock(this, &m_mutex);
+#else
   return !pthread_mutex_trylock(&m_mutex);
+#endif
 }
 
 pthread_mutex_t* priority_mutex::native_handle() {
@@ -0,0 +1,85 @@
+#include "HAL/Accelerometer.hpp"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <mutex>
+
+/*
+ * The built in accelerometer. Like the real one, it reads no more than the
+ * range it's set to.
+ */
+static std::mutex accelerometerMutex;
+static bool accelerometerActive = false;
+static AccelerometerRange accelerometerRange = kRange_2G;
+static double accelerations[3];
+
+static double readAxis(int axis) {
+	std::lock_guard<std::mutex> sync(accelerometerMutex);
+	double limit = 2 << accelerometerRange;
+	double value = accelerations[axis];
+	if (value > limit) return limit;
+	if (value < -limit) return -limit;
+	return value;
+}
+
+/**
+ * Set the accelerometer to active or standby mode.  It must be in standby
+ * mode to change any configuration.
+ */
+void setAccelerometerActive(bool active) {
+	std::lock_guard<std::mutex> sync(accelerometerMutex);
+	accelerometerActive = active;
+}
+
+/**
+ * Set the range of values that can be measured (either 2, 4, or 8 g-forces).
+ * The accelerometer should be in standby mode when this is called.
+ */
+void setAccelerometerRange(AccelerometerRange range) {
+	std::lock_guard<std::mutex> sync(accelerometerMutex);
+	accelerometerRange = range;
+}
+
+/**
+ * Get the x-axis acceleration
+ *
+ * This is a floating point value in units of 1 g-force
+ */
+double getAccelerometerX() {
+	return readAxis(0);
+}
+
+/**
+ * Get the y-axis acceleration
+ *
+ * This is a floating point value in units of 1 g-force
+ */
+double getAccelerometerY() {
+	return readAxis(1);
+}
+
+/**
+ * Get the z-axis acceleration
+ *
+ * This is a floating point value in units of 1 g-force
+ */
+double getAccelerometerZ() {
+	return readAxis(2);
+}
+
+void resetAccelerometer() {
+	std::lock_guard<std::mutex> sync(accelerometerMutex);
+	accelerations[0] = accelerations[1] = accelerations[2] = 0.0;
+}
+
+namespace hal {
+namespace desktop {
+
+void SetAccelerometer(double x, double y, double z) {
+	std::lock_guard<std::mutex> sync(accelerometerMutex);
+	accelerations[0] = x;
+	accelerations[1] = y;
+	accelerations[2] = z;
+}
+
+}  // namespace desktop
+}  // namespace hal
@@ -0,0 +1,836 @@
+
+#include "HAL/Analog.hpp"
+
+#include "HAL/cpp/priority_mutex.h"
+#include "HAL/Port.h"
+#include "HAL/HAL.hpp"
+#include "HAL/cpp/Resource.hpp"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <math.h>
+#include <vector>
+
+static const long kTimebase = 40000000; ///< 40 MHz clock
+static const long kDefaultOversampleBits = 0;
+static const long kDefaultAverageBits = 7;
+static const float kDefaultSampleRate = 50000.0;
+static const uint32_t kAnalogInputPins = 8;
+static const uint32_t kAnalogOutputPins = 2;
+static const uint32_t kAnalogTriggers = 8;
+
+static const uint32_t kAccumulatorNumChannels = 2;
+static const uint32_t kAccumulatorChannels[] = {0, 1};
+
+/*
+ * The calibration every channel gets, which makes the 12 bit converter span
+ * exactly 0V to 5V.
+ */
+static const uint32_t kLSBWeight = 1220703;
+static const int32_t kOffset = 0;
+static const int32_t kMaxValue = 0xFFF;
+
+/**
+ * An accumulator, which sums the averaged samples from its channel less the
+ * center. The desktop doesn't take samples; instead, whenever the accumulator
+ * is looked at or its input is about to change, it adds in all the samples
+ * there would have been since it was last brought up to date.
+ */
+struct Accumulator {
+  int64_t value;
+  uint32_t count;
+  int32_t center;
+  int32_t deadband;
+  uint64_t lastUpdate;
+  double partialSamples;
+};
+
+struct AnalogChannel {
+  int32_t value;
+  uint32_t averageBits;
+  uint32_t oversampleBits;
+  Accumulator *accumulator;
+};
+
+struct AnalogPort {
+  Port port;
+  Accumulator *accumulator;
+};
+
+bool analogSampleRateSet = false;
+priority_recursive_mutex analogRegisterWindowMutex;
+static float analogSampleRate = kDefaultSampleRate;
+static AnalogChannel analogChannels[kAnalogInputPins];
+static Accumulator analogAccumulators[kAccumulatorNumChannels];
+static uint16_t analogOutputs[kAnalogOutputPins];
+
+bool analogSystemInitialized = false;
+
+/**
+ * Initialize the analog System.
+ */
+void initializeAnalog(int32_t *status) {
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  if (analogSystemInitialized) return;
+  setAnalogSampleRate(kDefaultSampleRate, status);
+  analogSystemInitialized = true;
+}
+
+/**
+ * Initialize the analog input port using the given port object.
+ */
+void* initializeAnalogInputPort(void* port_pointer, int32_t *status) {
+  initializeAnalog(status);
+  Port* port = (Port*) port_pointer;
+
+  // Initialize port structure
+  AnalogPort* analog_port = new AnalogPort();
+  analog_port->port = *port;
+  analog_port->accumulator = NULL;
+  for (uint32_t i=0; i < kAccumulatorNumChannels; i++) {
+    if (port->pin == kAccumulatorChannels[i]) {
+      analog_port->accumulator = &analogAccumulators[i];
+    }
+  }
+
+  // Set default configuration
+  if (checkAnalogInputChannel(port->pin)) {
+    std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+    analogChannels[port->pin].accumulator = analog_port->accumulator;
+  }
+  setAnalogAverageBits(analog_port, kDefaultAverageBits, status);
+  setAnalogOversampleBits(analog_port, kDefaultOversampleBits, status);
+  return analog_port;
+}
+
+/**
+ * Initialize the analog output port using the given port object.
+ */
+void* initializeAnalogOutputPort(void* port_pointer, int32_t *status) {
+  initializeAnalog(status);
+  Port* port = (Port*) port_pointer;
+
+  // Initialize port structure
+  AnalogPort* analog_port = new AnalogPort();
+  analog_port->port = *port;
+  analog_port->accumulator = NULL;
+  return analog_port;
+}
+
+
+/**
+ * Check that the analog module number is valid.
+ *
+ * @return Analog module is valid and present
+ */
+bool checkAnalogModule(uint8_t module) {
+  return module == 1;
+}
+
+/**
+ * Check that the analog output channel number is value.
+ * Verify that the analog channel number is one of the legal channel numbers. Channel numbers
+ * are 0-based.
+ *
+ * @return Analog channel is valid
+ */
+bool checkAnalogInputChannel(uint32_t pin) {
+  if (pin < kAnalogInputPins)
+    return true;
+  return false;
+}
+
+/**
+ * Check that the analog output channel number is value.
+ * Verify that the analog channel number is one of the legal channel numbers. Channel numbers
+ * are 0-based.
+ *
+ * @return Analog channel is valid
+ */
+bool checkAnalogOutputChannel(uint32_t pin) {
+  if (pin < kAnalogOutputPins)
+    return true;
+  return false;
+}
+
+void setAnalogOutput(void* analog_port_pointer, double voltage, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogOutputChannel(port->port.pin)) return;
+
+  uint16_t rawValue = (uint16_t)(voltage / 5.0 * 0x1000);
+
+  if(voltage < 0.0) rawValue = 0;
+  else if(voltage > 5.0) rawValue = 0x1000;
+
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  analogOutputs[port->port.pin] = rawValue;
+}
+
+double getAnalogOutput(void* analog_port_pointer, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogOutputChannel(port->port.pin)) return 0.0;
+
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  uint16_t rawValue = analogOutputs[port->port.pin];
+
+  return rawValue * 5.0 / 0x1000;
+}
+
+/**
+ * Bring an accumulator up to date with the samples that have been taken of
+ * its channel since it last was. Must be called with
+ * analogRegisterWindowMutex held, and before the channel's value or
+ * configuration changes.
+ */
+static void integrateAccumulator(AnalogChannel &channel) {
+  Accumulator *accumulator = channel.accumulator;
+  if (accumulator == NULL) return;
+  uint64_t now = desktopTime();
+  if (now <= accumulator->lastUpdate) {
+    // Includes the clock being set back, when there's nothing to add up.
+    accumulator->lastUpdate = now;
+    return;
+  }
+
+  // The accumulator sees one value per average, made of 2**(average +
+  // oversample) samples.
+  double valuesPerSecond = analogSampleRate / (double)(1 << (channel.averageBits + channel.oversampleBits));
+  double values = (now - accumulator->lastUpdate) * 1.0e-6 * valuesPerSecond + accumulator->partialSamples;
+  uint32_t wholeValues = (uint32_t)values;
+  accumulator->partialSamples = values - wholeValues;
+  accumulator->lastUpdate = now;
+
+  int32_t sample = (channel.value << channel.oversampleBits) - accumulator->center;
+  if (sample < accumulator->deadband && sample > -accumulator->deadband) sample = 0;
+  accumulator->value += (int64_t)sample * wholeValues;
+  accumulator->count += wholeValues;
+}
+
+/**
+ * Set the sample rate.
+ *
+ * This is a global setting for the Athena and effects all channels.
+ *
+ * @param samplesPerSecond The number of samples per channel per second.
+ */
+void setAnalogSampleRate(double samplesPerSecond, int32_t *status) {
+  analogSampleRateSet = true;
+
+  // Compute the convert rate, just to know if it's too fast for the FPGA
+  uint32_t ticksPerSample = (uint32_t)((float)kTimebase / samplesPerSecond);
+  uint32_t ticksPerConversion = ticksPerSample / kAnalogInputPins;
+  // ticksPerConversion must be at least 80
+  if (ticksPerConversion < 80) {
+    if ((*status) >= 0) *status = SAMPLE_RATE_TOO_HIGH;
+    ticksPerConversion = 80;
+  }
+
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  for (AnalogChannel &channel : analogChannels) integrateAccumulator(channel);
+  analogSampleRate = (float)kTimebase / (float)(ticksPerConversion * kAnalogInputPins);
+}
+
+/**
+ * Get the current sample rate.
+ *
+ * This assumes one entry in the scan list.
+ * This is a global setting for the Athena and effects all channels.
+ *
+ * @return Sample rate.
+ */
+float getAnalogSampleRate(int32_t *status) {
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  return analogSampleRate;
+}
+
+/**
+ * Set the number of averaging bits.
+ *
+ * This sets the number of averaging bits. The actual number of averaged samples is 2**bits.
+ * Use averaging to improve the stability of your measurement at the expense of sampling rate.
+ *
+ * @param analog_port_pointer Pointer to the analog port to configure.
+ * @param bits Number of bits to average.
+ */
+void setAnalogAverageBits(void* analog_port_pointer, uint32_t bits, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogInputChannel(port->port.pin)) return;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  AnalogChannel &channel = analogChannels[port->port.pin];
+  integrateAccumulator(channel);
+  channel.averageBits = bits;
+}
+
+/**
+ * Get the number of averaging bits.
+ *
+ * The actual number of averaged samples is 2**bits.
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return Bits to average.
+ */
+uint32_t getAnalogAverageBits(void* analog_port_pointer, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogInputChannel(port->port.pin)) return 0;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  return analogChannels[port->port.pin].averageBits;
+}
+
+/**
+ * Set the number of oversample bits.
+ *
+ * This sets the number of oversample bits. The actual number of oversampled values is 2**bits.
+ * Use oversampling to improve the resolution of your measurements at the expense of sampling rate.
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @param bits Number of bits to oversample.
+ */
+void setAnalogOversampleBits(void* analog_port_pointer, uint32_t bits, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogInputChannel(port->port.pin)) return;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  AnalogChannel &channel = analogChannels[port->port.pin];
+  integrateAccumulator(channel);
+  channel.oversampleBits = bits;
+}
+
+
+/**
+ * Get the number of oversample bits.
+ *
+ * The actual number of oversampled values is 2**bits.
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return Bits to oversample.
+ */
+uint32_t getAnalogOversampleBits(void* analog_port_pointer, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogInputChannel(port->port.pin)) return 0;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  return analogChannels[port->port.pin].oversampleBits;
+}
+
+/**
+ * Get a sample straight from the channel on this module.
+ *
+ * The sample is a 12-bit value representing the 0V to 5V range of the A/D converter in the module.
+ * The units are in A/D converter codes.  Use GetVoltage() to get the analog value in calibrated units.
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return A sample straight from the channel on this module.
+ */
+int16_t getAnalogValue(void* analog_port_pointer, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogInputChannel(port->port.pin)) return 0;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  return (int16_t) analogChannels[port->port.pin].value;
+}
+
+/**
+ * Get a sample from the output of the oversample and average engine for the channel.
+ *
+ * The sample is 12-bit + the value configured in SetOversampleBits(). The
+ * input only changes when a test sets it, so the average of the samples is
+ * always the sample itself.
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return A sample from the oversample and average engine for the channel.
+ */
+int32_t getAnalogAverageValue(void* analog_port_pointer, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (!checkAnalogInputChannel(port->port.pin)) return 0;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  const AnalogChannel &channel = analogChannels[port->port.pin];
+  return channel.value << channel.oversampleBits;
+}
+
+/**
+ * Get a scaled sample straight from the channel on this module.
+ *
+ * The value is scaled to units of Volts using the calibrated scaling data from GetLSBWeight() and GetOffset().
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return A scaled sample straight from the channel on this module.
+ */
+float getAnalogVoltage(void* analog_port_pointer, int32_t *status) {
+  int16_t value = getAnalogValue(analog_port_pointer, status);
+  uint32_t LSBWeight = getAnalogLSBWeight(analog_port_pointer, status);
+  int32_t offset = getAnalogOffset(analog_port_pointer, status);
+  float voltage = LSBWeight * 1.0e-9 * value - offset * 1.0e-9;
+  return voltage;
+}
+
+/**
+ * Get a scaled sample from the output of the oversample and average engine for the channel.
+ *
+ * The value is scaled to units of Volts using the calibrated scaling data from GetLSBWeight() and GetOffset().
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return A scaled sample from the output of the oversample and average engine for the channel.
+ */
+float getAnalogAverageVoltage(void* analog_port_pointer, int32_t *status) {
+  int32_t value = getAnalogAverageValue(analog_port_pointer, status);
+  uint32_t LSBWeight = getAnalogLSBWeight(analog_port_pointer, status);
+  int32_t offset = getAnalogOffset(analog_port_pointer, status);
+  uint32_t oversampleBits = getAnalogOversampleBits(analog_port_pointer, status);
+  float voltage = ((LSBWeight * 1.0e-9 * value) / (float)(1 << oversampleBits)) - offset * 1.0e-9;
+  return voltage;
+}
+
+/**
+ * Convert a voltage to a raw value for a specified channel.
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @param voltage The voltage to convert.
+ * @return The raw value for the channel.
+ */
+int32_t getAnalogVoltsToValue(void* analog_port_pointer, double voltage, int32_t *status) {
+  if (voltage > 5.0) {
+    voltage = 5.0;
+    *status = VOLTAGE_OUT_OF_RANGE;
+  }
+  if (voltage < 0.0) {
+    voltage = 0.0;
+    *status = VOLTAGE_OUT_OF_RANGE;
+  }
+  uint32_t LSBWeight = getAnalogLSBWeight(analog_port_pointer, status);
+  int32_t offset = getAnalogOffset(analog_port_pointer, status);
+  int32_t value = (int32_t) ((voltage + offset * 1.0e-9) / (LSBWeight * 1.0e-9));
+  return value;
+}
+
+/**
+ * Get the scaling least significant bit weight constant.
+ *
+ * Volts = ((LSB_Weight * 1e-9) * raw) - (Offset * 1e-9)
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return Least significant bit weight.
+ */
+uint32_t getAnalogLSBWeight(void* analog_port_pointer, int32_t *status) {
+  return kLSBWeight;
+}
+
+/**
+ * Get the scaling offset constant.
+ *
+ * Volts = ((LSB_Weight * 1e-9) * raw) - (Offset * 1e-9)
+ *
+ * @param analog_port_pointer Pointer to the analog port to use.
+ * @return Offset constant.
+ */
+int32_t getAnalogOffset(void* analog_port_pointer, int32_t *status) {
+  return kOffset;
+}
+
+//// Accumulator Stuff
+
+/**
+ * Is the channel attached to an accumulator.
+ *
+ * @return The analog channel is attached to an accumulator.
+ */
+bool isAccumulatorChannel(void* analog_port_pointer, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  for (uint32_t i=0; i < kAccumulatorNumChannels; i++) {
+    if (port->port.pin == kAccumulatorChannels[i]) return true;
+  }
+  return false;
+}
+
+/**
+ * Initialize the accumulator.
+ */
+void initAccumulator(void* analog_port_pointer, int32_t *status) {
+  setAccumulatorCenter(analog_port_pointer, 0, status);
+  resetAccumulator(analog_port_pointer, status);
+}
+
+/**
+ * Resets the accumulator to the initial value.
+ */
+void resetAccumulator(void* analog_port_pointer, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (port->accumulator == NULL) {
+    *status = NULL_PARAMETER;
+    return;
+  }
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  port->accumulator->value = 0;
+  port->accumulator->count = 0;
+  port->accumulator->lastUpdate = desktopTime();
+  port->accumulator->partialSamples = 0;
+}
+
+/**
+ * Set the center value of the accumulator.
+ *
+ * The center value is subtracted from each A/D value before it is added to the accumulator. This
+ * is used for the center value of devices like gyros and accelerometers to make integration work
+ * and to take the device offset into account when integrating.
+ *
+ * This center value is based on the output of the oversampled and averaged source from channel 1.
+ * Because of this, any non-zero oversample bits will affect the size of the value for this field.
+ */
+void setAccumulatorCenter(void* analog_port_pointer, int32_t center, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (port->accumulator == NULL) {
+    *status = NULL_PARAMETER;
+    return;
+  }
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  integrateAccumulator(analogChannels[port->port.pin]);
+  port->accumulator->center = center;
+}
+
+/**
+ * Set the accumulator's deadband.
+ */
+void setAccumulatorDeadband(void* analog_port_pointer, int32_t deadband, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (port->accumulator == NULL) {
+    *status = NULL_PARAMETER;
+    return;
+  }
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  integrateAccumulator(analogChannels[port->port.pin]);
+  port->accumulator->deadband = deadband;
+}
+
+/**
+ * Read the accumulated value.
+ *
+ * The accumulator is attached after the oversample and average engine.
+ *
+ * @return The 64-bit value accumulated since the last Reset().
+ */
+int64_t getAccumulatorValue(void* analog_port_pointer, int32_t *status) {
+  int64_t value = 0;
+  uint32_t count = 0;
+  getAccumulatorOutput(analog_port_pointer, &value, &count, status);
+  return value;
+}
+
+/**
+ * Read the number of accumulated values.
+ *
+ * Read the count of the accumulated values since the accumulator was last Reset().
+ *
+ * @return The number of times samples from the channel were accumulated.
+ */
+uint32_t getAccumulatorCount(void* analog_port_pointer, int32_t *status) {
+  int64_t value = 0;
+  uint32_t count = 0;
+  getAccumulatorOutput(analog_port_pointer, &value, &count, status);
+  return count;
+}
+
+/**
+ * Read the accumulated value and the number of accumulated values atomically.
+ *
+ * This can be used for averaging.
+ *
+ * @param value Pointer to the 64-bit accumulated output.
+ * @param count Pointer to the number of accumulation cycles.
+ */
+void getAccumulatorOutput(void* analog_port_pointer, int64_t *value, uint32_t *count, int32_t *status) {
+  AnalogPort* port = (AnalogPort*) analog_port_pointer;
+  if (port->accumulator == NULL) {
+    *status = NULL_PARAMETER;
+    return;
+  }
+  if (value == NULL || count == NULL) {
+    *status = NULL_PARAMETER;
+    return;
+  }
+
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  integrateAccumulator(analogChannels[port->port.pin]);
+  *value = port->accumulator->value;
+  *count = port->accumulator->count;
+}
+
+
+struct trigger_t {
+  AnalogPort* port;
+  uint32_t index;
+  int32_t lower;
+  int32_t upper;
+  bool averaged;
+  bool filtered;
+  bool inWindow;
+  bool overLimit;
+};
+typedef struct trigger_t AnalogTrigger;
+
+static hal::Resource *triggers = NULL;
+static AnalogTrigger* triggerSlots[kAnalogTriggers];
+
+/** An analog trigger output changing, to be passed on once the lock is released. */
+struct TriggerEdge {
+  uint32_t pin;
+  bool value;
+};
+
+/**
+ * Work out a trigger's outputs again, noting the ones that changed. Must be
+ * called with analogRegisterWindowMutex held.
+ */
+static void updateTrigger(AnalogTrigger *trigger, std::vector<TriggerEdge> &edges) {
+  if (!checkAnalogInputChannel(trigger->port->port.pin)) return;
+  const AnalogChannel &channel = analogChannels[trigger->port->port.pin];
+  int32_t value = trigger->averaged ? channel.value << channel.oversampleBits : channel.value;
+
+  bool inWindow = value >= trigger->lower && value <= trigger->upper;
+  bool overLimit = trigger->overLimit;
+  if (value > trigger->upper) overLimit = true;
+  else if (value < trigger->lower) overLimit = false;
+
+  if (inWindow != trigger->inWindow) {
+    edges.push_back({(trigger->index << 2) + kInWindow, inWindow});
+  }
+  if (overLimit != trigger->overLimit) {
+    edges.push_back({(trigger->index << 2) + kState, overLimit});
+  }
+  trigger->inWindow = inWindow;
+  trigger->overLimit = overLimit;
+}
+
+/**
+ * Tell whatever's routed to analog trigger outputs that they changed. This
+ * has to be done without analogRegisterWindowMutex held, since counters look
+ * at the triggers with their own lock held.
+ */
+static void sendTriggerEdges(const std::vector<TriggerEdge> &edges) {
+  for (const TriggerEdge &edge : edges) {
+    digitalSourceChanged(edge.pin, true, edge.value);
+  }
+}
+
+void* initializeAnalogTrigger(void* port_pointer, uint32_t *index, int32_t *status) {
+  Port* port = (Port*) port_pointer;
+  hal::Resource::CreateResourceObject(&triggers, kAnalogTriggers);
+
+  uint32_t triggerIndex = triggers->Allocate("Analog Trigger");
+  if (triggerIndex == ~0u) {
+    *status = NO_AVAILABLE_RESOURCES;
+    return NULL;
+  }
+
+  AnalogTrigger* trigger = new AnalogTrigger();
+  trigger->port = (AnalogPort*) initializeAnalogInputPort(port, status);
+  trigger->index = triggerIndex;
+  *index = trigger->index;
+
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  triggerSlots[trigger->index] = trigger;
+  return trigger;
+}
+
+void cleanAnalogTrigger(void* analog_trigger_pointer, int32_t *status) {
+  AnalogTrigger* trigger = (AnalogTrigger*) analog_trigger_pointer;
+  {
+    std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+    triggerSlots[trigger->index] = NULL;
+  }
+  triggers->Free(trigger->index);
+  delete trigger->port;
+  delete trigger;
+}
+
+void setAnalogTriggerLimitsRaw(void* analog_trigger_pointer, int32_t lower, int32_t upper, int32_t *status) {
+  AnalogTrigger* trigger = (AnalogTrigger*) analog_trigger_pointer;
+  if (lower > upper) {
+	*status = ANALOG_TRIGGER_LIMIT_ORDER_ERROR;
+  }
+  std::vector<TriggerEdge> edges;
+  {
+    std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+    trigger->lower = lower;
+    trigger->upper = upper;
+    updateTrigger(trigger, edges);
+  }
+  sendTriggerEdges(edges);
+}
+
+/**
+ * Set the upper and lower limits of the analog trigger.
+ * The limits are given as floating point voltage values.
+ */
+void setAnalogTriggerLimitsVoltage(void* analog_trigger_pointer, double lower, double upper, int32_t *status) {
+  AnalogTrigger* trigger = (AnalogTrigger*) analog_trigger_pointer;
+  if (lower > upper) {
+	*status = ANALOG_TRIGGER_LIMIT_ORDER_ERROR;
+  }
+  // TODO: This depends on the averaged setting.  Only raw values will work as is.
+  int32_t lowerValue = getAnalogVoltsToValue(trigger->port, lower, status);
+  int32_t upperValue = getAnalogVoltsToValue(trigger->port, upper, status);
+  int32_t limitStatus = 0;
+  setAnalogTriggerLimitsRaw(trigger, lowerValue, upperValue, &limitStatus);
+}
+
+/**
+ * Configure the analog trigger to use the averaged vs. raw values.
+ * If the value is true, then the averaged value is selected for the analog trigger, otherwise
+ * the immediate value is used.
+ */
+void setAnalogTriggerAveraged(void* analog_trigger_pointer, bool useAveragedValue, int32_t *status) {
+  AnalogTrigger* trigger = (AnalogTrigger*) analog_trigger_pointer;
+  std::vector<TriggerEdge> edges;
+  {
+    std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+    if (trigger->filtered) {
+      *status = INCOMPATIBLE_STATE;
+    }
+    trigger->averaged = useAveragedValue;
+    updateTrigger(trigger, edges);
+  }
+  sendTriggerEdges(edges);
+}
+
+/**
+ * Configure the analog trigger to use a filtered value.
+ * The desktop input has no noise to filter, so this only records the setting.
+ */
+void setAnalogTriggerFiltered(void* analog_trigger_pointer, bool useFilteredValue, int32_t *status) {
+  AnalogTrigger* trigger = (AnalogTrigger*) analog_trigger_pointer;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  if (trigger->averaged) {
+	*status = INCOMPATIBLE_STATE;
+  }
+  trigger->filtered = useFilteredValue;
+}
+
+/**
+ * Return the InWindow output of the analog trigger.
+ * True if the analog input is between the upper and lower limits.
+ * @return The InWindow output of the analog trigger.
+ */
+bool getAnalogTriggerInWindow(void* analog_trigger_pointer, int32_t *status) {
+  return getAnalogTriggerOutput(analog_trigger_pointer, kInWindow, status);
+}
+
+/**
+ * Return the TriggerState output of the analog trigger.
+ * True if above upper limit.
+ * False if below lower limit.
+ * If in Hysteresis, maintain previous state.
+ * @return The TriggerState output of the analog trigger.
+ */
+bool getAnalogTriggerTriggerState(void* analog_trigger_pointer, int32_t *status) {
+  return getAnalogTriggerOutput(analog_trigger_pointer, kState, status);
+}
+
+/**
+ * Get the state of the analog trigger output.
+ * @return The state of the analog trigger output.
+ */
+bool getAnalogTriggerOutput(void* analog_trigger_pointer, AnalogTriggerType type, int32_t *status) {
+  AnalogTrigger* trigger = (AnalogTrigger*) analog_trigger_pointer;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  switch(type) {
+  case kInWindow:
+	return trigger->inWindow;
+  case kState:
+	return trigger->overLimit;
+  case kRisingPulse:
+  case kFallingPulse:
+	*status = ANALOG_TRIGGER_PULSE_OUTPUT_ERROR;
+	return false;
+  }
+  return false;
+}
+
+bool getAnalogTriggerLevel(uint32_t pin) {
+  uint32_t index = pin >> 2;
+  if (index >= kAnalogTriggers) return false;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  AnalogTrigger* trigger = triggerSlots[index];
+  if (trigger == NULL) return false;
+  switch (pin & 3) {
+  case kInWindow:
+	return trigger->inWindow;
+  case kState:
+	return trigger->overLimit;
+  default:
+	return false;
+  }
+}
+
+void resetAnalog() {
+  std::vector<TriggerEdge> edges;
+  {
+    std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+    for (AnalogChannel &channel : analogChannels) channel.value = 0;
+    for (Accumulator &accumulator : analogAccumulators) {
+      accumulator.value = 0;
+      accumulator.count = 0;
+      accumulator.lastUpdate = 0;
+      accumulator.partialSamples = 0;
+    }
+    for (uint16_t &output : analogOutputs) output = 0;
+    for (AnalogTrigger *trigger : triggerSlots) {
+      if (trigger != NULL) updateTrigger(trigger, edges);
+    }
+  }
+  sendTriggerEdges(edges);
+}
+
+namespace hal {
+namespace desktop {
+
+void SetAnalogInput(uint32_t channel, double voltage) {
+  if (!checkAnalogInputChannel(channel)) return;
+  int32_t value = (int32_t)lround((voltage + kOffset * 1.0e-9) / (kLSBWeight * 1.0e-9));
+  if (value < 0) value = 0;
+  if (value > kMaxValue) value = kMaxValue;
+
+  std::vector<TriggerEdge> edges;
+  {
+    std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+    integrateAccumulator(analogChannels[channel]);
+    analogChannels[channel].value = value;
+    for (AnalogTrigger *trigger : triggerSlots) {
+      if (trigger != NULL && trigger->port->port.pin == channel) {
+        updateTrigger(trigger, edges);
+      }
+    }
+  }
+  sendTriggerEdges(edges);
+}
+
+double GetAnalogOutput(uint32_t channel) {
+  if (!checkAnalogOutputChannel(channel)) return 0.0;
+  std::lock_guard<priority_recursive_mutex> sync(analogRegisterWindowMutex);
+  return analogOutputs[channel] * 5.0 / 0x1000;
+}
+
+}  // namespace desktop
+}  // namespace hal
+
+//// Float JNA Hack
+// Float
+int getAnalogSampleRateIntHack(int32_t *status) {
+  return floatToInt(getAnalogSampleRate(status));
+}
+
+int getAnalogVoltageIntHack(void* analog_port_pointer, int32_t *status) {
+  return floatToInt(getAnalogVoltage(analog_port_pointer, status));
+}
+
+int getAnalogAverageVoltageIntHack(void* analog_port_pointer, int32_t *status) {
+  return floatToInt(getAnalogAverageVoltage(analog_port_pointer, status));
+}
+
+
+// Doubles
+void setAnalogSampleRateIntHack(int samplesPerSecond, int32_t *status) {
+  setAnalogSampleRate(intToFloat(samplesPerSecond), status);
+}
+
+int32_t getAnalogVoltsToValueIntHack(void* analog_port_pointer, int voltage, int32_t *status) {
+  return getAnalogVoltsToValue(analog_port_pointer, intToFloat(voltage), status);
+}
+
+void setAnalogTriggerLimitsVoltageIntHack(void* analog_trigger_pointer, int lower, int upper, int32_t *status) {
+  setAnalogTriggerLimitsVoltage(analog_trigger_pointer, intToFloat(lower), intToFloat(upper), status);
+}
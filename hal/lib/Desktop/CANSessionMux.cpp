@@ -0,0 +1,158 @@
+/*
+ * The CAN bus, at the level of frames. The CTRE classes built into the HAL
+ * (CANTalon's CanTalonSRX, among others) talk to their devices through these
+ * functions, so a test can play the part of a device by reading what was
+ * sent to it and receiving the frames it would send back.
+ */
+#include "FRC_NetworkCommunication/CANSessionMux.h"
+
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string.h>
+
+struct SentFrame {
+	uint8_t data[8];
+	uint8_t dataSize;
+	int32_t periodMs;
+};
+
+struct StreamSession {
+	uint32_t messageID;
+	uint32_t messageIDMask;
+	uint32_t maxMessages;
+	std::deque<tCANStreamMessage> messages;
+};
+
+static std::mutex canMutex;
+static std::map<uint32_t, SentFrame> sentFrames;
+static std::map<uint32_t, tCANStreamMessage> receivedFrames;
+static std::map<uint32_t, StreamSession> streamSessions;
+static uint32_t nextSessionHandle = 1;
+
+static uint32_t canTimeStamp() {
+	return (uint32_t)(desktopTime() / 1000);
+}
+
+void FRC_NetworkCommunication_CANSessionMux_sendMessage(uint32_t messageID, const uint8_t *data, uint8_t dataSize, int32_t periodMs, int32_t *status) {
+	if (dataSize > 8 || (data == nullptr && dataSize > 0)) {
+		*status = ERR_CANSessionMux_InvalidBuffer;
+		return;
+	}
+	std::lock_guard<std::mutex> sync(canMutex);
+	SentFrame &frame = sentFrames[messageID];
+	if (periodMs == CAN_SEND_PERIOD_STOP_REPEATING) {
+		// Only stops the repeats; what was last sent stays visible.
+		frame.periodMs = periodMs;
+		return;
+	}
+	if (dataSize > 0) memcpy(frame.data, data, dataSize);
+	frame.dataSize = dataSize;
+	frame.periodMs = periodMs;
+}
+
+/**
+ * Get the latest frame received with an ID matching messageID under the
+ * mask. Frames stay until a newer one with the same ID replaces them, as if
+ * their device were sending them periodically.
+ */
+void FRC_NetworkCommunication_CANSessionMux_receiveMessage(uint32_t *messageID, uint32_t messageIDMask, uint8_t *data, uint8_t *dataSize, uint32_t *timeStamp, int32_t *status) {
+	if (messageID == nullptr || data == nullptr || dataSize == nullptr || timeStamp == nullptr) {
+		*status = ERR_CANSessionMux_InvalidBuffer;
+		return;
+	}
+	std::lock_guard<std::mutex> sync(canMutex);
+	for (auto &received : receivedFrames) {
+		const tCANStreamMessage &frame = received.second;
+		if ((frame.messageID & messageIDMask) != (*messageID & messageIDMask)) continue;
+		*messageID = frame.messageID;
+		memcpy(data, frame.data, frame.dataSize);
+		*dataSize = frame.dataSize;
+		*timeStamp = frame.timeStamp;
+		return;
+	}
+	*status = ERR_CANSessionMux_MessageNotFound;
+}
+
+void FRC_NetworkCommunication_CANSessionMux_openStreamSession(uint32_t *sessionHandle, uint32_t messageID, uint32_t messageIDMask, uint32_t maxMessages, int32_t *status) {
+	std::lock_guard<std::mutex> sync(canMutex);
+	*sessionHandle = nextSessionHandle++;
+	StreamSession &session = streamSessions[*sessionHandle];
+	session.messageID = messageID;
+	session.messageIDMask = messageIDMask;
+	session.maxMessages = maxMessages;
+}
+
+void FRC_NetworkCommunication_CANSessionMux_closeStreamSession(uint32_t sessionHandle) {
+	std::lock_guard<std::mutex> sync(canMutex);
+	streamSessions.erase(sessionHandle);
+}
+
+void FRC_NetworkCommunication_CANSessionMux_readStreamSession(uint32_t sessionHandle, struct tCANStreamMessage *messages, uint32_t messagesToRead, uint32_t *messagesRead, int32_t *status) {
+	std::lock_guard<std::mutex> sync(canMutex);
+	*messagesRead = 0;
+	auto session = streamSessions.find(sessionHandle);
+	if (session == streamSessions.end()) {
+		*status = ERR_CANSessionMux_NotAllowed;
+		return;
+	}
+	std::deque<tCANStreamMessage> &queued = session->second.messages;
+	while (*messagesRead < messagesToRead && !queued.empty()) {
+		messages[(*messagesRead)++] = queued.front();
+		queued.pop_front();
+	}
+}
+
+void FRC_NetworkCommunication_CANSessionMux_getCANStatus(float *percentBusUtilization, uint32_t *busOffCount, uint32_t *txFullCount, uint32_t *receiveErrorCount, uint32_t *transmitErrorCount, int32_t *status) {
+	*percentBusUtilization = 0;
+	*busOffCount = 0;
+	*txFullCount = 0;
+	*receiveErrorCount = 0;
+	*transmitErrorCount = 0;
+}
+
+void resetCAN() {
+	std::lock_guard<std::mutex> sync(canMutex);
+	sentFrames.clear();
+	receivedFrames.clear();
+	for (auto &session : streamSessions) session.second.messages.clear();
+}
+
+namespace hal {
+namespace desktop {
+
+void ReceiveCANFrame(uint32_t messageID, const uint8_t *data, uint8_t dataSize) {
+	if (dataSize > 8) return;
+	tCANStreamMessage frame;
+	frame.messageID = messageID;
+	frame.timeStamp = canTimeStamp();
+	memset(frame.data, 0, sizeof(frame.data));
+	if (dataSize > 0) memcpy(frame.data, data, dataSize);
+	frame.dataSize = dataSize;
+
+	std::lock_guard<std::mutex> sync(canMutex);
+	receivedFrames[messageID] = frame;
+	for (auto &entry : streamSessions) {
+		StreamSession &session = entry.second;
+		if ((messageID & session.messageIDMask) != (session.messageID & session.messageIDMask)) continue;
+		// Like the real session, a full one loses its oldest messages.
+		if (session.messages.size() >= session.maxMessages) session.messages.pop_front();
+		session.messages.push_back(frame);
+	}
+}
+
+bool GetSentCANFrame(uint32_t messageID, uint8_t *data, uint8_t *dataSize,
+                     int32_t *periodMs) {
+	std::lock_guard<std::mutex> sync(canMutex);
+	auto sent = sentFrames.find(messageID);
+	if (sent == sentFrames.end()) return false;
+	memcpy(data, sent->second.data, sent->second.dataSize);
+	*dataSize = sent->second.dataSize;
+	*periodMs = sent->second.periodMs;
+	return true;
+}
+
+}  // namespace desktop
+}  // namespace hal
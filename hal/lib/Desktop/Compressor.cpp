@@ -0,0 +1,74 @@
+#include "HAL/Compressor.hpp"
+#include "DesktopInternal.hpp"
+
+extern void initializePCM(int module);
+
+void *initializeCompressor(uint8_t module) {
+	initializePCM(module);
+
+	return &pneumaticsModules[module];
+}
+
+bool checkCompressorModule(uint8_t module) {
+	return module < kNumPneumaticsModules;
+}
+
+/**
+ * Whether the compressor is running, which under closed loop control is
+ * whenever the pressure switch says the tanks aren't full.
+ */
+bool getCompressor(void *pcm_pointer, int32_t *status) {
+	PneumaticsModule *module = (PneumaticsModule *)pcm_pointer;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	return module->closedLoopControl && !module->pressureSwitch;
+}
+
+
+void setClosedLoopControl(void *pcm_pointer, bool value, int32_t *status) {
+	PneumaticsModule *module = (PneumaticsModule *)pcm_pointer;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	module->closedLoopControl = value;
+}
+
+
+bool getClosedLoopControl(void *pcm_pointer, int32_t *status) {
+	PneumaticsModule *module = (PneumaticsModule *)pcm_pointer;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	return module->closedLoopControl;
+}
+
+
+bool getPressureSwitch(void *pcm_pointer, int32_t *status) {
+	PneumaticsModule *module = (PneumaticsModule *)pcm_pointer;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	return module->pressureSwitch;
+}
+
+
+float getCompressorCurrent(void *pcm_pointer, int32_t *status) {
+	PneumaticsModule *module = (PneumaticsModule *)pcm_pointer;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	return module->compressorCurrent;
+}
+
+// The compressor never faults on the desktop.
+bool getCompressorCurrentTooHighFault(void *pcm_pointer, int32_t *status) {
+	return false;
+}
+bool getCompressorCurrentTooHighStickyFault(void *pcm_pointer, int32_t *status) {
+	return false;
+}
+bool getCompressorShortedStickyFault(void *pcm_pointer, int32_t *status) {
+	return false;
+}
+bool getCompressorShortedFault(void *pcm_pointer, int32_t *status) {
+	return false;
+}
+bool getCompressorNotConnectedStickyFault(void *pcm_pointer, int32_t *status) {
+	return false;
+}
+bool getCompressorNotConnectedFault(void *pcm_pointer, int32_t *status) {
+	return false;
+}
+void clearAllPCMStickyFaults(void *pcm_pointer, int32_t *status) {
+}
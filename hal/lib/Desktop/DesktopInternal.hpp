@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+/*
+ * Connections between the parts of the desktop device model that live in
+ * different files. Not for use outside the desktop HAL.
+ */
+
+/** The FPGA time in microseconds, without wrapping at 32 bits. */
+uint64_t desktopTime();
+/** Move the manual clock, without running any notifiers. */
+void setDesktopTime(uint64_t microseconds);
+bool isDesktopClockManual();
+
+/**
+ * Run the notifier alarms that come due up to a time on the manual clock, in
+ * order, with the clock at each one's trigger time, then leave the clock at
+ * that time.
+ */
+void runNotifiersUntil(uint64_t microseconds);
+/** Wake the notifier thread after the clock was moved or changed mode. */
+void clockChanged();
+
+/**
+ * A digital source changed level. This is how counters, encoders and
+ * interrupts see their inputs, whether they come from a digital input or an
+ * analog trigger output.
+ * @param pin The pin as the HAL is given it for routing, which for analog
+ * trigger outputs is (trigger index << 2) + output type
+ */
+void digitalSourceChanged(uint32_t pin, bool analogTrigger, bool value);
+/** The level of a digital source. */
+bool getDigitalSourceLevel(uint32_t pin, bool analogTrigger);
+bool getAnalogTriggerLevel(uint32_t pin);
+void interruptSourceChanged(uint32_t pin, bool analogTrigger, bool value);
+
+// Put each part of the model back to its power on state.
+void resetDriverStation();
+void resetDigital();
+void resetAnalog();
+void resetInterrupts();
+void resetPneumatics();
+void resetPower();
+void resetPDP();
+void resetAccelerometer();
+void resetSerial();
+void resetBuses();
+void resetCAN();
+
+/**
+ * What a pneumatics control module on the CAN bus holds, shared between the
+ * solenoid and compressor code. Only touched with pneumaticsMutex held.
+ */
+struct PneumaticsModule {
+  bool initialized;
+  uint8_t solenoids;
+  uint8_t blackList;
+  bool closedLoopControl;
+  bool pressureSwitch;
+  float compressorCurrent;
+};
+
+static const int kNumPneumaticsModules = 63;
+extern std::mutex pneumaticsMutex;
+extern PneumaticsModule pneumaticsModules[kNumPneumaticsModules];
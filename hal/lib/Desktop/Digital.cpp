@@ -0,0 +1,1479 @@
+
+#include "HAL/Digital.hpp"
+
+#include "HAL/Port.h"
+#include "HAL/HAL.hpp"
+#include "HAL/cpp/HandleTable.hpp"
+#include "HAL/cpp/Resource.hpp"
+#include "HAL/cpp/priority_mutex.h"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <stdio.h>
+#include <math.h>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+
+static_assert(sizeof(uint32_t) <= sizeof(void *), "This file shoves uint32_ts into pointers.");
+
+static const uint32_t kExpectedLoopTiming = 40;
+static const uint32_t kDigitalPins = 26;
+static const uint32_t kPwmPins = 20;
+static const uint32_t kRelayPins = 8;
+static const uint32_t kNumHeaders = 10; // Number of non-MXP pins
+static const uint32_t kNumPwmHeaders = 10;
+static const uint32_t kNumPwmGenerators = 6;
+static const uint32_t kNumCounters = 8;
+static const uint32_t kNumEncoders = 8;
+static const uint32_t kNumSPIPorts = 5;
+static const uint32_t kNumI2CPorts = 2;
+static const int32_t kPwmDisabled = 0;
+static const double kDefaultMaxPeriod = 0.5;
+
+struct DigitalPort {
+  Port port;
+  uint32_t PWMGeneratorID;
+};
+
+// Create a mutex to protect changes to the digital output values
+static priority_recursive_mutex digitalDIOMutex;
+// Create a mutex to protect changes to the relay values
+static priority_recursive_mutex digitalRelayMutex;
+// Create a mutex to protect changes to the DO PWM config
+static priority_recursive_mutex digitalPwmMutex;
+static priority_recursive_mutex digitalI2COnBoardMutex;
+static priority_recursive_mutex digitalI2CMXPMutex;
+
+static hal::Resource *DIOChannels = NULL;
+static hal::Resource *DO_PWMGenerators = NULL;
+static hal::Resource *PWMChannels = NULL;
+
+static bool digitalSystemsInitialized = false;
+
+/*
+ * The registers. The DIO registers have a bit per pin, with the MXP pins
+ * following the headers rather than being in a register of their own.
+ */
+static std::atomic<uint32_t> dioOutputEnable(0);
+static std::atomic<uint32_t> dioOutputs(0);
+static std::atomic<uint32_t> dioInputs(0);
+static std::atomic<uint64_t> dioPulseEnd[kDigitalPins];
+static std::atomic<uint16_t> pwmValues[kPwmPins];
+static std::atomic<uint32_t> pwmPeriodScales[kPwmPins];
+static std::atomic<uint8_t> relayForward(0);
+static std::atomic<uint8_t> relayReverse(0);
+static double pwmRate = 0;
+static uint8_t pwmDutyCycles[kNumPwmGenerators];
+static uint32_t pwmOutputSelect[kNumPwmGenerators];
+
+/**
+ * Initialize the digital system.
+ */
+void initializeDigital(int32_t *status) {
+  std::lock_guard<priority_recursive_mutex> sync(digitalDIOMutex);
+  if (digitalSystemsInitialized) return;
+
+  hal::Resource::CreateResourceObject(&DIOChannels, kDigitalPins);
+  hal::Resource::CreateResourceObject(&DO_PWMGenerators, kNumPwmGenerators);
+  hal::Resource::CreateResourceObject(&PWMChannels, kPwmPins);
+
+  digitalSystemsInitialized = true;
+}
+
+/**
+ * Create a new instance of a digital port.
+ */
+void* initializeDigitalPort(void* port_pointer, int32_t *status) {
+  initializeDigital(status);
+  Port* port = (Port*) port_pointer;
+
+  // Initialize port structure
+  DigitalPort* digital_port = new DigitalPort();
+  digital_port->port = *port;
+
+  return digital_port;
+}
+
+bool checkPWMChannel(void* digital_port_pointer) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  return port->port.pin < kPwmPins;
+}
+
+bool checkRelayChannel(void* digital_port_pointer) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  return port->port.pin < kRelayPins;
+}
+
+uint32_t remapMXPPWMChannel(uint32_t pin) {
+	if(pin < 14) {
+		return pin - 10;	//first block of 4 pwms (MXP 0-3)
+	} else {
+		return pin - 6;	//block of PWMs after SPI
+	}
+}
+
+/** The level a pin reads, which is the level it's driven to if it's an output. */
+static bool getPinLevel(uint32_t pin) {
+  uint32_t bit = 1u << pin;
+  uint32_t levels = (dioOutputEnable & bit) ? dioOutputs.load() : dioInputs.load();
+  return (levels & bit) != 0;
+}
+
+/**
+ * Change the DIO registers, passing on any change in what the pins read to
+ * whatever is routed to them. Must be called with digitalDIOMutex held.
+ */
+template <typename Change>
+static void changePins(Change change) {
+  uint32_t before[kDigitalPins];
+  for (uint32_t pin = 0; pin < kDigitalPins; pin++) before[pin] = getPinLevel(pin);
+  change();
+  for (uint32_t pin = 0; pin < kDigitalPins; pin++) {
+    bool after = getPinLevel(pin);
+    if (after != before[pin]) digitalSourceChanged(pin, false, after);
+  }
+}
+
+/**
+ * Set a PWM channel to the desired value. The values range from 0 to 255 and the period is controlled
+ * by the PWM Period and MinHigh registers.
+ *
+ * @param channel The PWM channel to set.
+ * @param value The PWM value to set.
+ */
+void setPWM(void* digital_port_pointer, unsigned short value, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  if (!checkPWMChannel(port)) return;
+  pwmValues[port->port.pin] = value;
+}
+
+/**
+ * Get a value from a PWM channel. The values range from 0 to 255.
+ *
+ * @param channel The PWM channel to read from.
+ * @return The raw PWM value.
+ */
+unsigned short getPWM(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  if (!checkPWMChannel(port)) return 0;
+  return pwmValues[port->port.pin];
+}
+
+void latchPWMZero(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  if (!checkPWMChannel(port)) return;
+  pwmValues[port->port.pin] = kPwmDisabled;
+}
+
+/**
+ * Set how how often the PWM signal is squelched, thus scaling the period.
+ *
+ * @param channel The PWM channel to configure.
+ * @param squelchMask The 2-bit mask of outputs to squelch.
+ */
+void setPWMPeriodScale(void* digital_port_pointer, uint32_t squelchMask, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  if (!checkPWMChannel(port)) return;
+  pwmPeriodScales[port->port.pin] = squelchMask;
+}
+
+/**
+ * Allocate a DO PWM Generator.
+ * Allocate PWM generators so that they are not accidentally reused.
+ *
+ * @return PWM Generator refnum
+ */
+void* allocatePWM(int32_t *status) {
+  initializeDigital(status);
+  return (void*)(uintptr_t)DO_PWMGenerators->Allocate("DO_PWM");
+}
+
+/**
+ * Free the resource associated with a DO PWM generator.
+ *
+ * @param pwmGenerator The pwmGen to free that was allocated with AllocateDO_PWM()
+ */
+void freePWM(void* pwmGenerator, int32_t *status) {
+  uint32_t id = (uint32_t)(uintptr_t) pwmGenerator;
+  if (id == ~0u) return;
+  DO_PWMGenerators->Free(id);
+}
+
+/**
+ * Change the frequency of the DO PWM generator.
+ *
+ * @param rate The frequency to output all digital output PWM signals.
+ */
+void setPWMRate(double rate, int32_t *status) {
+  std::lock_guard<priority_recursive_mutex> sync(digitalPwmMutex);
+  pwmRate = rate;
+}
+
+/**
+ * Configure the duty-cycle of the PWM generator
+ *
+ * @param pwmGenerator The generator index reserved by AllocateDO_PWM()
+ * @param dutyCycle The percent duty cycle to output [0..1].
+ */
+void setPWMDutyCycle(void* pwmGenerator, double dutyCycle, int32_t *status) {
+  uint32_t id = (uint32_t)(uintptr_t) pwmGenerator;
+  if (id >= kNumPwmGenerators) return;
+  if (dutyCycle > 1.0) dutyCycle = 1.0;
+  if (dutyCycle < 0.0) dutyCycle = 0.0;
+  float rawDutyCycle = 256.0 * dutyCycle;
+  if (rawDutyCycle > 255.5) rawDutyCycle = 255.5;
+  std::lock_guard<priority_recursive_mutex> sync(digitalPwmMutex);
+  pwmDutyCycles[id] = (uint8_t)rawDutyCycle;
+}
+
+/**
+ * Configure which DO channel the PWM signal is output on
+ *
+ * @param pwmGenerator The generator index reserved by AllocateDO_PWM()
+ * @param channel The Digital Output channel to output on
+ */
+void setPWMOutputChannel(void* pwmGenerator, uint32_t pin, int32_t *status) {
+  uint32_t id = (uint32_t)(uintptr_t) pwmGenerator;
+  if (id >= kNumPwmGenerators) return;
+  std::lock_guard<priority_recursive_mutex> sync(digitalPwmMutex);
+  pwmOutputSelect[id] = pin;
+}
+
+/**
+ * Set the state of a relay.
+ * Set the state of a relay output to be forward. Relays have two outputs and each is
+ * independently set to 0v or 12v.
+ */
+void setRelayForward(void* digital_port_pointer, bool on, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  if (!checkRelayChannel(port)) return;
+  std::lock_guard<priority_recursive_mutex> sync(digitalRelayMutex);
+  if (on)
+    relayForward |= 1 << port->port.pin;
+  else
+    relayForward &= ~(1 << port->port.pin);
+}
+
+/**
+ * Set the state of a relay.
+ * Set the state of a relay output to be reverse. Relays have two outputs and each is
+ * independently set to 0v or 12v.
+ */
+void setRelayReverse(void* digital_port_pointer, bool on, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  if (!checkRelayChannel(port)) return;
+  std::lock_guard<priority_recursive_mutex> sync(digitalRelayMutex);
+  if (on)
+    relayReverse |= 1 << port->port.pin;
+  else
+    relayReverse &= ~(1 << port->port.pin);
+}
+
+/**
+ * Get the current state of the forward relay channel
+ */
+bool getRelayForward(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  return (relayForward & (1 << port->port.pin)) != 0;
+}
+
+/**
+ * Get the current state of the reverse relay channel
+ */
+bool getRelayReverse(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  return (relayReverse & (1 << port->port.pin)) != 0;
+}
+
+/**
+ * Allocate Digital I/O channels.
+ * Allocate channels so that they are not accidently reused. Also the direction is set at the
+ * time of the allocation.
+ *
+ * @param channel The Digital I/O channel
+ * @param input If true open as input; if false open as output
+ * @return Was successfully allocated
+ */
+bool allocateDIO(void* digital_port_pointer, bool input, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  char buf[64];
+  snprintf(buf, 64, "DIO %d", port->port.pin);
+  if (DIOChannels->Allocate(port->port.pin, buf) == ~0u) {
+    *status = RESOURCE_IS_ALLOCATED;
+    return false;
+  }
+
+  std::lock_guard<priority_recursive_mutex> sync(digitalDIOMutex);
+  uint32_t bit = 1u << port->port.pin;
+  changePins([&] {
+    if (input) {
+      dioOutputEnable &= ~bit; // clear the bit for read
+    } else {
+      dioOutputEnable |= bit; // set the bit for write
+    }
+  });
+  return true;
+}
+
+bool allocatePWMChannel(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  char buf[64];
+  snprintf(buf, 64, "PWM %d", port->port.pin);
+  if (PWMChannels->Allocate(port->port.pin, buf) == ~0u) {
+    *status = RESOURCE_IS_ALLOCATED;
+    return false;
+  }
+
+  if (port->port.pin > kNumPwmHeaders-1) {
+    snprintf(buf, 64, "PWM %d and DIO %d", port->port.pin, remapMXPPWMChannel(port->port.pin) + 10);
+    if (DIOChannels->Allocate(remapMXPPWMChannel(port->port.pin) + 10, buf) == ~0u) return false;
+  }
+  return true;
+}
+
+void freePWMChannel(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  PWMChannels->Free(port->port.pin);
+  if (port->port.pin > kNumPwmHeaders-1) {
+    DIOChannels->Free(remapMXPPWMChannel(port->port.pin) + 10);
+  }
+}
+
+/**
+ * Free the resource associated with a digital I/O channel.
+ *
+ * @param channel The Digital I/O channel to free
+ */
+void freeDIO(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  DIOChannels->Free(port->port.pin);
+}
+
+/**
+ * Write a digital I/O bit to the FPGA.
+ * Set a single value on a digital I/O channel.
+ *
+ * @param channel The Digital I/O channel
+ * @param value The state to set the digital channel (if it is configured as an output)
+ */
+void setDIO(void* digital_port_pointer, short value, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  uint32_t bit = 1u << port->port.pin;
+  std::lock_guard<priority_recursive_mutex> sync(digitalDIOMutex);
+  changePins([&] {
+    if (value == 0) {
+      dioOutputs &= ~bit;
+    } else {
+      dioOutputs |= bit;
+    }
+  });
+}
+
+/**
+ * Read a digital I/O bit from the FPGA.
+ * Get a single value from a digital I/O channel.
+ *
+ * @param channel The digital I/O channel
+ * @return The state of the specified channel
+ */
+bool getDIO(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  return getPinLevel(port->port.pin);
+}
+
+/**
+ * Read the direction of a the Digital I/O lines
+ * A 1 bit means output and a 0 bit means input.
+ *
+ * @param channel The digital I/O channel
+ * @return The direction of the specified channel
+ */
+bool getDIODirection(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  return (dioOutputEnable & (1u << port->port.pin)) != 0;
+}
+
+/**
+ * Generate a single pulse.
+ * Write a pulse to the specified digital output channel. There can only be a single pulse going at any time.
+ *
+ * @param channel The Digital Output channel that the pulse should be output on
+ * @param pulseLength The active length of the pulse (in seconds)
+ */
+void pulse(void* digital_port_pointer, double pulseLength, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  dioPulseEnd[port->port.pin] = desktopTime() + (uint64_t)(pulseLength * 1e6);
+}
+
+/**
+ * Check a DIO line to see if it is currently generating a pulse.
+ *
+ * @return A pulse is in progress
+ */
+bool isPulsing(void* digital_port_pointer, int32_t *status) {
+  DigitalPort* port = (DigitalPort*) digital_port_pointer;
+  return desktopTime() < dioPulseEnd[port->port.pin];
+}
+
+/**
+ * Check if any DIO line is currently generating a pulse.
+ *
+ * @return A pulse on some line is in progress
+ */
+bool isAnyPulsing(int32_t *status) {
+  uint64_t now = desktopTime();
+  for (uint32_t pin = 0; pin < kDigitalPins; pin++) {
+    if (now < dioPulseEnd[pin]) return true;
+  }
+  return false;
+}
+
+/**
+ * The input of a counter or encoder, as routed to it.
+ */
+struct Source {
+  bool enabled;
+  uint32_t pin;
+  bool analogTrigger;
+  bool risingEdge;
+  bool fallingEdge;
+
+  bool Matches(uint32_t pin, bool analogTrigger) const {
+    return enabled && this->pin == pin && this->analogTrigger == analogTrigger;
+  }
+  bool Counts(bool value) const {
+    return value ? risingEdge : fallingEdge;
+  }
+};
+
+/**
+ * What the FPGA's event timer works out from the times of the edges that are
+ * counted.
+ */
+struct Timer {
+  bool hasEdge;
+  uint64_t lastEdge;
+  double period;
+  double maxPeriod;
+  bool updateWhenEmpty;
+  int32_t samplesToAverage;
+
+  void Edge(uint64_t now) {
+    if (hasEdge) period = (now - lastEdge) * 1e-6;
+    lastEdge = now;
+    hasEdge = true;
+  }
+  void Set(double period) {
+    this->period = period;
+    lastEdge = desktopTime();
+    hasEdge = period > 0 && period < std::numeric_limits<double>::infinity();
+  }
+  bool Stalled() const {
+    return !hasEdge || (desktopTime() - lastEdge) * 1e-6 > maxPeriod;
+  }
+  double Period() const {
+    return Stalled() ? std::numeric_limits<double>::infinity() : period;
+  }
+};
+
+struct counter_t {
+  uint32_t index;
+  Mode mode;
+  Source up;
+  Source down;
+  double pulseLengthThreshold;
+  int32_t count;
+  bool direction;
+  uint64_t pulseStart;
+  Timer timer;
+};
+typedef struct counter_t Counter;
+
+static hal::HandleTable<Counter, kNumCounters, hal::HandleType::Counter>
+    counters;
+
+/*
+ * Counters and encoders are updated from whichever thread changes their
+ * inputs, so their state is only touched with counterMutex held. The slots
+ * point at the ones in use, for routing edges to.
+ */
+static std::mutex counterMutex;
+static Counter* counterSlots[kNumCounters];
+
+void* initializeCounter(Mode mode, uint32_t *index, int32_t *status) {
+	uint32_t handle = counters.Allocate();
+	if (handle == counters.kInvalidHandle) {
+		*status = NO_AVAILABLE_RESOURCES;
+		return NULL;
+	}
+	*index = counters.GetIndex(handle);
+	Counter* counter = counters.Get(handle);
+	std::lock_guard<std::mutex> sync(counterMutex);
+	counter->index = *index;
+	counter->mode = mode;
+	counter->timer.maxPeriod = kDefaultMaxPeriod;
+	counter->timer.samplesToAverage = 1;
+	counterSlots[*index] = counter;
+	return counters.HandleToPointer(handle);
+}
+
+void freeCounter(void* counter_pointer, int32_t *status) {
+  if (counter_pointer != NULL) {
+	  Counter* counter = counters.Get(counter_pointer, status);
+	  if (counter == nullptr) return;
+	  {
+	    std::lock_guard<std::mutex> sync(counterMutex);
+	    counterSlots[counter->index] = nullptr;
+	  }
+	  counters.Free(counter_pointer);
+  } else {
+	  *status = NULL_PARAMETER;
+  }
+}
+
+void setCounterAverageSize(void* counter_pointer, int32_t size, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->timer.samplesToAverage = size;
+}
+
+/**
+ * Set the source object that causes the counter to count up.
+ * Set the up counting DigitalSource.
+ */
+void setCounterUpSource(void* counter_pointer, uint32_t pin, bool analogTrigger, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->up.enabled = true;
+  counter->up.pin = pin;
+  counter->up.analogTrigger = analogTrigger;
+  if (counter->mode == kTwoPulse || counter->mode == kExternalDirection) {
+    counter->up.risingEdge = true;
+    counter->up.fallingEdge = false;
+  }
+  counter->count = 0;
+}
+
+/**
+ * Set the edge sensitivity on an up counting source.
+ * Set the up source to either detect rising edges or falling edges.
+ */
+void setCounterUpSourceEdge(void* counter_pointer, bool risingEdge, bool fallingEdge, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->up.risingEdge = risingEdge;
+  counter->up.fallingEdge = fallingEdge;
+}
+
+/**
+ * Disable the up counting source to the counter.
+ */
+void clearCounterUpSource(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->up = Source();
+}
+
+/**
+ * Set the source object that causes the counter to count down.
+ * Set the down counting DigitalSource.
+ */
+void setCounterDownSource(void* counter_pointer, uint32_t pin, bool analogTrigger, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  if (counter->mode != kTwoPulse && counter->mode != kExternalDirection) {
+	*status = PARAMETER_OUT_OF_RANGE;
+	return;
+  }
+  counter->down.enabled = true;
+  counter->down.pin = pin;
+  counter->down.analogTrigger = analogTrigger;
+  counter->down.risingEdge = true;
+  counter->down.fallingEdge = false;
+  counter->count = 0;
+}
+
+/**
+ * Set the edge sensitivity on a down counting source.
+ * Set the down source to either detect rising edges or falling edges.
+ */
+void setCounterDownSourceEdge(void* counter_pointer, bool risingEdge, bool fallingEdge, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->down.risingEdge = risingEdge;
+  counter->down.fallingEdge = fallingEdge;
+}
+
+/**
+ * Disable the down counting source to the counter.
+ */
+void clearCounterDownSource(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->down = Source();
+}
+
+/**
+ * Set standard up / down counting mode on this counter.
+ * Up and down counts are sourced independently from two inputs.
+ */
+void setCounterUpDownMode(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->mode = kTwoPulse;
+}
+
+/**
+ * Set external direction mode on this counter.
+ * Counts are sourced on the Up counter input.
+ * The Down counter input represents the direction to count.
+ */
+void setCounterExternalDirectionMode(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->mode = kExternalDirection;
+}
+
+/**
+ * Set Semi-period mode on this counter.
+ * Counts up on both rising and falling edges.
+ */
+void setCounterSemiPeriodMode(void* counter_pointer, bool highSemiPeriod, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->mode = kSemiperiod;
+  counter->up.risingEdge = highSemiPeriod;
+  counter->timer.updateWhenEmpty = false;
+}
+
+/**
+ * Configure the counter to count in up or down based on the length of the input pulse.
+ * This mode is most useful for direction sensitive gear tooth sensors.
+ * @param threshold The pulse length beyond which the counter counts the opposite direction.  Units are seconds.
+ */
+void setCounterPulseLengthMode(void* counter_pointer, double threshold, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->mode = kPulseLength;
+  counter->pulseLengthThreshold = threshold;
+}
+
+/**
+ * Get the Samples to Average which specifies the number of samples of the timer to
+ * average when calculating the period.
+ * @return SamplesToAverage The number of samples being averaged (from 1 to 127)
+ */
+int32_t getCounterSamplesToAverage(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return 0;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return counter->timer.samplesToAverage;
+}
+
+/**
+ * Set the Samples to Average which specifies the number of samples of the timer to
+ * average when calculating the period. The desktop timer measures every
+ * period exactly, so this is only stored.
+ * @param samplesToAverage The number of samples to average from 1 to 127.
+ */
+void setCounterSamplesToAverage(void* counter_pointer, int samplesToAverage, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  if (samplesToAverage < 1 || samplesToAverage > 127) {
+	*status = PARAMETER_OUT_OF_RANGE;
+  }
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->timer.samplesToAverage = samplesToAverage;
+}
+
+/**
+ * Reset the Counter to zero.
+ * Set the counter value to zero. This doesn't effect the running state of the counter, just sets
+ * the current value to zero.
+ */
+void resetCounter(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->count = 0;
+}
+
+/**
+ * Read the current counter value.
+ */
+int32_t getCounter(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return 0;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return counter->count;
+}
+
+/*
+ * Get the Period of the most recent count.
+ * Returns the time interval of the most recent count. This can be used for velocity calculations
+ * to determine shaft speed.
+ * @returns The period of the last two pulses in units of seconds.
+ */
+double getCounterPeriod(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return 0.0;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return counter->timer.Period();
+}
+
+/**
+ * Set the maximum period where the device is still considered "moving".
+ * @param maxPeriod The maximum period where the counted device is considered moving in
+ * seconds.
+ */
+void setCounterMaxPeriod(void* counter_pointer, double maxPeriod, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->timer.maxPeriod = maxPeriod;
+}
+
+/**
+ * Select whether you want to continue updating the event timer output when there are no samples captured.
+ */
+void setCounterUpdateWhenEmpty(void* counter_pointer, bool enabled, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  counter->timer.updateWhenEmpty = enabled;
+}
+
+/**
+ * Determine if the clock is stopped.
+ * @return Returns true if the most recent counter period exceeds the MaxPeriod value set by
+ * SetMaxPeriod.
+ */
+bool getCounterStopped(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return false;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return counter->timer.Stalled();
+}
+
+/**
+ * The last direction the counter value changed.
+ * @return The last direction the counter value changed.
+ */
+bool getCounterDirection(void* counter_pointer, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return false;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return counter->direction;
+}
+
+/**
+ * Set the Counter to return reversed sensing on the direction.
+ * This allows counters to change the direction they are counting in the case of 1X and 2X
+ * quadrature encoding only. Any other counter mode isn't supported.
+ * @param reverseDirection true if the value counted should be negated.
+ */
+void setCounterReverseDirection(void* counter_pointer, bool reverseDirection, int32_t *status) {
+  Counter* counter = counters.Get(counter_pointer, status);
+  if (counter == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  if (counter->mode == kExternalDirection) {
+    // As on the FPGA, a down source sensitive to both edges means reversed
+    counter->down.risingEdge = reverseDirection;
+    counter->down.fallingEdge = true;
+  }
+}
+
+static void countEdge(Counter* counter, int32_t delta, uint64_t now) {
+  counter->count += delta;
+  counter->direction = delta > 0;
+  counter->timer.Edge(now);
+}
+
+static void counterSourceChanged(Counter* counter, uint32_t pin, bool analogTrigger,
+                                 bool value, uint64_t now) {
+  bool up = counter->up.Matches(pin, analogTrigger);
+  bool down = counter->down.Matches(pin, analogTrigger);
+  switch (counter->mode) {
+    case kTwoPulse:
+      if (up && counter->up.Counts(value)) countEdge(counter, 1, now);
+      if (down && counter->down.Counts(value)) countEdge(counter, -1, now);
+      break;
+    case kExternalDirection:
+      if (up && counter->up.Counts(value)) {
+        bool reverse = counter->down.risingEdge && counter->down.fallingEdge;
+        bool backwards = counter->down.enabled &&
+            getDigitalSourceLevel(counter->down.pin, counter->down.analogTrigger);
+        countEdge(counter, backwards != reverse ? -1 : 1, now);
+      }
+      break;
+    case kSemiperiod:
+      // Time the pulses at the level the up source's rising edge is set to
+      if (!up) break;
+      if (value == counter->up.risingEdge) {
+        counter->pulseStart = now;
+      } else {
+        counter->count++;
+        counter->direction = true;
+        counter->timer.period = (now - counter->pulseStart) * 1e-6;
+        counter->timer.lastEdge = now;
+        counter->timer.hasEdge = true;
+      }
+      break;
+    case kPulseLength:
+      if (!up) break;
+      if (value) {
+        counter->pulseStart = now;
+      } else {
+        double length = (now - counter->pulseStart) * 1e-6;
+        countEdge(counter, length < counter->pulseLengthThreshold ? 1 : -1, now);
+      }
+      break;
+  }
+}
+
+struct encoder_t {
+  uint32_t index;
+  Source a;
+  Source b;
+  Source indexSource;
+  bool indexActiveHigh;
+  bool indexEdgeSensitive;
+  bool aLevel;
+  bool bLevel;
+  bool reverse;
+  int32_t count;
+  bool direction;
+  Timer timer;
+};
+typedef struct encoder_t Encoder;
+
+static const double DECODING_SCALING_FACTOR = 0.25;
+static hal::HandleTable<Encoder, kNumEncoders, hal::HandleType::Encoder>
+    quadEncoders;
+static Encoder* encoderSlots[kNumEncoders];
+
+/**
+ * The change in count for each transition of the A and B channels, indexed
+ * by (A << 3) | (B << 2) | (new A << 1) | new B. Counting up, A leads B.
+ */
+static const int8_t kQuadratureSteps[16] = {
+  0, -1,  1,  0,
+  1,  0,  0, -1,
+ -1,  0,  0,  1,
+  0,  1, -1,  0,
+};
+
+void* initializeEncoder(uint8_t port_a_module, uint32_t port_a_pin, bool port_a_analog_trigger,
+						uint8_t port_b_module, uint32_t port_b_pin, bool port_b_analog_trigger,
+						bool reverseDirection, int32_t *index, int32_t *status) {
+
+  uint32_t handle = quadEncoders.Allocate();
+  if (handle == quadEncoders.kInvalidHandle) {
+	*status = NO_AVAILABLE_RESOURCES;
+	return NULL;
+  }
+
+  // Initialize encoder structure
+  Encoder* encoder = quadEncoders.Get(handle);
+
+  std::lock_guard<std::mutex> sync(counterMutex);
+  encoder->index = quadEncoders.GetIndex(handle);
+  *index = encoder->index;
+  encoder->a.enabled = true;
+  encoder->a.pin = port_a_pin;
+  encoder->a.analogTrigger = port_a_analog_trigger;
+  encoder->b.enabled = true;
+  encoder->b.pin = port_b_pin;
+  encoder->b.analogTrigger = port_b_analog_trigger;
+  encoder->aLevel = getDigitalSourceLevel(port_a_pin, port_a_analog_trigger);
+  encoder->bLevel = getDigitalSourceLevel(port_b_pin, port_b_analog_trigger);
+  encoder->reverse = reverseDirection;
+  encoder->timer.maxPeriod = kDefaultMaxPeriod;
+  encoder->timer.samplesToAverage = 4;
+  encoderSlots[encoder->index] = encoder;
+
+  return quadEncoders.HandleToPointer(handle);
+}
+
+void freeEncoder(void* encoder_pointer, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
+  {
+    std::lock_guard<std::mutex> sync(counterMutex);
+    encoderSlots[encoder->index] = nullptr;
+  }
+  quadEncoders.Free(encoder_pointer);
+}
+
+/**
+ * Reset the Encoder distance to zero.
+ * Resets the current count to zero on the encoder.
+ */
+void resetEncoder(void* encoder_pointer, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  encoder->count = 0;
+}
+
+/**
+ * Gets the raw value from the encoder.
+ * The raw value is the actual count unscaled by the 1x, 2x, or 4x scale
+ * factor.
+ * @return Current raw count from the encoder
+ */
+int32_t getEncoder(void* encoder_pointer, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return 0;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return encoder->count;
+}
+
+/**
+ * Returns the period of the most recent pulse.
+ * Returns the period of the most recent Encoder pulse in seconds.
+ * This method compenstates for the decoding type.
+ *
+ * @return Period in seconds of the most recent pulse.
+ */
+double getEncoderPeriod(void* encoder_pointer, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return 0.0;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  // The timer measures between 4X edges, so a whole cycle is four of them.
+  return encoder->timer.Period() / DECODING_SCALING_FACTOR;
+}
+
+/**
+ * Sets the maximum period for stopped detection.
+ *
+ * @param maxPeriod The maximum time between rising and falling edges before the FPGA will
+ * report the device stopped. This is expressed in seconds.
+ */
+void setEncoderMaxPeriod(void* encoder_pointer, double maxPeriod, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  encoder->timer.maxPeriod = maxPeriod * DECODING_SCALING_FACTOR;
+}
+
+/**
+ * Determine if the encoder is stopped.
+ * @return True if the encoder is considered stopped.
+ */
+bool getEncoderStopped(void* encoder_pointer, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return false;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return encoder->timer.Stalled();
+}
+
+/**
+ * The last direction the encoder value changed.
+ * @return The last direction the encoder value changed.
+ */
+bool getEncoderDirection(void* encoder_pointer, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return false;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return encoder->direction;
+}
+
+/**
+ * Set the direction sensing for this encoder.
+ * @param reverseDirection true if the encoder direction should be reversed
+ */
+void setEncoderReverseDirection(void* encoder_pointer, bool reverseDirection, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  encoder->reverse = reverseDirection;
+}
+
+/**
+ * Set the Samples to Average which specifies the number of samples of the timer to
+ * average when calculating the period.
+ * @param samplesToAverage The number of samples to average from 1 to 127.
+ */
+void setEncoderSamplesToAverage(void* encoder_pointer, uint32_t samplesToAverage, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
+  if (samplesToAverage < 1 || samplesToAverage > 127) {
+	*status = PARAMETER_OUT_OF_RANGE;
+  }
+  std::lock_guard<std::mutex> sync(counterMutex);
+  encoder->timer.samplesToAverage = samplesToAverage;
+}
+
+/**
+ * Get the Samples to Average which specifies the number of samples of the timer to
+ * average when calculating the period.
+ * @return SamplesToAverage The number of samples being averaged (from 1 to 127)
+ */
+uint32_t getEncoderSamplesToAverage(void* encoder_pointer, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return 0;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  return encoder->timer.samplesToAverage;
+}
+
+/**
+ * Set an index source for an encoder, which is an input that resets the
+ * encoder's count.
+ */
+void setEncoderIndexSource(void *encoder_pointer, uint32_t pin, bool analogTrigger, bool activeHigh,
+    bool edgeSensitive, int32_t *status) {
+  Encoder* encoder = quadEncoders.Get(encoder_pointer, status);
+  if (encoder == nullptr) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  encoder->indexSource.enabled = true;
+  encoder->indexSource.pin = pin;
+  encoder->indexSource.analogTrigger = analogTrigger;
+  encoder->indexActiveHigh = activeHigh;
+  encoder->indexEdgeSensitive = edgeSensitive;
+}
+
+static void encoderSourceChanged(Encoder* encoder, uint32_t pin, bool analogTrigger,
+                                 bool value, uint64_t now) {
+  bool a = encoder->a.Matches(pin, analogTrigger) ? value : encoder->aLevel;
+  bool b = encoder->b.Matches(pin, analogTrigger) ? value : encoder->bLevel;
+  int32_t delta = kQuadratureSteps[(encoder->aLevel << 3) | (encoder->bLevel << 2) | (a << 1) | b];
+  encoder->aLevel = a;
+  encoder->bLevel = b;
+  if (delta != 0) {
+    if (encoder->reverse) delta = -delta;
+    encoder->count += delta;
+    encoder->direction = delta > 0;
+    encoder->timer.Edge(now);
+  }
+
+  if (encoder->indexSource.Matches(pin, analogTrigger) ||
+      (delta != 0 && encoder->indexSource.enabled && !encoder->indexEdgeSensitive)) {
+    bool level = getDigitalSourceLevel(encoder->indexSource.pin, encoder->indexSource.analogTrigger);
+    if (level == encoder->indexActiveHigh) encoder->count = 0;
+  }
+}
+
+void digitalSourceChanged(uint32_t pin, bool analogTrigger, bool value) {
+  uint64_t now = desktopTime();
+  {
+    std::lock_guard<std::mutex> sync(counterMutex);
+    for (uint32_t i = 0; i < kNumCounters; i++) {
+      if (counterSlots[i] != nullptr) {
+        counterSourceChanged(counterSlots[i], pin, analogTrigger, value, now);
+      }
+    }
+    for (uint32_t i = 0; i < kNumEncoders; i++) {
+      if (encoderSlots[i] != nullptr) {
+        encoderSourceChanged(encoderSlots[i], pin, analogTrigger, value, now);
+      }
+    }
+  }
+  interruptSourceChanged(pin, analogTrigger, value);
+}
+
+bool getDigitalSourceLevel(uint32_t pin, bool analogTrigger) {
+  if (analogTrigger) return getAnalogTriggerLevel(pin);
+  return pin < kDigitalPins && getPinLevel(pin);
+}
+
+/**
+ * Get the loop timing of the PWM system
+ *
+ * @return The loop time
+ */
+uint16_t getLoopTiming(int32_t *status) {
+  return kExpectedLoopTiming;
+}
+
+/**
+ * A bus as the robot code sees it: bytes it writes are kept for tests, and
+ * bytes tests push are what it reads.
+ */
+struct Bus {
+  int32_t handle;
+  std::deque<uint8_t> input;
+  std::string output;
+
+  void Transfer(const uint8_t *dataToSend, uint8_t sendSize,
+                uint8_t *dataReceived, uint8_t receiveSize) {
+    if (dataToSend != nullptr) output.append((const char *)dataToSend, sendSize);
+    for (uint8_t i = 0; i < receiveSize; i++) {
+      if (input.empty()) {
+        dataReceived[i] = 0;
+      } else {
+        dataReceived[i] = input.front();
+        input.pop_front();
+      }
+    }
+  }
+};
+
+static std::mutex busMutex;
+static Bus spiBuses[kNumSPIPorts];
+static Bus i2cBuses[kNumI2CPorts];
+
+uint8_t i2COnboardObjCount = 0;
+uint8_t i2CMXPObjCount = 0;
+
+priority_recursive_mutex spiOnboardSemaphore;
+priority_recursive_mutex spiMXPSemaphore;
+
+/*
+ * Initialize the spi port. Opens the port if necessary and saves the handle.
+ * If opening the MXP port, also sets up the pin functions appropriately
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP
+ */
+void spiInitialize(uint8_t port, int32_t *status) {
+	if (port >= kNumSPIPorts) return;
+	if(spiGetHandle(port) !=0 ) return;
+	if (port == 4) {
+		initializeDigital(status);
+		if(!allocateDIO(getPort(14), false, status)){printf("Failed to allocate DIO 14\n"); return;}
+		if(!allocateDIO(getPort(15), false, status)) {printf("Failed to allocate DIO 15\n"); return;}
+		if(!allocateDIO(getPort(16), true, status)) {printf("Failed to allocate DIO 16\n"); return;}
+		if(!allocateDIO(getPort(17), false, status)) {printf("Failed to allocate DIO 17\n"); return;}
+	}
+	spiSetHandle(port, port + 1);
+}
+
+/**
+ * Generic transaction.
+ *
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP
+ * @param dataToSend Buffer of data to send as part of the transaction.
+ * @param dataReceived Buffer to read data into.
+ * @param size Number of bytes to transfer. [0..7]
+ * @return Number of bytes transferred, -1 for error
+ */
+int32_t spiTransaction(uint8_t port, uint8_t *dataToSend, uint8_t *dataReceived, uint8_t size)
+{
+	std::lock_guard<priority_recursive_mutex> sync(spiGetSemaphore(port));
+	if (spiGetHandle(port) == 0) return -1;
+	std::lock_guard<std::mutex> busSync(busMutex);
+	spiBuses[port].Transfer(dataToSend, size, dataReceived, size);
+	return size;
+}
+
+/**
+ * Execute a write transaction with the device.
+ *
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP
+ * @param datToSend The data to write to the register on the device.
+ * @param sendSize The number of bytes to be written
+ * @return The number of bytes written. -1 for an error
+ */
+int32_t spiWrite(uint8_t port, uint8_t* dataToSend, uint8_t sendSize)
+{
+	std::lock_guard<priority_recursive_mutex> sync(spiGetSemaphore(port));
+	if (spiGetHandle(port) == 0) return -1;
+	std::lock_guard<std::mutex> busSync(busMutex);
+	spiBuses[port].Transfer(dataToSend, sendSize, nullptr, 0);
+	return sendSize;
+}
+
+/**
+ * Execute a read from the device.
+ *
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP
+ * @param buffer A pointer to the array of bytes to store the data read from the device.
+ * @param count The number of bytes to read in the transaction. [1..7]
+ * @return Number of bytes read. -1 for error.
+ */
+int32_t spiRead(uint8_t port, uint8_t *buffer, uint8_t count)
+{
+	std::lock_guard<priority_recursive_mutex> sync(spiGetSemaphore(port));
+	if (spiGetHandle(port) == 0) return -1;
+	std::lock_guard<std::mutex> busSync(busMutex);
+	spiBuses[port].Transfer(nullptr, 0, buffer, count);
+	return count;
+}
+
+/**
+ * Close the SPI port
+ *
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP
+ */
+void spiClose(uint8_t port) {
+	std::lock_guard<priority_recursive_mutex> sync(spiGetSemaphore(port));
+	spiSetHandle(port, 0);
+}
+
+// There's no clock or chip select to configure on the desktop.
+void spiSetSpeed(uint8_t port, uint32_t speed) {}
+void spiSetOpts(uint8_t port, int msb_first, int sample_on_trailing, int clk_idle_high) {}
+void spiSetChipSelectActiveHigh(uint8_t port, int32_t *status) {}
+void spiSetChipSelectActiveLow(uint8_t port, int32_t *status) {}
+
+/**
+ * Get the stored handle for a SPI port
+ *
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP
+ * @return The stored handle for the SPI port. 0 represents no stored handle.
+ */
+int32_t spiGetHandle(uint8_t port){
+	if (port >= kNumSPIPorts) return 0;
+	std::lock_guard<std::mutex> sync(busMutex);
+	return spiBuses[port].handle;
+}
+
+/**
+ * Set the stored handle for a SPI port
+ *
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP.
+ * @param handle The value of the handle for the port.
+ */
+void spiSetHandle(uint8_t port, int32_t handle){
+	if (port >= kNumSPIPorts) return;
+	std::lock_guard<std::mutex> sync(busMutex);
+	spiBuses[port].handle = handle;
+}
+
+/**
+ * Get the semaphore for a SPI port
+ *
+ * @param port The number of the port to use. 0-3 for Onboard CS0-CS2, 4 for MXP
+ * @return The semaphore for the SPI port.
+ */
+priority_recursive_mutex& spiGetSemaphore(uint8_t port) {
+	if(port < 4)
+		return spiOnboardSemaphore;
+	else
+		return spiMXPSemaphore;
+}
+
+/*
+ * Initialize the I2C port. Opens the port if necessary and saves the handle.
+ * If opening the MXP port, also sets up the pin functions appropriately
+ * @param port The port to open, 0 for the on-board, 1 for the MXP.
+ */
+void i2CInitialize(uint8_t port, int32_t *status) {
+	initializeDigital(status);
+
+	if(port > 1)
+	{
+		//Set port out of range error here
+		return;
+	}
+
+	priority_recursive_mutex &lock = port == 0 ? digitalI2COnBoardMutex : digitalI2CMXPMutex;
+	std::lock_guard<priority_recursive_mutex> sync(lock);
+	if(port == 0) {
+		i2COnboardObjCount++;
+	} else {
+		i2CMXPObjCount++;
+	}
+	if (i2cBuses[port].handle > 0) return;
+	if(port == 1) {
+		if(!allocateDIO(getPort(24), false, status)) return;
+		if(!allocateDIO(getPort(25), false, status)) return;
+	}
+	std::lock_guard<std::mutex> busSync(busMutex);
+	i2cBuses[port].handle = port + 1;
+}
+
+/**
+ * Generic transaction.
+ *
+ * @param dataToSend Buffer of data to send as part of the transaction.
+ * @param sendSize Number of bytes to send as part of the transaction.
+ * @param dataReceived Buffer to read data into.
+ * @param receiveSize Number of bytes to read from the device.
+ * @return Transfer Aborted... false for success, true for aborted.
+ */
+int32_t i2CTransaction(uint8_t port, uint8_t deviceAddress, uint8_t *dataToSend, uint8_t sendSize, uint8_t *dataReceived, uint8_t receiveSize)
+{
+	if(port > 1) {
+		//Set port out of range error here
+		return -1;
+	}
+
+	priority_recursive_mutex &lock = port == 0 ? digitalI2COnBoardMutex : digitalI2CMXPMutex;
+	std::lock_guard<priority_recursive_mutex> sync(lock);
+	std::lock_guard<std::mutex> busSync(busMutex);
+	if (i2cBuses[port].handle == 0) return -1;
+	i2cBuses[port].Transfer(dataToSend, sendSize, dataReceived, receiveSize);
+	return 0;
+}
+
+/**
+ * Execute a write transaction with the device.
+ *
+ * @return Transfer Aborted... false for success, true for aborted.
+ */
+int32_t i2CWrite(uint8_t port, uint8_t deviceAddress, uint8_t* dataToSend, uint8_t sendSize)
+{
+	return i2CTransaction(port, deviceAddress, dataToSend, sendSize, nullptr, 0);
+}
+
+/**
+ * Execute a read transaction with the device.
+ *
+ * @return Transfer Aborted... false for success, true for aborted.
+ */
+int32_t i2CRead(uint8_t port, uint8_t deviceAddress, uint8_t *buffer, uint8_t count)
+{
+	return i2CTransaction(port, deviceAddress, nullptr, 0, buffer, count);
+}
+
+void i2CClose(uint8_t port) {
+	if(port > 1) {
+		//Set port out of range error here
+		return;
+	}
+	priority_recursive_mutex &lock = port == 0 ? digitalI2COnBoardMutex : digitalI2CMXPMutex;
+	std::lock_guard<priority_recursive_mutex> sync(lock);
+	if((port == 0 ? i2COnboardObjCount--:i2CMXPObjCount--) == 0) {
+		std::lock_guard<std::mutex> busSync(busMutex);
+		i2cBuses[port].handle = 0;
+	}
+}
+
+void resetDigital() {
+  {
+    std::lock_guard<priority_recursive_mutex> sync(digitalDIOMutex);
+    dioOutputs = 0;
+    dioInputs = 0;
+  }
+  for (uint32_t pin = 0; pin < kDigitalPins; pin++) dioPulseEnd[pin] = 0;
+  for (uint32_t pin = 0; pin < kPwmPins; pin++) {
+    pwmValues[pin] = kPwmDisabled;
+    pwmPeriodScales[pin] = 0;
+  }
+  relayForward = 0;
+  relayReverse = 0;
+
+  std::lock_guard<std::mutex> sync(counterMutex);
+  for (uint32_t i = 0; i < kNumCounters; i++) {
+    if (counterSlots[i] == nullptr) continue;
+    counterSlots[i]->count = 0;
+    counterSlots[i]->timer.hasEdge = false;
+  }
+  for (uint32_t i = 0; i < kNumEncoders; i++) {
+    if (encoderSlots[i] == nullptr) continue;
+    encoderSlots[i]->count = 0;
+    encoderSlots[i]->aLevel = false;
+    encoderSlots[i]->bLevel = false;
+    encoderSlots[i]->timer.hasEdge = false;
+  }
+}
+
+void resetBuses() {
+  std::lock_guard<std::mutex> sync(busMutex);
+  for (Bus &bus : spiBuses) {
+    bus.input.clear();
+    bus.output.clear();
+  }
+  for (Bus &bus : i2cBuses) {
+    bus.input.clear();
+    bus.output.clear();
+  }
+}
+
+namespace hal {
+namespace desktop {
+
+void SetDigitalInput(uint32_t pin, bool value) {
+  if (pin >= kDigitalPins) return;
+  std::lock_guard<priority_recursive_mutex> sync(digitalDIOMutex);
+  changePins([&] {
+    if (value) {
+      dioInputs |= 1u << pin;
+    } else {
+      dioInputs &= ~(1u << pin);
+    }
+  });
+}
+
+bool GetDigitalOutput(uint32_t pin) {
+  if (pin >= kDigitalPins) return false;
+  return (dioOutputs & (1u << pin)) != 0 || desktopTime() < dioPulseEnd[pin];
+}
+
+bool IsDigitalOutput(uint32_t pin) {
+  return pin < kDigitalPins && (dioOutputEnable & (1u << pin)) != 0;
+}
+
+bool IsPulsing(uint32_t pin) {
+  return pin < kDigitalPins && desktopTime() < dioPulseEnd[pin];
+}
+
+uint16_t GetPWM(uint32_t channel) {
+  return channel < kPwmPins ? pwmValues[channel].load() : 0;
+}
+
+uint32_t GetPWMPeriodScale(uint32_t channel) {
+  return channel < kPwmPins ? pwmPeriodScales[channel].load() : 0;
+}
+
+bool GetRelayForward(uint32_t channel) {
+  return channel < kRelayPins && (relayForward & (1 << channel)) != 0;
+}
+
+bool GetRelayReverse(uint32_t channel) {
+  return channel < kRelayPins && (relayReverse & (1 << channel)) != 0;
+}
+
+void SetCounter(uint32_t index, int32_t count, double period) {
+  if (index >= kNumCounters) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  Counter* counter = counterSlots[index];
+  if (counter == nullptr) return;
+  counter->direction = count >= counter->count;
+  counter->count = count;
+  counter->timer.Set(period);
+}
+
+void SetEncoder(uint32_t index, int32_t count, double period) {
+  if (index >= kNumEncoders) return;
+  std::lock_guard<std::mutex> sync(counterMutex);
+  Encoder* encoder = encoderSlots[index];
+  if (encoder == nullptr) return;
+  encoder->direction = count >= encoder->count;
+  encoder->count = count;
+  encoder->timer.Set(period * DECODING_SCALING_FACTOR);
+}
+
+void PushSPIInput(uint8_t port, const std::string &bytes) {
+  if (port >= kNumSPIPorts) return;
+  std::lock_guard<std::mutex> sync(busMutex);
+  spiBuses[port].input.insert(spiBuses[port].input.end(), bytes.begin(), bytes.end());
+}
+
+std::string TakeSPIOutput(uint8_t port) {
+  if (port >= kNumSPIPorts) return "";
+  std::lock_guard<std::mutex> sync(busMutex);
+  std::string output;
+  output.swap(spiBuses[port].output);
+  return output;
+}
+
+void PushI2CInput(uint8_t port, const std::string &bytes) {
+  if (port >= kNumI2CPorts) return;
+  std::lock_guard<std::mutex> sync(busMutex);
+  i2cBuses[port].input.insert(i2cBuses[port].input.end(), bytes.begin(), bytes.end());
+}
+
+std::string TakeI2COutput(uint8_t port) {
+  if (port >= kNumI2CPorts) return "";
+  std::lock_guard<std::mutex> sync(busMutex);
+  std::string output;
+  output.swap(i2cBuses[port].output);
+  return output;
+}
+
+}  // namespace desktop
+}  // namespace hal
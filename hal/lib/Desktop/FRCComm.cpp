@@ -0,0 +1,198 @@
+/*
+ * The parts of the network communication library the HAL uses, kept in
+ * memory. Tests stand in for the driver station through the hooks in
+ * HALDesktop.hpp.
+ */
+#include "FRC_NetworkCommunication/FRCComm.h"
+
+#include "HAL/HAL.hpp"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <mutex>
+#include <string.h>
+
+static const uint8_t kJoystickPorts = 6;
+
+struct Joystick {
+  HALJoystickAxes axes;
+  HALJoystickPOVs povs;
+  HALJoystickButtons buttons;
+  HALJoystickDescriptor descriptor;
+  uint32_t outputs;
+  uint16_t leftRumble;
+  uint16_t rightRumble;
+};
+
+static std::mutex dsMutex;
+static ControlWord_t controlWord;
+static AllianceStationID_t allianceStation;
+static float matchTime;
+static Joystick joysticks[kJoystickPorts];
+static std::string errorData;
+static pthread_cond_t *newDataSem = nullptr;
+
+void resetDriverStation() {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  memset(&controlWord, 0, sizeof(controlWord));
+  allianceStation = kAllianceStationID_red1;
+  matchTime = -1.0f;
+  memset(joysticks, 0, sizeof(joysticks));
+  errorData.clear();
+}
+
+int FRC_NetworkCommunication_Reserve(void *instance) {
+  return 0;
+}
+
+int setErrorData(const char *errors, int errorsLength, int wait_ms) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  errorData.append(errors, errorsLength);
+  return 0;
+}
+
+void setNewDataSem(pthread_cond_t *sem) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  newDataSem = sem;
+}
+
+int FRC_NetworkCommunication_getControlWord(struct ControlWord_t *data) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  *data = controlWord;
+  return 0;
+}
+
+int FRC_NetworkCommunication_getAllianceStation(enum AllianceStationID_t *data) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  *data = allianceStation;
+  return 0;
+}
+
+int FRC_NetworkCommunication_getMatchTime(float *data) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  *data = matchTime;
+  return 0;
+}
+
+int FRC_NetworkCommunication_getJoystickAxes(uint8_t joystickNum, struct JoystickAxes_t *axes, uint8_t maxAxes) {
+  if (joystickNum >= kJoystickPorts) return -1;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  const HALJoystickAxes &source = joysticks[joystickNum].axes;
+  axes->count = source.count < maxAxes ? source.count : maxAxes;
+  // axes is really as long as maxAxes
+  memcpy(axes->axes, source.axes, axes->count * sizeof(int16_t));
+  return 0;
+}
+
+int FRC_NetworkCommunication_getJoystickButtons(uint8_t joystickNum, uint32_t *buttons, uint8_t *count) {
+  if (joystickNum >= kJoystickPorts) return -1;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  *buttons = joysticks[joystickNum].buttons.buttons;
+  *count = joysticks[joystickNum].buttons.count;
+  return 0;
+}
+
+int FRC_NetworkCommunication_getJoystickPOVs(uint8_t joystickNum, struct JoystickPOV_t *povs, uint8_t maxPOVs) {
+  if (joystickNum >= kJoystickPorts) return -1;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  const HALJoystickPOVs &source = joysticks[joystickNum].povs;
+  povs->count = source.count < maxPOVs ? source.count : maxPOVs;
+  memcpy(povs->povs, source.povs, povs->count * sizeof(int16_t));
+  return 0;
+}
+
+int FRC_NetworkCommunication_setJoystickOutputs(uint8_t joystickNum, uint32_t hidOutputs, uint16_t leftRumble, uint16_t rightRumble) {
+  if (joystickNum >= kJoystickPorts) return -1;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  joysticks[joystickNum].outputs = hidOutputs;
+  joysticks[joystickNum].leftRumble = leftRumble;
+  joysticks[joystickNum].rightRumble = rightRumble;
+  return 0;
+}
+
+int FRC_NetworkCommunication_getJoystickDesc(uint8_t joystickNum, uint8_t *isXBox, uint8_t *type, char *name,
+    uint8_t *axisCount, uint8_t *axisTypes, uint8_t *buttonCount, uint8_t *povCount) {
+  if (joystickNum >= kJoystickPorts) return -1;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  const HALJoystickDescriptor &desc = joysticks[joystickNum].descriptor;
+  *isXBox = desc.isXbox;
+  *type = desc.type;
+  memcpy(name, desc.name, sizeof(desc.name));
+  *axisCount = desc.axisCount;
+  memcpy(axisTypes, desc.axisTypes, sizeof(desc.axisTypes));
+  *buttonCount = desc.buttonCount;
+  *povCount = desc.povCount;
+  return 0;
+}
+
+// There's no driver station to tell what the robot program is doing.
+int FRC_NetworkCommunication_observeUserProgramStarting(void) { return 0; }
+void FRC_NetworkCommunication_observeUserProgramDisabled(void) {}
+void FRC_NetworkCommunication_observeUserProgramAutonomous(void) {}
+void FRC_NetworkCommunication_observeUserProgramTeleop(void) {}
+void FRC_NetworkCommunication_observeUserProgramTest(void) {}
+
+namespace hal {
+namespace desktop {
+
+void SetControlWord(const HALControlWord &word) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  memcpy(&controlWord, &word, sizeof(controlWord));
+}
+
+void SetAllianceStation(HALAllianceStationID station) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  allianceStation = (AllianceStationID_t)station;
+}
+
+void SetMatchTime(float time) {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  matchTime = time;
+}
+
+void SetJoystickAxes(uint8_t joystickNum, const HALJoystickAxes &axes) {
+  if (joystickNum >= kJoystickPorts) return;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  joysticks[joystickNum].axes = axes;
+}
+
+void SetJoystickPOVs(uint8_t joystickNum, const HALJoystickPOVs &povs) {
+  if (joystickNum >= kJoystickPorts) return;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  joysticks[joystickNum].povs = povs;
+}
+
+void SetJoystickButtons(uint8_t joystickNum, const HALJoystickButtons &buttons) {
+  if (joystickNum >= kJoystickPorts) return;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  joysticks[joystickNum].buttons = buttons;
+}
+
+void SetJoystickDescriptor(uint8_t joystickNum, const HALJoystickDescriptor &desc) {
+  if (joystickNum >= kJoystickPorts) return;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  joysticks[joystickNum].descriptor = desc;
+}
+
+void GetJoystickOutputs(uint8_t joystickNum, uint32_t *outputs,
+                        uint16_t *leftRumble, uint16_t *rightRumble) {
+  if (joystickNum >= kJoystickPorts) return;
+  std::lock_guard<std::mutex> sync(dsMutex);
+  *outputs = joysticks[joystickNum].outputs;
+  *leftRumble = joysticks[joystickNum].leftRumble;
+  *rightRumble = joysticks[joystickNum].rightRumble;
+}
+
+void NotifyNewData() {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  if (newDataSem != nullptr) pthread_cond_broadcast(newDataSem);
+}
+
+std::string TakeErrorData() {
+  std::lock_guard<std::mutex> sync(dsMutex);
+  std::string errors;
+  errors.swap(errorData);
+  return errors;
+}
+
+}  // namespace desktop
+}  // namespace hal
@@ -1 +1,247 @@
-//nothing here yet!
\ No newline at end of file
+#include "HAL/HAL.hpp"
+
+#include "HAL/Port.h"
+#include "HAL/Errors.hpp"
+#include "ctre/ctre.h"
+#include "FRC_NetworkCommunication/FRCComm.h"
+#include "FRC_NetworkCommunication/CANSessionMux.h"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+
+const uint32_t solenoid_kNumDO7_0Elements = 8;
+const uint32_t dio_kNumSystems = 1;
+const uint32_t interrupt_kNumSystems = 8;
+const uint32_t kSystemClockTicksPerMicrosecond = 40;
+
+static const uint16_t kFPGAVersion = 2015;
+
+static std::atomic<bool> systemActive(true);
+static std::atomic<bool> brownedOut(false);
+static std::atomic<bool> fpgaButton(false);
+
+/*
+ * The FPGA clock. It follows steady_clock from an epoch that moves when the
+ * time is set, unless it's been switched to manual, when it's just a number.
+ */
+static std::atomic<int64_t> clockEpoch(
+    std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+static std::atomic<bool> clockManual(false);
+static std::atomic<uint64_t> manualTime(0);
+
+static int64_t steadyMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t desktopTime() {
+  if (clockManual) return manualTime;
+  return steadyMicroseconds() - clockEpoch;
+}
+
+void setDesktopTime(uint64_t microseconds) {
+  manualTime = microseconds;
+  clockEpoch = steadyMicroseconds() - (int64_t)microseconds;
+}
+
+bool isDesktopClockManual() {
+  return clockManual;
+}
+
+void* getPort(uint8_t pin)
+{
+	Port* port = new Port();
+	port->pin = pin;
+	port->module = 1;
+	return port;
+}
+
+/**
+ * @deprecated Uses module numbers
+ */
+void* getPortWithModule(uint8_t module, uint8_t pin)
+{
+	Port* port = new Port();
+	port->pin = pin;
+	port->module = module;
+	return port;
+}
+
+const char* getHALErrorMessage(int32_t code)
+{
+	switch(code) {
+		case 0:
+			return "";
+		case CTR_RxTimeout:
+			return CTR_RxTimeout_MESSAGE;
+		case CTR_TxTimeout:
+			return CTR_TxTimeout_MESSAGE;
+		case CTR_InvalidParamValue:
+			return CTR_InvalidParamValue_MESSAGE;
+		case CTR_UnexpectedArbId:
+			return CTR_UnexpectedArbId_MESSAGE;
+		case CTR_TxFailed:
+			return CTR_TxFailed_MESSAGE;
+		case CTR_SigNotUpdated:
+			return CTR_SigNotUpdated_MESSAGE;
+		case SAMPLE_RATE_TOO_HIGH:
+			return SAMPLE_RATE_TOO_HIGH_MESSAGE;
+		case VOLTAGE_OUT_OF_RANGE:
+			return VOLTAGE_OUT_OF_RANGE_MESSAGE;
+		case LOOP_TIMING_ERROR:
+			return LOOP_TIMING_ERROR_MESSAGE;
+		case SPI_WRITE_NO_MOSI:
+			return SPI_WRITE_NO_MOSI_MESSAGE;
+		case SPI_READ_NO_MISO:
+			return SPI_READ_NO_MISO_MESSAGE;
+		case SPI_READ_NO_DATA:
+			return SPI_READ_NO_DATA_MESSAGE;
+		case INCOMPATIBLE_STATE:
+			return INCOMPATIBLE_STATE_MESSAGE;
+		case NO_AVAILABLE_RESOURCES:
+			return NO_AVAILABLE_RESOURCES_MESSAGE;
+		case NULL_PARAMETER:
+			return NULL_PARAMETER_MESSAGE;
+		case ANALOG_TRIGGER_LIMIT_ORDER_ERROR:
+			return ANALOG_TRIGGER_LIMIT_ORDER_ERROR_MESSAGE;
+		case ANALOG_TRIGGER_PULSE_OUTPUT_ERROR:
+			return ANALOG_TRIGGER_PULSE_OUTPUT_ERROR_MESSAGE;
+		case PARAMETER_OUT_OF_RANGE:
+			return PARAMETER_OUT_OF_RANGE_MESSAGE;
+		case RESOURCE_IS_ALLOCATED:
+			return RESOURCE_IS_ALLOCATED_MESSAGE;
+		case HAL_HANDLE_ERROR:
+			return HAL_HANDLE_ERROR_MESSAGE;
+		case ERR_CANSessionMux_InvalidBuffer:
+			return ERR_CANSessionMux_InvalidBuffer_MESSAGE;
+		case ERR_CANSessionMux_MessageNotFound:
+			return ERR_CANSessionMux_MessageNotFound_MESSAGE;
+		case WARN_CANSessionMux_NoToken:
+			return WARN_CANSessionMux_NoToken_MESSAGE;
+		case ERR_CANSessionMux_NotAllowed:
+			return ERR_CANSessionMux_NotAllowed_MESSAGE;
+		case ERR_CANSessionMux_NotInitialized:
+			return ERR_CANSessionMux_NotInitialized_MESSAGE;
+		default:
+			return "Unknown error status";
+	}
+}
+
+/**
+ * Return the FPGA Version number.
+ * There's no FPGA on the desktop, so this is the version the HAL was written
+ * against.
+ */
+uint16_t getFPGAVersion(int32_t *status)
+{
+	return kFPGAVersion;
+}
+
+uint32_t getFPGARevision(int32_t *status)
+{
+	return 0;
+}
+
+/**
+ * Read the microsecond-resolution timer on the FPGA.
+ *
+ * @return The current time in microseconds since the HAL was loaded, or since
+ * the time was last set by a test.
+ */
+uint32_t getFPGATime(int32_t *status)
+{
+	return (uint32_t)desktopTime();
+}
+
+bool getFPGAButton(int32_t *status)
+{
+	return fpgaButton;
+}
+
+int HALSetErrorData(const char *errors, int errorsLength, int wait_ms)
+{
+	return setErrorData(errors, errorsLength, wait_ms);
+}
+
+bool HALGetSystemActive(int32_t *status)
+{
+	return systemActive;
+}
+
+bool HALGetBrownedOut(int32_t *status)
+{
+	return brownedOut;
+}
+
+/**
+ * Call this to start up HAL. On the desktop there's no other robot program
+ * to stop and no FPGA to open, so this can't fail.
+ */
+int HALInitialize(int mode)
+{
+	setlinebuf(stdin);
+	setlinebuf(stdout);
+
+	FRC_NetworkCommunication_Reserve(nullptr);
+	return 1;
+}
+
+uint32_t HALReport(uint8_t resource, uint8_t instanceNumber, uint8_t context,
+		const char *feature)
+{
+	return 0;
+}
+
+namespace hal {
+namespace desktop {
+
+void Reset() {
+  systemActive = true;
+  brownedOut = false;
+  fpgaButton = false;
+  setDesktopTime(0);
+  resetDriverStation();
+  resetDigital();
+  resetAnalog();
+  resetInterrupts();
+  resetPneumatics();
+  resetPower();
+  resetPDP();
+  resetAccelerometer();
+  resetSerial();
+  resetBuses();
+  resetCAN();
+  clockChanged();
+}
+
+void SetManualClock(bool manual) {
+  uint64_t now = desktopTime();
+  clockManual = manual;
+  setDesktopTime(now);
+  clockChanged();
+}
+
+uint64_t GetTime() { return desktopTime(); }
+
+void SetTime(uint64_t microseconds) {
+  if (clockManual && microseconds >= desktopTime()) {
+    runNotifiersUntil(microseconds);
+  } else {
+    setDesktopTime(microseconds);
+  }
+  clockChanged();
+}
+
+void StepTime(uint64_t microseconds) { SetTime(desktopTime() + microseconds); }
+
+void SetSystemActive(bool active) { systemActive = active; }
+
+void SetFPGAButton(bool pressed) { fpgaButton = pressed; }
+
+void SetBrownedOut(bool brownedOut) { ::brownedOut = brownedOut; }
+
+}  // namespace desktop
+}  // namespace hal
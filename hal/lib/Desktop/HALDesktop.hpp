@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include "HAL/HAL.hpp"
+
+/**
+ * Hooks into the desktop HAL's in-memory device model.
+ *
+ * The desktop HAL implements the HAL API on plain memory instead of the
+ * roboRIO FPGA, so WPILib classes can be run and unit tested on a developer
+ * machine. Tests use these functions to play the part of the outside world:
+ * they set the inputs sensors would read, and read back what the robot code
+ * wrote to its outputs.
+ *
+ * Channels are numbered the same way as in the HAL API. Inputs changed here
+ * take effect immediately; edges on digital inputs update counters, encoders
+ * and interrupts routed to them, and interrupt handlers are called from the
+ * thread that changed the input.
+ */
+namespace hal {
+namespace desktop {
+
+/**
+ * Put every input and output back to its power on value, and the clock back
+ * to zero. Ports and handles that are still allocated stay allocated.
+ */
+void Reset();
+
+/**
+ * Stop the FPGA clock from following real time, so that it only moves when
+ * SetTime() or StepTime() is called. Notifier alarms that come due while
+ * stepping are run from the stepping thread before it returns.
+ */
+void SetManualClock(bool manual);
+/** The FPGA time in microseconds, as returned by getFPGATime(). */
+uint64_t GetTime();
+void SetTime(uint64_t microseconds);
+void StepTime(uint64_t microseconds);
+
+// Driver station
+void SetControlWord(const HALControlWord &controlWord);
+void SetAllianceStation(HALAllianceStationID allianceStation);
+void SetMatchTime(float matchTime);
+void SetJoystickAxes(uint8_t joystickNum, const HALJoystickAxes &axes);
+void SetJoystickPOVs(uint8_t joystickNum, const HALJoystickPOVs &povs);
+void SetJoystickButtons(uint8_t joystickNum, const HALJoystickButtons &buttons);
+void SetJoystickDescriptor(uint8_t joystickNum, const HALJoystickDescriptor &desc);
+/** The outputs and rumble last set with HALSetJoystickOutputs(). */
+void GetJoystickOutputs(uint8_t joystickNum, uint32_t *outputs,
+                        uint16_t *leftRumble, uint16_t *rightRumble);
+/**
+ * Wake up anything waiting on the semaphore given to HALSetNewDataSem(), as
+ * the network communication library does when a driver station packet
+ * arrives.
+ */
+void NotifyNewData();
+/** Everything sent with HALSetErrorData() since the last call. */
+std::string TakeErrorData();
+
+// Power and system state
+void SetSystemActive(bool active);
+void SetFPGAButton(bool pressed);
+void SetBrownedOut(bool brownedOut);
+void SetVinVoltage(float voltage);
+void SetVinCurrent(float current);
+/** Turn off the 6V, 5V or 3.3V user rail, as a short circuit would. */
+void SetUserRailActive(float nominalVoltage, bool active);
+
+// Digital I/O
+/** Drive a digital input, including one on the MXP, high or low. */
+void SetDigitalInput(uint32_t pin, bool value);
+/** The value the robot code is driving a digital output to. */
+bool GetDigitalOutput(uint32_t pin);
+/** True if the pin is allocated as an output. */
+bool IsDigitalOutput(uint32_t pin);
+bool IsPulsing(uint32_t pin);
+/** The raw value last written to a PWM channel. */
+uint16_t GetPWM(uint32_t channel);
+/** The squelch mask last given to setPWMPeriodScale(). */
+uint32_t GetPWMPeriodScale(uint32_t channel);
+bool GetRelayForward(uint32_t channel);
+bool GetRelayReverse(uint32_t channel);
+/**
+ * Overwrite the count and period of an FPGA counter or encoder, given the
+ * index the HAL returned when it was created. Edges on their sources count
+ * on from the new value.
+ */
+void SetCounter(uint32_t index, int32_t count, double period);
+void SetEncoder(uint32_t index, int32_t count, double period);
+
+// Analog I/O
+/** Set the voltage on an analog input, in volts. */
+void SetAnalogInput(uint32_t channel, double voltage);
+double GetAnalogOutput(uint32_t channel);
+void SetAccelerometer(double x, double y, double z);
+
+// Pneumatics and power distribution
+bool GetSolenoid(uint8_t module, uint32_t channel);
+/** Turn off solenoid channels, the way the PCM does after a short. */
+void SetSolenoidBlackList(uint8_t module, uint8_t mask);
+/** True if closed loop control has the compressor running. */
+bool GetCompressorOn(uint8_t module);
+/** Set whether the pressure switch says the tanks are full. */
+void SetPressureSwitch(uint8_t module, bool full);
+void SetCompressorCurrent(uint8_t module, float current);
+void SetPDPVoltage(uint8_t module, double voltage);
+void SetPDPTemperature(uint8_t module, double temperature);
+void SetPDPChannelCurrent(uint8_t module, uint8_t channel, double current);
+
+// Buses, as byte streams. Bytes pushed are returned by the next reads, and
+// reads past them return zeros.
+void PushSPIInput(uint8_t port, const std::string &bytes);
+std::string TakeSPIOutput(uint8_t port);
+void PushI2CInput(uint8_t port, const std::string &bytes);
+std::string TakeI2COutput(uint8_t port);
+void PushSerialInput(uint8_t port, const std::string &bytes);
+std::string TakeSerialOutput(uint8_t port);
+
+/**
+ * Receive a CAN frame, as if a device had sent it. It's returned by
+ * receiveMessage for its ID until replaced, and queued to every stream
+ * session it matches.
+ */
+void ReceiveCANFrame(uint32_t messageID, const uint8_t *data, uint8_t dataSize);
+/**
+ * The last frame the robot code sent with an ID.
+ * @param periodMs The period it's being repeated at, or
+ * CAN_SEND_PERIOD_NO_REPEAT.
+ * @return False if nothing has been sent with that ID.
+ */
+bool GetSentCANFrame(uint32_t messageID, uint8_t *data, uint8_t *dataSize,
+                     int32_t *periodMs);
+
+}  // namespace desktop
+}  // namespace hal
@@ -0,0 +1,223 @@
+#include "HAL/Interrupts.hpp"
+#include "HAL/HAL.hpp"
+#include "HAL/cpp/HandleTable.hpp"
+#include "DesktopInternal.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+static const uint32_t kNumInterrupts = 8;
+
+/*
+ * An interrupt watches one digital source. Synchronous (watcher) interrupts
+ * keep the edges they see until waitForInterrupt() picks them up; the others
+ * call their handler straight away, from the thread that changed the input.
+ */
+struct Interrupt
+{
+	uint32_t index;
+	bool watcher;
+	bool enabled;
+	bool routed;
+	uint32_t pin;
+	bool analogTrigger;
+	bool risingEdge;
+	bool fallingEdge;
+	uint64_t risingTimestamp;
+	uint64_t fallingTimestamp;
+	uint32_t assertedMask;
+	InterruptHandlerFunction handler;
+	void *param;
+};
+
+static hal::HandleTable<Interrupt, kNumInterrupts,
+                        hal::HandleType::Interrupt> interrupts;
+
+static std::mutex interruptMutex;
+static std::condition_variable interruptAsserted;
+static Interrupt* interruptSlots[kNumInterrupts];
+
+void* initializeInterrupts(uint32_t interruptIndex, bool watcher, int32_t *status)
+{
+	uint32_t handle = interrupts.Allocate();
+	if (handle == interrupts.kInvalidHandle) {
+		*status = NO_AVAILABLE_RESOURCES;
+		return NULL;
+	}
+	Interrupt* anInterrupt = interrupts.Get(handle);
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	// Expects the calling leaf class to allocate an interrupt index.
+	anInterrupt->index = interruptIndex;
+	anInterrupt->watcher = watcher;
+	anInterrupt->risingEdge = true;
+	interruptSlots[interrupts.GetIndex(handle)] = anInterrupt;
+	return interrupts.HandleToPointer(handle);
+}
+
+void cleanInterrupts(void* interrupt_pointer, int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
+	{
+		std::lock_guard<std::mutex> sync(interruptMutex);
+		for (Interrupt *&slot : interruptSlots) {
+			if (slot == anInterrupt) slot = nullptr;
+		}
+	}
+	interrupts.Free(interrupt_pointer);
+}
+
+/**
+ * In synchronous mode, wait for the defined interrupt to occur.
+ * @param timeout Timeout in seconds, of real time even if the clock is manual
+ * @param ignorePrevious If true, ignore interrupts that happened before
+ * waitForInterrupt was called.
+ * @return The mask of interrupts that fired.
+ */
+uint32_t waitForInterrupt(void* interrupt_pointer, double timeout, bool ignorePrevious, int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return 0;
+
+	std::unique_lock<std::mutex> sync(interruptMutex);
+	if (ignorePrevious) anInterrupt->assertedMask = 0;
+	// Don't report a timeout as an error - the return code is enough to tell
+	// that a timeout happened.
+	interruptAsserted.wait_for(sync, std::chrono::duration<double>(timeout),
+		[&] { return anInterrupt->assertedMask != 0; });
+	uint32_t result = anInterrupt->assertedMask;
+	anInterrupt->assertedMask = 0;
+	return result;
+}
+
+/**
+ * Enable interrupts to occur on this input.
+ * Interrupts are disabled when the RequestInterrupt call is made. This gives time to do the
+ * setup of the other options before starting to field interrupts.
+ */
+void enableInterrupts(void* interrupt_pointer, int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	anInterrupt->enabled = true;
+}
+
+/**
+ * Disable Interrupts without without deallocating structures.
+ */
+void disableInterrupts(void* interrupt_pointer, int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	anInterrupt->enabled = false;
+}
+
+/**
+ * Return the timestamp for the rising interrupt that occurred most recently.
+ * This is in the same time domain as GetClock().
+ * @return Timestamp in seconds since boot.
+ */
+double readRisingTimestamp(void* interrupt_pointer, int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return 0.0;
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	uint32_t timestamp = anInterrupt->risingTimestamp;
+	return timestamp * 1e-6;
+}
+
+/**
+* Return the timestamp for the falling interrupt that occurred most recently.
+* This is in the same time domain as GetClock().
+* @return Timestamp in seconds since boot.
+*/
+double readFallingTimestamp(void* interrupt_pointer, int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return 0.0;
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	uint32_t timestamp = anInterrupt->fallingTimestamp;
+	return timestamp * 1e-6;
+}
+
+void requestInterrupts(void* interrupt_pointer, uint8_t routing_module, uint32_t routing_pin,
+		bool routing_analog_trigger, int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	anInterrupt->routed = true;
+	anInterrupt->pin = routing_pin;
+	anInterrupt->analogTrigger = routing_analog_trigger;
+}
+
+void attachInterruptHandler(void* interrupt_pointer, InterruptHandlerFunction handler, void* param,
+		int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	anInterrupt->handler = handler;
+	anInterrupt->param = param;
+}
+
+void setInterruptUpSourceEdge(void* interrupt_pointer, bool risingEdge, bool fallingEdge,
+		int32_t *status)
+{
+	Interrupt* anInterrupt = interrupts.Get(interrupt_pointer, status);
+	if (anInterrupt == nullptr) return;
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	anInterrupt->risingEdge = risingEdge;
+	anInterrupt->fallingEdge = fallingEdge;
+}
+
+void interruptSourceChanged(uint32_t pin, bool analogTrigger, bool value)
+{
+	struct Call {
+		InterruptHandlerFunction handler;
+		uint32_t mask;
+		void *param;
+	};
+	std::vector<Call> calls;
+	uint64_t now = desktopTime();
+	{
+		std::lock_guard<std::mutex> sync(interruptMutex);
+		for (Interrupt *anInterrupt : interruptSlots) {
+			if (anInterrupt == nullptr || !anInterrupt->routed) continue;
+			if (anInterrupt->pin != pin || anInterrupt->analogTrigger != analogTrigger) continue;
+			if (!(value ? anInterrupt->risingEdge : anInterrupt->fallingEdge)) continue;
+
+			uint32_t mask;
+			if (value) {
+				anInterrupt->risingTimestamp = now;
+				mask = 1 << anInterrupt->index;
+			} else {
+				anInterrupt->fallingTimestamp = now;
+				mask = 1 << (anInterrupt->index + 8);
+			}
+			if (anInterrupt->watcher) {
+				anInterrupt->assertedMask |= mask;
+			} else if (anInterrupt->enabled && anInterrupt->handler != nullptr) {
+				calls.push_back({anInterrupt->handler, mask, anInterrupt->param});
+			}
+		}
+	}
+	interruptAsserted.notify_all();
+	for (const Call &call : calls) {
+		call.handler(call.mask, call.param);
+	}
+}
+
+void resetInterrupts()
+{
+	std::lock_guard<std::mutex> sync(interruptMutex);
+	for (Interrupt *anInterrupt : interruptSlots) {
+		if (anInterrupt == nullptr) continue;
+		anInterrupt->risingTimestamp = 0;
+		anInterrupt->fallingTimestamp = 0;
+		anInterrupt->assertedMask = 0;
+	}
+}
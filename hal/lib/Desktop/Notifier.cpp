@@ -0,0 +1,197 @@
+#include "HAL/Notifier.hpp"
+#include "HAL/HAL.hpp"
+#include "DesktopInternal.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const uint32_t kTimerInterruptNumber = 28;
+
+/*
+ * The alarms are kept as 64 bit times, so they don't wrap with the FPGA
+ * clock. One thread fires them while the clock follows real time. When the
+ * clock is manual, they're fired by whichever thread moves the clock instead,
+ * so a test knows that everything that was due has run when StepTime()
+ * returns.
+ *
+ * Handlers are called one at a time, with the lock released, in the same
+ * way the FPGA's interrupt manager calls them from a single thread.
+ */
+struct Notifier
+{
+	void (*process)(uint32_t, void*);
+	void *param;
+	bool enabled;
+	uint64_t triggerTime;
+	bool fired;
+	uint64_t lastFired;
+};
+
+struct NotifierThread
+{
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::vector<Notifier*> notifiers;
+	Notifier *dispatching = nullptr;
+	std::thread::id dispatchThread;
+};
+
+/*
+ * Never destroyed, since the thread is detached and may still be waiting on
+ * it as the program exits.
+ */
+static NotifierThread *notifierThread = nullptr;
+static std::once_flag notifierThreadStarted;
+
+/**
+ * The time an alarm is due. On the manual clock, an alarm that's put back to
+ * or before the time it last fired at is due a microsecond later, so that a
+ * handler which reschedules for a time the truncated clock hasn't quite
+ * reached can't keep the clock from moving on.
+ */
+static uint64_t dueTime(const Notifier *notifier)
+{
+	if (isDesktopClockManual() && notifier->fired && notifier->triggerTime <= notifier->lastFired)
+		return notifier->lastFired + 1;
+	return notifier->triggerTime;
+}
+
+static Notifier *nextAlarm(NotifierThread &thread)
+{
+	Notifier *next = nullptr;
+	for (Notifier *notifier : thread.notifiers) {
+		if (!notifier->enabled) continue;
+		if (next == nullptr || dueTime(notifier) < dueTime(next)) next = notifier;
+	}
+	return next;
+}
+
+/**
+ * Fire an alarm. Like the hardware, the alarm disables itself. Called and
+ * returns with the lock held, but releases it to call the handler.
+ */
+static void dispatch(NotifierThread &thread, std::unique_lock<std::mutex> &sync, Notifier *notifier)
+{
+	notifier->enabled = false;
+	notifier->fired = true;
+	notifier->lastFired = desktopTime();
+	void (*process)(uint32_t, void*) = notifier->process;
+	void *param = notifier->param;
+
+	thread.dispatching = notifier;
+	thread.dispatchThread = std::this_thread::get_id();
+	sync.unlock();
+	process(1 << kTimerInterruptNumber, param);
+	sync.lock();
+	thread.dispatching = nullptr;
+	thread.dispatchThread = std::thread::id();
+	thread.changed.notify_all();
+}
+
+static void waitForDispatch(NotifierThread &thread, std::unique_lock<std::mutex> &sync)
+{
+	thread.changed.wait(sync, [&] {
+		return thread.dispatching == nullptr ||
+			thread.dispatchThread == std::this_thread::get_id();
+	});
+}
+
+static void runAlarms(NotifierThread &thread)
+{
+	std::unique_lock<std::mutex> sync(thread.mutex);
+	while (true) {
+		Notifier *next = isDesktopClockManual() ? nullptr : nextAlarm(thread);
+		if (next == nullptr) {
+			thread.changed.wait(sync);
+			continue;
+		}
+		uint64_t now = desktopTime();
+		uint64_t due = dueTime(next);
+		if (due > now) {
+			thread.changed.wait_for(sync, std::chrono::microseconds(due - now));
+			continue;
+		}
+		dispatch(thread, sync, next);
+	}
+}
+
+static NotifierThread &getNotifierThread()
+{
+	std::call_once(notifierThreadStarted, [] {
+		notifierThread = new NotifierThread();
+		std::thread(runAlarms, std::ref(*notifierThread)).detach();
+	});
+	return *notifierThread;
+}
+
+/**
+ * Create a notifier that calls ProcessQueue from the alarm thread when its
+ * alarm fires.
+ * @param param Passed through to each ProcessQueue call, so several notifiers
+ * can share one handler
+ */
+void* initializeNotifier(void (*ProcessQueue)(uint32_t, void*), void* param, int32_t *status)
+{
+	NotifierThread &thread = getNotifierThread();
+	Notifier* notifier = new Notifier();
+	notifier->process = ProcessQueue;
+	notifier->param = param;
+	std::lock_guard<std::mutex> sync(thread.mutex);
+	thread.notifiers.push_back(notifier);
+	return notifier;
+}
+
+void cleanNotifier(void* notifier_pointer, int32_t *status)
+{
+	NotifierThread &thread = getNotifierThread();
+	Notifier* notifier = (Notifier*)notifier_pointer;
+	std::unique_lock<std::mutex> sync(thread.mutex);
+	thread.notifiers.erase(
+		std::remove(thread.notifiers.begin(), thread.notifiers.end(), notifier),
+		thread.notifiers.end());
+	// Make sure the handler isn't still running with what it was given.
+	thread.changed.wait(sync, [&] {
+		return thread.dispatching != notifier ||
+			thread.dispatchThread == std::this_thread::get_id();
+	});
+	delete notifier;
+}
+
+void updateNotifierAlarm(void* notifier_pointer, uint32_t triggerTime, int32_t *status)
+{
+	NotifierThread &thread = getNotifierThread();
+	Notifier* notifier = (Notifier*)notifier_pointer;
+	std::lock_guard<std::mutex> sync(thread.mutex);
+	// Take the trigger time as the nearest time to now with those low 32 bits.
+	uint64_t now = desktopTime();
+	int32_t fromNow = (int32_t)(triggerTime - (uint32_t)now);
+	notifier->triggerTime = fromNow < 0 && now < (uint64_t)-fromNow ? 0 : now + fromNow;
+	// Enable the alarm.  It disables itself after each alarm.
+	notifier->enabled = true;
+	thread.changed.notify_all();
+}
+
+void runNotifiersUntil(uint64_t microseconds)
+{
+	NotifierThread &thread = getNotifierThread();
+	std::unique_lock<std::mutex> sync(thread.mutex);
+	waitForDispatch(thread, sync);
+	while (true) {
+		Notifier *next = nextAlarm(thread);
+		if (next == nullptr || dueTime(next) > microseconds) break;
+		setDesktopTime(std::max(dueTime(next), desktopTime()));
+		dispatch(thread, sync, next);
+		waitForDispatch(thread, sync);
+	}
+	if (microseconds > desktopTime()) setDesktopTime(microseconds);
+}
+
+void clockChanged()
+{
+	NotifierThread &thread = getNotifierThread();
+	std::lock_guard<std::mutex> sync(thread.mutex);
+	thread.changed.notify_all();
+}
@@ -0,0 +1,129 @@
+#include "HAL/PDP.hpp"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <mutex>
+
+static const int NUM_MODULE_NUMBERS = 63;
+static const int kNumChannels = 16;
+static const double kDefaultVoltage = 12.0;
+static const double kDefaultTemperature = 25.0;
+
+/*
+ * A power distribution panel. Energy is worked out from the power whenever
+ * the power is about to change or is looked at, so it follows the clock.
+ */
+struct PowerDistributionPanel {
+	double voltage;
+	double temperature;
+	double currents[kNumChannels];
+	double energy;
+	uint64_t energyUpdated;
+};
+
+static std::mutex pdpMutex;
+static PowerDistributionPanel pdp[NUM_MODULE_NUMBERS];
+
+static void resetPanel(PowerDistributionPanel &panel) {
+	panel = PowerDistributionPanel();
+	panel.voltage = kDefaultVoltage;
+	panel.temperature = kDefaultTemperature;
+	panel.energyUpdated = desktopTime();
+}
+
+static double totalCurrent(const PowerDistributionPanel &panel) {
+	double current = 0.0;
+	for (double channelCurrent : panel.currents) current += channelCurrent;
+	return current;
+}
+
+static void updateEnergy(PowerDistributionPanel &panel) {
+	uint64_t now = desktopTime();
+	if (now > panel.energyUpdated) {
+		panel.energy += panel.voltage * totalCurrent(panel) * (now - panel.energyUpdated) * 1e-6;
+	}
+	panel.energyUpdated = now;
+}
+
+void initializePDP(int module) {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	if (pdp[module].voltage == 0.0) {
+		resetPanel(pdp[module]);
+	}
+}
+
+double getPDPTemperature(int32_t *status, uint8_t module) {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	return pdp[module].temperature;
+}
+
+double getPDPVoltage(int32_t *status, uint8_t module) {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	return pdp[module].voltage;
+}
+
+double getPDPChannelCurrent(uint8_t channel, int32_t *status, uint8_t module) {
+	if (channel >= kNumChannels) {
+		*status = PARAMETER_OUT_OF_RANGE;
+		return 0.0;
+	}
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	return pdp[module].currents[channel];
+}
+
+double getPDPTotalCurrent(int32_t *status, uint8_t module) {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	return totalCurrent(pdp[module]);
+}
+
+double getPDPTotalPower(int32_t *status, uint8_t module) {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	return pdp[module].voltage * totalCurrent(pdp[module]);
+}
+
+double getPDPTotalEnergy(int32_t *status, uint8_t module) {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	updateEnergy(pdp[module]);
+	return pdp[module].energy;
+}
+
+void resetPDPTotalEnergy(int32_t *status, uint8_t module) {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	pdp[module].energy = 0.0;
+	pdp[module].energyUpdated = desktopTime();
+}
+
+void clearPDPStickyFaults(int32_t *status, uint8_t module) {
+}
+
+void resetPDP() {
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	for (PowerDistributionPanel &panel : pdp) {
+		if (panel.voltage != 0.0) resetPanel(panel);
+	}
+}
+
+namespace hal {
+namespace desktop {
+
+void SetPDPVoltage(uint8_t module, double voltage) {
+	if (module >= NUM_MODULE_NUMBERS) return;
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	updateEnergy(pdp[module]);
+	pdp[module].voltage = voltage;
+}
+
+void SetPDPTemperature(uint8_t module, double temperature) {
+	if (module >= NUM_MODULE_NUMBERS) return;
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	pdp[module].temperature = temperature;
+}
+
+void SetPDPChannelCurrent(uint8_t module, uint8_t channel, double current) {
+	if (module >= NUM_MODULE_NUMBERS || channel >= kNumChannels) return;
+	std::lock_guard<std::mutex> sync(pdpMutex);
+	updateEnergy(pdp[module]);
+	pdp[module].currents[channel] = current;
+}
+
+}  // namespace desktop
+}  // namespace hal
@@ -0,0 +1,169 @@
+#include "HAL/Power.hpp"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <mutex>
+
+/*
+ * The roboRIO's power supplies. Each user rail sits at its nominal voltage
+ * until a test turns it off, which counts as an over current fault.
+ */
+struct Rail {
+	float nominalVoltage;
+	bool active;
+	int faults;
+};
+
+static std::mutex powerMutex;
+static float vinVoltage = 12.0f;
+static float vinCurrent = 0.0f;
+static Rail rail6V = {6.0f, true, 0};
+static Rail rail5V = {5.0f, true, 0};
+static Rail rail3V3 = {3.3f, true, 0};
+
+static float railVoltage(const Rail &rail) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	return rail.active ? rail.nominalVoltage : 0.0f;
+}
+
+static bool railActive(const Rail &rail) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	return rail.active;
+}
+
+static int railFaults(const Rail &rail) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	return rail.faults;
+}
+
+/**
+ * Get the roboRIO input voltage
+ */
+float getVinVoltage(int32_t *status) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	return vinVoltage;
+}
+
+/**
+ * Get the roboRIO input current
+ */
+float getVinCurrent(int32_t *status) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	return vinCurrent;
+}
+
+/**
+ * Get the 6V rail voltage
+ */
+float getUserVoltage6V(int32_t *status) {
+	return railVoltage(rail6V);
+}
+
+/**
+ * Get the 6V rail current
+ */
+float getUserCurrent6V(int32_t *status) {
+	return 0.0f;
+}
+
+/**
+ * Get the active state of the 6V rail
+ */
+bool getUserActive6V(int32_t *status) {
+	return railActive(rail6V);
+}
+
+/**
+ * Get the fault count for the 6V rail
+ */
+int getUserCurrentFaults6V(int32_t *status) {
+	return railFaults(rail6V);
+}
+
+/**
+ * Get the 5V rail voltage
+ */
+float getUserVoltage5V(int32_t *status) {
+	return railVoltage(rail5V);
+}
+
+/**
+ * Get the 5V rail current
+ */
+float getUserCurrent5V(int32_t *status) {
+	return 0.0f;
+}
+
+/**
+ * Get the active state of the 5V rail
+ */
+bool getUserActive5V(int32_t *status) {
+	return railActive(rail5V);
+}
+
+/**
+ * Get the fault count for the 5V rail
+ */
+int getUserCurrentFaults5V(int32_t *status) {
+	return railFaults(rail5V);
+}
+
+/**
+ * Get the 3.3V rail voltage
+ */
+float getUserVoltage3V3(int32_t *status) {
+	return railVoltage(rail3V3);
+}
+
+/**
+ * Get the 3.3V rail current
+ */
+float getUserCurrent3V3(int32_t *status) {
+	return 0.0f;
+}
+
+/**
+ * Get the active state of the 3.3V rail
+ */
+bool getUserActive3V3(int32_t *status) {
+	return railActive(rail3V3);
+}
+
+/**
+ * Get the fault count for the 3.3V rail
+ */
+int getUserCurrentFaults3V3(int32_t *status) {
+	return railFaults(rail3V3);
+}
+
+void resetPower() {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	vinVoltage = 12.0f;
+	vinCurrent = 0.0f;
+	for (Rail *rail : {&rail6V, &rail5V, &rail3V3}) {
+		rail->active = true;
+		rail->faults = 0;
+	}
+}
+
+namespace hal {
+namespace desktop {
+
+void SetVinVoltage(float voltage) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	vinVoltage = voltage;
+}
+
+void SetVinCurrent(float current) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	vinCurrent = current;
+}
+
+void SetUserRailActive(float nominalVoltage, bool active) {
+	std::lock_guard<std::mutex> sync(powerMutex);
+	Rail *rail = nominalVoltage > 5.5f ? &rail6V : nominalVoltage > 4.0f ? &rail5V : &rail3V3;
+	if (rail->active && !active) rail->faults++;
+	rail->active = active;
+}
+
+}  // namespace desktop
+}  // namespace hal
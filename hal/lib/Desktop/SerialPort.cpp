@@ -0,0 +1,156 @@
+#include "HAL/SerialPort.hpp"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+
+static const uint8_t kNumSerialPorts = 3;
+// The VISA default, in seconds
+static const float kDefaultTimeout = 2.0f;
+
+/*
+ * A serial port as a pair of byte queues. Reads wait, in real time, for the
+ * bytes a test pushes in, the same way they wait for a device.
+ */
+struct Serial {
+	bool open;
+	float timeout;
+	bool terminationEnabled;
+	char terminator;
+	std::deque<char> input;
+	std::string output;
+};
+
+static std::mutex serialMutex;
+static std::condition_variable serialInputArrived;
+static Serial serialPorts[kNumSerialPorts];
+
+void serialInitializePort(uint8_t port, int32_t *status) {
+	if (port >= kNumSerialPorts) {
+		*status = PARAMETER_OUT_OF_RANGE;
+		return;
+	}
+	std::lock_guard<std::mutex> sync(serialMutex);
+	serialPorts[port].open = true;
+	serialPorts[port].timeout = kDefaultTimeout;
+	serialPorts[port].terminationEnabled = false;
+}
+
+// The line settings make no difference to bytes in memory.
+void serialSetBaudRate(uint8_t port, uint32_t baud, int32_t *status) {}
+void serialSetDataBits(uint8_t port, uint8_t bits, int32_t *status) {}
+void serialSetParity(uint8_t port, uint8_t parity, int32_t *status) {}
+void serialSetStopBits(uint8_t port, uint8_t stopBits, int32_t *status) {}
+void serialSetWriteMode(uint8_t port, uint8_t mode, int32_t *status) {}
+void serialSetFlowControl(uint8_t port, uint8_t flow, int32_t *status) {}
+void serialSetReadBufferSize(uint8_t port, uint32_t size, int32_t *status) {}
+void serialSetWriteBufferSize(uint8_t port, uint32_t size, int32_t *status) {}
+
+void serialSetTimeout(uint8_t port, float timeout, int32_t *status) {
+	if (port >= kNumSerialPorts) return;
+	std::lock_guard<std::mutex> sync(serialMutex);
+	serialPorts[port].timeout = timeout;
+}
+
+void serialEnableTermination(uint8_t port, char terminator, int32_t *status) {
+	if (port >= kNumSerialPorts) return;
+	std::lock_guard<std::mutex> sync(serialMutex);
+	serialPorts[port].terminationEnabled = true;
+	serialPorts[port].terminator = terminator;
+}
+
+void serialDisableTermination(uint8_t port, int32_t *status) {
+	if (port >= kNumSerialPorts) return;
+	std::lock_guard<std::mutex> sync(serialMutex);
+	serialPorts[port].terminationEnabled = false;
+}
+
+int32_t serialGetBytesReceived(uint8_t port, int32_t *status) {
+	if (port >= kNumSerialPorts) return 0;
+	std::lock_guard<std::mutex> sync(serialMutex);
+	return serialPorts[port].input.size();
+}
+
+/**
+ * Read up to count bytes, waiting until there are that many, the terminator
+ * has arrived or the timeout has passed.
+ */
+uint32_t serialRead(uint8_t port, char* buffer, int32_t count, int32_t *status) {
+	if (port >= kNumSerialPorts) return 0;
+	std::unique_lock<std::mutex> sync(serialMutex);
+	Serial &serial = serialPorts[port];
+	auto available = [&] {
+		if (serial.input.size() >= (size_t)count) return true;
+		if (!serial.terminationEnabled) return false;
+		for (char c : serial.input) {
+			if (c == serial.terminator) return true;
+		}
+		return false;
+	};
+	serialInputArrived.wait_for(sync, std::chrono::duration<double>(serial.timeout), available);
+
+	uint32_t retCount = 0;
+	while (retCount < (uint32_t)count && !serial.input.empty()) {
+		char c = serial.input.front();
+		serial.input.pop_front();
+		buffer[retCount++] = c;
+		if (serial.terminationEnabled && c == serial.terminator) break;
+	}
+	return retCount;
+}
+
+uint32_t serialWrite(uint8_t port, const char *buffer, int32_t count, int32_t *status) {
+	if (port >= kNumSerialPorts) return 0;
+	std::lock_guard<std::mutex> sync(serialMutex);
+	serialPorts[port].output.append(buffer, count);
+	return count;
+}
+
+void serialFlush(uint8_t port, int32_t *status) {
+}
+
+void serialClear(uint8_t port, int32_t *status) {
+	if (port >= kNumSerialPorts) return;
+	std::lock_guard<std::mutex> sync(serialMutex);
+	serialPorts[port].input.clear();
+}
+
+void serialClose(uint8_t port, int32_t *status) {
+	if (port >= kNumSerialPorts) return;
+	std::lock_guard<std::mutex> sync(serialMutex);
+	serialPorts[port].open = false;
+}
+
+void resetSerial() {
+	std::lock_guard<std::mutex> sync(serialMutex);
+	for (Serial &serial : serialPorts) {
+		serial.input.clear();
+		serial.output.clear();
+	}
+}
+
+namespace hal {
+namespace desktop {
+
+void PushSerialInput(uint8_t port, const std::string &bytes) {
+	if (port >= kNumSerialPorts) return;
+	{
+		std::lock_guard<std::mutex> sync(serialMutex);
+		serialPorts[port].input.insert(serialPorts[port].input.end(), bytes.begin(), bytes.end());
+	}
+	serialInputArrived.notify_all();
+}
+
+std::string TakeSerialOutput(uint8_t port) {
+	if (port >= kNumSerialPorts) return "";
+	std::lock_guard<std::mutex> sync(serialMutex);
+	std::string output;
+	output.swap(serialPorts[port].output);
+	return output;
+}
+
+}  // namespace desktop
+}  // namespace hal
@@ -0,0 +1,141 @@
+
+#include "HAL/Solenoid.hpp"
+
+#include "HAL/Port.h"
+#include "HAL/Errors.hpp"
+#include "HALDesktop.hpp"
+#include "DesktopInternal.hpp"
+
+std::mutex pneumaticsMutex;
+PneumaticsModule pneumaticsModules[kNumPneumaticsModules];
+
+struct solenoid_port_t {
+	PneumaticsModule *module;
+	uint32_t pin;
+};
+
+static const uint32_t kNumSolenoidChannels = 8;
+
+/**
+ * Put a module in the state a PCM powers on in, which has closed loop
+ * control of the compressor on.
+ */
+static void resetPCM(PneumaticsModule &module) {
+	module.solenoids = 0;
+	module.blackList = 0;
+	module.closedLoopControl = true;
+	module.pressureSwitch = false;
+	module.compressorCurrent = 0;
+}
+
+void initializePCM(int module) {
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	if(!pneumaticsModules[module].initialized) {
+		resetPCM(pneumaticsModules[module]);
+		pneumaticsModules[module].initialized = true;
+	}
+}
+
+void* initializeSolenoidPort(void *port_pointer, int32_t *status) {
+	Port* port = (Port*) port_pointer;
+	initializePCM(port->module);
+
+	solenoid_port_t *solenoid_port = new solenoid_port_t;
+	solenoid_port->module = &pneumaticsModules[port->module];
+	solenoid_port->pin = port->pin;
+
+	return solenoid_port;
+}
+
+bool checkSolenoidModule(uint8_t module) {
+	return module < kNumPneumaticsModules;
+}
+
+bool getSolenoid(void* solenoid_port_pointer, int32_t *status) {
+	solenoid_port_t* port = (solenoid_port_t*) solenoid_port_pointer;
+	if (port->pin >= kNumSolenoidChannels) {
+		*status = PARAMETER_OUT_OF_RANGE;
+		return false;
+	}
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	return (port->module->solenoids & ~port->module->blackList & (1 << port->pin)) != 0;
+}
+
+void setSolenoid(void* solenoid_port_pointer, bool value, int32_t *status) {
+	solenoid_port_t* port = (solenoid_port_t*) solenoid_port_pointer;
+	if (port->pin >= kNumSolenoidChannels) {
+		*status = PARAMETER_OUT_OF_RANGE;
+		return;
+	}
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	if (value)
+		port->module->solenoids |= 1 << port->pin;
+	else
+		port->module->solenoids &= ~(1 << port->pin);
+}
+
+int getPCMSolenoidBlackList(void* solenoid_port_pointer, int32_t *status){
+	solenoid_port_t* port = (solenoid_port_t*) solenoid_port_pointer;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	return port->module->blackList;
+}
+
+// The solenoid supply never faults on the desktop.
+bool getPCMSolenoidVoltageStickyFault(void* solenoid_port_pointer, int32_t *status){
+	return false;
+}
+bool getPCMSolenoidVoltageFault(void* solenoid_port_pointer, int32_t *status){
+	return false;
+}
+
+/**
+ * Clear the sticky faults, which also clears the black list, as on the PCM.
+ */
+void clearAllPCMStickyFaults_sol(void *solenoid_port_pointer, int32_t *status){
+	solenoid_port_t* port = (solenoid_port_t*) solenoid_port_pointer;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	port->module->blackList = 0;
+}
+
+void resetPneumatics() {
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	for (PneumaticsModule &module : pneumaticsModules) resetPCM(module);
+}
+
+namespace hal {
+namespace desktop {
+
+bool GetSolenoid(uint8_t module, uint32_t channel) {
+	if (module >= kNumPneumaticsModules || channel >= kNumSolenoidChannels) return false;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	const PneumaticsModule &pcm = pneumaticsModules[module];
+	return (pcm.solenoids & ~pcm.blackList & (1 << channel)) != 0;
+}
+
+void SetSolenoidBlackList(uint8_t module, uint8_t mask) {
+	if (module >= kNumPneumaticsModules) return;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	pneumaticsModules[module].blackList = mask;
+}
+
+bool GetCompressorOn(uint8_t module) {
+	if (module >= kNumPneumaticsModules) return false;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	const PneumaticsModule &pcm = pneumaticsModules[module];
+	return pcm.closedLoopControl && !pcm.pressureSwitch;
+}
+
+void SetPressureSwitch(uint8_t module, bool full) {
+	if (module >= kNumPneumaticsModules) return;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	pneumaticsModules[module].pressureSwitch = full;
+}
+
+void SetCompressorCurrent(uint8_t module, float current) {
+	if (module >= kNumPneumaticsModules) return;
+	std::lock_guard<std::mutex> sync(pneumaticsMutex);
+	pneumaticsModules[module].compressorCurrent = current;
+}
+
+}  // namespace desktop
+}  // namespace hal
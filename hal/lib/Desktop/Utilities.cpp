@@ -0,0 +1,26 @@
+#include "HAL/Utilities.hpp"
+#include <chrono>
+#include <thread>
+
+const int32_t HAL_NO_WAIT = 0;
+const int32_t HAL_WAIT_FOREVER = -1;
+
+/*
+ * Delays are real time, even when the FPGA clock is manual; robot code
+ * that sleeps is waiting for the outside world, which a test moves on from
+ * another thread.
+ */
+void delayTicks(int32_t ticks)
+{
+	std::this_thread::sleep_for(std::chrono::nanoseconds(ticks * 3));
+}
+
+void delayMillis(double ms)
+{
+	std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+}
+
+void delaySeconds(double s)
+{
+	std::this_thread::sleep_for(std::chrono::duration<double>(s));
+}
@@ -0,0 +1,31 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "HAL/HAL.hpp"
+#include "HALDesktop.hpp"
+#include "gtest/gtest.h"
+
+/**
+ * Starts each test from the power on state, on a clock that only moves when
+ * the test steps it.
+ *
+ * Reset() doesn't free anything, so each test frees the ports and handles it
+ * allocates.
+ */
+class DesktopTest : public testing::Test {
+ protected:
+  virtual void SetUp() override {
+    hal::desktop::SetManualClock(true);
+    hal::desktop::Reset();
+  }
+
+  virtual void TearDown() override { hal::desktop::SetManualClock(false); }
+
+  int32_t m_status = 0;
+};
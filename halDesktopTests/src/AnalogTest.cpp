@@ -0,0 +1,76 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "DesktopTest.h"
+
+class AnalogTest : public DesktopTest {
+ protected:
+  virtual void SetUp() override {
+    DesktopTest::SetUp();
+    m_port = initializeAnalogInputPort(getPort(0), &m_status);
+    ASSERT_EQ(0, m_status);
+  }
+
+  void *m_port = nullptr;
+};
+
+TEST_F(AnalogTest, VoltageIsSetByTheTest) {
+  hal::desktop::SetAnalogInput(0, 2.5);
+  EXPECT_NEAR(2.5, getAnalogVoltage(m_port, &m_status), 0.01);
+  EXPECT_NEAR(2.5, getAnalogAverageVoltage(m_port, &m_status), 0.01);
+  EXPECT_EQ(0, m_status);
+
+  hal::desktop::SetAnalogInput(0, 4.0);
+  EXPECT_NEAR(4.0, getAnalogVoltage(m_port, &m_status), 0.01);
+}
+
+TEST_F(AnalogTest, RawValueMatchesTheCalibration) {
+  hal::desktop::SetAnalogInput(0, 1.0);
+  int32_t value = getAnalogValue(m_port, &m_status);
+  EXPECT_EQ(getAnalogVoltsToValue(m_port, 1.0, &m_status), value);
+}
+
+TEST_F(AnalogTest, AccumulatorIntegratesOverTime) {
+  ASSERT_TRUE(isAccumulatorChannel(m_port, &m_status));
+  hal::desktop::SetAnalogInput(0, 2.5);
+  initAccumulator(m_port, &m_status);
+  int32_t center = getAnalogAverageValue(m_port, &m_status);
+  setAccumulatorCenter(m_port, center, &m_status);
+
+  hal::desktop::StepTime(100000);
+  uint32_t count = getAccumulatorCount(m_port, &m_status);
+  EXPECT_GT(count, 0u);
+  EXPECT_EQ(0, getAccumulatorValue(m_port, &m_status));
+
+  // Above the center, every sample adds the same amount
+  hal::desktop::SetAnalogInput(0, 3.0);
+  resetAccumulator(m_port, &m_status);
+  hal::desktop::StepTime(100000);
+  int64_t value;
+  getAccumulatorOutput(m_port, &value, &count, &m_status);
+  EXPECT_GT(count, 0u);
+  EXPECT_GT(value, 0);
+  EXPECT_EQ(0, value % count);
+  EXPECT_EQ(0, m_status);
+}
+
+TEST_F(AnalogTest, TriggerFollowsTheInput) {
+  uint32_t index;
+  void *trigger = initializeAnalogTrigger(getPort(0), &index, &m_status);
+  ASSERT_EQ(0, m_status);
+  setAnalogTriggerLimitsVoltage(trigger, 1.0, 3.0, &m_status);
+
+  hal::desktop::SetAnalogInput(0, 2.0);
+  EXPECT_TRUE(getAnalogTriggerInWindow(trigger, &m_status));
+  hal::desktop::SetAnalogInput(0, 4.0);
+  EXPECT_FALSE(getAnalogTriggerInWindow(trigger, &m_status));
+  EXPECT_TRUE(getAnalogTriggerTriggerState(trigger, &m_status));
+  hal::desktop::SetAnalogInput(0, 0.5);
+  EXPECT_FALSE(getAnalogTriggerTriggerState(trigger, &m_status));
+
+  cleanAnalogTrigger(trigger, &m_status);
+}
@@ -0,0 +1,76 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "DesktopTest.h"
+
+static const uint32_t kUp = 4;
+static const uint32_t kDown = 5;
+
+class CounterTest : public DesktopTest {
+ protected:
+  virtual void SetUp() override {
+    DesktopTest::SetUp();
+    m_counter = initializeCounter(kTwoPulse, &m_index, &m_status);
+    ASSERT_EQ(0, m_status);
+    setCounterUpSource(m_counter, kUp, false, &m_status);
+    setCounterUpSourceEdge(m_counter, true, false, &m_status);
+  }
+
+  virtual void TearDown() override {
+    freeCounter(m_counter, &m_status);
+    DesktopTest::TearDown();
+  }
+
+  /** A 1ms pulse on a pin, 10ms after the last. */
+  void Pulse(uint32_t pin) {
+    hal::desktop::StepTime(9000);
+    hal::desktop::SetDigitalInput(pin, true);
+    hal::desktop::StepTime(1000);
+    hal::desktop::SetDigitalInput(pin, false);
+  }
+
+  void *m_counter = nullptr;
+  uint32_t m_index = 0;
+};
+
+TEST_F(CounterTest, CountsRisingEdges) {
+  for (int i = 0; i < 5; i++) Pulse(kUp);
+  EXPECT_EQ(5, getCounter(m_counter, &m_status));
+  EXPECT_NEAR(0.01, getCounterPeriod(m_counter, &m_status), 1e-6);
+  EXPECT_EQ(0, m_status);
+
+  resetCounter(m_counter, &m_status);
+  EXPECT_EQ(0, getCounter(m_counter, &m_status));
+}
+
+TEST_F(CounterTest, CountsBothEdges) {
+  setCounterUpSourceEdge(m_counter, true, true, &m_status);
+  for (int i = 0; i < 5; i++) Pulse(kUp);
+  EXPECT_EQ(10, getCounter(m_counter, &m_status));
+}
+
+TEST_F(CounterTest, DownSourceCountsDown) {
+  setCounterDownSource(m_counter, kDown, false, &m_status);
+  setCounterDownSourceEdge(m_counter, true, false, &m_status);
+  for (int i = 0; i < 3; i++) Pulse(kUp);
+  Pulse(kDown);
+  EXPECT_EQ(2, getCounter(m_counter, &m_status));
+  EXPECT_FALSE(getCounterDirection(m_counter, &m_status));
+}
+
+TEST_F(CounterTest, SemiPeriodTimesThePulse) {
+  setCounterSemiPeriodMode(m_counter, true, &m_status);
+  Pulse(kUp);
+  EXPECT_NEAR(0.001, getCounterPeriod(m_counter, &m_status), 1e-6);
+}
+
+TEST_F(CounterTest, SetByTheTest) {
+  hal::desktop::SetCounter(m_index, 42, 0.5);
+  EXPECT_EQ(42, getCounter(m_counter, &m_status));
+  Pulse(kUp);
+  EXPECT_EQ(43, getCounter(m_counter, &m_status));
+}
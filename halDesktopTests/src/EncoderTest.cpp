@@ -0,0 +1,91 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "DesktopTest.h"
+
+static const uint32_t kA = 0;
+static const uint32_t kB = 1;
+
+class EncoderTest : public DesktopTest {
+ protected:
+  virtual void SetUp() override {
+    DesktopTest::SetUp();
+    m_encoder = initializeEncoder(0, kA, false, 0, kB, false, false, &m_index,
+                                  &m_status);
+    ASSERT_EQ(0, m_status);
+  }
+
+  virtual void TearDown() override {
+    freeEncoder(m_encoder, &m_status);
+    DesktopTest::TearDown();
+  }
+
+  /** Turn the shaft one cycle, A leading B, 1ms between edges. */
+  void Forward() {
+    Edge(kA, true);
+    Edge(kB, true);
+    Edge(kA, false);
+    Edge(kB, false);
+  }
+
+  void Backward() {
+    Edge(kB, true);
+    Edge(kA, true);
+    Edge(kB, false);
+    Edge(kA, false);
+  }
+
+  void Edge(uint32_t pin, bool value) {
+    hal::desktop::StepTime(1000);
+    hal::desktop::SetDigitalInput(pin, value);
+  }
+
+  void *m_encoder = nullptr;
+  int32_t m_index = 0;
+};
+
+TEST_F(EncoderTest, CountsEveryEdge) {
+  Forward();
+  Forward();
+  EXPECT_EQ(8, getEncoder(m_encoder, &m_status));
+  EXPECT_TRUE(getEncoderDirection(m_encoder, &m_status));
+
+  Backward();
+  EXPECT_EQ(4, getEncoder(m_encoder, &m_status));
+  EXPECT_FALSE(getEncoderDirection(m_encoder, &m_status));
+  EXPECT_EQ(0, m_status);
+}
+
+TEST_F(EncoderTest, ReverseDirection) {
+  setEncoderReverseDirection(m_encoder, true, &m_status);
+  Forward();
+  EXPECT_EQ(-4, getEncoder(m_encoder, &m_status));
+}
+
+TEST_F(EncoderTest, PeriodFollowsTheEdges) {
+  Forward();
+  Forward();
+  // The period is of a whole cycle, four edges
+  EXPECT_NEAR(0.004, getEncoderPeriod(m_encoder, &m_status), 1e-6);
+  EXPECT_FALSE(getEncoderStopped(m_encoder, &m_status));
+
+  setEncoderMaxPeriod(m_encoder, 0.1, &m_status);
+  hal::desktop::StepTime(200000);
+  EXPECT_TRUE(getEncoderStopped(m_encoder, &m_status));
+}
+
+TEST_F(EncoderTest, SetByTheTest) {
+  hal::desktop::SetEncoder(m_index, 100, 0.01);
+  EXPECT_EQ(100, getEncoder(m_encoder, &m_status));
+  EXPECT_NEAR(0.01, getEncoderPeriod(m_encoder, &m_status), 1e-6);
+
+  Forward();
+  EXPECT_EQ(104, getEncoder(m_encoder, &m_status));
+
+  resetEncoder(m_encoder, &m_status);
+  EXPECT_EQ(0, getEncoder(m_encoder, &m_status));
+}
@@ -0,0 +1,150 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include "HAL/cpp/mutex_profiler.h"
+#include "HAL/cpp/priority_condition_variable.h"
+#include "HAL/cpp/priority_mutex.h"
+#include "gtest/gtest.h"
+
+namespace profiler = hal::mutex_profiler;
+
+#ifdef FRC_MUTEX_PROFILING
+
+/**
+ * Only built with -PmutexProfiling; without it the profiler is a set of stubs.
+ */
+class MutexProfilerTest : public testing::Test {
+ protected:
+  virtual void SetUp() override {
+    profiler::Reset();
+    profiler::SetEnabled(true);
+  }
+
+  virtual void TearDown() override { profiler::SetEnabled(false); }
+
+  /** What was recorded for a lock; all zero if nothing was. */
+  static profiler::LockStats StatsOf(const void *lock) {
+    for (const profiler::LockStats &stats : profiler::GetStats()) {
+      if (stats.lock == lock) return stats;
+    }
+    return profiler::LockStats();
+  }
+
+  static uint64_t Holds(const profiler::LockStats &stats) {
+    uint64_t holds = 0;
+    for (uint64_t count : stats.holdHistogram) holds += count;
+    return holds;
+  }
+};
+
+TEST_F(MutexProfilerTest, RecursiveRelockIsOneAcquisition) {
+  priority_recursive_mutex mutex;
+  mutex.lock();
+  mutex.lock();
+  mutex.lock();
+  mutex.unlock();
+  mutex.unlock();
+  // Still held, so no hold time yet
+  EXPECT_EQ(0u, Holds(StatsOf(&mutex)));
+  mutex.unlock();
+
+  profiler::LockStats stats = StatsOf(&mutex);
+  EXPECT_EQ(1u, stats.acquisitions);
+  EXPECT_EQ(0u, stats.contended);
+  EXPECT_EQ(1u, Holds(stats));
+}
+
+/**
+ * A condition variable wait releases the lock, so the wait isn't hold time,
+ * and taking it back afterwards is a new acquisition.
+ */
+TEST_F(MutexProfilerTest, ConditionWaitEndsTheHold) {
+  const auto kWait = std::chrono::milliseconds(20);
+  priority_mutex mutex;
+  priority_condition_variable condition;
+  {
+    std::unique_lock<priority_mutex> lock(mutex);
+    condition.wait_for(lock, kWait);
+  }
+
+  profiler::LockStats stats = StatsOf(&mutex);
+  EXPECT_EQ(2u, stats.acquisitions);
+  EXPECT_EQ(2u, Holds(stats));
+  EXPECT_LT(stats.maxHoldNs, static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(kWait).count() / 2));
+}
+
+TEST_F(MutexProfilerTest, ResetForgetsEarlierLocks) {
+  priority_mutex mutex;
+  mutex.lock();
+  mutex.unlock();
+  ASSERT_EQ(1u, StatsOf(&mutex).acquisitions);
+
+  // Taken before the Reset(), so neither it nor its hold is counted
+  mutex.lock();
+  profiler::Reset();
+  EXPECT_EQ(0u, StatsOf(&mutex).acquisitions);
+  mutex.unlock();
+  EXPECT_EQ(0u, Holds(StatsOf(&mutex)));
+
+  mutex.lock();
+  mutex.unlock();
+  profiler::LockStats stats = StatsOf(&mutex);
+  EXPECT_EQ(1u, stats.acquisitions);
+  EXPECT_EQ(1u, Holds(stats));
+}
+
+/**
+ * While disabled nothing is recorded, and a lock and unlock cost about what
+ * the pthread mutex underneath does. The allowance is loose, so a busy
+ * machine doesn't fail it; wpilibcBenchmarks has the actual numbers.
+ */
+TEST_F(MutexProfilerTest, DisabledIsNearlyFree) {
+  const int kIterations = 1000000;
+  profiler::SetEnabled(false);
+  priority_mutex mutex;
+
+  auto time = [&](bool raw) {
+    auto best = std::chrono::nanoseconds::max();
+    for (int run = 0; run < 5; run++) {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < kIterations; i++) {
+        if (raw) {
+          pthread_mutex_lock(mutex.native_handle());
+          pthread_mutex_unlock(mutex.native_handle());
+        } else {
+          mutex.lock();
+          mutex.unlock();
+        }
+      }
+      best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start));
+    }
+    return static_cast<double>(best.count()) / kIterations;
+  };
+  double rawNs = time(true);
+  double disabledNs = time(false);
+
+  EXPECT_EQ(0u, StatsOf(&mutex).acquisitions);
+  EXPECT_LT(disabledNs, 2 * rawNs + 10)
+      << "pthread " << rawNs << "ns, disabled profiler " << disabledNs << "ns";
+}
+
+#else
+
+TEST(MutexProfilerTest, NotBuiltIn) {
+  profiler::SetEnabled(true);
+  EXPECT_FALSE(profiler::IsEnabled());
+  priority_mutex mutex;
+  mutex.lock();
+  mutex.unlock();
+  EXPECT_TRUE(profiler::GetStats().empty());
+}
+
+#endif  // FRC_MUTEX_PROFILING
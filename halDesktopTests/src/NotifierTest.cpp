@@ -0,0 +1,63 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <vector>
+#include "DesktopTest.h"
+
+class NotifierTest : public DesktopTest {
+ protected:
+  /** Called with the interrupt mask, like the FPGA's interrupt manager. */
+  static void Record(uint32_t mask, void *param) {
+    int32_t status = 0;
+    static_cast<NotifierTest *>(param)->m_fired.push_back(getFPGATime(&status));
+  }
+
+  std::vector<uint32_t> m_fired;
+};
+
+TEST_F(NotifierTest, FiresWhenTheClockPassesTheAlarm) {
+  void *notifier = initializeNotifier(Record, this, &m_status);
+  ASSERT_EQ(0, m_status);
+  updateNotifierAlarm(notifier, 5000, &m_status);
+
+  hal::desktop::StepTime(4999);
+  EXPECT_TRUE(m_fired.empty());
+
+  hal::desktop::StepTime(1);
+  ASSERT_EQ(1u, m_fired.size());
+  EXPECT_EQ(5000u, m_fired[0]);
+
+  // An alarm fires once, until it's set again
+  hal::desktop::StepTime(10000);
+  EXPECT_EQ(1u, m_fired.size());
+
+  cleanNotifier(notifier, &m_status);
+}
+
+TEST_F(NotifierTest, AlarmsFireInOrderWhileStepping) {
+  void *first = initializeNotifier(Record, this, &m_status);
+  void *second = initializeNotifier(Record, this, &m_status);
+  updateNotifierAlarm(second, 3000, &m_status);
+  updateNotifierAlarm(first, 2000, &m_status);
+
+  hal::desktop::StepTime(10000);
+  ASSERT_EQ(2u, m_fired.size());
+  EXPECT_EQ(2000u, m_fired[0]);
+  EXPECT_EQ(3000u, m_fired[1]);
+
+  cleanNotifier(first, &m_status);
+  cleanNotifier(second, &m_status);
+}
+
+TEST_F(NotifierTest, CleanedNotifierDoesNotFire) {
+  void *notifier = initializeNotifier(Record, this, &m_status);
+  updateNotifierAlarm(notifier, 1000, &m_status);
+  cleanNotifier(notifier, &m_status);
+
+  hal::desktop::StepTime(2000);
+  EXPECT_TRUE(m_fired.empty());
+}
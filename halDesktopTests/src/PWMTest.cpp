@@ -0,0 +1,51 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "DesktopTest.h"
+
+class PWMTest : public DesktopTest {};
+
+TEST_F(PWMTest, ValueIsSeenByTheTest) {
+  void *port = initializeDigitalPort(getPort(3), &m_status);
+  ASSERT_TRUE(allocatePWMChannel(port, &m_status));
+
+  setPWM(port, 1234, &m_status);
+  EXPECT_EQ(0, m_status);
+  EXPECT_EQ(1234, hal::desktop::GetPWM(3));
+  EXPECT_EQ(1234, getPWM(port, &m_status));
+  EXPECT_EQ(0, hal::desktop::GetPWM(4));
+
+  setPWMPeriodScale(port, 3, &m_status);
+  EXPECT_EQ(3u, hal::desktop::GetPWMPeriodScale(3));
+
+  freePWMChannel(port, &m_status);
+}
+
+TEST_F(PWMTest, ChannelCanOnlyBeAllocatedOnce) {
+  void *port = initializeDigitalPort(getPort(5), &m_status);
+  ASSERT_TRUE(allocatePWMChannel(port, &m_status));
+
+  void *again = initializeDigitalPort(getPort(5), &m_status);
+  EXPECT_FALSE(allocatePWMChannel(again, &m_status));
+  EXPECT_EQ(RESOURCE_IS_ALLOCATED, m_status);
+
+  freePWMChannel(port, &m_status);
+  m_status = 0;
+  EXPECT_TRUE(allocatePWMChannel(again, &m_status));
+  freePWMChannel(again, &m_status);
+}
+
+TEST_F(PWMTest, ResetPutsTheValueBack) {
+  void *port = initializeDigitalPort(getPort(6), &m_status);
+  ASSERT_TRUE(allocatePWMChannel(port, &m_status));
+  setPWM(port, 2000, &m_status);
+
+  hal::desktop::Reset();
+  EXPECT_EQ(0, hal::desktop::GetPWM(6));
+
+  freePWMChannel(port, &m_status);
+}
@@ -0,0 +1,515 @@
+/**
+ * \file
+ * \brief Runs a robot program in many headless simulations at once, for
+ * example to try out sets of autonomous parameters overnight.
+ *
+ * Each run gets its own gzserver on its own Gazebo master port, so runs
+ * can't see each other's topics (or shared memory frames), and its own
+ * working directory, holding the wpilib-preferences.ini its parameters are
+ * passed in and the logs of the simulator and robot program. The robot
+ * program gets a NetworkTables port of its own through FRCSIM_NT_PORT, and
+ * keeps its persistent NetworkTables values in its run's directory through
+ * FRCSIM_NT_PERSISTENT_FILE. Anything else a robot program opens at a fixed
+ * port or path, like a camera server, is still shared between runs, so only
+ * one of them gets it.
+ *
+ * The runner plays the part of the driver station: it waits for the robot
+ * program to subscribe to ds/state, starts the world, then enables
+ * autonomous and teleop for the given number of simulated seconds, while
+ * recording the topics given as metrics. One line per run is written to a
+ * CSV file.
+ *
+ *     frc_batch_runner --world robot.world --robot "java -jar robot.jar"
+ *                      --params params.csv --metric ~/simulator/encoder/1/position
+ *
+ * Options:
+ * - `--world file`: The world to simulate. Required.
+ * - `--robot command`: Starts the robot program, run with /bin/sh in the
+ *                      run's directory. Required.
+ * - `--params file`: CSV file with Preferences keys on its first line and
+ *                    one run per following line. Quoted fields aren't
+ *                    supported, so no key or value may contain a comma or a
+ *                    double quote.
+ * - `--runs n`: Number of runs if there's no params file. Defaults to 1.
+ * - `--metric topic`: A gazebo.msgs.Float64 topic to record the final,
+ *                     minimum and maximum of. May be repeated.
+ * - `--auto seconds`: Simulated time in autonomous. Defaults to 15.
+ * - `--teleop seconds`: Simulated time in teleop after that. Defaults to 0.
+ * - `--timeout seconds`: Wall clock time before a run is abandoned.
+ *                        Defaults to 300.
+ * - `--jobs n`: Runs at a time. Defaults to half the cores, since each run
+ *               is a simulator and a robot program.
+ * - `--port n`: Gazebo master port of the first run; run i uses port+i.
+ *               Defaults to 11400.
+ * - `--nt-port n`: NetworkTables port of the first run; run i uses n+i.
+ *                  Defaults to 11735.
+ * - `--world-name name`: Name of the world in the world file. Defaults to
+ *                        "default".
+ * - `--dir path`: Where to put each run's directory. Defaults to batch-runs.
+ * - `--output file`: The CSV file written. Defaults to results.csv.
+ *
+ * GAZEBO_PLUGIN_PATH and GAZEBO_MODEL_PATH need to be set up as frcsim.sh
+ * does.
+ */
+
+#include "simulation/gz_msgs/msgs.h"
+
+#include <gazebo/gazebo_client.hh>
+#include <gazebo/msgs/msgs.hh>
+#include <gazebo/transport/transport.hh>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gazebo;
+
+/// \brief Everything set on the command line.
+struct Options {
+  std::string world;
+  std::string world_name = "default";
+  std::string robot;
+  std::string params;
+  std::string dir = "batch-runs";
+  std::string output = "results.csv";
+  std::vector<std::string> metrics;
+  int runs = 1;
+  int jobs = 0;
+  int port = 11400;
+  int nt_port = 11735;
+  double auto_time = 15;
+  double teleop_time = 0;
+  double timeout = 300;
+};
+
+/// \brief Records the final, minimum and maximum values of a topic.
+class Metric {
+public:
+  explicit Metric(const std::string &topic) : topic(topic) {}
+
+  void Subscribe(transport::NodePtr node) {
+    sub = node->Subscribe(topic, &Metric::Callback, this);
+  }
+
+  /// \brief The CSV columns of the metric: final, minimum, maximum.
+  std::string Columns() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream columns;
+    if (samples > 0) {
+      columns << last << "," << min << "," << max;
+    } else {
+      columns << ",,";
+    }
+    return columns.str();
+  }
+
+private:
+  void Callback(const msgs::ConstFloat64Ptr &msg) {
+    std::lock_guard<std::mutex> lock(mutex);
+    last = msg->data();
+    min = std::min(min, last);
+    max = std::max(max, last);
+    samples++;
+  }
+
+  std::string topic;
+  std::mutex mutex;
+  double last = 0;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  int samples = 0;
+  transport::SubscriberPtr sub;
+};
+
+/// \brief Tracks the simulation time of a run's world.
+class WorldClock {
+public:
+  void Subscribe(transport::NodePtr node, const std::string &world_name) {
+    sub = node->Subscribe("/gazebo/" + world_name + "/world_stats",
+                          &WorldClock::Callback, this);
+  }
+
+  double Get() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return time;
+  }
+
+private:
+  void Callback(const boost::shared_ptr<const msgs::WorldStatistics> &msg) {
+    std::lock_guard<std::mutex> lock(mutex);
+    time = msgs::Convert(msg->sim_time()).Double();
+  }
+
+  std::mutex mutex;
+  double time = 0;
+  transport::SubscriberPtr sub;
+};
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void Interrupt(int) { interrupted = 1; }
+
+/// \brief Split a line of the params file into its fields.
+/// \return false if a field is quoted, since a quoted field may hold a comma
+///         and a double quote can't be written to wpilib-preferences.ini.
+static bool SplitCsv(const std::string &line,
+                     std::vector<std::string> *fields) {
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    if (field.find('"') != std::string::npos) return false;
+    fields->push_back(field);
+  }
+  return true;
+}
+
+/// \brief Start a program in its own process group, in the given directory,
+///        with its output going to a log file there.
+static pid_t Spawn(const std::vector<std::string> &args, const std::string &dir,
+                   const std::string &log) {
+  pid_t pid = fork();
+  if (pid != 0) return pid;
+
+  setpgid(0, 0);
+  if (chdir(dir.c_str()) != 0) _exit(127);
+  int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0) {
+    dup2(fd, STDOUT_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+  }
+  std::vector<char *> argv;
+  for (const std::string &arg : args) {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+  execvp(argv[0], argv.data());
+  _exit(127);
+}
+
+/// \brief Ask a process group to stop, and make it stop if it doesn't.
+static void Stop(pid_t pid) {
+  if (pid <= 0) return;
+  kill(-pid, SIGTERM);
+  for (int i = 0; i < 50; i++) {
+    if (waitpid(pid, nullptr, WNOHANG) == pid) {
+      kill(-pid, SIGKILL);  // anything the program left behind
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  kill(-pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+}
+
+static bool Exited(pid_t pid) { return waitpid(pid, nullptr, WNOHANG) == pid; }
+
+/// \brief Simulate one run, in a process of its own, and write its line of
+///        results to result.csv in its directory.
+static int Run(const Options &options, int index,
+               const std::vector<std::string> &keys,
+               const std::vector<std::string> &values) {
+  signal(SIGINT, Interrupt);
+  signal(SIGTERM, Interrupt);
+
+  std::string dir = options.dir + "/run-" + std::to_string(index);
+  mkdir(dir.c_str(), 0755);
+  // A result left from an earlier batch in the same directory would be taken
+  // for this run's if it fails before writing its own
+  unlink((dir + "/result.csv").c_str());
+  {
+    std::ofstream preferences(dir + "/wpilib-preferences.ini");
+    for (size_t i = 0; i < keys.size() && i < values.size(); i++) {
+      preferences << keys[i] << "=\"" << values[i] << "\"\n";
+    }
+  }
+
+  // Everything started from here on talks to this run's master. JavaGazebo
+  // only understands host:port, without the http:// gazebo also accepts.
+  std::string uri = "localhost:" + std::to_string(options.port + index);
+  setenv("GAZEBO_MASTER_URI", uri.c_str(), 1);
+  setenv("FRCSIM_NT_PORT", std::to_string(options.nt_port + index).c_str(), 1);
+  // The robot program runs in the run's directory
+  setenv("FRCSIM_NT_PERSISTENT_FILE", "networktables.ini", 1);
+
+  pid_t server = Spawn({"gzserver", "-u", options.world}, dir, "gzserver.log");
+  pid_t robot = Spawn({"/bin/sh", "-c", options.robot}, dir, "robot.log");
+
+  std::string status = "ok";
+  gazebo::client::setup();
+  transport::NodePtr node(new transport::Node());
+  node->Init("frc");
+  transport::PublisherPtr ds = node->Advertise<msgs::DriverStation>("~/ds/state");
+  transport::PublisherPtr control = node->Advertise<msgs::WorldControl>(
+      "/gazebo/" + options.world_name + "/world_control");
+  WorldClock clock;
+  clock.Subscribe(node, options.world_name);
+  std::vector<std::unique_ptr<Metric>> metrics;
+  for (const std::string &topic : options.metrics) {
+    metrics.emplace_back(new Metric(topic));
+    metrics.back()->Subscribe(node);
+  }
+
+  // The world starts paused, and stays that way until the robot program is
+  // listening to the driver station, however long it takes to start.
+  common::Time timeout(options.timeout);
+  if (!ds->WaitForConnection(timeout) ||
+      !control->WaitForConnection(common::Time(5.0))) {
+    status = "robot did not connect";
+  } else {
+    msgs::WorldControl start;
+    start.set_pause(false);
+    control->Publish(start);
+  }
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::duration<double>(options.timeout);
+  double end_time = options.auto_time + options.teleop_time;
+  msgs::DriverStation state;
+  while (status == "ok") {
+    double time = clock.Get();
+    if (time >= end_time) break;
+    state.set_enabled(true);
+    state.set_state(time < options.auto_time ? msgs::DriverStation::AUTO
+                                              : msgs::DriverStation::TELEOP);
+    ds->Publish(state);
+
+    if (interrupted) status = "interrupted";
+    else if (Exited(robot)) status = "robot exited";
+    else if (Exited(server)) status = "simulator exited";
+    else if (std::chrono::steady_clock::now() > deadline) status = "timeout";
+    // Driver station packets come every 20ms
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  state.set_enabled(false);
+  ds->Publish(state);
+
+  std::ofstream result(dir + "/result.csv");
+  result << index;
+  for (size_t i = 0; i < keys.size(); i++) {
+    result << "," << (i < values.size() ? values[i] : "");
+  }
+  result << "," << status << "," << clock.Get();
+  for (auto &metric : metrics) {
+    result << "," << metric->Columns();
+  }
+  result << std::endl;
+
+  Stop(robot);
+  Stop(server);
+  node->Fini();
+  gazebo::client::shutdown();
+  return status == "ok" ? 0 : 1;
+}
+
+static void Usage() {
+  std::cerr << "usage: frc_batch_runner --world file --robot command "
+               "[--params file | --runs n] [--metric topic]... [--auto s] "
+               "[--teleop s] [--timeout s] [--jobs n] [--port n] [--nt-port n] "
+               "[--world-name name] [--dir path] [--output file]"
+            << std::endl;
+}
+
+static const int kMaxInt = std::numeric_limits<int>::max();
+static const int kMaxPort = 65535;
+
+/// \brief Parse a whole option value as a number from min to max.
+static bool ParseInt(const std::string &value, int min, int max,
+                     int *result) {
+  char *end;
+  errno = 0;
+  long number = std::strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || errno != 0 || number < min ||
+      number > max) {
+    return false;
+  }
+  *result = number;
+  return true;
+}
+
+/// \brief Parse a whole option value as a number of seconds, at least 0.
+static bool ParseSeconds(const std::string &value, double *result) {
+  char *end;
+  errno = 0;
+  double number = std::strtod(value.c_str(), &end);
+  if (value.empty() || *end != '\0' || errno != 0 || !(number >= 0) ||
+      number == std::numeric_limits<double>::infinity()) {
+    return false;
+  }
+  *result = number;
+  return true;
+}
+
+static bool ParseOptions(int argc, char **argv, Options *options) {
+  for (int i = 1; i < argc; i++) {
+    std::string option = argv[i];
+    if (i + 1 >= argc) return false;
+    std::string value = argv[++i];
+    bool ok = true;
+    if (option == "--world") {
+      options->world = value;
+    } else if (option == "--world-name") {
+      options->world_name = value;
+    } else if (option == "--robot") {
+      options->robot = value;
+    } else if (option == "--params") {
+      options->params = value;
+    } else if (option == "--runs") {
+      ok = ParseInt(value, 1, kMaxInt, &options->runs);
+    } else if (option == "--metric") {
+      // The topic names the metric's columns in the results
+      ok = value.find_first_of(",\"") == std::string::npos;
+      options->metrics.push_back(value);
+    } else if (option == "--auto") {
+      ok = ParseSeconds(value, &options->auto_time);
+    } else if (option == "--teleop") {
+      ok = ParseSeconds(value, &options->teleop_time);
+    } else if (option == "--timeout") {
+      ok = ParseSeconds(value, &options->timeout);
+    } else if (option == "--jobs") {
+      ok = ParseInt(value, 0, kMaxInt, &options->jobs);
+    } else if (option == "--port") {
+      ok = ParseInt(value, 1, kMaxPort, &options->port);
+    } else if (option == "--nt-port") {
+      ok = ParseInt(value, 1, kMaxPort, &options->nt_port);
+    } else if (option == "--dir") {
+      options->dir = value;
+    } else if (option == "--output") {
+      options->output = value;
+    } else {
+      return false;
+    }
+    if (!ok) {
+      std::cerr << "Bad value for " << option << ": " << value << std::endl;
+      return false;
+    }
+  }
+  return !options->world.empty() && !options->robot.empty();
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    Usage();
+    return 2;
+  }
+
+  // Each run works in its own directory
+  char path[PATH_MAX];
+  if (realpath(options.world.c_str(), path) == nullptr) {
+    std::cerr << "Can't find world " << options.world << std::endl;
+    return 1;
+  }
+  options.world = path;
+  mkdir(options.dir.c_str(), 0755);
+
+  std::vector<std::string> keys;
+  std::vector<std::vector<std::string>> runs;
+  if (!options.params.empty()) {
+    std::ifstream params(options.params);
+    std::string line;
+    if (!params || !std::getline(params, line)) {
+      std::cerr << "Can't read " << options.params << std::endl;
+      return 1;
+    }
+    bool quoted = !SplitCsv(line, &keys);
+    while (!quoted && std::getline(params, line)) {
+      if (line.empty()) continue;
+      runs.emplace_back();
+      quoted = !SplitCsv(line, &runs.back());
+    }
+    if (quoted) {
+      std::cerr << options.params << " has a quoted field, which isn't "
+                << "supported" << std::endl;
+      return 1;
+    }
+  } else {
+    runs.resize(options.runs);
+  }
+
+  // Each run needs a port of each kind to itself
+  long count = runs.size();
+  if (options.port + count - 1 > kMaxPort ||
+      options.nt_port + count - 1 > kMaxPort ||
+      (options.port < options.nt_port + count &&
+       options.nt_port < options.port + count)) {
+    std::cerr << "The Gazebo and NetworkTables ports of the " << count
+              << " runs overlap or go past " << kMaxPort
+              << "; change --port or --nt-port" << std::endl;
+    return 1;
+  }
+
+  int jobs = options.jobs;
+  if (jobs <= 0) {
+    jobs = std::max(1u, std::thread::hardware_concurrency() / 2);
+  }
+
+  // Ctrl-C reaches the runs too; they stop their simulations and write what
+  // they have, and no more are started.
+  signal(SIGINT, Interrupt);
+  signal(SIGTERM, Interrupt);
+
+  // The parent never touches Gazebo transport, which can only talk to one
+  // master per process; each run is a fork of its own.
+  int next = 0, active = 0;
+  while ((next < (int)runs.size() && !interrupted) || active > 0) {
+    if (next < (int)runs.size() && active < jobs && !interrupted) {
+      pid_t pid = fork();
+      if (pid == 0) _exit(Run(options, next, keys, runs[next]));
+      if (pid < 0) {
+        std::cerr << "Can't start run " << next << ": " << strerror(errno)
+                  << std::endl;
+        return 1;
+      }
+      std::cout << "Started run " << next << " of " << runs.size() << std::endl;
+      next++;
+      active++;
+    } else if (wait(nullptr) > 0) {
+      active--;
+    }
+  }
+
+  std::ofstream output(options.output);
+  output << "run";
+  for (const std::string &key : keys) output << "," << key;
+  output << ",status,sim_time";
+  for (const std::string &topic : options.metrics) {
+    output << "," << topic << " final," << topic << " min," << topic << " max";
+  }
+  output << std::endl;
+  for (size_t i = 0; i < runs.size(); i++) {
+    std::ifstream result(options.dir + "/run-" + std::to_string(i) +
+                         "/result.csv");
+    std::string line;
+    if (std::getline(result, line)) {
+      output << line << std::endl;
+    } else {
+      output << i;
+      for (size_t k = 0; k < keys.size(); k++) {
+        output << "," << (k < runs[i].size() ? runs[i][k] : "");
+      }
+      output << ",failed," << std::string(3 * options.metrics.size(), ',')
+             << std::endl;
+    }
+  }
+  std::cout << "Wrote " << options.output << std::endl;
+  return 0;
+}
@@ -1,10 +1,42 @@
 #include "dc_motor.h"
 
+#include <cmath>
+
 GZ_REGISTER_MODEL_PLUGIN(DCMotor)
 
-DCMotor::DCMotor() {}
+/// \brief The moment of inertia of a joint's child link about the joint's
+///        axis. Links further down the chain aren't counted.
+static double JointInertia(physics::JointPtr joint) {
+  physics::LinkPtr child = joint->GetChild();
+  if (!child) {
+    return 0;
+  }
+  physics::InertialPtr inertial = child->GetInertial();
+  math::Pose cog = child->GetWorldCoGPose();
+  math::Vector3 axis = joint->GetGlobalAxis(0).Normalize();
+
+  // About the center of gravity, in the frame the inertia is given in
+  math::Vector3 local = cog.rot.RotateVectorReverse(axis);
+  math::Matrix3 moi = inertial->GetMOI();
+  double inertia = 0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      inertia += local[i] * moi[i][j] * local[j];
+    }
+  }
+
+  // Moved to the joint's axis
+  math::Vector3 offset = (cog.pos - joint->GetAnchor(0)).Cross(axis);
+  return inertia + inertial->GetMass() * offset.GetSquaredLength();
+}
+
+DCMotor::DCMotor() : electrical_index(-1) {}
 
-DCMotor::~DCMotor() {}
+DCMotor::~DCMotor() {
+  if (electrical_index >= 0) {
+    ElectricalSystem::Get().Remove(electrical_index);
+  }
+}
 
 void DCMotor::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   this->model = model;
@@ -24,8 +56,35 @@ void DCMotor::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
     multiplier = 1;
   }
 
-  gzmsg << "Initializing motor: " << topic << " joint=" << joint->GetName()
-        << " multiplier=" << multiplier << std::endl;
+  bool modeled = sdf->HasElement("stall_torque") && sdf->HasElement("free_speed");
+  double stall_torque = 0, free_speed = 0, inertia = 0;
+  double resistance = MotorBank::kNominalVoltage / 131;
+  if (modeled) {
+    stall_torque = sdf->Get<double>("stall_torque");
+    free_speed = sdf->Get<double>("free_speed");
+    if (sdf->HasElement("resistance")) {
+      resistance = sdf->Get<double>("resistance");
+    }
+    // The model divides by each of them
+    if (!(stall_torque > 0 && free_speed > 0 && resistance > 0)) {
+      gzerr << "Motor " << topic << " needs a positive stall_torque, "
+            << "free_speed and resistance; using its multiplier instead."
+            << std::endl;
+      modeled = false;
+    }
+  }
+
+  if (modeled) {
+    inertia = JointInertia(joint);
+    gzmsg << "Initializing motor: " << topic << " joint=" << joint->GetName()
+          << " stall_torque=" << stall_torque
+          << " free_speed=" << free_speed
+          << " resistance=" << resistance
+          << " inertia=" << inertia << std::endl;
+  } else {
+    gzmsg << "Initializing motor: " << topic << " joint=" << joint->GetName()
+          << " multiplier=" << multiplier << std::endl;
+  }
 
   // Connect to Gazebo transport for messaging
   std::string scoped_name = model->GetWorld()->GetName()+"::"+model->GetScopedName();
@@ -33,18 +92,79 @@ void DCMotor::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   node = transport::NodePtr(new transport::Node());
   node->Init(scoped_name);
   sub = node->Subscribe(topic, &DCMotor::Callback, this);
+  frame_index = frames.Open() ? frames.AddOutput(topic) : -1;
+  current_index = -1;
+
+  if (!modeled) {
+    // Connect to the world update event.
+    // This will trigger the Update function every Gazebo iteration
+    updateConn = event::Events::ConnectWorldUpdateBegin(boost::bind(&DCMotor::Update, this, _1));
+    return;
+  }
 
-  // Connect to the world update event.
-  // This will trigger the Update function every Gazebo iteration
-  updateConn = event::Events::ConnectWorldUpdateBegin(boost::bind(&DCMotor::Update, this, _1));
+  if (sdf->HasElement("pdp_channel")) {
+    std::string current_topic = "/gazebo/frc/simulator/pdp/" +
+        sdf->Get<std::string>("pdp_channel") + "/current";
+    current_pub = node->Advertise<msgs::Float64>(current_topic);
+    if (frames.IsOpen()) {
+      current_index = frames.AddInput(current_topic);
+      endConn = event::Events::ConnectWorldUpdateEnd(
+          boost::bind(&frc_sim::FrameWriter::Publish, &frames));
+    }
+  }
+
+  ElectricalSystem &system = ElectricalSystem::Get();
+  if (sdf->HasElement("battery_voltage")) {
+    system.SetBatteryVoltage(sdf->Get<double>("battery_voltage"));
+  }
+  if (sdf->HasElement("battery_resistance")) {
+    system.SetBatteryResistance(sdf->Get<double>("battery_resistance"));
+  }
+  // The system updates every modeled motor at once, at the start of each step
+  electrical_index = system.Add(this, model->GetWorld(), stall_torque,
+                                free_speed, resistance, inertia);
 }
 
 void DCMotor::Update(const common::UpdateInfo &info) {
+  ReadSignal();
   joint->SetForce(0, signal*multiplier);
 }
 
+void DCMotor::Gather(double *signal, double *velocity) {
+  ReadSignal();
+  *signal = this->signal;
+  *velocity = joint->GetVelocity(0);
+}
+
+void DCMotor::Apply(double torque, double current, uint64_t iteration, double time) {
+  joint->SetForce(0, torque);
+  if (!current_pub) {
+    return;
+  }
+
+  // The PDP measures the size of the current, not its direction
+  current = std::abs(current);
+  frames.SetInput(current_index, current, iteration, time);
+  if (!frames.InputBound(current_index) && current_pub->HasConnections()) {
+    msgs::Float64 msg;
+    msg.set_data(current);
+    current_pub->Publish(msg);
+  }
+}
+
 void DCMotor::Callback(const msgs::ConstFloat64Ptr &msg) {
-  signal = msg->data();
+  SetSignal(msg->data());
+}
+
+void DCMotor::ReadSignal() {
+  double value;
+  if (frames.GetOutput(frame_index, &value)) {
+    SetSignal(value);
+  }
+}
+
+void DCMotor::SetSignal(double value) {
+  signal = value;
   if (signal < -1) { signal = -1; }
   else if (signal > 1) { signal = 1; }
 }
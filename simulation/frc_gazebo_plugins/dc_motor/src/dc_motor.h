@@ -1,12 +1,13 @@
 #pragma once
 
 #include "simulation/gz_msgs/msgs.h"
+#include "simulation/gz_msgs/shared_frame.h"
 
 #include <gazebo/physics/physics.hh>
 #include <gazebo/transport/transport.hh>
 #include <gazebo/gazebo.hh>
 
-
+#include "electrical_system.h"
 
 
 using namespace gazebo;
@@ -15,8 +16,9 @@ using namespace gazebo;
  * \brief Plugin for controlling a joint with a DC motor.
  *
  * This plugin subscribes to a topic to get a signal in the range
- * [-1,1]. Every physics update the joint's torque is set as
- * multiplier*signal.
+ * [-1,1]. Every physics update the joint's torque is set from the
+ * signal, either as multiplier*signal, or by a model of the motor's
+ * electrical behavior when its specifications are given.
  *
  * To add a DC motor to your robot, add the following XML to your
  * robot model:
@@ -27,9 +29,44 @@ using namespace gazebo;
  *       <multiplier>Number</multiplier>
  *     </plugin>
  *
+ * or, to model the motor,
+ *
+ *     <plugin name="my_motor" filename="libgz_dc_motor.so">
+ *       <joint>Joint Name</joint>
+ *       <topic>~/my/topic</topic>
+ *       <stall_torque>Number</stall_torque>
+ *       <free_speed>Number</free_speed>
+ *       <resistance>Number</resistance>
+ *       <pdp_channel>Number</pdp_channel>
+ *     </plugin>
+ *
  * - `joint`: Name of the joint this Dc motor is attached to.
  * - `topic`: Optional. Message type should be gazebo.msgs.Float64.
  * - `multiplier`: Optional. Defaults to 1.
+ * - `stall_torque`: Optional. Torque on the joint at 12V and zero speed,
+ *                   in N*m, so including any gearing.
+ * - `free_speed`: Optional. Speed of the joint at 12V with no load, in
+ *                 rad/s. The motor is modeled when both this and
+ *                 `stall_torque` are given.
+ * - `resistance`: Optional. Winding resistance in ohms. Defaults to a
+ *                 CIM's, 12V/131A.
+ * - `pdp_channel`: Optional. The current drawn by the motor controller is
+ *                  published on /gazebo/frc/simulator/pdp/`pdp_channel`/current
+ *                  (gazebo.msgs.Float64).
+ * - `battery_voltage`, `battery_resistance`: Optional. The battery's open
+ *                  circuit voltage and internal resistance, shared by all
+ *                  modeled motors, so they only need to be given once.
+ *                  Default to 12.5V and 0.015 ohms.
+ *
+ * Modeled motors slow down with back EMF, and all draw their current from
+ * one battery, whose voltage sags under load. The back EMF is solved
+ * implicitly with the inertia of the joint's child link, so it stays stable
+ * for light joints with a lot of gearing. `stall_torque`, `free_speed` and
+ * `resistance` must be positive, or the motor uses `multiplier` instead. The bus voltage is published
+ * on /gazebo/frc/simulator/pdp/voltage (gazebo.msgs.Float64).
+ *
+ * When the robot program writes the signal to the shared memory frame
+ * instead of the topic, it's read from there.
  */
 class DCMotor: public ModelPlugin {
 public:
@@ -42,6 +79,12 @@ public:
   /// \brief Update the torque on the joint from the dc motor each timestep.
   void Update(const common::UpdateInfo &info);
 
+  /// \brief Get the signal and joint velocity for the electrical model.
+  void Gather(double *signal, double *velocity);
+
+  /// \brief Apply the electrical model's torque and publish the current.
+  void Apply(double torque, double current, uint64_t iteration, double time);
+
 private:
   /// \brief Topic to read control signal from.
   std::string topic;
@@ -58,9 +101,24 @@ private:
   /// \brief Callback for receiving msgs and storing the signal.
   void Callback(const msgs::ConstFloat64Ptr &msg);
 
+  /// \brief Limit a signal to [-1,1] and store it.
+  void SetSignal(double value);
+
+  /// \brief Take the signal from the shared memory frame, if it's there.
+  void ReadSignal();
+
+  /// \brief Index in the ElectricalSystem, or -1 if the motor isn't modeled.
+  int electrical_index;
+
+  /// \brief Shared memory transport, and the signal's and current's indices
+  ///        in it.
+  frc_sim::FrameWriter frames;
+  int frame_index, current_index;
 
   physics::ModelPtr model;         ///< \brief The model that this is attached to.
   event::ConnectionPtr updateConn; ///< \brief Pointer to the world update function.
+  event::ConnectionPtr endConn;    ///< \brief Publishes the frame at the end of a step.
   transport::NodePtr node;         ///< \brief The node we're advertising on.
   transport::SubscriberPtr sub;    ///< \brief Subscriber handle.
+  transport::PublisherPtr current_pub; ///< \brief Current publisher handle.
 };
@@ -0,0 +1,73 @@
+#include "electrical_system.h"
+#include "dc_motor.h"
+
+ElectricalSystem &ElectricalSystem::Get() {
+  // Never destroyed, since it holds transport objects that can't outlive
+  // Gazebo's shutdown.
+  static ElectricalSystem *system = new ElectricalSystem();
+  return *system;
+}
+
+ElectricalSystem::ElectricalSystem()
+    : battery_voltage(12.5), battery_resistance(0.015), frame_index(-1) {}
+
+int ElectricalSystem::Add(DCMotor *motor, physics::WorldPtr world,
+                          double stall_torque, double free_speed,
+                          double resistance, double inertia) {
+  if (!this->world) {
+    this->world = world;
+    node = transport::NodePtr(new transport::Node());
+    node->Init(world->GetName());
+    pub = node->Advertise<msgs::Float64>("/gazebo/frc/simulator/pdp/voltage");
+    if (frames.Open()) {
+      frame_index = frames.AddInput("/gazebo/frc/simulator/pdp/voltage");
+      endConn = event::Events::ConnectWorldUpdateEnd(
+          boost::bind(&frc_sim::FrameWriter::Publish, &frames));
+    }
+    updateConn = event::Events::ConnectWorldUpdateBegin(
+        boost::bind(&ElectricalSystem::Update, this, _1));
+  }
+
+  motors.push_back(motor);
+  return bank.Add(stall_torque, free_speed, resistance, inertia);
+}
+
+void ElectricalSystem::Remove(int index) {
+  motors[index] = nullptr;
+  bank.Remove(index);
+}
+
+void ElectricalSystem::SetBatteryVoltage(double voltage) {
+  battery_voltage = voltage;
+}
+
+void ElectricalSystem::SetBatteryResistance(double resistance) {
+  battery_resistance = resistance;
+}
+
+void ElectricalSystem::Update(const common::UpdateInfo &info) {
+  const size_t n = motors.size();
+  for (size_t i = 0; i < n; i++) {
+    if (motors[i] != nullptr) {
+      motors[i]->Gather(&bank.signal[i], &bank.velocity[i]);
+    }
+  }
+
+  bank.Solve(battery_voltage, battery_resistance,
+             world->GetPhysicsEngine()->GetMaxStepSize());
+
+  uint64_t iteration = world->GetIterations();
+  double time = info.simTime.Double();
+  for (size_t i = 0; i < n; i++) {
+    if (motors[i] != nullptr) {
+      motors[i]->Apply(bank.torque[i], bank.current[i], iteration, time);
+    }
+  }
+
+  frames.SetInput(frame_index, bank.bus_voltage, iteration, time);
+  if (!frames.InputBound(frame_index) && pub->HasConnections()) {
+    msgs::Float64 msg;
+    msg.set_data(bank.bus_voltage);
+    pub->Publish(msg);
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "simulation/gz_msgs/msgs.h"
+#include "simulation/gz_msgs/shared_frame.h"
+#include "motor_bank.h"
+
+#include <gazebo/physics/physics.hh>
+#include <gazebo/transport/transport.hh>
+#include <gazebo/gazebo.hh>
+
+#include <vector>
+
+using namespace gazebo;
+
+class DCMotor;
+
+/**
+ * \brief The battery all the DC motors with electrical parameters share.
+ *
+ * It updates every motor in one pass at the start of each physics step,
+ * and publishes the bus voltage on ~/simulator/pdp/voltage.
+ */
+class ElectricalSystem {
+public:
+  /// \brief The system of the world being simulated.
+  static ElectricalSystem &Get();
+
+  /// \brief Add a motor, given its specifications and the inertia it
+  ///        turns (see MotorBank::Add()).
+  /// \return Its index, used to remove it.
+  int Add(DCMotor *motor, physics::WorldPtr world, double stall_torque,
+          double free_speed, double resistance, double inertia);
+
+  /// \brief Remove a motor that's being unloaded.
+  void Remove(int index);
+
+  /// \brief Set the battery's open circuit voltage.
+  void SetBatteryVoltage(double voltage);
+
+  /// \brief Set the battery's internal resistance in ohms.
+  void SetBatteryResistance(double resistance);
+
+  /// \brief Solve for this step and apply each motor's torque.
+  void Update(const common::UpdateInfo &info);
+
+private:
+  ElectricalSystem();
+
+  MotorBank bank;
+  std::vector<DCMotor*> motors;
+
+  double battery_voltage;
+  double battery_resistance;
+
+  /// \brief Shared memory transport, and the bus voltage's index in it.
+  frc_sim::FrameWriter frames;
+  int frame_index;
+
+  physics::WorldPtr world;          ///< \brief The world the motors are in.
+  event::ConnectionPtr updateConn;  ///< \brief Pointer to the world update function.
+  event::ConnectionPtr endConn;     ///< \brief Publishes the frame at the end of a step.
+  transport::NodePtr node;          ///< \brief The node we're advertising on.
+  transport::PublisherPtr pub;      ///< \brief Bus voltage publisher handle.
+};
@@ -0,0 +1,57 @@
+#include "motor_bank.h"
+
+int MotorBank::Add(double stall_torque, double free_speed, double resistance,
+                   double inertia) {
+  signal.push_back(0);
+  velocity.push_back(0);
+  // At stall the whole nominal voltage is across the windings, and at free
+  // speed all of it is back EMF.
+  kt.push_back(stall_torque * resistance / kNominalVoltage);
+  ke.push_back(kNominalVoltage / free_speed);
+  conductance.push_back(1 / resistance);
+  damping_rate.push_back(
+      inertia > 0 ? kt.back() * ke.back() / (resistance * inertia) : 0);
+  current.push_back(0);
+  torque.push_back(0);
+  step_conductance.push_back(StepConductance(signal.size() - 1));
+  return signal.size() - 1;
+}
+
+void MotorBank::Remove(int index) {
+  signal[index] = 0;
+  kt[index] = 0;
+  conductance[index] = 0;
+  step_conductance[index] = 0;
+}
+
+double MotorBank::StepConductance(size_t index) const {
+  // 1/(R + kt*ke*dt/J), as 1/R / (1 + kt*ke/(R*J)*dt)
+  return conductance[index] / (1 + damping_rate[index] * step_size);
+}
+
+void MotorBank::Solve(double battery_voltage, double battery_resistance,
+                      double step_size) {
+  const size_t n = signal.size();
+  if (step_size != this->step_size) {
+    this->step_size = step_size;
+    for (size_t i = 0; i < n; i++) step_conductance[i] = StepConductance(i);
+  }
+
+  double load = 0, emf = 0;
+  for (size_t i = 0; i < n; i++) {
+    double drive = signal[i] * step_conductance[i];
+    load += signal[i] * drive;
+    emf += drive * ke[i] * velocity[i];
+  }
+
+  bus_voltage = (battery_voltage + battery_resistance * emf) /
+                (1 + battery_resistance * load);
+  if (bus_voltage < 0) { bus_voltage = 0; }
+
+  for (size_t i = 0; i < n; i++) {
+    double motor_current =
+        (signal[i] * bus_voltage - ke[i] * velocity[i]) * step_conductance[i];
+    torque[i] = kt[i] * motor_current;
+    current[i] = signal[i] * motor_current;
+  }
+}
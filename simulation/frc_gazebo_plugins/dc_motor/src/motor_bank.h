@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * \brief The electrical state of a set of DC motors on one battery, kept
+ *        as one array per quantity so a step is a few flat loops over all
+ *        the motors.
+ *
+ * Each motor is driven by a motor controller at duty cycle `signal` in
+ * [-1,1] from the bus voltage V, so that its current and torque are
+ *
+ *     I_motor = (signal*V - ke*velocity) / R
+ *     torque = kt*I_motor
+ *
+ * and the controller draws signal*I_motor from the battery. The battery
+ * has an internal resistance Rb, so V = V_battery - Rb*sum(signal*I_motor),
+ * which solves to
+ *
+ *     V = (V_battery + Rb*sum(signal*ke*velocity/R)) / (1 + Rb*sum(signal^2/R))
+ *
+ * A motor at zero duty cycle is shorted by its controller, as in brake mode.
+ *
+ * The back EMF term brakes the joint like a damper of kt*ke/R. Taken at the
+ * velocity at the start of the step, it overshoots and diverges once that
+ * damping stops the joint's inertia J in less than a step. So the back EMF
+ * is taken at the velocity at the end of the step instead (backward Euler),
+ * which for a joint driven only by its motor works out to the same formulas
+ * with R replaced by R + kt*ke*dt/J. A motor whose inertia isn't known
+ * (0) keeps R.
+ */
+class MotorBank {
+public:
+  /// \brief Nominal voltage motor specifications are given at.
+  static constexpr double kNominalVoltage = 12;
+
+  MotorBank() : bus_voltage(kNominalVoltage), step_size(0) {}
+
+  /// \brief Add a motor from its specifications at kNominalVoltage.
+  /// \param[in] stall_torque Torque at zero speed, in N*m. Must be > 0.
+  /// \param[in] free_speed Speed with no load, in rad/s. Must be > 0.
+  /// \param[in] resistance Winding resistance in ohms. Must be > 0.
+  /// \param[in] inertia Moment of inertia the motor turns, in kg*m^2, or 0
+  ///                    if it isn't known.
+  /// \return The motor's index into the arrays.
+  int Add(double stall_torque, double free_speed, double resistance,
+          double inertia);
+
+  /// \brief Stop a motor taking part, without moving the others.
+  void Remove(int index);
+
+  /// \brief Compute the bus voltage and every motor's current and torque
+  ///        from the signals and velocities.
+  /// \param[in] step_size Length of the physics step, in seconds.
+  void Solve(double battery_voltage, double battery_resistance,
+             double step_size);
+
+  /// \brief Inputs, set before Solve().
+  std::vector<double> signal, velocity;
+
+  /// \brief Motor constants: torque per amp, volts per rad/s and 1/R.
+  std::vector<double> kt, ke, conductance;
+
+  /// \brief kt*ke/(R*J), the rate in 1/s at which the back EMF alone
+  ///        brakes the joint, or 0 if the inertia isn't known.
+  std::vector<double> damping_rate;
+
+  /// \brief Outputs of Solve(): the current each motor controller draws
+  ///        from the battery, and the torque on each motor.
+  std::vector<double> current, torque;
+
+  /// \brief Output of Solve(): the voltage at the motor controllers.
+  double bus_voltage;
+
+private:
+  /// \brief A motor's 1/R with the back EMF term made implicit.
+  double StepConductance(size_t index) const;
+
+  /// \brief Each motor's StepConductance() for step_size, which only
+  ///        changes with the physics settings.
+  std::vector<double> step_conductance;
+  double step_size;
+};
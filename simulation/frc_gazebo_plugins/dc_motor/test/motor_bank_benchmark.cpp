@@ -0,0 +1,45 @@
+/*
+ * Times MotorBank::Solve(), which the electrical system runs once per
+ * physics step for all the modeled motors, and reports the time per motor.
+ *
+ * Usage: motor_bank_benchmark [motors] [steps]
+ */
+
+#include "motor_bank.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv) {
+  int motors = argc > 1 ? std::atoi(argv[1]) : 1000;
+  int steps = argc > 2 ? std::atoi(argv[2]) : 10000;
+  if (motors <= 0 || steps <= 0) {
+    std::fprintf(stderr, "Usage: motor_bank_benchmark [motors] [steps]\n");
+    return 1;
+  }
+
+  // CIMs at half power, at a spread of speeds, some with a known inertia
+  MotorBank bank;
+  for (int i = 0; i < motors; i++) {
+    bank.Add(2.42, 5310 * 2 * M_PI / 60, 12.0 / 131, i % 2 == 0 ? 0.01 : 0);
+    bank.signal[i] = 0.5;
+    bank.velocity[i] = i % 300;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  double sum = 0;
+  for (int step = 0; step < steps; step++) {
+    bank.Solve(12.5, 0.015, 0.001);
+    sum += bank.bus_voltage;
+  }
+  double elapsed = std::chrono::duration<double, std::nano>(
+                       std::chrono::steady_clock::now() - start).count();
+
+  std::printf("%d motors, %d steps: %.2f ns/motor, %.0f ns/step "
+              "(mean bus voltage %.3fV)\n",
+              motors, steps, elapsed / steps / motors, elapsed / steps,
+              sum / steps);
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include "motor_bank.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+// A CIM: 2.42N*m at stall, 5310rpm free, 131A at stall
+static const double kStallTorque = 2.42;
+static const double kFreeSpeed = 5310 * 2 * M_PI / 60;
+static const double kResistance = 12.0 / 131;
+static const double kStep = 0.001;
+
+/**
+ * At the nominal voltage a motor gives its stall torque at zero speed, and
+ * no torque at its free speed.
+ */
+TEST(MotorBankTest, StallAndFreeSpeed) {
+  MotorBank bank;
+  bank.Add(kStallTorque, kFreeSpeed, kResistance, 0);
+  bank.signal[0] = 1;
+
+  bank.Solve(12, 0, kStep);
+  EXPECT_DOUBLE_EQ(12, bank.bus_voltage);
+  EXPECT_NEAR(kStallTorque, bank.torque[0], 1e-9);
+  EXPECT_NEAR(131, bank.current[0], 1e-9);
+
+  bank.velocity[0] = kFreeSpeed;
+  bank.Solve(12, 0, kStep);
+  EXPECT_NEAR(0, bank.torque[0], 1e-9);
+  EXPECT_NEAR(0, bank.current[0], 1e-9);
+}
+
+/**
+ * The bus voltage is what's left of the battery's after the drop across its
+ * internal resistance from the current all the controllers draw.
+ */
+TEST(MotorBankTest, BusVoltageSags) {
+  MotorBank bank;
+  const double signals[] = {1, -1, 0.5, 0};
+  const double velocities[] = {0, 100, -200, 300};
+  for (int i = 0; i < 4; i++) {
+    bank.Add(kStallTorque, kFreeSpeed, kResistance, 0);
+    bank.signal[i] = signals[i];
+    bank.velocity[i] = velocities[i];
+  }
+
+  bank.Solve(12.5, 0.015, kStep);
+  double total = 0;
+  for (int i = 0; i < 4; i++) total += bank.current[i];
+  EXPECT_LT(bank.bus_voltage, 12.5);
+  EXPECT_NEAR(12.5 - 0.015 * total, bank.bus_voltage, 1e-9);
+  // A shorted motor draws nothing from the battery, but still brakes
+  EXPECT_EQ(0, bank.current[3]);
+  EXPECT_LT(bank.torque[3], 0);
+}
+
+/**
+ * A removed motor stops loading the battery, and the others keep their
+ * indices.
+ */
+TEST(MotorBankTest, Remove) {
+  MotorBank bank;
+  bank.Add(kStallTorque, kFreeSpeed, kResistance, 0);
+  bank.Add(kStallTorque, kFreeSpeed, kResistance, 0);
+  bank.signal[0] = bank.signal[1] = 1;
+  bank.Solve(12.5, 0.015, kStep);
+  double loaded = bank.bus_voltage;
+
+  bank.Remove(0);
+  bank.Solve(12.5, 0.015, kStep);
+  EXPECT_EQ(0, bank.torque[0]);
+  EXPECT_EQ(0, bank.current[0]);
+  EXPECT_GT(bank.bus_voltage, loaded);
+  EXPECT_GT(bank.torque[1], 0);
+}
+
+/**
+ * Spins up a light, highly geared joint driven only by its motor, where the
+ * back EMF stops the joint in less than a step. Taking the back EMF at the
+ * start of the step makes the speed oscillate and grow; solving it
+ * implicitly settles at the free speed without overshooting.
+ */
+TEST(MotorBankTest, LightJointIsStable) {
+  const double gearing = 20;
+  const double inertia = 1e-4;
+  MotorBank implicit, explicit_;
+  implicit.Add(kStallTorque * gearing, kFreeSpeed / gearing, kResistance,
+               inertia);
+  explicit_.Add(kStallTorque * gearing, kFreeSpeed / gearing, kResistance, 0);
+  implicit.signal[0] = explicit_.signal[0] = 1;
+
+  for (int step = 0; step < 1000; step++) {
+    implicit.Solve(12, 0, kStep);
+    implicit.velocity[0] += implicit.torque[0] / inertia * kStep;
+    ASSERT_LE(implicit.velocity[0], kFreeSpeed / gearing * (1 + 1e-9));
+    explicit_.Solve(12, 0, kStep);
+    explicit_.velocity[0] += explicit_.torque[0] / inertia * kStep;
+  }
+  EXPECT_NEAR(kFreeSpeed / gearing, implicit.velocity[0], 1e-6);
+  // By now it may have gone past infinity to not a number
+  EXPECT_FALSE(std::abs(explicit_.velocity[0]) < 10 * kFreeSpeed / gearing);
+}
+
+/**
+ * For a joint heavy enough that the explicit solution is fine, the implicit
+ * one is close to it.
+ */
+TEST(MotorBankTest, HeavyJointMatchesExplicit) {
+  MotorBank implicit, explicit_;
+  implicit.Add(kStallTorque, kFreeSpeed, kResistance, 10);
+  explicit_.Add(kStallTorque, kFreeSpeed, kResistance, 0);
+  implicit.signal[0] = explicit_.signal[0] = 0.75;
+  implicit.velocity[0] = explicit_.velocity[0] = 200;
+
+  implicit.Solve(12.5, 0.015, kStep);
+  explicit_.Solve(12.5, 0.015, kStep);
+  EXPECT_NEAR(explicit_.torque[0], implicit.torque[0],
+              1e-4 * std::abs(explicit_.torque[0]));
+  EXPECT_NEAR(explicit_.bus_voltage, implicit.bus_voltage, 1e-4);
+}
@@ -37,6 +37,14 @@ void Encoder::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   command_sub = node->Subscribe(topic+"/control", &Encoder::Callback, this);
   pos_pub = node->Advertise<msgs::Float64>(topic+"/position");
   vel_pub = node->Advertise<msgs::Float64>(topic+"/velocity");
+  if (frames.Open()) {
+    pos_index = frames.AddInput(topic+"/position");
+    vel_index = frames.AddInput(topic+"/velocity");
+    endConn = event::Events::ConnectWorldUpdateEnd(
+        boost::bind(&frc_sim::FrameWriter::Publish, &frames));
+  } else {
+    pos_index = vel_index = -1;
+  }
 
   // Connect to the world update event.
   // This will trigger the Update function every Gazebo iteration
@@ -44,16 +52,26 @@ void Encoder::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
 }
 
 void Encoder::Update(const common::UpdateInfo &info) {
-  msgs::Float64 pos_msg, vel_msg;
+  double position, velocity;
   if (stopped) {
-    pos_msg.set_data(stop_value);
-    pos_pub->Publish(pos_msg);
-    vel_msg.set_data(0);
-    vel_pub->Publish(vel_msg);
+    position = stop_value;
+    velocity = 0;
   } else {
-    pos_msg.set_data(GetAngle() - zero);
+    position = GetAngle() - zero;
+    velocity = GetVelocity();
+  }
+
+  uint64_t iteration = model->GetWorld()->GetIterations();
+  frames.SetInput(pos_index, position, iteration, info.simTime.Double());
+  frames.SetInput(vel_index, velocity, iteration, info.simTime.Double());
+
+  msgs::Float64 pos_msg, vel_msg;
+  if (!frames.InputBound(pos_index) && pos_pub->HasConnections()) {
+    pos_msg.set_data(position);
     pos_pub->Publish(pos_msg);
-    vel_msg.set_data(GetVelocity());
+  }
+  if (!frames.InputBound(vel_index) && vel_pub->HasConnections()) {
+    vel_msg.set_data(velocity);
     vel_pub->Publish(vel_msg);
   }
 }
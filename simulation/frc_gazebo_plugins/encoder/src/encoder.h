@@ -1,6 +1,7 @@
 #pragma once
 
 #include "simulation/gz_msgs/msgs.h"
+#include "simulation/gz_msgs/shared_frame.h"
 
 #include <gazebo/physics/physics.hh>
 #include <gazebo/transport/transport.hh>
@@ -34,6 +35,11 @@ using namespace gazebo;
  * - `topic`: Optional. Used as the root for subtopics. `topic`/position (gazebo.msgs.Float64),
  *            `topic`/velocity (gazebo.msgs.Float64), `topic`/control (gazebo.msgs.String)
  * - `units`: Optional. Defaults to radians.
+ *
+ * Readings are also written to the shared memory frame (see the
+ * sensor_frame plugin), and are only published on the topic while
+ * something subscribes to it and the robot program isn't reading them
+ * from the frame.
  */
 class Encoder: public ModelPlugin {
 public:
@@ -76,8 +82,13 @@ private:
   ///        return radians/second or degrees/second.
   double GetVelocity();
 
+  /// \brief Shared memory transport, and the readings' indices in it.
+  frc_sim::FrameWriter frames;
+  int pos_index, vel_index;
+
   physics::ModelPtr model;                  ///< \brief The model that this is attached to.
   event::ConnectionPtr updateConn;          ///< \brief Pointer to the world update function.
+  event::ConnectionPtr endConn;             ///< \brief Publishes the shared memory frame.
   transport::NodePtr node;                  ///< \brief The node we're advertising on.
   transport::SubscriberPtr command_sub;     ///< \brief Subscriber handle.
   transport::PublisherPtr pos_pub, vel_pub; ///< \brief Publisher handles.
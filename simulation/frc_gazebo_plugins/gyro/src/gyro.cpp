@@ -41,6 +41,14 @@ void Gyro::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   command_sub = node->Subscribe(topic+"/control", &Gyro::Callback, this);
   pos_pub = node->Advertise<msgs::Float64>(topic+"/position");
   vel_pub = node->Advertise<msgs::Float64>(topic+"/velocity");
+  if (frames.Open()) {
+    pos_index = frames.AddInput(topic+"/position");
+    vel_index = frames.AddInput(topic+"/velocity");
+    endConn = event::Events::ConnectWorldUpdateEnd(
+        boost::bind(&frc_sim::FrameWriter::Publish, &frames));
+  } else {
+    pos_index = vel_index = -1;
+  }
 
   // Connect to the world update event.
   // This will trigger the Update function every Gazebo iteration
@@ -48,11 +56,22 @@ void Gyro::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
 }
 
 void Gyro::Update(const common::UpdateInfo &info) {
+  double position = Limit(GetAngle() - zero);
+  double velocity = GetVelocity();
+
+  uint64_t iteration = model->GetWorld()->GetIterations();
+  frames.SetInput(pos_index, position, iteration, info.simTime.Double());
+  frames.SetInput(vel_index, velocity, iteration, info.simTime.Double());
+
   msgs::Float64 pos_msg, vel_msg;
-  pos_msg.set_data(Limit(GetAngle() - zero));
-  pos_pub->Publish(pos_msg);
-  vel_msg.set_data(GetVelocity());
-  vel_pub->Publish(vel_msg);
+  if (!frames.InputBound(pos_index) && pos_pub->HasConnections()) {
+    pos_msg.set_data(position);
+    pos_pub->Publish(pos_msg);
+  }
+  if (!frames.InputBound(vel_index) && vel_pub->HasConnections()) {
+    vel_msg.set_data(velocity);
+    vel_pub->Publish(vel_msg);
+  }
 }
 
 void Gyro::Callback(const msgs::ConstStringPtr &msg) {
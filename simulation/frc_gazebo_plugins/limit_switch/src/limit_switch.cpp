@@ -32,6 +32,13 @@ void LimitSwitch::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   node = transport::NodePtr(new transport::Node());
   node->Init(scoped_name);
   pub = node->Advertise<msgs::Bool>(topic);
+  if (frames.Open()) {
+    frame_index = frames.AddInput(topic);
+    endConn = event::Events::ConnectWorldUpdateEnd(
+        boost::bind(&frc_sim::FrameWriter::Publish, &frames));
+  } else {
+    frame_index = -1;
+  }
 
   // Connect to the world update event.
   // This will trigger the Update function every Gazebo iteration
@@ -39,7 +46,13 @@ void LimitSwitch::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
 }
 
 void LimitSwitch::Update(const common::UpdateInfo &info) {
-  msgs::Bool msg;
-  msg.set_data(ls->Get());
-  pub->Publish(msg);
+  bool triggered = ls->Get();
+
+  frames.SetInput(frame_index, triggered ? 1 : 0,
+                  model->GetWorld()->GetIterations(), info.simTime.Double());
+  if (!frames.InputBound(frame_index) && pub->HasConnections()) {
+    msgs::Bool msg;
+    msg.set_data(triggered);
+    pub->Publish(msg);
+  }
 }
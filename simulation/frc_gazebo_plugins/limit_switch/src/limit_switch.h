@@ -1,6 +1,7 @@
 #pragma once
 
 #include "simulation/gz_msgs/msgs.h"
+#include "simulation/gz_msgs/shared_frame.h"
 
 #include "switch.h"
 
@@ -58,6 +59,11 @@ using namespace gazebo;
  *
  * External
  * - `sensor`: Name of the contact sensor that this limit switch uses.
+ *
+ * Readings are also written to the shared memory frame (see the
+ * sensor_frame plugin), and are only published on the topic while
+ * something subscribes to it and the robot program isn't reading them
+ * from the frame.
  */
 class LimitSwitch: public ModelPlugin {
 public:
@@ -77,9 +83,13 @@ private:
   /// \brief LimitSwitch object, currently internal or external.
   Switch* ls;
 
+  /// \brief Shared memory transport, and the reading's index in it.
+  frc_sim::FrameWriter frames;
+  int frame_index;
 
   physics::ModelPtr model;         ///< \brief The model that this is attached to.
   event::ConnectionPtr updateConn; ///< \brief Pointer to the world update function.
+  event::ConnectionPtr endConn;    ///< \brief Publishes the shared memory frame.
   transport::NodePtr node;         ///< \brief The node we're advertising on.
   transport::PublisherPtr pub;     ///< \brief Publisher handle.
 };
@@ -45,6 +45,7 @@ void PneumaticPiston::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   node = transport::NodePtr(new transport::Node());
   node->Init(scoped_name);
   sub = node->Subscribe(topic, &PneumaticPiston::Callback, this);
+  frame_index = frames.Open() ? frames.AddOutput(topic) : -1;
 
   // Connect to the world update event.
   // This will trigger the Update function every Gazebo iteration
@@ -52,10 +53,18 @@ void PneumaticPiston::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
 }
 
 void PneumaticPiston::Update(const common::UpdateInfo &info) {
+  double value;
+  if (frames.GetOutput(frame_index, &value)) {
+    SetSignal(value);
+  }
   joint->SetForce(0, signal);
 }
 
 void PneumaticPiston::Callback(const msgs::ConstFloat64Ptr &msg) {
-  if (msg->data() < -0.001) { signal = -reverse_force; }
-  else if (msg->data() > 0.001) { signal = forward_force; }
+  SetSignal(msg->data());
+}
+
+void PneumaticPiston::SetSignal(double value) {
+  if (value < -0.001) { signal = -reverse_force; }
+  else if (value > 0.001) { signal = forward_force; }
 }
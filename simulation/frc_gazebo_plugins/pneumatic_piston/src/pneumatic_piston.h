@@ -1,6 +1,7 @@
 #pragma once
 
 #include "simulation/gz_msgs/msgs.h"
+#include "simulation/gz_msgs/shared_frame.h"
 
 #include <gazebo/gazebo.hh>
 
@@ -38,6 +39,9 @@ using namespace gazebo;
  * - `forward-force`: Force to apply in the forward direction.
  * - `reverse-force`: Force to apply in the reverse direction.
  *
+ * When the robot program writes the signal to the shared memory frame
+ * instead of the topic, it's read from there.
+ *
  * \todo Signal should probably be made a tri-state message.
  */
 class PneumaticPiston: public ModelPlugin {
@@ -67,6 +71,12 @@ private:
   /// \brief Callback for receiving msgs and updating the torque.
   void Callback(const msgs::ConstFloat64Ptr &msg);
 
+  /// \brief Update the force from a signal.
+  void SetSignal(double value);
+
+  /// \brief Shared memory transport, and the signal's index in it.
+  frc_sim::FrameWriter frames;
+  int frame_index;
 
   physics::ModelPtr model;         ///< \brief The model that this is attached to.
   event::ConnectionPtr updateConn; ///< \brief Pointer to the world update function.
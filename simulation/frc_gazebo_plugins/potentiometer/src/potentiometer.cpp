@@ -43,6 +43,13 @@ void Potentiometer::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   node = transport::NodePtr(new transport::Node());
   node->Init(scoped_name);
   pub = node->Advertise<msgs::Float64>(topic);
+  if (frames.Open()) {
+    frame_index = frames.AddInput(topic);
+    endConn = event::Events::ConnectWorldUpdateEnd(
+        boost::bind(&frc_sim::FrameWriter::Publish, &frames));
+  } else {
+    frame_index = -1;
+  }
 
   // Connect to the world update event.
   // This will trigger the Update function every Gazebo iteration
@@ -51,11 +58,18 @@ void Potentiometer::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
 
 void Potentiometer::Update(const common::UpdateInfo &info) {
   joint->GetAngle(0).Normalize();
-  msgs::Float64 msg;
+  double angle;
   if (radians) {
-    msg.set_data(joint->GetAngle(0).Radian());
+    angle = joint->GetAngle(0).Radian();
   } else {
-    msg.set_data(joint->GetAngle(0).Degree());
+    angle = joint->GetAngle(0).Degree();
+  }
+
+  frames.SetInput(frame_index, angle, model->GetWorld()->GetIterations(),
+                  info.simTime.Double());
+  if (!frames.InputBound(frame_index) && pub->HasConnections()) {
+    msgs::Float64 msg;
+    msg.set_data(angle);
+    pub->Publish(msg);
   }
-  pub->Publish(msg);
 }
@@ -38,6 +38,13 @@ void Rangefinder::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
   node = transport::NodePtr(new transport::Node());
   node->Init(scoped_name);
   pub = node->Advertise<msgs::Float64>(topic);
+  if (frames.Open()) {
+    frame_index = frames.AddInput(topic);
+    endConn = event::Events::ConnectWorldUpdateEnd(
+        boost::bind(&frc_sim::FrameWriter::Publish, &frames));
+  } else {
+    frame_index = -1;
+  }
 
   // Connect to the world update event.
   // This will trigger the Update function every Gazebo iteration
@@ -45,7 +52,13 @@ void Rangefinder::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
 }
 
 void Rangefinder::Update(const common::UpdateInfo &info) {
-  msgs::Float64 msg;
-  msg.set_data(sensor->GetRange());
-  pub->Publish(msg);
+  double range = sensor->GetRange();
+
+  frames.SetInput(frame_index, range, model->GetWorld()->GetIterations(),
+                  info.simTime.Double());
+  if (!frames.InputBound(frame_index) && pub->HasConnections()) {
+    msgs::Float64 msg;
+    msg.set_data(range);
+    pub->Publish(msg);
+  }
 }
@@ -0,0 +1,73 @@
+#include "sensor_frame.h"
+
+GZ_REGISTER_MODEL_PLUGIN(SensorFrame)
+
+SensorFrame::SensorFrame() {}
+
+SensorFrame::~SensorFrame() {}
+
+void SensorFrame::Load(physics::ModelPtr model, sdf::ElementPtr sdf) {
+  this->model = model;
+  layout_size = 0;
+  last_iteration = 0;
+
+  // Parse SDF properties
+  if (sdf->HasElement("topic")) {
+    topic = sdf->Get<std::string>("topic");
+  } else {
+    // Where robot code looks for it, whatever the plugin is called
+    topic = "/gazebo/frc/simulator/sensors";
+  }
+
+  if (!frames.Open()) {
+    gzerr << "WARNING: Sensor frame " << topic
+          << " needs the shared memory transport." << std::endl;
+    return;
+  }
+
+  gzmsg << "Initializing sensor frame: " << topic << std::endl;
+
+  // Connect to Gazebo transport for messaging
+  std::string scoped_name = model->GetWorld()->GetName()+"::"+model->GetScopedName();
+  boost::replace_all(scoped_name, "::", "/");
+  node = transport::NodePtr(new transport::Node());
+  node->Init(scoped_name);
+  pub = node->Advertise<msgs::SensorFrame>(topic);
+  layout_pub = node->Advertise<msgs::SensorFrameLayout>(topic+"/layout");
+
+  // Connect to the world update end event, after the sensor plugins have
+  // written their readings for the step.
+  updateConn = event::Events::ConnectWorldUpdateEnd(boost::bind(&SensorFrame::Update, this));
+}
+
+void SensorFrame::Update() {
+  // The sensor plugins publish the frame at the end of the step too, but
+  // there's no telling whose handler runs first.
+  frames.Publish();
+
+  uint32_t size = frames.NumInputs();
+  if (size != layout_size) {
+    msgs::SensorFrameLayout layout;
+    for (uint32_t i = 0; i < size; i++) {
+      layout.add_names(frames.InputName(i));
+    }
+    layout_pub->Publish(layout);
+    layout_size = size;
+  }
+
+  double values[frc_sim::kMaxSignals];
+  double time;
+  uint64_t iteration = frames.ReadFrame(values, size, &time);
+  if (iteration == 0 || iteration == last_iteration || !pub->HasConnections()) {
+    return;
+  }
+  last_iteration = iteration;
+
+  msg.set_time(time);
+  msg.set_iteration(iteration);
+  msg.clear_values();
+  for (uint32_t i = 0; i < size; i++) {
+    msg.add_values(values[i]);
+  }
+  pub->Publish(msg);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "simulation/gz_msgs/msgs.h"
+#include "simulation/gz_msgs/shared_frame.h"
+
+#include <gazebo/physics/physics.hh>
+#include <gazebo/transport/transport.hh>
+#include <gazebo/gazebo.hh>
+
+using namespace gazebo;
+
+/**
+ * \brief Plugin for publishing every sensor reading of a physics step in
+ * one message.
+ *
+ * The sensor plugins (encoder, gyro, potentiometer, limit switch and
+ * rangefinder) write their readings into the shared memory frame each
+ * step. This plugin publishes the whole frame at the end of the step as
+ * a single gazebo.msgs.SensorFrame stamped with the simulation time, so
+ * robot code that can't map the frame, for example because it runs on
+ * another machine, still gets one message per step instead of one per
+ * reading, with all readings taken at the same time. The sensor plugins
+ * stop publishing their own topics once nothing subscribes to them.
+ *
+ * The names of the readings are published as a
+ * gazebo.msgs.SensorFrameLayout on `topic`/layout whenever a sensor is
+ * added; subscribe to it with latching to get the current layout.
+ *
+ * To add it to your robot, add the following XML to your robot model:
+ *
+ *     <plugin name="sensor_frame" filename="libgz_sensor_frame.so">
+ *       <topic>/gazebo/frc/simulator/sensors</topic>
+ *     </plugin>
+ *
+ * - `topic`: Optional. Message type is gazebo.msgs.SensorFrame. Defaults to
+ *   /gazebo/frc/simulator/sensors, the topic robot code reads; robot code
+ *   won't find the frame on any other topic.
+ *
+ * Requires the shared memory transport, so it does nothing if
+ * FRCSIM_SHARED_MEMORY is 0.
+ */
+class SensorFrame: public ModelPlugin {
+public:
+  SensorFrame();
+  ~SensorFrame();
+
+  /// \brief Load the sensor frame and configures it according to the sdf.
+  void Load(physics::ModelPtr model, sdf::ElementPtr sdf);
+
+  /// \brief Sends out the readings at the end of each timestep.
+  void Update();
+
+private:
+  /// \brief Publish the readings on this topic.
+  std::string topic;
+
+  /// \brief The frame the sensor plugins write their readings to.
+  frc_sim::FrameWriter frames;
+
+  /// \brief The number of names in the last layout published.
+  uint32_t layout_size;
+
+  /// \brief The iteration of the last frame published.
+  uint64_t last_iteration;
+
+  /// \brief Reused for every frame, to avoid allocating.
+  msgs::SensorFrame msg;
+
+  physics::ModelPtr model;         ///< \brief The model that this is attached to.
+  event::ConnectionPtr updateConn; ///< \brief Pointer to the world update function.
+  transport::NodePtr node;         ///< \brief The node we're advertising on.
+  transport::PublisherPtr pub;     ///< \brief Publisher handle.
+  transport::PublisherPtr layout_pub; ///< \brief Layout publisher handle.
+};
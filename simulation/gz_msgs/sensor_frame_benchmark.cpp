@@ -0,0 +1,85 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Compares the protobuf cost of sending the readings of one physics step as
+ * one gazebo.msgs.Float64 per sensor with sending them as one
+ * gazebo.msgs.SensorFrame. Each message is serialized and parsed again, as
+ * it would be by the sensor plugin and robot code. Gazebo's transport isn't
+ * involved, so this is the least either way costs per step.
+ *
+ * Usage: sensor_frame_benchmark [steps]
+ */
+
+#include "simulation/gz_msgs/float64.pb.h"
+#include "simulation/gz_msgs/sensor-frame.pb.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static const int kSensors = 20;
+
+static void Report(const char *name, int steps,
+                   std::chrono::steady_clock::duration elapsed,
+                   size_t bytes, int messages) {
+  std::printf("%-14s %8.0f ns/step %5zu bytes/step %3d messages/step\n", name,
+              std::chrono::duration<double, std::nano>(elapsed).count() /
+                  steps,
+              bytes / steps, messages);
+}
+
+int main(int argc, char **argv) {
+  int steps = argc > 1 ? std::atoi(argv[1]) : 200000;
+  if (steps <= 0) {
+    std::fprintf(stderr, "Usage: sensor_frame_benchmark [steps]\n");
+    return 1;
+  }
+  std::printf("%d sensors, %d steps\n", kSensors, steps);
+
+  // Checked at the end, so the parsing can't be optimized away
+  double sum = 0, frameSum = 0;
+  std::string wire;
+
+  size_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; step++) {
+    for (int i = 0; i < kSensors; i++) {
+      gazebo::msgs::Float64 sent, received;
+      sent.set_data(step + i);
+      sent.SerializeToString(&wire);
+      bytes += wire.size();
+      received.ParseFromString(wire);
+      sum += received.data();
+    }
+  }
+  Report("Float64", steps, std::chrono::steady_clock::now() - start, bytes,
+         kSensors);
+
+  bytes = 0;
+  gazebo::msgs::SensorFrame sent, received;
+  start = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; step++) {
+    sent.set_time(step * 0.001);
+    sent.set_iteration(step);
+    sent.clear_values();
+    for (int i = 0; i < kSensors; i++) sent.add_values(step + i);
+    sent.SerializeToString(&wire);
+    bytes += wire.size();
+    received.ParseFromString(wire);
+    for (double value : received.values()) frameSum += value;
+  }
+  Report("SensorFrame", steps, std::chrono::steady_clock::now() - start,
+         bytes, 1);
+
+  if (sum != frameSum) {
+    std::fprintf(stderr, "The readings don't match\n");
+    return 1;
+  }
+  return 0;
+}
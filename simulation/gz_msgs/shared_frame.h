@@ -0,0 +1,511 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \brief Shared memory transport between the frc_gazebo_plugins and
+ * simulated robot code.
+ *
+ * Every signal (a sensor reading or a motor output) travels as its own
+ * protobuf message on its own Gazebo topic, so each sample pays for
+ * serialization and a trip through a socket. When both sides run on the same
+ * machine, this header lets them exchange the values through one fixed-layout
+ * SharedFrame instead:
+ *
+ * - Sensor plugins write their readings into the frame being built for the
+ *   current physics step, and the frame is published once at the end of the
+ *   step, so robot code always sees the readings of one step together. The
+ *   last kRingSize frames are kept in a ring, each guarded by a sequence
+ *   number, so the robot never waits for the simulator and vice versa.
+ * - Robot code writes outputs into one slot per signal, which motor plugins
+ *   read every step.
+ *
+ * The segment is created by Gazebo when the first plugin loads, with the
+ * name of every signal a plugin registers. Robot code binds to signals by
+ * name when its devices are created. Anything that can't be bound (the
+ * segment doesn't exist, was made by a different version of this header, or
+ * has no signal by that name) keeps using its topic, and plugins keep
+ * publishing on the topics of signals that robot code hasn't bound, so Java
+ * robot programs and older plugins work as before.
+ *
+ * The segment is unlinked when the last plugin of the Gazebo process that
+ * made it is unloaded. When the robot program exits its signals are unbound,
+ * so the plugins go back to their topics; a robot program that dies without
+ * exiting is noticed within about a second.
+ *
+ * Set the environment variable FRCSIM_SHARED_MEMORY to 0 on either side to
+ * turn the transport off.
+ */
+namespace frc_sim {
+
+/// \brief "FRCS", marks a segment as a SharedFrame.
+static const uint32_t kFrameMagic = 0x53435246;
+
+/// \brief Version of the SharedFrame layout. Must be bumped whenever the
+///        layout changes; a segment with another version isn't used.
+static const uint32_t kFrameVersion = 2;
+
+static const int kMaxSignals = 128;
+static const int kNameLength = 48;
+static const int kRingSize = 4;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "Atomics shared between processes must be lock-free");
+
+/// \brief The sensor readings of one physics step.
+struct InputFrame {
+  /// \brief Odd while the frame is being written.
+  std::atomic<uint32_t> sequence;
+  /// \brief Gazebo iteration the readings were taken at.
+  std::atomic<uint64_t> iteration;
+  /// \brief Simulation time in seconds, as the bits of a double.
+  std::atomic<uint64_t> time;
+  /// \brief One reading per input signal, as the bits of a double.
+  std::atomic<uint64_t> values[kMaxSignals];
+};
+
+/// \brief The layout of the shared memory segment.
+struct SharedFrame {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  /// \brief The Gazebo process that owns the segment.
+  int32_t writerPid;
+  /// \brief The robot program bound to the segment, 0 if none.
+  std::atomic<int32_t> readerPid;
+  /// \brief The number of FrameWriters that have the segment open.
+  std::atomic<int32_t> writers;
+
+  std::atomic<uint32_t> numInputs;
+  std::atomic<uint32_t> numOutputs;
+  char inputNames[kMaxSignals][kNameLength];
+  char outputNames[kMaxSignals][kNameLength];
+  /// \brief Set for each signal the robot program reads or writes here
+  ///        instead of on its topic.
+  std::atomic<uint32_t> inputBound[kMaxSignals];
+  std::atomic<uint32_t> outputBound[kMaxSignals];
+
+  /// \brief The latest value of each output, as the bits of a double.
+  std::atomic<uint64_t> outputs[kMaxSignals];
+
+  /// \brief Number of input frames published so far. The latest one is
+  ///        inputs[(published - 1) % kRingSize].
+  std::atomic<uint64_t> published;
+  InputFrame inputs[kRingSize];
+};
+
+inline uint64_t DoubleToBits(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double BitsToDouble(uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/// \brief Whether FRCSIM_SHARED_MEMORY allows the transport to be used.
+inline bool SharedMemoryEnabled() {
+  const char *enabled = std::getenv("FRCSIM_SHARED_MEMORY");
+  return enabled == nullptr || std::strcmp(enabled, "0") != 0;
+}
+
+/// \brief The name of the segment. Simulations on different Gazebo master
+///        ports get different segments.
+inline std::string SegmentName() {
+  std::string name = "/frcsim";
+  const char *uri = std::getenv("GAZEBO_MASTER_URI");
+  if (uri != nullptr) {
+    const char *port = std::strrchr(uri, ':');
+    if (port != nullptr) name += std::string("-") + (port + 1);
+  }
+  return name;
+}
+
+/// \brief The name a signal is known by in the frame: the part of its topic
+///        after "simulator/", which is the same on both sides even though
+///        the topic namespaces differ.
+inline std::string SignalKey(const std::string &topic) {
+  static const std::string kPrefix = "simulator/";
+  size_t start = topic.rfind(kPrefix);
+  std::string key = start == std::string::npos
+                        ? topic
+                        : topic.substr(start + kPrefix.size());
+  return key.substr(0, kNameLength - 1);
+}
+
+inline int FindSignal(const char (*names)[kNameLength], uint32_t count,
+                      const std::string &key) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (key == names[i]) return i;
+  }
+  return -1;
+}
+
+/// \brief Copy the readings of the latest published frame.
+/// \return The iteration they were taken at, or 0 if there's no frame yet.
+inline uint64_t ReadLatestFrame(const SharedFrame *frame, double *values,
+                                int count, double *time) {
+  while (true) {
+    uint64_t published = frame->published.load(std::memory_order_acquire);
+    if (published == 0) return 0;
+    const InputFrame &latest = frame->inputs[(published - 1) % kRingSize];
+    uint32_t sequence = latest.sequence.load(std::memory_order_acquire);
+    uint64_t iteration = latest.iteration.load(std::memory_order_relaxed);
+    *time = BitsToDouble(latest.time.load(std::memory_order_relaxed));
+    for (int i = 0; i < count && i < kMaxSignals; i++) {
+      values[i] =
+          BitsToDouble(latest.values[i].load(std::memory_order_relaxed));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if ((sequence & 1) == 0 &&
+        latest.sequence.load(std::memory_order_relaxed) == sequence) {
+      return iteration;
+    }
+    // The writer went all the way around the ring while we were reading
+  }
+}
+
+/// \brief Give every signal back to its topic, and forget the reader.
+inline void UnbindAll(SharedFrame *frame) {
+  for (int i = 0; i < kMaxSignals; i++) {
+    frame->inputBound[i].store(0);
+    frame->outputBound[i].store(0);
+  }
+  frame->readerPid.store(0);
+}
+
+#ifndef _WIN32
+/// \brief Map a segment, if it's big enough to hold a SharedFrame.
+inline SharedFrame *MapSegment(int fd) {
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size < (off_t)sizeof(SharedFrame)) {
+    close(fd);
+    return nullptr;
+  }
+  void *memory = mmap(nullptr, sizeof(SharedFrame), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+  return memory == MAP_FAILED ? nullptr : static_cast<SharedFrame *>(memory);
+}
+#endif
+
+/**
+ * \brief The Gazebo side of the transport. Each plugin keeps its own
+ * FrameWriter; they all map the same segment.
+ */
+class FrameWriter {
+public:
+  FrameWriter() : frame(nullptr), readerChecked(0) {}
+  FrameWriter(const FrameWriter &) = delete;
+  FrameWriter &operator=(const FrameWriter &) = delete;
+
+  /// \brief Unmap the segment, and unlink it if this was the last writer,
+  ///        so it doesn't outlive the simulation.
+  ~FrameWriter() {
+#ifndef _WIN32
+    if (frame == nullptr) return;
+    if (frame->writers.fetch_sub(1) == 1) shm_unlink(name.c_str());
+    munmap(frame, sizeof(SharedFrame));
+#endif
+  }
+
+  /// \brief Map the segment, creating it if this process hasn't yet.
+  /// \return false if the transport is disabled or unavailable.
+  bool Open() {
+#ifndef _WIN32
+    if (frame != nullptr) return true;
+    if (!SharedMemoryEnabled()) return false;
+    name = SegmentName();
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd >= 0) {
+      frame = MapSegment(fd);
+      if (frame != nullptr && frame->magic == kFrameMagic &&
+          frame->version == kFrameVersion &&
+          frame->size == sizeof(SharedFrame) && frame->writerPid == getpid()) {
+        frame->writers++;
+        return true;
+      }
+      // Left behind by an earlier run, or by another version
+      if (frame != nullptr) munmap(frame, sizeof(SharedFrame));
+      frame = nullptr;
+      shm_unlink(name.c_str());
+    }
+
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return false;
+    if (ftruncate(fd, sizeof(SharedFrame)) != 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+    frame = MapSegment(fd);
+    if (frame == nullptr) return false;
+    // A new segment is zero filled; the header is written last so a reader
+    // never sees a valid magic number on a half built segment.
+    frame->version = kFrameVersion;
+    frame->size = sizeof(SharedFrame);
+    frame->writerPid = getpid();
+    frame->writers.store(1);
+    std::atomic_thread_fence(std::memory_order_release);
+    frame->magic = kFrameMagic;
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  bool IsOpen() const { return frame != nullptr; }
+
+  /// \brief Register a sensor signal.
+  /// \return Its index, or -1 if it can't be carried in the frame.
+  int AddInput(const std::string &topic) {
+    return Add(frame->inputNames, frame->numInputs, topic);
+  }
+
+  /// \brief Register an output signal.
+  /// \return Its index, or -1 if it can't be carried in the frame.
+  int AddOutput(const std::string &topic) {
+    return Add(frame->outputNames, frame->numOutputs, topic);
+  }
+
+  /// \brief Whether robot code reads this input from the frame, so it
+  ///        doesn't need to be published on its topic.
+  bool InputBound(int index) const {
+    return index >= 0 && frame->inputBound[index].load() != 0;
+  }
+
+  /// \brief Get an output robot code writes to the frame. Called every
+  ///        step, so outputs whose robot program has exited are unbound even
+  ///        in a simulation without sensors.
+  /// \return false if robot code hasn't bound it, so the value should come
+  ///         from its topic.
+  bool GetOutput(int index, double *value) {
+    if (index < 0) return false;
+    CheckReader();
+    if (frame->outputBound[index].load() == 0) return false;
+    *value = BitsToDouble(
+        frame->outputs[index].load(std::memory_order_relaxed));
+    return true;
+  }
+
+  /// \brief Set a reading in the frame for the given physics step. The
+  ///        first reading of a step starts a new frame.
+  void SetInput(int index, double value, uint64_t iteration, double time) {
+    if (index < 0) return;
+    InputFrame &current = Begin(iteration, time);
+    current.values[index].store(DoubleToBits(value),
+                                std::memory_order_relaxed);
+  }
+
+  /// \brief Publish the frame for the current step, if a reading has been
+  ///        set since the last one was published. Called by every sensor
+  ///        plugin at the end of each step; only the first call publishes.
+  void Publish() {
+    if (frame == nullptr) return;
+    uint64_t published = frame->published.load(std::memory_order_relaxed);
+    InputFrame &current = frame->inputs[published % kRingSize];
+    uint32_t sequence = current.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) == 0) return;
+    current.sequence.store(sequence + 1, std::memory_order_release);
+    frame->published.store(published + 1, std::memory_order_release);
+  }
+
+  /// \brief The number of input signals registered so far. Signals are
+  ///        only ever added, so an index stays valid for the life of the
+  ///        segment.
+  uint32_t NumInputs() const { return frame->numInputs.load(); }
+
+  const char *InputName(int index) const { return frame->inputNames[index]; }
+
+  /// \brief Copy all the readings of the latest published frame.
+  /// \return The iteration they were taken at, or 0 if there's no frame yet.
+  uint64_t ReadFrame(double *values, int count, double *time) const {
+    return ReadLatestFrame(frame, values, count, time);
+  }
+
+private:
+  int Add(char (*names)[kNameLength], std::atomic<uint32_t> &count,
+          const std::string &topic) {
+    std::string key = SignalKey(topic);
+    uint32_t n = count.load();
+    int index = FindSignal(names, n, key);
+    if (index >= 0 || n == (uint32_t)kMaxSignals) return index;
+    std::strncpy(names[n], key.c_str(), kNameLength - 1);
+    count.store(n + 1);  // publishes the name
+    return n;
+  }
+
+  InputFrame &Begin(uint64_t iteration, double time) {
+    uint64_t published = frame->published.load(std::memory_order_relaxed);
+    InputFrame &current = frame->inputs[published % kRingSize];
+    uint32_t sequence = current.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) != 0 &&
+        current.iteration.load(std::memory_order_relaxed) == iteration) {
+      return current;
+    }
+
+    CheckReader();
+    current.sequence.store(sequence | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    current.iteration.store(iteration, std::memory_order_relaxed);
+    current.time.store(DoubleToBits(time), std::memory_order_relaxed);
+    // Readings a plugin doesn't set this step carry over
+    if (published > 0) {
+      const InputFrame &last = frame->inputs[(published - 1) % kRingSize];
+      uint32_t n = frame->numInputs.load(std::memory_order_relaxed);
+      for (uint32_t i = 0; i < n; i++) {
+        current.values[i].store(last.values[i].load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+      }
+    }
+    return current;
+  }
+
+  /// \brief Every thousand calls, about once a second, unbind the signals
+  ///        of a robot program that died without unbinding them, so they're
+  ///        carried on their topics again.
+  void CheckReader() {
+#ifndef _WIN32
+    if (++readerChecked < 1000) return;
+    readerChecked = 0;
+    int32_t pid = frame->readerPid.load();
+    if (pid == 0 || kill(pid, 0) == 0 || errno != ESRCH) return;
+    UnbindAll(frame);
+#endif
+  }
+
+  SharedFrame *frame;
+  std::string name;
+  int readerChecked;
+};
+
+/**
+ * \brief The robot side of the transport.
+ */
+class FrameReader {
+public:
+  FrameReader() : frame(nullptr) {}
+  FrameReader(const FrameReader &) = delete;
+  FrameReader &operator=(const FrameReader &) = delete;
+
+  /// \brief Unbind the robot program's signals, so the plugins go back to
+  ///        their topics, and unmap the segment.
+  ~FrameReader() {
+#ifndef _WIN32
+    if (frame == nullptr) return;
+    if (frame->readerPid.load() == getpid()) UnbindAll(frame);
+    munmap(frame, sizeof(SharedFrame));
+#endif
+  }
+
+  /// \brief Map the segment Gazebo created.
+  /// \return false if there isn't one this version can use.
+  bool Open() {
+#ifndef _WIN32
+    if (frame != nullptr) return true;
+    if (!SharedMemoryEnabled()) return false;
+    int fd = shm_open(SegmentName().c_str(), O_RDWR, 0600);
+    if (fd < 0) return false;
+    frame = MapSegment(fd);
+    if (frame == nullptr) return false;
+    if (frame->magic != kFrameMagic || frame->version != kFrameVersion ||
+        frame->size != sizeof(SharedFrame) ||
+        (kill(frame->writerPid, 0) != 0 && errno == ESRCH)) {
+      munmap(frame, sizeof(SharedFrame));
+      frame = nullptr;
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    frame->readerPid.store(getpid());
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  bool IsOpen() const { return frame != nullptr; }
+
+  /// \brief Read a sensor signal from the frame from now on.
+  /// \return Its index, or -1 if it has to be read from its topic.
+  int BindInput(const std::string &topic) {
+    if (frame == nullptr) return -1;
+    int index = FindSignal(frame->inputNames, frame->numInputs.load(),
+                           SignalKey(topic));
+    if (index >= 0) frame->inputBound[index].store(1);
+    return index;
+  }
+
+  /// \brief Write an output signal to the frame from now on.
+  /// \return Its index, or -1 if it has to be published on its topic.
+  int BindOutput(const std::string &topic) {
+    if (frame == nullptr) return -1;
+    int index = FindSignal(frame->outputNames, frame->numOutputs.load(),
+                           SignalKey(topic));
+    if (index >= 0) frame->outputBound[index].store(1);
+    return index;
+  }
+
+  /// \brief Get a reading from the latest published frame.
+  double GetInput(int index) const {
+    double value;
+    GetInputs(&index, &value, 1);
+    return value;
+  }
+
+  /// \brief Get several readings, all from the same published frame, for
+  ///        values that only make sense together, like a position and its
+  ///        velocity. Readings are 0 if there's no frame yet.
+  void GetInputs(const int *indices, double *values, int count) const {
+    while (true) {
+      uint64_t published = frame->published.load(std::memory_order_acquire);
+      if (published == 0) {
+        for (int i = 0; i < count; i++) values[i] = 0;
+        return;
+      }
+      const InputFrame &latest = frame->inputs[(published - 1) % kRingSize];
+      uint32_t sequence = latest.sequence.load(std::memory_order_acquire);
+      for (int i = 0; i < count; i++) {
+        values[i] = BitsToDouble(
+            latest.values[indices[i]].load(std::memory_order_relaxed));
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ((sequence & 1) == 0 &&
+          latest.sequence.load(std::memory_order_relaxed) == sequence) {
+        return;
+      }
+      // Gazebo went all the way around the ring while we were reading
+    }
+  }
+
+  /// \brief Copy all the readings of the latest published frame.
+  /// \return The iteration they were taken at, or 0 if there's no frame yet.
+  uint64_t ReadFrame(double *values, int count, double *time) const {
+    return ReadLatestFrame(frame, values, count, time);
+  }
+
+  void SetOutput(int index, double value) {
+    frame->outputs[index].store(DoubleToBits(value),
+                                std::memory_order_relaxed);
+  }
+
+private:
+  SharedFrame *frame;
+};
+
+}  // namespace frc_sim
@@ -0,0 +1,182 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Runs a simulator and a robot program in lockstep, with 20 motors and 20
+ * sensors, and reports the time per step. Each step the simulator publishes
+ * the readings of 20 sensors, waits for the robot program to write 20 motor
+ * outputs computed from them, and reads the outputs back.
+ *
+ * The two sides are threads of this process rather than Gazebo and a robot
+ * program, so this only measures the transport. It's run once through the
+ * shared memory frame, and once with one socket message per value, which is
+ * the least a topic per signal costs before protobuf and Gazebo's transport.
+ *
+ * Usage: shared_frame_benchmark [steps]
+ */
+
+#include "shared_frame.h"
+
+#include <sys/socket.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+static const int kMotors = 20;
+static const int kSensors = 20;
+
+static double Reading(uint64_t step, int sensor) { return step + sensor; }
+static double Output(double reading) { return reading * 0.5; }
+
+static void Check(bool ok, const char *what) {
+  if (!ok) {
+    std::fprintf(stderr, "%s\n", what);
+    std::exit(1);
+  }
+}
+
+static void Report(const char *name, uint64_t steps,
+                   std::chrono::steady_clock::duration elapsed) {
+  double seconds = std::chrono::duration<double>(elapsed).count();
+  std::printf("%-14s %8.2f us/step %10.0f steps/s\n", name,
+              seconds / steps * 1e6, steps / seconds);
+}
+
+static void RunSharedFrame(uint64_t steps) {
+  frc_sim::FrameWriter writer;
+  Check(writer.Open(), "Can't create the shared memory segment");
+  int inputs[kSensors], outputs[kMotors];
+  for (int i = 0; i < kSensors; i++) {
+    inputs[i] = writer.AddInput("simulator/sensor/" + std::to_string(i));
+  }
+  for (int i = 0; i < kMotors; i++) {
+    outputs[i] = writer.AddOutput("simulator/motor/" + std::to_string(i));
+  }
+
+  frc_sim::FrameReader reader;
+  Check(reader.Open(), "Can't map the shared memory segment");
+  for (int i = 0; i < kSensors; i++) {
+    Check(reader.BindInput("sensor/" + std::to_string(i)) == inputs[i],
+          "Sensor isn't in the frame");
+  }
+  for (int i = 0; i < kMotors; i++) {
+    Check(reader.BindOutput("motor/" + std::to_string(i)) == outputs[i],
+          "Motor isn't in the frame");
+  }
+
+  // The step the robot program has written the outputs for
+  std::atomic<uint64_t> written(0);
+  std::thread robot([&] {
+    double values[kSensors], time;
+    for (uint64_t step = 1; step <= steps; step++) {
+      while (reader.ReadFrame(values, kSensors, &time) != step) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < kMotors; i++) {
+        reader.SetOutput(outputs[i], Output(values[i % kSensors]));
+      }
+      written.store(step, std::memory_order_release);
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t step = 1; step <= steps; step++) {
+    for (int i = 0; i < kSensors; i++) {
+      writer.SetInput(inputs[i], Reading(step, i), step, step * 0.001);
+    }
+    writer.Publish();
+    while (written.load(std::memory_order_acquire) != step) {
+      std::this_thread::yield();
+    }
+    for (int i = 0; i < kMotors; i++) {
+      double value;
+      Check(writer.GetOutput(outputs[i], &value) &&
+                value == Output(Reading(step, i % kSensors)),
+            "Wrong motor output");
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  robot.join();
+  Report("shared frame", steps, elapsed);
+}
+
+/// One value of one signal, as it would be sent on its topic.
+struct Message {
+  int32_t signal;
+  double value;
+};
+
+static void Send(int fd, int signal, double value) {
+  Message message = {signal, value};
+  Check(write(fd, &message, sizeof(message)) == sizeof(message),
+        "Can't send");
+}
+
+static Message Receive(int fd) {
+  Message message;
+  Check(read(fd, &message, sizeof(message)) == sizeof(message),
+        "Can't receive");
+  return message;
+}
+
+static void RunSockets(uint64_t steps) {
+  int fds[2];
+  Check(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0,
+        "Can't create a socket pair");
+
+  std::thread robot([&] {
+    double values[kSensors];
+    for (uint64_t step = 1; step <= steps; step++) {
+      for (int i = 0; i < kSensors; i++) {
+        Message message = Receive(fds[1]);
+        values[message.signal] = message.value;
+      }
+      for (int i = 0; i < kMotors; i++) {
+        Send(fds[1], i, Output(values[i % kSensors]));
+      }
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t step = 1; step <= steps; step++) {
+    for (int i = 0; i < kSensors; i++) Send(fds[0], i, Reading(step, i));
+    for (int i = 0; i < kMotors; i++) {
+      Message message = Receive(fds[0]);
+      Check(message.value ==
+                Output(Reading(step, message.signal % kSensors)),
+            "Wrong motor output");
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  robot.join();
+  close(fds[0]);
+  close(fds[1]);
+  Report("socket/value", steps, elapsed);
+}
+
+int main(int argc, char **argv) {
+  uint64_t steps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  Check(steps > 0, "Usage: shared_frame_benchmark [steps]");
+
+  // A segment of its own, so a running simulation isn't disturbed
+  std::string uri = "http://localhost:" + std::to_string(20000 + getpid());
+  setenv("GAZEBO_MASTER_URI", uri.c_str(), 1);
+  setenv("FRCSIM_SHARED_MEMORY", "1", 1);
+
+  std::printf("%d motors, %d sensors, %llu steps\n", kMotors, kSensors,
+              static_cast<unsigned long long>(steps));
+  RunSharedFrame(steps);
+  RunSockets(steps);
+
+  // The writer unlinked the segment when it was destroyed
+  Check(shm_open(frc_sim::SegmentName().c_str(), O_RDWR, 0600) < 0,
+        "The segment outlived its writer");
+  return 0;
+}
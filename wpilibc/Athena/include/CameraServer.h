@@ -11,10 +11,10 @@
 #include "nivision.h"
 #include "NIIMAQdx.h"
 
+#include "HAL/cpp/priority_event.h"
 #include "HAL/cpp/priority_mutex.h"
 #include <thread>
 #include <memory>
-#include <condition_variable>
 #include <tuple>
 #include <vector>
 
@@ -28,6 +28,11 @@ class CameraServer : public ErrorBase {
   static constexpr int32_t kHardwareCompression = -1;
   static constexpr uint32_t kMaxImageSize = 200000;
 
+  // Who the image data belongs to, and so how to free it
+  enum ImageSource { kPoolImage, kImaqImage, kCameraImage };
+  typedef std::tuple<uint8_t*, unsigned int, unsigned int, ImageSource>
+      ImageData;
+
  protected:
   CameraServer();
 
@@ -35,19 +40,18 @@ class CameraServer : public ErrorBase {
   std::thread m_serverThread;
   std::thread m_captureThread;
   priority_recursive_mutex m_imageMutex;
-  std::condition_variable_any m_newImageVariable;
+  priority_condition m_newImageVariable;
   std::vector<uint8_t*> m_dataPool;
   unsigned int m_quality;
   bool m_autoCaptureStarted;
   bool m_hwClient;
-  std::tuple<uint8_t*, unsigned int, unsigned int, bool> m_imageData;
+  ImageData m_imageData;
 
   void Serve();
   void AutoCapture();
   void SetImageData(uint8_t* data, unsigned int size, unsigned int start = 0,
-                    bool imaqData = false);
-  void FreeImageData(
-      std::tuple<uint8_t*, unsigned int, unsigned int, bool> imageData);
+                    ImageSource source = kPoolImage);
+  void FreeImageData(ImageData imageData);
 
   struct Request {
     uint32_t fps;
@@ -12,6 +12,7 @@
 #include "HAL/cpp/Semaphore.hpp"
 #include "HAL/cpp/priority_mutex.h"
 #include "HAL/cpp/priority_condition_variable.h"
+#include "HAL/cpp/priority_event.h"
 #include <condition_variable>
 #include <atomic>
 
@@ -33,6 +34,7 @@ class DriverStation : public SensorBase, public RobotStateInterface {
   static const uint32_t kJoystickPorts = 6;
 
   float GetStickAxis(uint32_t stick, uint32_t axis);
+  void GetStickAxes(uint32_t stick, HALJoystickAxes &axes) const;
   int GetStickPOV(uint32_t stick, uint32_t pov);
   uint32_t GetStickButtons(uint32_t stick) const;
   bool GetStickButton(uint32_t stick, uint8_t button);
@@ -60,6 +62,8 @@ class DriverStation : public SensorBase, public RobotStateInterface {
   Alliance GetAlliance() const;
   uint32_t GetLocation() const;
   void WaitForData();
+  /** The number of DS packets received; changes whenever new data arrives */
+  uint32_t GetPacketCount() const { return m_packetCount; }
   double GetMatchTime() const;
   float GetBatteryVoltage() const;
 
@@ -103,11 +107,11 @@ class DriverStation : public SensorBase, public RobotStateInterface {
   HALJoystickDescriptor m_joystickDescriptor[kJoystickPorts];
   Task m_task;
   std::atomic<bool> m_isRunning{false};
+  std::atomic<uint32_t> m_packetCount{0};
   mutable Semaphore m_newControlData{Semaphore::kEmpty};
   mutable priority_condition_variable m_packetDataAvailableCond;
   priority_mutex m_packetDataAvailableMutex;
-  std::condition_variable_any m_waitForDataCond;
-  priority_mutex m_waitForDataMutex;
+  priority_broadcast m_waitForData;
   bool m_userInDisabled = false;
   bool m_userInAutonomous = false;
   bool m_userInTeleop = false;
@@ -69,6 +69,8 @@ class IterativeRobot : public RobotBase {
   virtual void TeleopPeriodic();
   virtual void TestPeriodic();
 
+  void EnableLoopTiming(bool enabled, double overrunThreshold = 0.020);
+
  protected:
   virtual void Prestart();
 
@@ -13,6 +13,8 @@
 #include <vector>
 #include "GenericHID.h"
 #include "ErrorBase.h"
+#include "HAL/HAL.hpp"
+#include "HAL/cpp/priority_mutex.h"
 
 class DriverStation;
 
@@ -72,6 +74,11 @@ class Joystick : public GenericHID, public ErrorBase {
   uint32_t GetAxisChannel(AxisType axis) const;
   void SetAxisChannel(AxisType axis, uint32_t channel);
 
+  void SetAxisDeadband(uint32_t axis, float deadband);
+  void SetAxisExpo(uint32_t axis, float expo);
+  void SetAxisSlewRate(uint32_t axis, float rate);
+  bool IsAxisShaped(uint32_t axis) const;
+
   virtual float GetX(JoystickHand hand = kRightHand) const override;
   virtual float GetY(JoystickHand hand = kRightHand) const override;
   virtual float GetZ() const override;
@@ -87,6 +94,7 @@ class Joystick : public GenericHID, public ErrorBase {
   virtual int GetPOV(uint32_t pov = 0) const override;
   bool GetButton(ButtonType button) const;
   static Joystick *GetStickForPort(uint32_t port);
+  uint32_t GetPort() const { return m_port; }
 
   virtual float GetMagnitude() const;
   virtual float GetDirectionRadians() const;
@@ -106,9 +114,34 @@ class Joystick : public GenericHID, public ErrorBase {
   void SetOutputs(uint32_t value);
 
  private:
+  struct AxisShaping {
+    float deadband = 0.0f;
+    float expo = 0.0f;
+    float slewRate = 0.0f;
+  };
+
+  void BuildAxisTable(uint32_t axis);
+  void UpdateAxes() const;
+
   DriverStation &m_ds;
   uint32_t m_port;
   std::vector<uint32_t> m_axes;
+
+  // Guards the shaping, the tables and the cached values, which are
+  // refreshed by whichever thread reads an axis first after a packet
+  mutable priority_mutex m_axisMutex;
+
+  // Shaping of each raw axis, baked into a table indexed by the raw int8 value
+  AxisShaping m_axisShaping[kMaxJoystickAxes];
+  std::vector<float> m_axisTables[kMaxJoystickAxes];
+  const float *m_axisLookup[kMaxJoystickAxes];
+
+  // Shaped axis values, refreshed once per DS packet
+  mutable float m_axisValues[kMaxJoystickAxes] = {};
+  mutable uint32_t m_axisCount = 0;
+  mutable uint32_t m_axisPacket = 0;
+  mutable double m_axisTime = 0.0;
+
   std::vector<uint32_t> m_buttons;
   uint32_t m_outputs = 0;
   uint16_t m_leftRumble = 0;
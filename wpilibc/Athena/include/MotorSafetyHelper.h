@@ -9,7 +9,11 @@
 #include "ErrorBase.h"
 #include "HAL/cpp/priority_mutex.h"
 
+#include <atomic>
+#include <cstdint>
 #include <set>
+#include <utility>
+#include <vector>
 
 class MotorSafety;
 
@@ -25,16 +29,37 @@ class MotorSafetyHelper : public ErrorBase {
   void SetSafetyEnabled(bool enabled);
   bool IsSafetyEnabled() const;
   static void CheckMotors();
+  static void SetCheckPeriod(double period);
+  static double GetCheckPeriod();
 
  private:
-  double m_expiration;  // the expiration time for this object
-  bool m_enabled;       // true if motor safety is enabled for this motor
-  double m_stopTime;    // the FPGA clock value when this motor has expired
-  mutable priority_recursive_mutex
-      m_syncMutex;            // protect accesses to the state for this object
+  typedef std::pair<int64_t, MotorSafetyHelper *> Deadline;
+
+  static int64_t GetTime();
+  static void WatchdogRun();
+  bool CheckExpired(int64_t now, bool stopAllowed);
+  void Stop();
+  void Schedule(int64_t deadline);
+
+  // The expiration time for this object in microseconds
+  std::atomic<int64_t> m_expiration;
+  // True if motor safety is enabled for this motor
+  std::atomic<bool> m_enabled;
+  // GetTime() value of the last call to Feed()
+  std::atomic<int64_t> m_lastFeed;
+  // Deadline this helper is filed under in m_deadlines
+  int64_t m_deadline;
   MotorSafety *m_safeObject;  // the object that is using the helper
-  // List of all existing MotorSafetyHelper objects.
-  static std::set<MotorSafetyHelper*> m_helperList;
+  // All existing MotorSafetyHelper objects, ordered by the time at which they
+  // next need to be checked.
+  static std::set<Deadline> m_deadlines;
   static priority_recursive_mutex
       m_listMutex;  // protect accesses to the list of helpers
+  // Held while CheckMotors() stops the expired motors outside m_listMutex, so
+  // a helper can't be destroyed while it is being stopped
+  static priority_mutex m_stopMutex;
+  // Period of the dedicated thread checking the deadlines in microseconds, or
+  // 0 to check only from the DriverStation task
+  static std::atomic<int64_t> m_checkPeriod;
+  static std::atomic<bool> m_watchdogRunning;
 };
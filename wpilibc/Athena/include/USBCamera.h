@@ -36,11 +36,11 @@ class USBCamera : public ErrorBase {
   static constexpr char const *ATTR_BR_VALUE =
       "CameraAttributes::Brightness::Value";
 
+ protected:
   // Constants for the manual and auto types
   static constexpr char const* AUTO = "Auto";
   static constexpr char const* MANUAL = "Manual";
 
- protected:
   IMAQdxSession m_id = 0;
   std::string m_name;
   bool m_useJpeg;
@@ -67,15 +67,16 @@ class USBCamera : public ErrorBase {
   static constexpr char const *kDefaultCameraName = "cam0";
 
   USBCamera(std::string name, bool useJpeg);
+  virtual ~USBCamera() = default;
 
-  void OpenCamera();
-  void CloseCamera();
-  void StartCapture();
-  void StopCapture();
+  virtual void OpenCamera();
+  virtual void CloseCamera();
+  virtual void StartCapture();
+  virtual void StopCapture();
   void SetFPS(double fps);
   void SetSize(unsigned int width, unsigned int height);
 
-  void UpdateSettings();
+  virtual void UpdateSettings();
   /**
    * Set the brightness, as a percentage (0-100).
    */
@@ -116,6 +117,24 @@ class USBCamera : public ErrorBase {
    */
   void SetExposureManual(unsigned int expValue);
 
-  void GetImage(Image *image);
-  unsigned int GetImageData(void *buffer, unsigned int bufferSize);
+  virtual void GetImage(Image *image);
+  virtual unsigned int GetImageData(void *buffer, unsigned int bufferSize);
+
+  /**
+   * Borrow the next JPEG image without copying it.
+   *
+   * Cameras that can't lend out their buffers return nullptr, and the image
+   * has to be copied with GetImageData() instead.
+   *
+   * @param size Set to the size of the image in bytes
+   * @return The image, which must be given back with ReleaseImageData()
+   */
+  virtual const uint8_t *AcquireImageData(unsigned int &size) {
+    return nullptr;
+  }
+
+  /**
+   * Give back an image borrowed with AcquireImageData().
+   */
+  virtual void ReleaseImageData(const uint8_t *data) {}
 };
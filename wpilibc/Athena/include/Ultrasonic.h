@@ -35,6 +35,12 @@ class DigitalOutput;
  * the echo is received. The time that the line is high determines the round
  * trip distance
  * (time of flight).
+ *
+ * In automatic mode a background task pings the sensors group by group.
+ * Sensors in the same ping group fire together, so put sensors in one group
+ * only if they can't hear each other's echoes.  Each sensor starts in a group
+ * of its own, which gives the classic round robin.  Every echo is timestamped
+ * and median filtered into a short history that can be read without locking.
  */
 class Ultrasonic : public SensorBase,
                    public PIDSource,
@@ -42,6 +48,15 @@ class Ultrasonic : public SensorBase,
  public:
   enum DistanceUnit { kInches = 0, kMilliMeters = 1 };
 
+  /** A filtered range measurement taken in automatic mode. */
+  struct RangeSample {
+    double timestamp;    ///< FPGA time (sec) at which the echo ended
+    double rangeInches;  ///< Median filtered range
+  };
+
+  /** Number of samples kept in each sensor's range history */
+  static const int kHistorySize = 16;
+
   DEPRECATED(
       "Raw pointers are deprecated; prefer either specifying the channel "
       "numbers as integers or passing shared_ptrs.")
@@ -64,6 +79,12 @@ class Ultrasonic : public SensorBase,
   void Ping();
   bool IsRangeValid() const;
   static void SetAutomaticMode(bool enabling);
+  static void SetPingPeriod(double seconds);
+  static double GetPingPeriod();
+  void SetPingGroup(uint32_t group);
+  uint32_t GetPingGroup() const { return m_pingGroup; }
+  int GetRangeHistory(RangeSample *samples, int count) const;
+  double GetRangeTimestamp() const;
   double GetRangeInches() const;
   double GetRangeMM() const;
   bool IsEnabled() const { return m_enabled; }
@@ -85,6 +106,8 @@ class Ultrasonic : public SensorBase,
   void Initialize();
 
   static void UltrasonicChecker();
+  void UpdateRange(double pingTime);
+  void AddSample(double timestamp, double rangeInches);
 
   static constexpr double kPingTime =
       10 * 1e-6;  ///< Time (sec) for the ping trigger pulse.
@@ -98,6 +121,7 @@ class Ultrasonic : public SensorBase,
   static Ultrasonic *m_firstSensor;  // head of the ultrasonic sensor list
   static std::atomic<bool> m_automaticEnabled; // automatic round robin mode
   static priority_mutex m_mutex;  // synchronize access to the list of sensors
+  static std::atomic<double> m_pingPeriod;  // time (sec) between ping groups
 
   std::shared_ptr<DigitalOutput> m_pingChannel;
   std::shared_ptr<DigitalInput> m_echoChannel;
@@ -106,6 +130,18 @@ class Ultrasonic : public SensorBase,
   Counter m_counter;
   Ultrasonic *m_nextSensor;
   DistanceUnit m_units;
+  std::atomic<uint32_t> m_pingGroup{0};
+
+  // Written only by the automatic mode task
+  int32_t m_lastEchoCount = 0;
+  double m_rawRanges[3] = {};
+  uint32_t m_rawCount = 0;
+
+  // Range history ring buffer, published by m_sampleCount.  The entries are
+  // atomics so a reader racing with the writer never sees a torn double.
+  std::atomic<double> m_sampleTimestamps[kHistorySize];
+  std::atomic<double> m_sampleRanges[kHistorySize];
+  std::atomic<uint32_t> m_sampleCount{0};
 
   std::shared_ptr<ITable> m_table = nullptr;
 };
@@ -0,0 +1,63 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+#pragma once
+
+#include "USBCamera.h"
+#include "V4L2Capture.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * A USBCamera captured through Video4Linux2 rather than NI IMAQdx, so the
+ * same camera code runs on the roboRIO, on a Linux coprocessor and on a
+ * desktop.
+ *
+ * The capture itself is done by a V4L2Capture, which doesn't need NI's
+ * libraries; this class adds the USBCamera interface and converts frames to
+ * NI images. The camera captures in MJPEG when the JPEG data is wanted,
+ * which is passed through as the camera compressed it, and in YUYV when
+ * images are wanted for processing.
+ *
+ * As with V4L2Capture, the device can be a file of frames to play back.
+ */
+class V4L2Camera : public USBCamera {
+ public:
+  typedef V4L2Capture::Frame Frame;
+
+  static constexpr char const *kDefaultDevice = V4L2Capture::kDefaultDevice;
+
+  explicit V4L2Camera(std::string device = kDefaultDevice,
+                      bool useJpeg = true);
+  virtual ~V4L2Camera() = default;
+
+  void OpenCamera() override;
+  void CloseCamera() override;
+  void StartCapture() override;
+  void StopCapture() override;
+  void UpdateSettings() override;
+
+  void GetImage(Image *image) override;
+  unsigned int GetImageData(void *buffer, unsigned int bufferSize) override;
+  const uint8_t *AcquireImageData(unsigned int &size) override;
+  void ReleaseImageData(const uint8_t *data) override;
+
+  bool AcquireFrame(Frame &frame, bool jpeg, double timeout = 1.0);
+  void ReleaseFrame(const Frame &frame);
+
+  bool IsFakeDevice() const { return m_capture.IsFakeDevice(); }
+
+ private:
+  V4L2Capture::Settings GetSettings() const;
+  void TakeCaptureError();
+
+  V4L2Capture m_capture;
+
+  // Scratch space for converting YUYV frames in GetImage()
+  priority_mutex m_rgbMutex;
+  std::vector<RGBValue> m_rgb;
+};
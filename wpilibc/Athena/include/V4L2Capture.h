@@ -0,0 +1,132 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+#pragma once
+
+#include "ErrorBase.h"
+#include "HAL/cpp/priority_mutex.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Captures frames from a USB camera through Video4Linux2.
+ *
+ * This only depends on Linux, not on NI's vision libraries, so it can be used
+ * by itself on a coprocessor or a desktop. V4L2Camera builds a USBCamera on
+ * top of it.
+ *
+ * Frames are captured with V4L2 streaming I/O into buffers mapped from the
+ * driver. AcquireFrame() lends out the driver's buffer itself, and the buffer
+ * only goes back to the driver when the frame is released, so a frame is
+ * never copied. MJPEG frames are passed through as the camera compressed
+ * them.
+ *
+ * If the device is a regular file instead of a video device, frames are read
+ * from the file, so capture can be tested and benchmarked without a camera.
+ * The file is either a series of JPEG images, or raw YUYV frames of the size
+ * in the settings. The frames are played back in a loop at the frame rate of
+ * the settings, or as fast as they are asked for if it is 0.
+ */
+class V4L2Capture : public ErrorBase {
+ public:
+  static constexpr char const *kDefaultDevice = "/dev/video0";
+
+  /// Number of buffers requested from the driver.
+  static constexpr unsigned int kNumBuffers = 4;
+
+  struct Frame {
+    const uint8_t *data = nullptr;
+    unsigned int size = 0;
+    /// V4L2_PIX_FMT_MJPEG or V4L2_PIX_FMT_YUYV
+    uint32_t pixelFormat = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+  };
+
+  struct Settings {
+    /// Capture MJPEG frames rather than YUYV frames
+    bool jpeg = true;
+    unsigned int width = 320;
+    unsigned int height = 240;
+    double fps = 30;
+    bool autoWhiteBalance = true;
+    /// Color temperature for manual white balance, -1 to hold the current one
+    int whiteBalance = -1;
+    bool autoExposure = false;
+    /// Percentage (0-100) for manual exposure, -1 to hold the current one
+    int exposure = -1;
+    /// Percentage (0-100)
+    unsigned int brightness = 80;
+  };
+
+  explicit V4L2Capture(std::string device = kDefaultDevice);
+  virtual ~V4L2Capture();
+
+  void Open();
+  void Close();
+  void Start();
+  void Stop();
+  void ApplySettings(const Settings &settings);
+
+  bool IsOpen() const;
+  bool IsActive() const;
+  bool IsFakeDevice() const;
+
+  bool AcquireFrame(Frame &frame, double timeout = 1.0);
+  void ReleaseFrame(const uint8_t *data);
+
+  static unsigned int GetJpegSize(const uint8_t *data, size_t size);
+
+ private:
+  /**
+   * A buffer mapped from the driver, or for a fake device the mapped file.
+   * Buffers that are still lent out when the camera is closed are kept until
+   * they are released, since the mapping outlives the file descriptor.
+   */
+  struct Buffer {
+    uint8_t *start;
+    size_t length;
+    int index;  // the driver's buffer index, -1 for a fake device
+    unsigned int borrowed;
+  };
+
+  bool OpenDevice();
+  bool OpenFakeDevice();
+  void ConfigureDevice();
+  void SetControl(uint32_t id, int value);
+  void SetControlPercent(uint32_t id, unsigned int percent);
+  void UnmapBuffers();
+  bool NextFakeFrame(Frame &frame,
+                     std::unique_lock<priority_recursive_mutex> &lock);
+
+  std::string m_device;
+  Settings m_settings;
+  bool m_open = false;
+  bool m_active = false;
+
+  mutable priority_recursive_mutex m_mutex;
+
+  int m_fd = -1;
+  bool m_fake = false;
+  bool m_fakeJpeg = false;
+  uint32_t m_pixelFormat = 0;
+  unsigned int m_frameWidth = 0;
+  unsigned int m_frameHeight = 0;
+  std::vector<Buffer> m_buffers;
+  std::vector<Buffer> m_orphans;
+  // Changed whenever capture stops, to notice it while waiting for a frame
+  unsigned int m_captureGeneration = 0;
+
+  // Offset and size of each frame of a fake device
+  std::vector<std::pair<size_t, size_t>> m_fakeFrames;
+  size_t m_nextFakeFrame = 0;
+  std::chrono::steady_clock::time_point m_nextFakeFrameTime;
+};
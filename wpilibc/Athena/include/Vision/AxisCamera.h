@@ -6,13 +6,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <string>
+#include "HAL/cpp/priority_condition_variable.h"
 #include "HAL/cpp/priority_mutex.h"
 
 #include "ErrorBase.h"
 #include "Vision/ColorImage.h"
 #include "Vision/HSLImage.h"
+#include "Vision/MJPEGStreamParser.h"
 #include "nivision.h"
 
 /**
@@ -55,6 +58,7 @@ class AxisCamera : public ErrorBase {
   AxisCamera& operator=(const AxisCamera&) = delete;
 
   bool IsFreshImage() const;
+  bool WaitForImage(double timeout);
 
   int GetImage(Image *image);
   int GetImage(ColorImage *image);
@@ -92,12 +96,16 @@ class AxisCamera : public ErrorBase {
  private:
   std::thread m_captureThread;
   std::string m_cameraHost;
+  std::string m_cameraPort = "80";
   int m_cameraSocket = -1;
   priority_mutex m_captureMutex;
 
   priority_mutex m_imageDataMutex;
+  priority_condition_variable m_imageDataCond;
   std::vector<uint8_t> m_imageData;
   bool m_freshImage = false;
+  uint32_t m_imageCount = 0;
+  MJPEGStreamParser m_parser;
 
   int m_brightness = 50;
   WhiteBalance m_whiteBalance = kWhiteBalance_Automatic;
@@ -112,11 +120,12 @@ class AxisCamera : public ErrorBase {
   bool m_streamDirty = true;
   priority_mutex m_parametersMutex;
 
-  bool m_done = false;
+  std::atomic<bool> m_done{false};
 
   void Capture();
   void ReadImagesFromCamera();
   bool WriteParameters();
 
   int CreateCameraSocket(std::string const &requestString, bool setError);
+  bool WaitForSocket(int socket, short events, double timeout);
 };
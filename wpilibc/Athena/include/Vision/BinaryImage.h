@@ -7,6 +7,7 @@
 #pragma once
 
 #include "MonoImage.h"
+#include "ParticleAnalyzer.h"
 /**
  * Included for ParticleAnalysisReport definition
  * TODO: Eliminate this dependency!
@@ -24,11 +25,20 @@ class BinaryImage : public MonoImage {
   void GetParticleAnalysisReport(int particleNumber,
                                  ParticleAnalysisReport *par);
   std::vector<ParticleAnalysisReport> *GetOrderedParticleAnalysisReports();
+  void GetOrderedParticleAnalysisReports(
+      ParticleAnalyzer &analyzer, std::vector<ParticleAnalysisReport> &reports);
   BinaryImage *RemoveSmallObjects(bool connectivity8, int erosions);
   BinaryImage *RemoveLargeObjects(bool connectivity8, int erosions);
   BinaryImage *ConvexHull(bool connectivity8);
   BinaryImage *ParticleFilter(ParticleFilterCriteria2 *criteria,
                               int criteriaCount);
+  void RemoveSmallObjects(bool connectivity8, int erosions,
+                          BinaryImage *result);
+  void RemoveLargeObjects(bool connectivity8, int erosions,
+                          BinaryImage *result);
+  void ConvexHull(bool connectivity8, BinaryImage *result);
+  void ParticleFilter(ParticleFilterCriteria2 *criteria, int criteriaCount,
+                      BinaryImage *result);
   virtual void Write(const char *fileName);
 
  private:
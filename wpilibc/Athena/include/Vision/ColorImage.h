@@ -8,6 +8,7 @@
 
 #include "ImageBase.h"
 #include "BinaryImage.h"
+#include "ColorKernels.h"
 #include "Threshold.h"
 
 class ColorImage : public ImageBase {
@@ -28,6 +29,10 @@ class ColorImage : public ImageBase {
   BinaryImage *ThresholdHSL(Threshold &threshold);
   BinaryImage *ThresholdHSV(Threshold &threshold);
   BinaryImage *ThresholdHSI(Threshold &threshold);
+  void ThresholdRGB(const Threshold &threshold, BinaryImage *result);
+  void ThresholdHSL(const Threshold &threshold, BinaryImage *result);
+  void ThresholdNativeHSV(const Threshold &threshold, BinaryImage *result);
+  void ExtractNativeColorPlane(ColorKernels::Plane plane, MonoImage *result);
   MonoImage *GetRedPlane();
   MonoImage *GetGreenPlane();
   MonoImage *GetBluePlane();
@@ -58,6 +63,9 @@ class ColorImage : public ImageBase {
  private:
   BinaryImage *ComputeThreshold(ColorMode colorMode, int low1, int high1,
                                 int low2, int high2, int low3, int high3);
+  void ComputeThreshold(ColorMode colorMode, const Threshold &threshold,
+                        BinaryImage *result);
+  bool GetRGBPixels(ImageBase *result, ImageInfo &source, ImageInfo &dest);
   void Equalize(bool allPlanes);
   MonoImage *ExtractColorPlane(ColorMode mode, int planeNumber);
   MonoImage *ExtractFirstColorPlane(ColorMode mode);
@@ -0,0 +1,59 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "Threshold.h"
+
+/**
+ * Color threshold and plane extraction on raw pixel buffers.
+ *
+ * The source is laid out like an IMAQ_IMAGE_RGB image: 4 bytes per pixel in
+ * blue, green, red, alpha order. The destination is one byte per pixel, like
+ * an IMAQ_IMAGE_U8 image. Both are passed with their number of pixels per
+ * line, which may be more than the width, and are provided by the caller, so
+ * nothing is allocated.
+ *
+ * The kernels use SSE2 or NEON when the compiler targets them, working on 16
+ * pixels at a time, with a scalar loop for the rest of each line. The HSV
+ * threshold converts and thresholds each pixel in the same pass, without
+ * dividing, so the HSV planes are never stored.
+ *
+ * HSV is on a 0-255 scale: the value is the largest of R, G and B, the
+ * saturation is 255 * (max - min) / max, and the hue goes once around the
+ * color circle from red at 0. A hue range whose low end is above its high
+ * end wraps around through red. This is not exactly the scale of IMAQ_HSV,
+ * so thresholds tuned against NI Vision may need adjusting.
+ */
+class ColorKernels {
+ public:
+  enum Plane {
+    kRedPlane,
+    kGreenPlane,
+    kBluePlane,
+    kHSVHuePlane,
+    kHSVSaturationPlane,
+    kHSVValuePlane
+  };
+
+  static void ThresholdRGB(const uint8_t *source, int sourcePixelsPerLine,
+                           uint8_t *dest, int destPixelsPerLine, int width,
+                           int height, const Threshold &threshold,
+                           uint8_t replaceValue = 1);
+  static void ThresholdHSV(const uint8_t *source, int sourcePixelsPerLine,
+                           uint8_t *dest, int destPixelsPerLine, int width,
+                           int height, const Threshold &threshold,
+                           uint8_t replaceValue = 1);
+  static void ExtractPlane(const uint8_t *source, int sourcePixelsPerLine,
+                           uint8_t *dest, int destPixelsPerLine, int width,
+                           int height, Plane plane);
+
+  static bool HasVectorUnit();
+  static void SetVectorized(bool vectorized);
+  static bool IsVectorized();
+};
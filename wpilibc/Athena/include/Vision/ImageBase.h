@@ -7,6 +7,8 @@
 #pragma once
 
 #include <stdio.h>
+#include <atomic>
+#include <cstdint>
 #include "nivision.h"
 #include "ErrorBase.h"
 
@@ -21,6 +23,11 @@ class ImageBase : public ErrorBase {
   int GetWidth();
   Image *GetImaqImage();
 
+  static uint64_t GetImagesCreated();
+
  protected:
   Image *m_imaqImage;
+
+ private:
+  static std::atomic<uint64_t> s_imagesCreated;
 };
@@ -0,0 +1,160 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+#include "HAL/cpp/priority_mutex.h"
+
+#include "ErrorBase.h"
+#include "ImageBase.h"
+
+/**
+ * A pool of images that are reused instead of being created and disposed for
+ * every frame.
+ *
+ * Images are kept in buckets by class and size, so an image taken from the
+ * pool never has to be resized. An image that is resized while it is out of
+ * the pool goes back to the bucket of its new size. Acquire() returns a
+ * reference counted handle to an image. When the last handle to it is
+ * destroyed, the image goes back to its bucket to be handed out again, so a
+ * processing loop that acquires the same images each frame stops creating
+ * images after the first frame.
+ * Use ImageBase::GetImagesCreated() or GetStatistics() to check that it does.
+ *
+ * The pool must outlive every handle to its images. Handles can be copied and
+ * destroyed on any thread.
+ *
+ * Example:
+ * @code
+ *   ImagePool pool;
+ *   while (true) {
+ *     ImagePool::Ref<RGBImage> image = pool.Acquire<RGBImage>(320, 240);
+ *     camera->GetImage(image->GetImaqImage());
+ *     ImagePool::Ref<BinaryImage> binary =
+ *         pool.Acquire<BinaryImage>(320, 240);
+ *     image->ThresholdNativeHSV(threshold, binary.Get());
+ *     binary->RemoveSmallObjects(true, 2, binary.Get());
+ *   }
+ * @endcode
+ */
+class ImagePool : public ErrorBase {
+  struct Entry {
+    std::unique_ptr<ImageBase> image;
+    size_t bucket;
+    std::atomic<int> references;
+    ImagePool *pool;
+  };
+
+ public:
+  /**
+   * A counted reference to an image from the pool.
+   */
+  template <typename T>
+  class Ref {
+   public:
+    Ref() = default;
+    Ref(const Ref &other) : m_entry(other.m_entry) {
+      if (m_entry != nullptr) m_entry->references++;
+    }
+    Ref(Ref &&other) : m_entry(other.m_entry) { other.m_entry = nullptr; }
+    ~Ref() { Reset(); }
+
+    Ref &operator=(Ref other) {
+      std::swap(m_entry, other.m_entry);
+      return *this;
+    }
+
+    /**
+     * Let go of the image, giving it back to the pool if this was the last
+     * reference to it.
+     */
+    void Reset() {
+      if (m_entry != nullptr && --m_entry->references == 0) {
+        m_entry->pool->Release(m_entry);
+      }
+      m_entry = nullptr;
+    }
+
+    T *Get() const {
+      return m_entry ? static_cast<T *>(m_entry->image.get()) : nullptr;
+    }
+    T *operator->() const { return Get(); }
+    T &operator*() const { return *Get(); }
+    explicit operator bool() const { return m_entry != nullptr; }
+
+    int GetReferenceCount() const {
+      return m_entry ? m_entry->references.load() : 0;
+    }
+
+   private:
+    friend class ImagePool;
+    explicit Ref(Entry *entry) : m_entry(entry) {}
+
+    Entry *m_entry = nullptr;
+  };
+
+  struct Statistics {
+    uint64_t acquired;  // images handed out
+    uint64_t created;   // images created because none were free
+    size_t inUse;
+    size_t free;
+  };
+
+  ImagePool() = default;
+  virtual ~ImagePool();
+
+  ImagePool(const ImagePool &) = delete;
+  ImagePool &operator=(const ImagePool &) = delete;
+
+  /**
+   * Get an image of the given class and size, reusing a free one if there
+   * is one.
+   * The contents of a reused image are whatever was last left in it.
+   */
+  template <typename T>
+  Ref<T> Acquire(int width, int height) {
+    return Ref<T>(AcquireEntry(typeid(T), width, height,
+                               []() -> ImageBase * { return new T(); }));
+  }
+
+  /**
+   * Create images ahead of time, so the first frames don't have to.
+   * @param count The number of free images of the class and size to have
+   */
+  template <typename T>
+  void Reserve(int width, int height, size_t count) {
+    std::vector<Ref<T>> images;
+    while (images.size() < count) images.push_back(Acquire<T>(width, height));
+  }
+
+  Statistics GetStatistics();
+
+ private:
+  struct Bucket {
+    const std::type_info *type;
+    int width;
+    int height;
+    std::vector<Entry *> free;
+  };
+
+  size_t FindBucket(const std::type_info &type, int width, int height);
+  Entry *AcquireEntry(const std::type_info &type, int width, int height,
+                      ImageBase *(*create)());
+  void Release(Entry *entry);
+
+  priority_mutex m_mutex;
+  std::vector<Bucket> m_buckets;
+  std::vector<std::unique_ptr<Entry>> m_entries;
+  uint64_t m_acquired = 0;
+  size_t m_inUse = 0;
+};
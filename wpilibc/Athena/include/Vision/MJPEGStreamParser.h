@@ -0,0 +1,53 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Incremental parser for an HTTP multipart MJPEG stream, as sent by Axis
+ * cameras.
+ *
+ * Bytes are fed in whatever pieces the socket returns them.  Header blocks
+ * without a Content-Length, like the HTTP response header, are skipped; every
+ * other header block is followed by a frame of exactly Content-Length bytes.
+ * Each byte is looked at once, and the frame buffer keeps its capacity from
+ * frame to frame so it is only reallocated when the frames grow.
+ */
+class MJPEGStreamParser {
+ public:
+  enum Result { kNeedMoreData, kFrameReady, kError };
+
+  static const size_t kMaxHeaderSize = 4096;
+  static const size_t kMaxFrameSize = 4 * 1024 * 1024;
+
+  MJPEGStreamParser() = default;
+
+  size_t Feed(const uint8_t *data, size_t length, Result &result);
+  void Reset();
+
+  /**
+   * The frame completed by the last Feed() that returned kFrameReady.  The
+   * caller may swap it with another buffer to keep the frame without copying.
+   */
+  std::vector<uint8_t> &GetFrame() { return m_frame; }
+  const std::string &GetError() const { return m_error; }
+
+ private:
+  bool ParseHeader();
+
+  enum State { kHeader, kBody };
+
+  State m_state = kHeader;
+  std::string m_header;
+  size_t m_frameLength = 0;
+  size_t m_frameRead = 0;
+  std::vector<uint8_t> m_frame;
+  std::string m_error;
+};
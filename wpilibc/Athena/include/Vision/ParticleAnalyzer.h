@@ -0,0 +1,145 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "HAL/cpp/priority_condition_variable.h"
+#include "HAL/cpp/priority_mutex.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/**
+ * Connected component labeling and particle measurement for binary images.
+ *
+ * Analyze() sweeps the image once, encoding each line as runs of particle
+ * and background pixels and joining the runs that touch runs of the line
+ * above. Every measurement is then summed from the runs, so the work per
+ * particle doesn't depend on how many measurements are wanted, and the
+ * reports of all the particles are produced together in one array.
+ *
+ * Pixel (x, y) covers the square from (x, y) to (x + 1, y + 1), so its center
+ * is (x + 0.5, y + 0.5) and a particle of one pixel has a convex hull area of
+ * 1. Particles are numbered in the order their first pixel is found, top to
+ * bottom and left to right, which is how NI Vision numbers them.
+ *
+ * The analyzer keeps its memory from one image to the next, so after the
+ * first few frames analyzing an image doesn't allocate. With more than one
+ * thread the image is split into bands of lines that are encoded in
+ * parallel, then joined. The threads are started once and wait for the next
+ * image between calls to Analyze().
+ */
+class ParticleAnalyzer {
+ public:
+  struct Report {
+    int index;  // the order in which the particle was found, from 0
+    int area;   // in pixels
+    int left;
+    int top;
+    int width;
+    int height;
+    double centerX;  // center of mass
+    double centerY;
+    // Second moments about the center of mass: the sums of (x - centerX)^2,
+    // (y - centerY)^2 and (x - centerX)(y - centerY) over the pixels
+    double momentXX;
+    double momentYY;
+    double momentXY;
+    double convexHullArea;
+    int holesArea;  // background enclosed by the particle
+  };
+
+  explicit ParticleAnalyzer(bool connectivity8 = true, int threads = 1);
+  ~ParticleAnalyzer();
+
+  ParticleAnalyzer(const ParticleAnalyzer &) = delete;
+  ParticleAnalyzer &operator=(const ParticleAnalyzer &) = delete;
+
+  void SetConnectivity8(bool connectivity8) { m_connectivity8 = connectivity8; }
+  void SetThreads(int threads);
+
+  int Analyze(const uint8_t *pixels, int pixelsPerLine, int width,
+              int height);
+  void SortByArea();
+
+  const std::vector<Report> &GetReports() const { return m_reports; }
+
+ private:
+  struct Run {
+    int y;
+    int x0;  // first pixel
+    int x1;  // last pixel
+  };
+
+  // The runs of one kind of pixel: particle or background
+  struct Runs {
+    std::vector<Run> runs;
+    std::vector<int> parents;
+    std::vector<int> lineStarts;  // index of the first run of each line
+
+    void Clear();
+    int Find(int run);
+    void Union(int run1, int run2);
+    void JoinLines(int above, int below, int end, bool connectivity8);
+    void Append(const Runs &band);
+  };
+
+  struct Band {
+    Runs particles;
+    Runs background;
+  };
+
+  struct Sums {
+    int64_t x, y, xx, yy, xy;
+  };
+
+  struct Point {
+    int x;
+    int y;
+    bool operator<(const Point &other) const {
+      return y < other.y || (y == other.y && x < other.x);
+    }
+  };
+
+  static void EncodeBand(Band &band, const uint8_t *pixels, int pixelsPerLine,
+                         int width, int firstLine, int endLine,
+                         bool connectivity8);
+  void StopWorkers();
+  void Work(int band);
+  void Measure(int width, int height);
+  void MeasureConvexHulls();
+  void MeasureHoles(int width, int height);
+
+  bool m_connectivity8;
+  int m_threads;
+  std::vector<Band> m_bands;
+
+  // Band i is encoded by worker i - 1, band 0 by the thread calling Analyze()
+  std::vector<std::thread> m_workers;
+  priority_mutex m_workMutex;
+  priority_condition_variable m_workReady;
+  priority_condition_variable m_workDone;
+  unsigned int m_generation = 0;  // counts the images given to the workers
+  int m_pendingWorkers = 0;
+  bool m_stopWorkers = false;
+  // The image being encoded
+  const uint8_t *m_pixels = nullptr;
+  int m_pixelsPerLine = 0;
+  int m_width = 0;
+  int m_height = 0;
+  int m_numBands = 0;
+
+  Band m_image;
+  std::vector<int> m_particleOfRun;
+  std::vector<int> m_backgroundAreas;  // by root run, -1 if not a hole
+  std::vector<int> m_runOrder;  // runs sorted by particle
+  std::vector<int> m_particleStarts;
+  std::vector<Sums> m_sums;
+  std::vector<Point> m_points;
+  std::vector<Point> m_hull;
+  std::vector<Report> m_reports;
+};
@@ -0,0 +1,155 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HAL/cpp/priority_condition_variable.h"
+#include "HAL/cpp/priority_mutex.h"
+
+#include "ErrorBase.h"
+#include "USBCamera.h"
+#include "Vision/BinaryImage.h"
+#include "Vision/RGBImage.h"
+
+/**
+ * Runs vision processing as a pipeline of stages, each on its own thread.
+ *
+ * Frames go from capture, to JPEG decoding, through the stages added with
+ * AddStage(), to the publisher. While one stage works on a frame, the stage
+ * before it is already working on the next one, so the frame rate is set by
+ * the slowest stage rather than by the sum of all of them.
+ *
+ * Between each pair of stages is a short queue. When a stage falls behind,
+ * the oldest frame waiting for it is dropped to make room for the new one,
+ * so the results are always of the latest frame that could be processed.
+ *
+ * All the frames are allocated when the pipeline starts, with enough of them
+ * for every queue and stage to hold one, and are reused after being
+ * published or dropped. Stages should keep their results in the frame's
+ * images and vectors, which keep their memory from one use to the next.
+ *
+ * Each frame carries the FPGA time it was captured at, so results can be
+ * matched with where the robot was when the picture was taken.
+ *
+ * Frames that can't be decoded are dropped rather than passed on with the
+ * image of an earlier frame, and counted as failed in the decode stage's
+ * statistics. Errors on the pipeline's threads are only counted, never set
+ * on the pipeline, since ErrorBase isn't safe to set from several threads.
+ *
+ * Example:
+ * @code
+ *   VisionPipeline pipeline(camera);
+ *   pipeline.AddStage("threshold", [](VisionPipeline::Frame &frame) {
+ *     frame.image.ThresholdNativeHSV(threshold, &frame.binary);
+ *   });
+ *   pipeline.AddStage("particles", [&](VisionPipeline::Frame &frame) {
+ *     frame.binary.GetOrderedParticleAnalysisReports(analyzer,
+ *                                                     frame.particles);
+ *   });
+ *   pipeline.Start();
+ * @endcode
+ */
+class VisionPipeline : public ErrorBase {
+ public:
+  /// Largest JPEG image that can be captured
+  static constexpr unsigned int kMaxImageSize = 200000;
+
+  struct Frame {
+    uint64_t number = 0;     // counts the frames captured
+    double timestamp = 0.0;  // FPGA time when the frame was captured
+    // The JPEG image from the camera
+    std::unique_ptr<uint8_t[]> jpeg{new uint8_t[kMaxImageSize]};
+    unsigned int jpegSize = 0;
+    RGBImage image;  // the decoded image
+    BinaryImage binary;
+    std::vector<ParticleAnalysisReport> particles;
+  };
+
+  struct Statistics {
+    uint64_t frames = 0;   // frames processed
+    uint64_t dropped = 0;  // frames dropped while waiting for the stage
+    uint64_t failed = 0;   // frames dropped because the stage failed on them
+    // Processing time of a frame in seconds
+    double lastTime = 0.0;
+    double averageTime = 0.0;
+    double maxTime = 0.0;
+  };
+
+  typedef std::function<void(Frame &frame)> StageFunction;
+  typedef std::function<void(const Frame &frame)> Publisher;
+
+  explicit VisionPipeline(std::shared_ptr<USBCamera> camera,
+                          unsigned int queueLength = 1);
+  virtual ~VisionPipeline();
+
+  VisionPipeline(const VisionPipeline &) = delete;
+  VisionPipeline &operator=(const VisionPipeline &) = delete;
+
+  void AddStage(std::string name, StageFunction function);
+  void SetPublisher(Publisher publisher);
+
+  void Start();
+  void Stop();
+  bool IsRunning();
+
+  int GetNumStages();
+  std::string GetStageName(int stage);
+  Statistics GetStatistics(int stage);
+  Statistics GetLatency();
+
+  bool GetLatestResult(std::vector<ParticleAnalysisReport> &particles,
+                       double &timestamp);
+
+ private:
+  // Returns false to drop the frame
+  typedef std::function<bool(Frame &frame)> StageStep;
+
+  struct Stage {
+    std::string name;
+    StageStep function;
+    // The frames waiting for the stage, oldest first, in a ring
+    std::vector<Frame *> queue;
+    size_t queueStart = 0;
+    size_t queueSize = 0;
+    priority_condition_variable frameReady;
+    Statistics statistics;
+    double totalTime = 0.0;
+    std::thread thread;
+
+    Stage(std::string name, StageStep function)
+        : name(name), function(function) {}
+  };
+
+  void Capture();
+  static bool Decode(Frame &frame);
+  bool Publish(Frame &frame);
+  void RunStage(size_t index);
+  void PushFrame(Stage &stage, Frame *frame);
+  static void AddTime(Statistics &statistics, double &totalTime, double time);
+  void ReleaseFrame(Frame *frame);
+
+  std::shared_ptr<USBCamera> m_camera;
+  unsigned int m_queueLength;
+  Publisher m_publisher;
+
+  priority_mutex m_mutex;
+  bool m_running = false;
+  // Capture, decode, the stages that were added, then publish
+  std::vector<std::unique_ptr<Stage>> m_stages;
+  std::vector<std::unique_ptr<Frame>> m_frames;
+  std::vector<Frame *> m_freeFrames;
+  priority_condition_variable m_frameFreed;
+  uint64_t m_frameNumber = 0;
+  Frame *m_latest = nullptr;
+  Statistics m_latency;
+  double m_totalLatency = 0.0;
+};
@@ -86,9 +86,10 @@ void ADXL345_I2C::InitTable(std::shared_ptr<ITable> subtable) {
 }
 
 void ADXL345_I2C::UpdateTable() {
-  m_table->PutNumber("X", GetX());
-  m_table->PutNumber("Y", GetY());
-  m_table->PutNumber("Z", GetZ());
+  LiveWindow *liveWindow = LiveWindow::GetInstance();
+  liveWindow->PublishNumber(m_table, "X", GetX());
+  liveWindow->PublishNumber(m_table, "Y", GetY());
+  liveWindow->PublishNumber(m_table, "Z", GetZ());
 }
 
 std::shared_ptr<ITable> ADXL345_I2C::GetTable() const { return m_table; }
@@ -117,9 +117,10 @@ void ADXL345_SPI::InitTable(std::shared_ptr<ITable> subtable) {
 
 void ADXL345_SPI::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("X", GetX());
-    m_table->PutNumber("Y", GetY());
-    m_table->PutNumber("Z", GetZ());
+    LiveWindow *liveWindow = LiveWindow::GetInstance();
+    liveWindow->PublishNumber(m_table, "X", GetX());
+    liveWindow->PublishNumber(m_table, "Y", GetY());
+    liveWindow->PublishNumber(m_table, "Z", GetZ());
   }
 }
 
@@ -114,7 +114,8 @@ double AnalogAccelerometer::PIDGet() { return GetAcceleration(); }
 
 void AnalogAccelerometer::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Value", GetAcceleration());
+    LiveWindow::GetInstance()->PublishNumber(m_table, "Value",
+                                             GetAcceleration());
   }
 }
 
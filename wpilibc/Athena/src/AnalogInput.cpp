@@ -402,7 +402,8 @@ double AnalogInput::PIDGet() {
 
 void AnalogInput::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Value", GetAverageVoltage());
+    LiveWindow::GetInstance()->PublishNumber(m_table, "Value",
+                                             GetAverageVoltage());
   }
 }
 
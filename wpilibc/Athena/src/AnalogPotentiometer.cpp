@@ -1,5 +1,6 @@
 #include "AnalogPotentiometer.h"
 #include "ControllerPower.h"
+#include "LiveWindow/LiveWindow.h"
 
 /**
  * Construct an Analog Potentiometer object from a channel number.
@@ -85,7 +86,7 @@ void AnalogPotentiometer::InitTable(std::shared_ptr<ITable> subtable) {
 
 void AnalogPotentiometer::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Value", Get());
+    LiveWindow::GetInstance()->PublishNumber(m_table, "Value", Get());
   }
 }
 
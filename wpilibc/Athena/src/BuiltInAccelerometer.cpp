@@ -59,9 +59,10 @@ void BuiltInAccelerometer::InitTable(std::shared_ptr<ITable> subtable) {
 
 void BuiltInAccelerometer::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("X", GetX());
-    m_table->PutNumber("Y", GetY());
-    m_table->PutNumber("Z", GetZ());
+    LiveWindow *liveWindow = LiveWindow::GetInstance();
+    liveWindow->PublishNumber(m_table, "X", GetX());
+    liveWindow->PublishNumber(m_table, "Y", GetY());
+    liveWindow->PublishNumber(m_table, "Z", GetZ());
   }
 }
 
@@ -1,6 +1,7 @@
 #include "CameraServer.h"
 #include "WPIErrors.h"
 #include "Utility.h"
+#include "HAL/cpp/mutex_profiler.h"
 
 #include <iostream>
 #include <chrono>
@@ -26,14 +27,16 @@ CameraServer::CameraServer()
       m_quality(50),
       m_autoCaptureStarted(false),
       m_hwClient(true),
-      m_imageData(nullptr, 0, 0, false) {
+      m_imageData(nullptr, 0, 0, kPoolImage) {
   for (int i = 0; i < 3; i++) m_dataPool.push_back(new uint8_t[kMaxImageSize]);
+  hal::mutex_profiler::SetLockName(&m_imageMutex, "CameraServer::m_imageMutex");
 }
 
-void CameraServer::FreeImageData(
-    std::tuple<uint8_t*, unsigned int, unsigned int, bool> imageData) {
-  if (std::get<3>(imageData))
+void CameraServer::FreeImageData(ImageData imageData) {
+  if (std::get<3>(imageData) == kImaqImage)
     imaqDispose(std::get<0>(imageData));
+  else if (std::get<3>(imageData) == kCameraImage)
+    m_camera->ReleaseImageData(std::get<0>(imageData));
   else if (std::get<0>(imageData) != nullptr) {
     std::lock_guard<priority_recursive_mutex> lock(m_imageMutex);
     m_dataPool.push_back(std::get<0>(imageData));
@@ -41,10 +44,10 @@ void CameraServer::FreeImageData(
 }
 
 void CameraServer::SetImageData(uint8_t* data, unsigned int size,
-                                unsigned int start, bool imaqData) {
+                                unsigned int start, ImageSource source) {
   std::lock_guard<priority_recursive_mutex> lock(m_imageMutex);
   FreeImageData(m_imageData);
-  m_imageData = std::make_tuple(data, size, start, imaqData);
+  m_imageData = std::make_tuple(data, size, start, source);
   m_newImageVariable.notify_all();
 }
 
@@ -73,7 +76,7 @@ void CameraServer::SetImage(Image const* image) {
   dataSize -= start;
 
   wpi_assert(dataSize > 2);
-  SetImageData(data, dataSize, start, true);
+  SetImageData(data, dataSize, start, kImaqImage);
 }
 
 void CameraServer::AutoCapture() {
@@ -81,18 +84,28 @@ void CameraServer::AutoCapture() {
 
   while (true) {
     bool hwClient;
-    uint8_t* data = nullptr;
     {
       std::lock_guard<priority_recursive_mutex> lock(m_imageMutex);
       hwClient = m_hwClient;
-      if (hwClient) {
-        data = m_dataPool.back();
-        m_dataPool.pop_back();
-      }
     }
 
     if (hwClient) {
-      unsigned int size = m_camera->GetImageData(data, kMaxImageSize);
+      // Send the camera's own buffer if it lends it out, rather than copying
+      // the image into one from the pool
+      unsigned int size = 0;
+      const uint8_t* cameraData = m_camera->AcquireImageData(size);
+      if (cameraData != nullptr) {
+        SetImageData(const_cast<uint8_t*>(cameraData), size, 0, kCameraImage);
+        continue;
+      }
+
+      uint8_t* data = nullptr;
+      {
+        std::lock_guard<priority_recursive_mutex> lock(m_imageMutex);
+        data = m_dataPool.back();
+        m_dataPool.pop_back();
+      }
+      size = m_camera->GetImageData(data, kMaxImageSize);
       SetImageData(data, size);
     } else {
       m_camera->GetImage(frame);
@@ -217,12 +230,12 @@ void CameraServer::Serve() {
     auto period = std::chrono::microseconds(1000000) / req.fps;
     while (true) {
       auto startTime = std::chrono::steady_clock::now();
-      std::tuple<uint8_t*, unsigned int, unsigned int, bool> imageData;
+      ImageData imageData;
       {
         std::unique_lock<priority_recursive_mutex> lock(m_imageMutex);
         m_newImageVariable.wait(lock);
         imageData = m_imageData;
-        m_imageData = std::make_tuple<uint8_t*>(nullptr, 0, 0, false);
+        m_imageData = std::make_tuple<uint8_t*>(nullptr, 0, 0, kPoolImage);
       }
 
       unsigned int size = std::get<1>(imageData);
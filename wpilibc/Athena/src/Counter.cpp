@@ -8,6 +8,7 @@
 #include "Counter.h"
 #include "AnalogTrigger.h"
 #include "DigitalInput.h"
+#include "LiveWindow/LiveWindow.h"
 //#include "NetworkCommunication/UsageReporting.h"
 #include "Resource.h"
 #include "WPIErrors.h"
@@ -590,7 +591,7 @@ void Counter::SetReverseDirection(bool reverseDirection) {
 
 void Counter::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Value", Get());
+    LiveWindow::GetInstance()->PublishNumber(m_table, "Value", Get());
   }
 }
 
@@ -50,11 +50,17 @@ DriverStation::DriverStation() {
 
   AddToSingletonList();
 
+  m_isRunning = true;
   m_task = Task("DriverStation", &DriverStation::Run, this);
 }
 
 DriverStation::~DriverStation() {
-  m_isRunning = false;
+  {
+    // Wake the task up, since packets may have stopped coming.
+    std::lock_guard<priority_mutex> lock(m_packetDataAvailableMutex);
+    m_isRunning = false;
+    m_packetDataAvailableCond.notify_all();
+  }
   m_task.join();
 
   // Unregister our semaphore.
@@ -62,15 +68,16 @@ DriverStation::~DriverStation() {
 }
 
 void DriverStation::Run() {
-  m_isRunning = true;
   int period = 0;
-  while (m_isRunning) {
+  while (true) {
     {
       std::unique_lock<priority_mutex> lock(m_packetDataAvailableMutex);
+      if (!m_isRunning) break;
       m_packetDataAvailableCond.wait(lock);
+      if (!m_isRunning) break;
     }
     GetData();
-    m_waitForDataCond.notify_all();
+    m_waitForData.notify_all();
 
     if (++period >= 4) {
       MotorSafetyHelper::CheckMotors();
@@ -106,6 +113,7 @@ void DriverStation::GetData() {
     HALGetJoystickButtons(stick, &m_joystickButtons[stick]);
     HALGetJoystickDescriptor(stick, &m_joystickDescriptor[stick]);
   }
+  m_packetCount++;
   m_newControlData.give();
 }
 
@@ -271,6 +279,23 @@ float DriverStation::GetStickAxis(uint32_t stick, uint32_t axis) {
   }
 }
 
+/**
+ * Copy all of the axes of a joystick, as received in the last packet.
+ * Unlike GetStickAxis() this doesn't report missing axes; callers should check
+ * the count.
+ *
+ * @param stick The joystick to read.
+ * @param axes Filled in with the raw axis values and the number of axes.
+ */
+void DriverStation::GetStickAxes(uint32_t stick, HALJoystickAxes &axes) const {
+  if (stick >= kJoystickPorts) {
+    wpi_setWPIError(BadJoystickIndex);
+    axes.count = 0;
+    return;
+  }
+  axes = m_joystickAxes[stick];
+}
+
 /**
  * Get the state of a POV on the joystick.
  *
@@ -499,10 +524,7 @@ uint32_t DriverStation::GetLocation() const {
  * This is a good way to delay processing until there is new driver station data
  * to act on
  */
-void DriverStation::WaitForData() {
-  std::unique_lock<priority_mutex> lock(m_waitForDataMutex);
-  m_waitForDataCond.wait(lock);
-}
+void DriverStation::WaitForData() { m_waitForData.wait(); }
 
 /**
  * Return the approximate match time
@@ -545,9 +545,10 @@ void Encoder::SetIndexSource(const DigitalSource &source,
 
 void Encoder::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Speed", GetRate());
-    m_table->PutNumber("Distance", GetDistance());
-    m_table->PutNumber("Distance per Tick", m_distancePerPulse);
+    LiveWindow *liveWindow = LiveWindow::GetInstance();
+    liveWindow->PublishNumber(m_table, "Speed", GetRate());
+    liveWindow->PublishNumber(m_table, "Distance", GetDistance());
+    liveWindow->PublishNumber(m_table, "Distance per Tick", m_distancePerPulse);
   }
 }
 
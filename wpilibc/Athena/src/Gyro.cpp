@@ -208,7 +208,7 @@ double Gyro::PIDGet() {
 
 void Gyro::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Value", GetAngle());
+    LiveWindow::GetInstance()->PublishNumber(m_table, "Value", GetAngle());
   }
 }
 
@@ -12,6 +12,7 @@
 #include "HAL/HAL.hpp"
 #include "SmartDashboard/SmartDashboard.h"
 #include "LiveWindow/LiveWindow.h"
+#include "LoopTiming.h"
 #include "networktables/NetworkTable.h"
 
 constexpr double IterativeRobot::kDefaultPeriod;
@@ -26,12 +27,16 @@ void IterativeRobot::Prestart() {
  *
  * This specific StartCompetition() implements "main loop" behaviour synced with
  * the DS packets
+ *
+ * Each pass is timed by LoopTiming when it is enabled, see
+ * EnableLoopTiming().
  */
 void IterativeRobot::StartCompetition() {
   HALReport(HALUsageReporting::kResourceType_Framework,
             HALUsageReporting::kFramework_Iterative);
 
   LiveWindow *lw = LiveWindow::GetInstance();
+  LoopTiming *timing = LoopTiming::GetInstance();
   // first and one-time initialization
   SmartDashboard::init();
   NetworkTable::GetTable("LiveWindow")
@@ -48,6 +53,7 @@ void IterativeRobot::StartCompetition() {
   // loop forever, calling the appropriate mode-dependent function
   lw->SetEnabled(false);
   while (true) {
+    timing->StartLoop();
     // Call the appropriate function depending upon the current robot mode
     if (IsDisabled()) {
       // call DisabledInit() if we are now just entering disabled mode from
@@ -62,7 +68,10 @@ void IterativeRobot::StartCompetition() {
         m_testInitialized = false;
       }
       HALNetworkCommunicationObserveUserProgramDisabled();
-      DisabledPeriodic();
+      {
+        LoopTiming::Scope periodic(LoopTiming::kPeriodic);
+        DisabledPeriodic();
+      }
     } else if (IsAutonomous()) {
       // call AutonomousInit() if we are now just entering autonomous mode from
       // either a different mode or from power-on
@@ -76,7 +85,10 @@ void IterativeRobot::StartCompetition() {
         m_testInitialized = false;
       }
       HALNetworkCommunicationObserveUserProgramAutonomous();
-      AutonomousPeriodic();
+      {
+        LoopTiming::Scope periodic(LoopTiming::kPeriodic);
+        AutonomousPeriodic();
+      }
     } else if (IsTest()) {
       // call TestInit() if we are now just entering test mode from
       // either a different mode or from power-on
@@ -90,7 +102,10 @@ void IterativeRobot::StartCompetition() {
         m_teleopInitialized = false;
       }
       HALNetworkCommunicationObserveUserProgramTest();
-      TestPeriodic();
+      {
+        LoopTiming::Scope periodic(LoopTiming::kPeriodic);
+        TestPeriodic();
+      }
     } else {
       // call TeleopInit() if we are now just entering teleop mode from
       // either a different mode or from power-on
@@ -105,13 +120,39 @@ void IterativeRobot::StartCompetition() {
         Scheduler::GetInstance()->SetEnabled(true);
       }
       HALNetworkCommunicationObserveUserProgramTeleop();
-      TeleopPeriodic();
+      {
+        LoopTiming::Scope periodic(LoopTiming::kPeriodic);
+        TeleopPeriodic();
+      }
     }
     // wait for driver station data so the loop doesn't hog the CPU
-    m_ds.WaitForData();
+    {
+      LoopTiming::Scope waiting(LoopTiming::kDSWait);
+      m_ds.WaitForData();
+    }
+    timing->EndLoop();
   }
 }
 
+/**
+ * Turn on timing of the main loop.
+ *
+ * The time spent waiting for DS data, in the Periodic() functions, in the
+ * Scheduler and in the LiveWindow is measured every loop.  Loops whose work,
+ * not counting the wait for DS data, takes longer than the overrun threshold
+ * are counted and logged, and the statistics are published to the
+ * "LoopTiming" table of the SmartDashboard.
+ *
+ * @param enabled True to measure the loop
+ * @param overrunThreshold The loop time, in seconds, above which a loop is an
+ * overrun.  The default is the DS packet period.
+ */
+void IterativeRobot::EnableLoopTiming(bool enabled, double overrunThreshold) {
+  LoopTiming *timing = LoopTiming::GetInstance();
+  timing->SetOverrunThreshold(overrunThreshold);
+  timing->SetEnabled(enabled);
+}
+
 /**
  * Robot-wide initialization code should go here.
  *
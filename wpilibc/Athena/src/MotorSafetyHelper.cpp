@@ -9,14 +9,19 @@
 
 #include "DriverStation.h"
 #include "MotorSafety.h"
-#include "Timer.h"
+#include "Task.h"
 #include "WPIErrors.h"
 
 #include <stdio.h>
+#include <chrono>
 #include <sstream>
+#include <thread>
 
-std::set<MotorSafetyHelper*> MotorSafetyHelper::m_helperList;
+std::set<MotorSafetyHelper::Deadline> MotorSafetyHelper::m_deadlines;
 priority_recursive_mutex MotorSafetyHelper::m_listMutex;
+priority_mutex MotorSafetyHelper::m_stopMutex;
+std::atomic<int64_t> MotorSafetyHelper::m_checkPeriod{0};
+std::atomic<bool> MotorSafetyHelper::m_watchdogRunning{false};
 
 /**
  * The constructor for a MotorSafetyHelper object.
@@ -33,45 +38,50 @@ priority_recursive_mutex MotorSafetyHelper::m_listMutex;
  */
 MotorSafetyHelper::MotorSafetyHelper(MotorSafety *safeObject)
     : m_safeObject(safeObject) {
+  int64_t now = GetTime();
   m_enabled = false;
-  m_expiration = DEFAULT_SAFETY_EXPIRATION;
-  m_stopTime = Timer::GetFPGATimestamp();
+  m_expiration = DEFAULT_SAFETY_EXPIRATION * 1e6;
+  // Not fed yet, so already expired
+  m_lastFeed = now - m_expiration;
+  m_deadline = now;
 
   std::lock_guard<priority_recursive_mutex> sync(m_listMutex);
-  m_helperList.insert(this);
+  m_deadlines.insert(Deadline(m_deadline, this));
 }
 
 MotorSafetyHelper::~MotorSafetyHelper() {
-  std::lock_guard<priority_recursive_mutex> sync(m_listMutex);
-  m_helperList.erase(this);
+  {
+    std::lock_guard<priority_recursive_mutex> sync(m_listMutex);
+    m_deadlines.erase(Deadline(m_deadline, this));
+  }
+  // Wait out a CheckMotors() that took this helper off the list to stop it
+  std::lock_guard<priority_mutex> sync(m_stopMutex);
 }
 
 /**
  * Feed the motor safety object.
  * Resets the timer on this object that is used to do the timeouts.
+ * This only records the time; the deadline is moved lazily when it is reached.
  */
-void MotorSafetyHelper::Feed() {
-  std::lock_guard<priority_recursive_mutex> sync(m_syncMutex);
-  m_stopTime = Timer::GetFPGATimestamp() + m_expiration;
-}
+void MotorSafetyHelper::Feed() { m_lastFeed = GetTime(); }
 
 /**
  * Set the expiration time for the corresponding motor safety object.
  * @param expirationTime The timeout value in seconds.
  */
 void MotorSafetyHelper::SetExpiration(float expirationTime) {
-  std::lock_guard<priority_recursive_mutex> sync(m_syncMutex);
-  m_expiration = expirationTime;
+  m_expiration = expirationTime * 1e6;
+
+  // The deadline may have moved earlier
+  std::lock_guard<priority_recursive_mutex> sync(m_listMutex);
+  Schedule(m_lastFeed + m_expiration);
 }
 
 /**
  * Retrieve the timeout value for the corresponding motor safety object.
  * @return the timeout value in seconds.
  */
-float MotorSafetyHelper::GetExpiration() const {
-  std::lock_guard<priority_recursive_mutex> sync(m_syncMutex);
-  return m_expiration;
-}
+float MotorSafetyHelper::GetExpiration() const { return m_expiration / 1e6; }
 
 /**
  * Determine if the motor is still operating or has timed out.
@@ -79,8 +89,7 @@ float MotorSafetyHelper::GetExpiration() const {
  * timed out.
  */
 bool MotorSafetyHelper::IsAlive() const {
-  std::lock_guard<priority_recursive_mutex> sync(m_syncMutex);
-  return !m_enabled || m_stopTime > Timer::GetFPGATimestamp();
+  return !m_enabled || m_lastFeed + m_expiration > GetTime();
 }
 
 /**
@@ -95,14 +104,7 @@ void MotorSafetyHelper::Check() {
   DriverStation &ds = DriverStation::GetInstance();
   if (!m_enabled || ds.IsDisabled() || ds.IsTest()) return;
 
-  std::lock_guard<priority_recursive_mutex> sync(m_syncMutex);
-  if (m_stopTime < Timer::GetFPGATimestamp()) {
-    std::ostringstream desc;
-    m_safeObject->GetDescription(desc);
-    desc <<  "... Output not updated often enough.";
-    wpi_setWPIErrorWithContext(Timeout, desc.str().c_str());
-    m_safeObject->StopMotor();
-  }
+  if (m_lastFeed + m_expiration < GetTime()) Stop();
 }
 
 /**
@@ -111,8 +113,12 @@ void MotorSafetyHelper::Check() {
  * @param enabled True if motor safety is enforced for this object
  */
 void MotorSafetyHelper::SetSafetyEnabled(bool enabled) {
-  std::lock_guard<priority_recursive_mutex> sync(m_syncMutex);
   m_enabled = enabled;
+
+  if (enabled) {
+    std::lock_guard<priority_recursive_mutex> sync(m_listMutex);
+    Schedule(m_lastFeed + m_expiration);
+  }
 }
 
 /**
@@ -120,20 +126,127 @@ void MotorSafetyHelper::SetSafetyEnabled(bool enabled) {
  * Return if the motor safety is currently enabled for this devicce.
  * @return True if motor safety is enforced for this device
  */
-bool MotorSafetyHelper::IsSafetyEnabled() const {
-  std::lock_guard<priority_recursive_mutex> sync(m_syncMutex);
-  return m_enabled;
-}
+bool MotorSafetyHelper::IsSafetyEnabled() const { return m_enabled; }
 
 /**
  * Check the motors to see if any have timed out.
- * This static  method is called periodically to poll all the motors and stop
- * any that have
- * timed out.
+ * This static  method is called periodically to stop any motors that have
+ * timed out.  The helpers are kept ordered by deadline, so only the ones whose
+ * deadline has passed are looked at; when nothing is due this is a single
+ * comparison.
+ *
+ * The motors are stopped after m_listMutex is released, so a slow StopMotor()
+ * doesn't hold up helpers being created or rescheduled.
  */
 void MotorSafetyHelper::CheckMotors() {
-  std::lock_guard<priority_recursive_mutex> sync(m_listMutex);
-  for (auto elem : m_helperList) {
-    elem->Check();
+  int64_t now = GetTime();
+  std::vector<MotorSafetyHelper *> expired;
+  std::unique_lock<priority_mutex> stopSync(m_stopMutex, std::defer_lock);
+
+  {
+    std::lock_guard<priority_recursive_mutex> sync(m_listMutex);
+    if (m_deadlines.empty() || m_deadlines.begin()->first > now) return;
+
+    DriverStation &ds = DriverStation::GetInstance();
+    bool stopAllowed = !ds.IsDisabled() && !ds.IsTest();
+    while (!m_deadlines.empty() && m_deadlines.begin()->first <= now) {
+      MotorSafetyHelper *helper = m_deadlines.begin()->second;
+      if (helper->CheckExpired(now, stopAllowed)) expired.push_back(helper);
+    }
+    // Taken before the list is released, so none of the expired helpers can
+    // finish being destroyed until they have been stopped
+    if (!expired.empty()) stopSync.lock();
   }
+
+  for (MotorSafetyHelper *helper : expired) helper->Stop();
+}
+
+/**
+ * Check the motors from a dedicated thread in addition to the DriverStation
+ * task, which only checks every fourth DS packet.  A shorter period stops the
+ * motors sooner after a hung loop stops feeding them.
+ *
+ * @param period The time between checks in seconds, or 0 to stop the thread.
+ */
+void MotorSafetyHelper::SetCheckPeriod(double period) {
+  m_checkPeriod = period > 0.0 ? static_cast<int64_t>(period * 1e6) : 0;
+
+  if (m_checkPeriod > 0 && !m_watchdogRunning.exchange(true)) {
+    Task watchdog("MotorSafety", &MotorSafetyHelper::WatchdogRun);
+    watchdog.detach();
+  }
+}
+
+/**
+ * @return The period of the dedicated check thread in seconds, or 0 if motors
+ * are only checked from the DriverStation task.
+ */
+double MotorSafetyHelper::GetCheckPeriod() { return m_checkPeriod / 1e6; }
+
+/**
+ * Body of the dedicated check thread.  Exits once the period is set to 0.
+ */
+void MotorSafetyHelper::WatchdogRun() {
+  while (true) {
+    int64_t period;
+    while ((period = m_checkPeriod) > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(period));
+      CheckMotors();
+    }
+    m_watchdogRunning = false;
+    // Keep going if the period was set again before we cleared the flag
+    if (m_checkPeriod == 0 || m_watchdogRunning.exchange(true)) return;
+  }
+}
+
+/**
+ * Handle this helper reaching its deadline.
+ * If it has been fed since the deadline was set, the deadline is moved to the
+ * new expiration.  Otherwise the motor is checked again after another
+ * expiration period.  Must be called with m_listMutex held.
+ *
+ * @param now The current GetTime()
+ * @param stopAllowed False if the robot is disabled or in test mode
+ * @return True if the motor needs to be stopped
+ */
+bool MotorSafetyHelper::CheckExpired(int64_t now, bool stopAllowed) {
+  int64_t deadline = m_lastFeed + m_expiration;
+  if (deadline > now) {
+    Schedule(deadline);
+    return false;
+  }
+
+  // Always move past now so CheckMotors() makes progress
+  Schedule(now + m_expiration + 1);
+  return m_enabled && stopAllowed;
+}
+
+/**
+ * Report the timeout and stop the motor.
+ */
+void MotorSafetyHelper::Stop() {
+  std::ostringstream desc;
+  m_safeObject->GetDescription(desc);
+  desc <<  "... Output not updated often enough.";
+  wpi_setWPIErrorWithContext(Timeout, desc.str().c_str());
+  m_safeObject->StopMotor();
+}
+
+/**
+ * Move this helper to a new deadline.  Must be called with m_listMutex held.
+ */
+void MotorSafetyHelper::Schedule(int64_t deadline) {
+  m_deadlines.erase(Deadline(m_deadline, this));
+  m_deadline = deadline;
+  m_deadlines.insert(Deadline(m_deadline, this));
+}
+
+/**
+ * @return A monotonic timestamp in microseconds.  This is much cheaper to read
+ * than the FPGA timestamp.
+ */
+int64_t MotorSafetyHelper::GetTime() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
 }
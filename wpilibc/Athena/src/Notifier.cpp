@@ -31,7 +31,7 @@ Notifier::Notifier(TimerEventHandler handler, void *param) {
     // do the first time intialization of static variables
     if (refcount == 0) {
       int32_t status = 0;
-      m_notifier = initializeNotifier(ProcessQueue, &status);
+      m_notifier = initializeNotifier(ProcessQueue, nullptr, &status);
       wpi_setErrorWithContext(status, getHALErrorMessage(status));
     }
     refcount++;
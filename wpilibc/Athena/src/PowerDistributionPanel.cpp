@@ -153,24 +153,25 @@ void PowerDistributionPanel::ClearStickyFaults() {
 
 void PowerDistributionPanel::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Chan0", GetCurrent(0));
-    m_table->PutNumber("Chan1", GetCurrent(1));
-    m_table->PutNumber("Chan2", GetCurrent(2));
-    m_table->PutNumber("Chan3", GetCurrent(3));
-    m_table->PutNumber("Chan4", GetCurrent(4));
-    m_table->PutNumber("Chan5", GetCurrent(5));
-    m_table->PutNumber("Chan6", GetCurrent(6));
-    m_table->PutNumber("Chan7", GetCurrent(7));
-    m_table->PutNumber("Chan8", GetCurrent(8));
-    m_table->PutNumber("Chan9", GetCurrent(9));
-    m_table->PutNumber("Chan10", GetCurrent(10));
-    m_table->PutNumber("Chan11", GetCurrent(11));
-    m_table->PutNumber("Chan12", GetCurrent(12));
-    m_table->PutNumber("Chan13", GetCurrent(13));
-    m_table->PutNumber("Chan14", GetCurrent(14));
-    m_table->PutNumber("Chan15", GetCurrent(15));
-    m_table->PutNumber("Voltage", GetVoltage());
-    m_table->PutNumber("TotalCurrent", GetTotalCurrent());
+    LiveWindow *liveWindow = LiveWindow::GetInstance();
+    liveWindow->PublishNumber(m_table, "Chan0", GetCurrent(0));
+    liveWindow->PublishNumber(m_table, "Chan1", GetCurrent(1));
+    liveWindow->PublishNumber(m_table, "Chan2", GetCurrent(2));
+    liveWindow->PublishNumber(m_table, "Chan3", GetCurrent(3));
+    liveWindow->PublishNumber(m_table, "Chan4", GetCurrent(4));
+    liveWindow->PublishNumber(m_table, "Chan5", GetCurrent(5));
+    liveWindow->PublishNumber(m_table, "Chan6", GetCurrent(6));
+    liveWindow->PublishNumber(m_table, "Chan7", GetCurrent(7));
+    liveWindow->PublishNumber(m_table, "Chan8", GetCurrent(8));
+    liveWindow->PublishNumber(m_table, "Chan9", GetCurrent(9));
+    liveWindow->PublishNumber(m_table, "Chan10", GetCurrent(10));
+    liveWindow->PublishNumber(m_table, "Chan11", GetCurrent(11));
+    liveWindow->PublishNumber(m_table, "Chan12", GetCurrent(12));
+    liveWindow->PublishNumber(m_table, "Chan13", GetCurrent(13));
+    liveWindow->PublishNumber(m_table, "Chan14", GetCurrent(14));
+    liveWindow->PublishNumber(m_table, "Chan15", GetCurrent(15));
+    liveWindow->PublishNumber(m_table, "Voltage", GetVoltage());
+    liveWindow->PublishNumber(m_table, "TotalCurrent", GetTotalCurrent());
   }
 }
 
@@ -16,6 +16,9 @@
 #include "WPIErrors.h"
 #include "LiveWindow/LiveWindow.h"
 
+#include <algorithm>
+#include <vector>
+
 constexpr double
     Ultrasonic::kPingTime;  ///< Time (sec) for the ping trigger pulse.
 const uint32_t Ultrasonic::kPriority;  ///< Priority that the ultrasonic round
@@ -28,11 +31,15 @@ Ultrasonic *Ultrasonic::m_firstSensor =
 Task Ultrasonic::m_task;
 std::atomic<bool> Ultrasonic::m_automaticEnabled{false}; // automatic round robin mode
 priority_mutex Ultrasonic::m_mutex;
+std::atomic<double> Ultrasonic::m_pingPeriod{kMaxUltrasonicTime};
+const int Ultrasonic::kHistorySize;
 
 /**
- * Background task that goes through the list of ultrasonic sensors and pings
- * each one in turn. The counter
- * is configured to read the timing of the returned echo pulse.
+ * Background task that goes through the ping groups of the ultrasonic sensors
+ * in increasing order and pings all of the sensors in a group at once. The
+ * counters are configured to read the timing of the returned echo pulses,
+ * which are collected into the range history of each sensor before the next
+ * group is pinged.
  *
  * DANGER WILL ROBINSON, DANGER WILL ROBINSON:
  * This code runs as a task and assumes that none of the ultrasonic sensors will
@@ -42,14 +49,88 @@ priority_mutex Ultrasonic::m_mutex;
  * anything with the sensors!!
  */
 void Ultrasonic::UltrasonicChecker() {
-  Ultrasonic *u = nullptr;
+  int64_t lastGroup = -1;
+  std::vector<std::shared_ptr<DigitalOutput>> pingChannels;
   while (m_automaticEnabled) {
-    if (u == nullptr) u = m_firstSensor;
-    if (u == nullptr) return;
-    if (u->IsEnabled()) u->m_pingChannel->Pulse(kPingTime);  // do the ping
-    u = u->m_nextSensor;
-    Wait(0.1);  // wait for ping to return
+    double pingTime;
+    uint32_t group;
+    pingChannels.clear();
+    {
+      std::lock_guard<priority_mutex> lock(m_mutex);
+      if (m_firstSensor == nullptr) return;
+
+      // Find the next group after the one pinged last, wrapping around to the
+      // lowest one
+      int64_t lowest = -1, next = -1;
+      for (Ultrasonic *u = m_firstSensor; u != nullptr; u = u->m_nextSensor) {
+        if (!u->IsEnabled()) continue;
+        int64_t g = u->m_pingGroup;
+        if (lowest < 0 || g < lowest) lowest = g;
+        if (g > lastGroup && (next < 0 || g < next)) next = g;
+      }
+      if (next < 0) next = lowest;
+      lastGroup = next;
+
+      group = next;
+      for (Ultrasonic *u = m_firstSensor; u != nullptr && next >= 0;
+           u = u->m_nextSensor) {
+        if (!u->IsEnabled() || u->m_pingGroup != group) continue;
+        u->m_lastEchoCount = u->m_counter.Get();
+        pingChannels.push_back(u->m_pingChannel);
+      }
+    }
+
+    // Ping without the lock, so the sensors can be read meanwhile
+    pingTime = Timer::GetFPGATimestamp();
+    for (auto &pingChannel : pingChannels) pingChannel->Pulse(kPingTime);
+
+    Wait(m_pingPeriod);  // wait for the pings to return
+
+    if (lastGroup < 0) continue;
+    std::lock_guard<priority_mutex> lock(m_mutex);
+    for (Ultrasonic *u = m_firstSensor; u != nullptr; u = u->m_nextSensor) {
+      if (u->IsEnabled() && u->m_pingGroup == group) u->UpdateRange(pingTime);
+    }
+  }
+}
+
+/**
+ * Read the echo of the last ping from the counter and add it to the range
+ * history.
+ * The counter runs in semi-period mode, so its period is the length of the
+ * echo pulse, which starts right after the ping.
+ * @param pingTime The FPGA time at which the ping was sent
+ */
+void Ultrasonic::UpdateRange(double pingTime) {
+  int32_t count = m_counter.Get();
+  if (count == m_lastEchoCount) return;  // no echo came back
+
+  double period = m_counter.GetPeriod();
+  double range = period * kSpeedOfSoundInchesPerSec / 2.0;
+
+  // Median of the last three echoes, to drop single missed or crossed echoes
+  m_rawRanges[m_rawCount++ % 3] = range;
+  if (m_rawCount >= 3) {
+    double a = m_rawRanges[0], b = m_rawRanges[1], c = m_rawRanges[2];
+    range = std::max(std::min(a, b), std::min(std::max(a, b), c));
   }
+  AddSample(pingTime + period, range);
+}
+
+/**
+ * Append a sample to the range history.
+ * There is a single writer, the automatic mode task; readers check the sample
+ * count before and after copying to detect entries overwritten meanwhile.
+ */
+void Ultrasonic::AddSample(double timestamp, double rangeInches) {
+  uint32_t count = m_sampleCount.load(std::memory_order_relaxed);
+  uint32_t index = count % kHistorySize;
+  // Make the entry's new contents visible only after readers can see that the
+  // old sample is gone (see GetRangeHistory())
+  std::atomic_thread_fence(std::memory_order_release);
+  m_sampleTimestamps[index].store(timestamp, std::memory_order_relaxed);
+  m_sampleRanges[index].store(rangeInches, std::memory_order_relaxed);
+  m_sampleCount.store(count + 1, std::memory_order_release);
 }
 
 /**
@@ -76,10 +157,16 @@ void Ultrasonic::Initialize() {
   m_counter.SetSemiPeriodMode(true);
   m_counter.Reset();
   m_enabled = true;  // make it available for round robin scheduling
-  SetAutomaticMode(originalMode);
+  for (int i = 0; i < kHistorySize; i++) {
+    m_sampleTimestamps[i] = 0.0;
+    m_sampleRanges[i] = 0.0;
+  }
 
   static int instances = 0;
   instances++;
+  m_pingGroup = instances;  // a group of its own, i.e. plain round robin
+  SetAutomaticMode(originalMode);
+
   HALReport(HALUsageReporting::kResourceType_Ultrasonic, instances);
   LiveWindow::GetInstance()->AddSensor("Ultrasonic",
                                        m_echoChannel->GetChannel(), this);
@@ -225,9 +312,12 @@ void Ultrasonic::SetAutomaticMode(bool enabling) {
   m_automaticEnabled = enabling;
   if (enabling) {
     // enabling automatic mode.
-    // Clear all the counters so no data is valid
+    // Clear all the counters and histories so no data is valid
     for (Ultrasonic *u = m_firstSensor; u != nullptr; u = u->m_nextSensor) {
       u->m_counter.Reset();
+      u->m_lastEchoCount = 0;
+      u->m_rawCount = 0;
+      u->m_sampleCount = 0;
     }
     // Start round robin task
     wpi_assert(m_task.Verify() ==
@@ -239,20 +329,82 @@ void Ultrasonic::SetAutomaticMode(bool enabling) {
     // Ultrasonic::SetAutomicMode().
     //m_task.SetPriority(kPriority);
   } else {
-    // disabling automatic mode. Wait for background task to stop running.
-    while (m_task.Verify())
-      Wait(0.15);  // just a little longer than the ping time for round-robin to
-                   // stop
+    // disabling automatic mode. Wait for background task to stop running; it
+    // checks m_automaticEnabled after every ping group.
+    m_task.join();
 
     // clear all the counters (data now invalid) since automatic mode is stopped
     for (Ultrasonic *u = m_firstSensor; u != nullptr; u = u->m_nextSensor) {
       u->m_counter.Reset();
     }
-    m_automaticEnabled = false;
-    m_task.join();
   }
 }
 
+/**
+ * Set the time between pinging two groups in automatic mode.
+ * This must be long enough for the echo of the farthest target to return,
+ * which is a little under 40ms for the SRF04's 3m range.
+ * @param seconds The time to wait for the echoes of a group, greater than 0
+ */
+void Ultrasonic::SetPingPeriod(double seconds) {
+  if (seconds <= 0.0) {
+    wpi_setGlobalWPIErrorWithContext(ParameterOutOfRange,
+                                     "ping period must be positive");
+    return;
+  }
+  m_pingPeriod = seconds;
+}
+
+double Ultrasonic::GetPingPeriod() { return m_pingPeriod; }
+
+/**
+ * Put the sensor into a ping group.
+ * In automatic mode all enabled sensors with the same group number are pinged
+ * at the same time, and the groups take turns in increasing order. Sensors
+ * sharing a group must not be able to hear each other.
+ * @param group The ping group of the sensor
+ */
+void Ultrasonic::SetPingGroup(uint32_t group) { m_pingGroup = group; }
+
+/**
+ * Get the most recent samples of the range history.
+ * The history is filled in automatic mode and can be read from any thread
+ * without blocking the automatic mode task.
+ * @param samples Array that receives the samples, newest first
+ * @param count The size of the array
+ * @return The number of samples stored into the array
+ */
+int Ultrasonic::GetRangeHistory(RangeSample *samples, int count) const {
+  uint32_t head = m_sampleCount.load(std::memory_order_acquire);
+  if (count > kHistorySize) count = kHistorySize;
+  if (count > static_cast<int>(head)) count = head;
+
+  for (int i = 0; i < count; i++) {
+    uint32_t index = (head - 1 - i) % kHistorySize;
+    samples[i].timestamp =
+        m_sampleTimestamps[index].load(std::memory_order_relaxed);
+    samples[i].rangeInches =
+        m_sampleRanges[index].load(std::memory_order_relaxed);
+  }
+
+  // Drop the samples whose entries the writer started overwriting while they
+  // were being copied
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint32_t tail = m_sampleCount.load(std::memory_order_relaxed);
+  while (count > 0 && tail - (head - count) >= kHistorySize) count--;
+  return count;
+}
+
+/**
+ * Get the time of the range returned by GetRangeInches() in automatic mode.
+ * @return The FPGA time at which the echo ended, or 0 if there is none
+ */
+double Ultrasonic::GetRangeTimestamp() const {
+  RangeSample sample;
+  if (GetRangeHistory(&sample, 1) == 0) return 0.0;
+  return sample.timestamp;
+}
+
 /**
  * Single ping to ultrasonic sensor.
  * Send out a single ping to the ultrasonic sensor. This only works if automatic
@@ -275,16 +427,25 @@ void Ultrasonic::Ping() {
  * signal. If the count is not at least 2, then the range has not yet been
  * measured, and is invalid.
  */
-bool Ultrasonic::IsRangeValid() const { return m_counter.Get() > 1; }
+bool Ultrasonic::IsRangeValid() const {
+  if (m_automaticEnabled) return m_sampleCount > 0;
+  return m_counter.Get() > 1;
+}
 
 /**
  * Get the range in inches from the ultrasonic sensor.
  * @return double Range in inches of the target returned from the ultrasonic
  * sensor. If there is
  * no valid value yet, i.e. at least one measurement hasn't completed, then
- * return 0.
+ * return 0. In automatic mode this is the newest filtered sample of the range
+ * history.
  */
 double Ultrasonic::GetRangeInches() const {
+  if (m_automaticEnabled) {
+    RangeSample sample;
+    if (GetRangeHistory(&sample, 1) == 0) return 0;
+    return sample.rangeInches;
+  }
   if (IsRangeValid())
     return m_counter.GetPeriod() * kSpeedOfSoundInchesPerSec / 2.0;
   else
@@ -341,7 +502,8 @@ Ultrasonic::DistanceUnit Ultrasonic::GetDistanceUnits() const {
 
 void Ultrasonic::UpdateTable() {
   if (m_table != nullptr) {
-    m_table->PutNumber("Value", GetRangeInches());
+    LiveWindow::GetInstance()->PublishNumber(m_table, "Value",
+                                             GetRangeInches());
   }
 }
 
@@ -0,0 +1,205 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "V4L2Camera.h"
+
+#include "WPIErrors.h"
+
+#include <cstring>
+#include <mutex>
+
+#include <linux/videodev2.h>
+
+static inline uint8_t Clamp(int value) {
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+/**
+ * @param device The path of the video device, such as /dev/video0, or of a
+ * file of frames to play back
+ * @param useJpeg Whether to start out capturing JPEG frames or YUYV frames
+ */
+V4L2Camera::V4L2Camera(std::string device, bool useJpeg)
+    : USBCamera(device, useJpeg), m_capture(device) {}
+
+/**
+ * The settings of this camera, for the capture.
+ * Must be called with m_mutex held.
+ */
+V4L2Capture::Settings V4L2Camera::GetSettings() const {
+  V4L2Capture::Settings settings;
+  settings.jpeg = m_useJpeg;
+  settings.width = m_width;
+  settings.height = m_height;
+  settings.fps = m_fps;
+  settings.autoWhiteBalance = m_whiteBalance.compare(AUTO) == 0;
+  settings.whiteBalance =
+      m_whiteBalanceValuePresent ? static_cast<int>(m_whiteBalanceValue) : -1;
+  settings.autoExposure = m_exposure.compare(AUTO) == 0;
+  settings.exposure =
+      m_exposureValuePresent ? static_cast<int>(m_exposureValue) : -1;
+  settings.brightness = m_brightness;
+  return settings;
+}
+
+/**
+ * Report an error of the capture as an error of this camera.
+ */
+void V4L2Camera::TakeCaptureError() {
+  if (m_capture.GetError().GetCode() == 0) return;
+  CloneError(m_capture);
+  m_capture.ClearError();
+}
+
+void V4L2Camera::OpenCamera() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  if (m_capture.IsOpen()) return;
+  m_capture.ApplySettings(GetSettings());
+  m_needSettingsUpdate = false;
+  m_capture.Open();
+  m_open = m_capture.IsOpen();
+  TakeCaptureError();
+}
+
+void V4L2Camera::CloseCamera() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_capture.Close();
+  m_open = false;
+  m_active = false;
+  TakeCaptureError();
+}
+
+void V4L2Camera::StartCapture() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_capture.Start();
+  m_active = m_capture.IsActive();
+  TakeCaptureError();
+}
+
+void V4L2Camera::StopCapture() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_capture.Stop();
+  m_open = m_capture.IsOpen();
+  m_active = false;
+  TakeCaptureError();
+}
+
+void V4L2Camera::UpdateSettings() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_needSettingsUpdate = false;
+  m_capture.ApplySettings(GetSettings());
+  m_capture.Open();
+  m_open = m_capture.IsOpen();
+  m_active = m_capture.IsActive();
+  TakeCaptureError();
+}
+
+/**
+ * Borrow the next frame the camera captures.
+ *
+ * The frame is the camera's own buffer, which is not reused until the frame
+ * is given back with ReleaseFrame(). Frames should be released promptly,
+ * since the camera drops frames once all of its buffers are lent out.
+ *
+ * @param frame Set to the frame
+ * @param jpeg Whether to capture MJPEG frames rather than YUYV frames. A fake
+ * device always plays back the frames in its file.
+ * @param timeout Time to wait for the frame, in seconds
+ * @return Whether a frame was captured
+ */
+bool V4L2Camera::AcquireFrame(Frame &frame, bool jpeg, double timeout) {
+  {
+    std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+    if (m_needSettingsUpdate ||
+        (!m_capture.IsFakeDevice() && m_useJpeg != jpeg)) {
+      m_useJpeg = jpeg;
+      UpdateSettings();
+    }
+  }
+  // Waiting for the frame only takes the capture's lock, which it releases
+  // while it waits, so the settings can be changed in the meantime
+  bool acquired = m_capture.AcquireFrame(frame, timeout);
+  TakeCaptureError();
+  return acquired;
+}
+
+/**
+ * Give back a frame borrowed with AcquireFrame(), so the camera can capture
+ * into it again.
+ */
+void V4L2Camera::ReleaseFrame(const Frame &frame) {
+  ReleaseImageData(frame.data);
+}
+
+void V4L2Camera::ReleaseImageData(const uint8_t *data) {
+  m_capture.ReleaseFrame(data);
+  TakeCaptureError();
+}
+
+/**
+ * Borrow the next MJPEG frame, exactly as the camera compressed it.
+ */
+const uint8_t *V4L2Camera::AcquireImageData(unsigned int &size) {
+  Frame frame;
+  if (!AcquireFrame(frame, true)) return nullptr;
+  if (frame.pixelFormat != V4L2_PIX_FMT_MJPEG) {
+    wpi_setWPIErrorWithContext(IncompatibleMode, "Frames are not JPEG");
+    ReleaseFrame(frame);
+    return nullptr;
+  }
+  size = frame.size;
+  return frame.data;
+}
+
+unsigned int V4L2Camera::GetImageData(void *buffer, unsigned int bufferSize) {
+  unsigned int size = 0;
+  const uint8_t *data = AcquireImageData(size);
+  if (data == nullptr) return 0;
+  if (size > bufferSize) {
+    wpi_setWPIErrorWithContext(ParameterOutOfRange,
+                               "Image is larger than the buffer");
+    size = 0;
+  } else {
+    std::memcpy(buffer, data, size);
+  }
+  ReleaseImageData(data);
+  return size;
+}
+
+void V4L2Camera::GetImage(Image *image) {
+  Frame frame;
+  if (!AcquireFrame(frame, false)) return;
+
+  if (frame.pixelFormat == V4L2_PIX_FMT_MJPEG) {
+    Priv_ReadJPEGString_C(image, frame.data, frame.size);
+    ReleaseFrame(frame);
+    return;
+  }
+
+  // Convert each pair of YUYV pixels to RGB with the integer BT.601
+  // coefficients
+  std::lock_guard<priority_mutex> lock(m_rgbMutex);
+  m_rgb.resize(frame.width * frame.height);
+  const uint8_t *yuyv = frame.data;
+  RGBValue *rgb = m_rgb.data();
+  for (unsigned int i = 0; i < frame.width * frame.height / 2; i++) {
+    int u = yuyv[1] - 128, v = yuyv[3] - 128;
+    for (int j = 0; j < 2; j++) {
+      int c = 298 * (yuyv[j * 2] - 16) + 128;
+      rgb->R = Clamp((c + 409 * v) >> 8);
+      rgb->G = Clamp((c - 100 * u - 208 * v) >> 8);
+      rgb->B = Clamp((c + 516 * u) >> 8);
+      rgb->alpha = 0;
+      rgb++;
+    }
+    yuyv += 4;
+  }
+  ReleaseFrame(frame);
+
+  if (!imaqArrayToImage(image, m_rgb.data(), frame.width, frame.height))
+    wpi_setImaqErrorWithContext(imaqGetLastError(), "imaqArrayToImage");
+}
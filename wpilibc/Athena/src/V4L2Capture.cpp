@@ -0,0 +1,550 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "V4L2Capture.h"
+
+#include "WPIErrors.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * ioctl() that is retried if interrupted by a signal.
+ */
+static int xioctl(int fd, unsigned long request, void *arg) {
+  int result;
+  do {
+    result = ioctl(fd, request, arg);
+  } while (result == -1 && errno == EINTR);
+  return result;
+}
+
+/**
+ * @param device The path of the video device, such as /dev/video0, or of a
+ * file of frames to play back
+ */
+V4L2Capture::V4L2Capture(std::string device) : m_device(device) {}
+
+V4L2Capture::~V4L2Capture() {
+  Close();
+  // Nobody can give back the frames that are still lent out anymore
+  for (auto &buffer : m_orphans) munmap(buffer.start, buffer.length);
+}
+
+void V4L2Capture::Open() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  if (m_open) return;
+
+  struct stat info;
+  if (stat(m_device.c_str(), &info) == -1) {
+    wpi_setErrnoErrorWithContext(m_device.c_str());
+    return;
+  }
+  m_fake = S_ISREG(info.st_mode);
+  m_open = m_fake ? OpenFakeDevice() : OpenDevice();
+  if (m_open && !m_fake) ConfigureDevice();
+}
+
+bool V4L2Capture::OpenDevice() {
+  m_fd = open(m_device.c_str(), O_RDWR | O_NONBLOCK);
+  if (m_fd == -1) {
+    wpi_setErrnoErrorWithContext(m_device.c_str());
+    return false;
+  }
+
+  v4l2_capability capability;
+  std::memset(&capability, 0, sizeof(capability));
+  if (xioctl(m_fd, VIDIOC_QUERYCAP, &capability) == -1) {
+    wpi_setErrnoErrorWithContext("VIDIOC_QUERYCAP");
+  } else if (!(capability.capabilities & V4L2_CAP_VIDEO_CAPTURE) ||
+             !(capability.capabilities & V4L2_CAP_STREAMING)) {
+    wpi_setWPIErrorWithContext(IncompatibleMode,
+                               "Device can't stream video capture");
+  } else {
+    return true;
+  }
+  close(m_fd);
+  m_fd = -1;
+  return false;
+}
+
+/**
+ * Map a file of frames, and find where each frame is in it.
+ */
+bool V4L2Capture::OpenFakeDevice() {
+  m_fd = open(m_device.c_str(), O_RDONLY);
+  if (m_fd == -1) {
+    wpi_setErrnoErrorWithContext(m_device.c_str());
+    return false;
+  }
+
+  struct stat info;
+  fstat(m_fd, &info);
+  size_t length = info.st_size;
+  void *start = length > 0 ? mmap(nullptr, length, PROT_READ, MAP_SHARED,
+                                  m_fd, 0)
+                           : MAP_FAILED;
+  if (start == MAP_FAILED) {
+    wpi_setErrnoErrorWithContext("Mapping the frame file");
+    close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+  m_buffers.push_back({static_cast<uint8_t *>(start), length, -1, 0});
+
+  uint8_t *data = m_buffers[0].start;
+  m_fakeFrames.clear();
+  m_nextFakeFrame = 0;
+  m_fakeJpeg = length >= 2 && data[0] == 0xff && data[1] == 0xd8;
+  if (m_fakeJpeg) {
+    m_frameWidth = m_frameHeight = 0;
+    for (size_t offset = 0; offset < length;) {
+      unsigned int size = GetJpegSize(data + offset, length - offset);
+      if (size == 0) break;
+      m_fakeFrames.emplace_back(offset, size);
+      offset += size;
+    }
+  } else {
+    m_frameWidth = m_settings.width;
+    m_frameHeight = m_settings.height;
+    size_t size = m_settings.width * m_settings.height * 2;
+    for (size_t offset = 0; size > 0 && offset + size <= length;
+         offset += size) {
+      m_fakeFrames.emplace_back(offset, size);
+    }
+  }
+
+  if (m_fakeFrames.empty()) {
+    wpi_setWPIErrorWithContext(IncompatibleMode,
+                               "File holds no JPEG or YUYV frames");
+    UnmapBuffers();
+    close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+  m_pixelFormat = m_fakeJpeg ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV;
+  return true;
+}
+
+/**
+ * Set the format, frame rate and controls of a video device from the
+ * settings.
+ */
+void V4L2Capture::ConfigureDevice() {
+  v4l2_format format;
+  std::memset(&format, 0, sizeof(format));
+  format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  format.fmt.pix.width = m_settings.width;
+  format.fmt.pix.height = m_settings.height;
+  format.fmt.pix.pixelformat =
+      m_settings.jpeg ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV;
+  format.fmt.pix.field = V4L2_FIELD_ANY;
+  if (xioctl(m_fd, VIDIOC_S_FMT, &format) == -1) {
+    wpi_setErrnoErrorWithContext("VIDIOC_S_FMT");
+  }
+  // The driver picks the closest size it has
+  m_pixelFormat = format.fmt.pix.pixelformat;
+  m_frameWidth = format.fmt.pix.width;
+  m_frameHeight = format.fmt.pix.height;
+  if (m_pixelFormat !=
+      (m_settings.jpeg ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV)) {
+    wpi_setWPIErrorWithContext(IncompatibleMode,
+                               m_settings.jpeg
+                                   ? "Camera doesn't support MJPEG"
+                                   : "Camera doesn't support YUYV");
+  }
+
+  if (m_settings.fps > 0) {
+    v4l2_streamparm parm;
+    std::memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1000;
+    parm.parm.capture.timeperframe.denominator = m_settings.fps * 1000;
+    // Not every camera can set its frame rate
+    xioctl(m_fd, VIDIOC_S_PARM, &parm);
+  }
+
+  if (m_settings.autoWhiteBalance) {
+    SetControl(V4L2_CID_AUTO_WHITE_BALANCE, 1);
+  } else {
+    SetControl(V4L2_CID_AUTO_WHITE_BALANCE, 0);
+    if (m_settings.whiteBalance >= 0)
+      SetControl(V4L2_CID_WHITE_BALANCE_TEMPERATURE, m_settings.whiteBalance);
+  }
+
+  if (m_settings.autoExposure) {
+    SetControl(V4L2_CID_EXPOSURE_AUTO, V4L2_EXPOSURE_APERTURE_PRIORITY);
+  } else {
+    SetControl(V4L2_CID_EXPOSURE_AUTO, V4L2_EXPOSURE_MANUAL);
+    if (m_settings.exposure >= 0)
+      SetControlPercent(V4L2_CID_EXPOSURE_ABSOLUTE, m_settings.exposure);
+  }
+
+  SetControlPercent(V4L2_CID_BRIGHTNESS, m_settings.brightness);
+}
+
+void V4L2Capture::Close() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  if (m_active) Stop();
+  // A fake device keeps its file mapped while it is open
+  UnmapBuffers();
+  if (m_fd != -1) close(m_fd);
+  m_fd = -1;
+  m_open = false;
+}
+
+/**
+ * Unmap all the buffers, except those still lent out, which are unmapped when
+ * they are released.
+ */
+void V4L2Capture::UnmapBuffers() {
+  for (auto &buffer : m_buffers) {
+    if (buffer.borrowed > 0)
+      m_orphans.push_back(buffer);
+    else
+      munmap(buffer.start, buffer.length);
+  }
+  m_buffers.clear();
+}
+
+void V4L2Capture::Start() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  if (!m_open || m_active) return;
+
+  if (m_fake) {
+    m_nextFakeFrameTime = std::chrono::steady_clock::now();
+    m_active = true;
+    return;
+  }
+
+  v4l2_requestbuffers request;
+  std::memset(&request, 0, sizeof(request));
+  request.count = kNumBuffers;
+  request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  request.memory = V4L2_MEMORY_MMAP;
+  if (xioctl(m_fd, VIDIOC_REQBUFS, &request) == -1) {
+    wpi_setErrnoErrorWithContext("VIDIOC_REQBUFS");
+    return;
+  }
+
+  for (unsigned int i = 0; i < request.count; i++) {
+    v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = i;
+    if (xioctl(m_fd, VIDIOC_QUERYBUF, &buf) == -1) {
+      wpi_setErrnoErrorWithContext("VIDIOC_QUERYBUF");
+      UnmapBuffers();
+      return;
+    }
+    void *start = mmap(nullptr, buf.length, PROT_READ, MAP_SHARED, m_fd,
+                       buf.m.offset);
+    if (start == MAP_FAILED) {
+      wpi_setErrnoErrorWithContext("Mapping a capture buffer");
+      UnmapBuffers();
+      return;
+    }
+    m_buffers.push_back(
+        {static_cast<uint8_t *>(start), buf.length, static_cast<int>(i), 0});
+    if (xioctl(m_fd, VIDIOC_QBUF, &buf) == -1) {
+      wpi_setErrnoErrorWithContext("VIDIOC_QBUF");
+      UnmapBuffers();
+      return;
+    }
+  }
+
+  int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (xioctl(m_fd, VIDIOC_STREAMON, &type) == -1) {
+    wpi_setErrnoErrorWithContext("VIDIOC_STREAMON");
+    UnmapBuffers();
+    return;
+  }
+  m_active = true;
+}
+
+void V4L2Capture::Stop() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  if (!m_open || !m_active) return;
+  m_active = false;
+  m_captureGeneration++;
+  if (m_fake) return;
+
+  int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (xioctl(m_fd, VIDIOC_STREAMOFF, &type) == -1)
+    wpi_setErrnoErrorWithContext("VIDIOC_STREAMOFF");
+  UnmapBuffers();
+
+  if (m_orphans.empty()) {
+    v4l2_requestbuffers request;
+    std::memset(&request, 0, sizeof(request));
+    request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    request.memory = V4L2_MEMORY_MMAP;
+    xioctl(m_fd, VIDIOC_REQBUFS, &request);
+  } else {
+    // The driver won't allocate new buffers while frames that are lent out
+    // still map the old ones, so start over with a new file descriptor,
+    // configured like the first one.
+    close(m_fd);
+    m_open = OpenDevice();
+    if (m_open) ConfigureDevice();
+  }
+}
+
+/**
+ * Change the settings. An open device is reopened to apply them, and keeps
+ * capturing if it was.
+ */
+void V4L2Capture::ApplySettings(const Settings &settings) {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_settings = settings;
+  if (!m_open) return;
+
+  bool wasActive = m_active;
+  Close();
+  Open();
+  if (wasActive) Start();
+}
+
+bool V4L2Capture::IsOpen() const {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  return m_open;
+}
+
+bool V4L2Capture::IsActive() const {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  return m_active;
+}
+
+bool V4L2Capture::IsFakeDevice() const {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  return m_fake;
+}
+
+/**
+ * Set a control of the camera, if the camera has it.
+ */
+void V4L2Capture::SetControl(uint32_t id, int value) {
+  v4l2_queryctrl query;
+  std::memset(&query, 0, sizeof(query));
+  query.id = id;
+  if (xioctl(m_fd, VIDIOC_QUERYCTRL, &query) == -1 ||
+      (query.flags & V4L2_CTRL_FLAG_DISABLED))
+    return;
+
+  v4l2_control control;
+  control.id = id;
+  control.value = value;
+  if (xioctl(m_fd, VIDIOC_S_CTRL, &control) == -1)
+    wpi_setErrnoErrorWithContext(reinterpret_cast<char *>(query.name));
+}
+
+/**
+ * Set a control of the camera to a percentage of its range, if the camera
+ * has it.
+ */
+void V4L2Capture::SetControlPercent(uint32_t id, unsigned int percent) {
+  v4l2_queryctrl query;
+  std::memset(&query, 0, sizeof(query));
+  query.id = id;
+  if (xioctl(m_fd, VIDIOC_QUERYCTRL, &query) == -1) return;
+  SetControl(id, query.minimum +
+                     (query.maximum - query.minimum) * (int)percent / 100);
+}
+
+/**
+ * Borrow the next frame the camera captures.
+ *
+ * The frame is the camera's own buffer, which is not reused until the frame
+ * is given back with ReleaseFrame(). Frames should be released promptly,
+ * since the camera drops frames once all of its buffers are lent out. Frames
+ * the driver marks as corrupted are skipped.
+ *
+ * The lock is released while waiting for the frame, so other threads can
+ * release frames and change the settings in the meantime.
+ *
+ * @param frame Set to the frame
+ * @param timeout Time to wait for the frame, in seconds
+ * @return Whether a frame was captured
+ */
+bool V4L2Capture::AcquireFrame(Frame &frame, double timeout) {
+  std::unique_lock<priority_recursive_mutex> lock(m_mutex);
+  if (!m_active) {
+    wpi_setWPIErrorWithContext(IncompatibleState, "Camera is not capturing");
+    return false;
+  }
+  if (m_fake) return NextFakeFrame(frame, lock);
+
+  unsigned int generation = m_captureGeneration;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::duration<double>(timeout);
+  while (true) {
+    v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_DQBUF, &buf) == 0) {
+      if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+        // A corrupted frame, which goes straight back to the driver
+        if (xioctl(m_fd, VIDIOC_QBUF, &buf) == -1) {
+          wpi_setErrnoErrorWithContext("VIDIOC_QBUF");
+          return false;
+        }
+        continue;
+      }
+      Buffer &buffer = m_buffers[buf.index];
+      buffer.borrowed = 1;
+      frame.data = buffer.start;
+      // Only the bytes the driver filled in are part of the frame, however
+      // large the buffer is
+      frame.size = std::min<size_t>(buf.bytesused, buffer.length);
+      frame.pixelFormat = m_pixelFormat;
+      frame.width = m_frameWidth;
+      frame.height = m_frameHeight;
+      return true;
+    }
+    if (errno != EAGAIN) {
+      wpi_setErrnoErrorWithContext("VIDIOC_DQBUF");
+      return false;
+    }
+
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0) {
+      wpi_setWPIErrorWithContext(Timeout, "Waiting for a camera frame");
+      return false;
+    }
+
+    pollfd fds = {m_fd, POLLIN, 0};
+    lock.unlock();
+    poll(&fds, 1, remaining.count());
+    lock.lock();
+    if (!m_active || m_captureGeneration != generation) return false;
+  }
+}
+
+/**
+ * Play back the next frame of a fake device, waiting until it is due. The
+ * frame is borrowed before the lock is released for the wait, so the file
+ * stays mapped even if the device is closed in the meantime.
+ */
+bool V4L2Capture::NextFakeFrame(
+    Frame &frame, std::unique_lock<priority_recursive_mutex> &lock) {
+  Buffer &buffer = m_buffers[0];
+  auto &fakeFrame = m_fakeFrames[m_nextFakeFrame];
+  m_nextFakeFrame = (m_nextFakeFrame + 1) % m_fakeFrames.size();
+  buffer.borrowed++;
+  frame.data = buffer.start + fakeFrame.first;
+  frame.size = fakeFrame.second;
+  frame.pixelFormat = m_pixelFormat;
+  frame.width = m_frameWidth;
+  frame.height = m_frameHeight;
+
+  if (m_settings.fps > 0) {
+    auto due = m_nextFakeFrameTime;
+    m_nextFakeFrameTime += std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / m_settings.fps));
+    lock.unlock();
+    std::this_thread::sleep_until(due);
+  }
+  return true;
+}
+
+/**
+ * Give back a frame borrowed with AcquireFrame(), so the camera can capture
+ * into it again.
+ *
+ * @param data The data of the frame
+ */
+void V4L2Capture::ReleaseFrame(const uint8_t *data) {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  auto contains = [data](const Buffer &buffer) {
+    return data >= buffer.start && data < buffer.start + buffer.length;
+  };
+
+  auto orphan = std::find_if(m_orphans.begin(), m_orphans.end(), contains);
+  if (orphan != m_orphans.end()) {
+    if (--orphan->borrowed == 0) {
+      munmap(orphan->start, orphan->length);
+      m_orphans.erase(orphan);
+    }
+    return;
+  }
+
+  auto buffer = std::find_if(m_buffers.begin(), m_buffers.end(), contains);
+  if (buffer == m_buffers.end() || buffer->borrowed == 0) {
+    wpi_setWPIErrorWithContext(NotAllocated, "Frame is not from this camera");
+    return;
+  }
+  buffer->borrowed--;
+  if (m_fake) return;
+
+  v4l2_buffer buf;
+  std::memset(&buf, 0, sizeof(buf));
+  buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  buf.memory = V4L2_MEMORY_MMAP;
+  buf.index = buffer->index;
+  if (xioctl(m_fd, VIDIOC_QBUF, &buf) == -1)
+    wpi_setErrnoErrorWithContext("VIDIOC_QBUF");
+}
+
+/**
+ * Find the size of the JPEG image at the start of a buffer, without reading
+ * past the end of the buffer.
+ *
+ * @param data The buffer
+ * @param size The number of bytes of the buffer that hold data
+ * @return The size of the image up to and including its end of image marker,
+ * or 0 if the buffer doesn't start with a whole JPEG image
+ */
+unsigned int V4L2Capture::GetJpegSize(const uint8_t *data, size_t size) {
+  if (size < 2 || data[0] != 0xff || data[1] != 0xd8) return 0;
+  size_t pos = 2;
+  while (pos + 2 <= size) {
+    // Every marker starts with 0xff
+    if (data[pos] != 0xff) return 0;
+    uint8_t marker = data[pos + 1];
+    if (marker == 0xd9) {
+      // End of image
+      return pos + 2;
+    } else if (marker == 0xd8) {
+      // Another start of image
+      return 0;
+    } else if (marker == 0x01 || (marker >= 0xd0 && marker <= 0xd7)) {
+      // Markers without a header
+      pos += 2;
+      continue;
+    }
+
+    // The other markers are followed by the big-endian length of their
+    // header, which counts the length itself
+    if (pos + 4 > size) return 0;
+    pos += 2 + ((data[pos + 2] << 8) | data[pos + 3]);
+
+    if (marker == 0xda) {
+      // The scan data after the SOS header runs up to the next marker. 0xff
+      // is escaped as 0xff00 in the data, and the data has RST markers in it.
+      while (pos + 1 < size &&
+             (data[pos] != 0xff || data[pos + 1] == 0x00 ||
+              (data[pos + 1] >= 0xd0 && data[pos + 1] <= 0xd7))) {
+        pos++;
+      }
+    }
+  }
+  return 0;
+}
@@ -8,7 +8,11 @@
 
 #include "WPIErrors.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -18,8 +22,14 @@
 #include <iostream>
 #include <sstream>
 
-static const unsigned int kMaxPacketSize = 1536;
-static const unsigned int kImageBufferAllocationIncrement = 1000;
+static const unsigned int kReadBufferSize = 16384;
+
+// Time (sec) without data from the camera after which the stream is restarted
+static const double kReadTimeout = 2.0;
+// Time (sec) to wait for a connection to the camera
+static const double kConnectTimeout = 1.0;
+// Longest single wait on a socket, so the capture thread notices m_done
+static const double kPollInterval = 0.1;
 
 static const std::string kWhiteBalanceStrings[] = {
     "auto",         "hold",         "fixed_outdoor1", "fixed_outdoor2",
@@ -40,10 +50,16 @@ static const std::string kRotationStrings[] = {
 
 /**
  * AxisCamera constructor
- * @param cameraHost The host to find the camera at, typically an IP address
+ * @param cameraHost The host to find the camera at, typically an IP address.
+ * A port other than 80 can be given as "host:port".
  */
 AxisCamera::AxisCamera(std::string const &cameraHost)
     : m_cameraHost(cameraHost) {
+  size_t colon = m_cameraHost.rfind(':');
+  if (colon != std::string::npos) {
+    m_cameraPort = m_cameraHost.substr(colon + 1);
+    m_cameraHost.erase(colon);
+  }
   m_captureThread = std::thread(&AxisCamera::Capture, this);
 }
 
@@ -59,6 +75,19 @@ AxisCamera::~AxisCamera() {
  */
 bool AxisCamera::IsFreshImage() const { return m_freshImage; }
 
+/**
+ * Wait for the next image to arrive from the camera.
+ * @param timeout The longest time to wait, in seconds
+ * @return true if an image arrived, false on timeout
+ */
+bool AxisCamera::WaitForImage(double timeout) {
+  std::unique_lock<priority_mutex> lock(m_imageDataMutex);
+  uint32_t imageCount = m_imageCount;
+  return m_imageDataCond.wait_for(
+      lock, std::chrono::duration<double>(timeout),
+      [&] { return m_imageCount != imageCount; });
+}
+
 /**
  * Get an image from the camera and store it in the provided image.
  * @param image The imaq image to store the result in. This must be an HSL or
@@ -66,12 +95,12 @@ bool AxisCamera::IsFreshImage() const { return m_freshImage; }
  * @return 1 upon success, zero on a failure
  */
 int AxisCamera::GetImage(Image *image) {
+  std::lock_guard<priority_mutex> lock(m_imageDataMutex);
+
   if (m_imageData.size() == 0) {
     return 0;
   }
 
-  std::lock_guard<priority_mutex> lock(m_imageDataMutex);
-
   Priv_ReadJPEGString_C(image, m_imageData.data(), m_imageData.size());
 
   m_freshImage = false;
@@ -126,7 +155,9 @@ int AxisCamera::CopyJPEG(char **destImage, unsigned int &destImageSize,
       m_imageData.size())  // if current destination buffer too small
   {
     if (*destImage != nullptr) delete[] * destImage;
-    destImageBufferSize = m_imageData.size() + kImageBufferAllocationIncrement;
+    // The frame buffer keeps the capacity of the largest frame so far, so the
+    // copy only needs to grow again for a larger frame
+    destImageBufferSize = m_imageData.capacity();
     *destImage = new char[destImageBufferSize];
     if (*destImage == nullptr) return 0;
   }
@@ -399,87 +430,67 @@ void AxisCamera::Capture() {
 
 /**
  * This function actually reads the images from the camera.
+ * The stream is read in large non-blocking reads and parsed incrementally.
+ * Each frame is swapped into m_imageData, so the two frame buffers are reused
+ * rather than allocated per frame. If the camera sends nothing for
+ * kReadTimeout, the connection is closed so Capture() reconnects.
  */
 void AxisCamera::ReadImagesFromCamera() {
-  char *imgBuffer = nullptr;
-  int imgBufferLength = 0;
-
-  // TODO: these recv calls must be non-blocking. Otherwise if the camera
-  // fails during a read, the code hangs and never retries when the camera comes
-  // back up.
+  uint8_t readBuffer[kReadBufferSize];
+  double lastData = Timer::GetFPGATimestamp();
 
-  int counter = 2;
+  m_parser.Reset();
   while (!m_done) {
-    char initialReadBuffer[kMaxPacketSize] = "";
-    char intermediateBuffer[1];
-    char *trailingPtr = initialReadBuffer;
-    int trailingCounter = 0;
-    while (counter) {
-      // TODO: fix me... this cannot be the most efficient way to approach this,
-      // reading one byte at a time.
-      if (recv(m_cameraSocket, intermediateBuffer, 1, 0) == -1) {
-        wpi_setErrnoErrorWithContext("Failed to read image header");
-        close(m_cameraSocket);
-        return;
-      }
-      strncat(initialReadBuffer, intermediateBuffer, 1);
-      // trailingCounter ensures that we start looking for the 4 byte string
-      // after
-      // there is at least 4 bytes total. Kind of obscure.
-      // look for 2 blank lines (\r\n)
-      if (nullptr != strstr(trailingPtr, "\r\n\r\n")) {
-        --counter;
-      }
-      if (++trailingCounter >= 4) {
-        trailingPtr++;
-      }
-    }
-    counter = 1;
-    char *contentLength = strstr(initialReadBuffer, "Content-Length: ");
-    if (contentLength == nullptr) {
-      wpi_setWPIErrorWithContext(IncompatibleMode,
-                                 "No content-length token found in packet");
-      close(m_cameraSocket);
-      return;
-    }
-    contentLength = contentLength + 16;    // skip past "content length"
-    int readLength = atol(contentLength);  // get the image byte count
-
-    // Make sure buffer is large enough
-    if (imgBufferLength < readLength) {
-      if (imgBuffer) delete[] imgBuffer;
-      imgBufferLength = readLength + kImageBufferAllocationIncrement;
-      imgBuffer = new char[imgBufferLength];
-      if (imgBuffer == nullptr) {
-        imgBufferLength = 0;
-        continue;
+    if (!WaitForSocket(m_cameraSocket, POLLIN, kPollInterval)) {
+      if (Timer::GetFPGATimestamp() - lastData > kReadTimeout) {
+        wpi_setWPIErrorWithContext(Timeout, "Camera stopped sending images");
+        break;
       }
+      continue;
     }
 
-    // Read the image data for "Content-Length" bytes
-    int bytesRead = 0;
-    int remaining = readLength;
-    while (bytesRead < readLength) {
-      int bytesThisRecv =
-          recv(m_cameraSocket, &imgBuffer[bytesRead], remaining, 0);
-      bytesRead += bytesThisRecv;
-      remaining -= bytesThisRecv;
-    }
-
-    // Update image
-    {
-      std::lock_guard<priority_mutex> lock(m_imageDataMutex);
-
-      m_imageData.assign(imgBuffer, imgBuffer + imgBufferLength);
-      m_freshImage = true;
+    ssize_t bytesRead = recv(m_cameraSocket, readBuffer, sizeof(readBuffer), 0);
+    if (bytesRead < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) continue;
+      wpi_setErrnoErrorWithContext("Failed to read from the camera");
+      break;
     }
+    if (bytesRead == 0) break;  // the camera closed the connection
+    lastData = Timer::GetFPGATimestamp();
+
+    bool restart = false;
+    size_t parsed = 0;
+    while (parsed < static_cast<size_t>(bytesRead)) {
+      MJPEGStreamParser::Result result;
+      parsed += m_parser.Feed(&readBuffer[parsed], bytesRead - parsed, result);
+
+      if (result == MJPEGStreamParser::kError) {
+        wpi_setWPIErrorWithContext(IncompatibleMode,
+                                   m_parser.GetError().c_str());
+        restart = true;
+        break;
+      }
 
-    if (WriteParameters()) {
-      break;
+      if (result == MJPEGStreamParser::kFrameReady) {
+        {
+          std::lock_guard<priority_mutex> lock(m_imageDataMutex);
+          m_imageData.swap(m_parser.GetFrame());
+          m_freshImage = true;
+          m_imageCount++;
+        }
+        m_imageDataCond.notify_all();
+
+        if (WriteParameters()) {
+          restart = true;
+          break;
+        }
+      }
     }
+    if (restart) break;
   }
 
   close(m_cameraSocket);
+  m_cameraSocket = -1;
 }
 
 /**
@@ -553,37 +564,96 @@ bool AxisCamera::WriteParameters() {
  */
 int AxisCamera::CreateCameraSocket(std::string const &requestString,
                                    bool setError) {
+  struct addrinfo hints = {};
   struct addrinfo *address = nullptr;
   int camSocket;
 
-  /* create socket */
-  if ((camSocket = socket(AF_INET, SOCK_STREAM, 0)) == -1) {
-    if (setError)
-      wpi_setErrnoErrorWithContext("Failed to create the camera socket");
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  int rc = getaddrinfo(m_cameraHost.c_str(), m_cameraPort.c_str(), &hints,
+                       &address);
+  if (rc != 0) {
+    // getaddrinfo() only sets errno for EAI_SYSTEM
+    if (setError && rc == EAI_SYSTEM) {
+      wpi_setErrnoErrorWithContext("Failed to look up the camera address");
+    } else if (setError) {
+      wpi_setWPIErrorWithContext(
+          ParameterOutOfRange,
+          (std::string("Failed to look up the camera address: ") +
+           gai_strerror(rc)).c_str());
+    }
     return -1;
   }
 
-  if (getaddrinfo(m_cameraHost.c_str(), "80", nullptr, &address) == -1) {
+  /* create socket */
+  if ((camSocket = socket(AF_INET, SOCK_STREAM, 0)) == -1) {
     if (setError)
       wpi_setErrnoErrorWithContext("Failed to create the camera socket");
+    freeaddrinfo(address);
     return -1;
   }
 
+  // All socket operations are non-blocking, so a camera that goes away can't
+  // hang the capture thread
+  fcntl(camSocket, F_SETFL, fcntl(camSocket, F_GETFL, 0) | O_NONBLOCK);
+
   /* connect to server */
-  if (connect(camSocket, address->ai_addr, address->ai_addrlen) == -1) {
+  int connected = connect(camSocket, address->ai_addr, address->ai_addrlen);
+  // Saved before freeaddrinfo() can change it
+  int connectError = connected == -1 ? errno : 0;
+  freeaddrinfo(address);
+  if (connected == -1 && connectError == EINPROGRESS) {
+    connectError = ETIMEDOUT;
+    socklen_t errorSize = sizeof(connectError);
+    if (WaitForSocket(camSocket, POLLOUT, kConnectTimeout))
+      getsockopt(camSocket, SOL_SOCKET, SO_ERROR, &connectError, &errorSize);
+    if (connectError == 0) connected = 0;
+  }
+  if (connected == -1) {
+    errno = connectError;
     if (setError)
       wpi_setErrnoErrorWithContext("Failed to connect to the camera");
     close(camSocket);
     return -1;
   }
 
-  int sent = send(camSocket, requestString.c_str(), requestString.size(), 0);
-  if (sent == -1) {
-    if (setError)
-      wpi_setErrnoErrorWithContext("Failed to send a request to the camera");
-    close(camSocket);
-    return -1;
+  size_t sent = 0;
+  while (sent < requestString.size()) {
+    ssize_t count = send(camSocket, requestString.c_str() + sent,
+                         requestString.size() - sent, MSG_NOSIGNAL);
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+        WaitForSocket(camSocket, POLLOUT, kConnectTimeout))
+      continue;
+    if (count < 0) {
+      if (setError)
+        wpi_setErrnoErrorWithContext("Failed to send a request to the camera");
+      close(camSocket);
+      return -1;
+    }
+    sent += count;
   }
 
   return camSocket;
 }
+
+/**
+ * Wait until a socket is ready, but not longer than kPollInterval at once.
+ * @param socket The socket to wait for
+ * @param events The poll() events to wait for
+ * @param timeout The longest time to wait, in seconds
+ * @return true if the socket is ready, false on timeout, error or if the
+ * camera is being destroyed
+ */
+bool AxisCamera::WaitForSocket(int socket, short events, double timeout) {
+  double end = Timer::GetFPGATimestamp() + timeout;
+  while (!m_done) {
+    double remaining = end - Timer::GetFPGATimestamp();
+    if (remaining <= 0.0) return false;
+
+    struct pollfd fd = {socket, events, 0};
+    int ready = poll(&fd, 1, std::min(remaining, kPollInterval) * 1000 + 1);
+    if (ready > 0) return true;
+    if (ready < 0 && errno != EINTR) return false;
+  }
+  return false;
+}
@@ -104,18 +104,67 @@ void BinaryImage::GetParticleAnalysisReport(int particleNumber,
 vector<ParticleAnalysisReport> *
 BinaryImage::GetOrderedParticleAnalysisReports() {
   auto particles = new vector<ParticleAnalysisReport>;
-  int particleCount = GetNumberParticles();
-  for (int particleIndex = 0; particleIndex < particleCount; particleIndex++) {
-    particles->push_back(GetParticleAnalysisReport(particleIndex));
-  }
-  // TODO: This is pretty inefficient since each compare in the sort copies
-  //   both reports being compared... do it manually instead... while we're
-  //   at it, we should provide a version that allows a preallocated buffer of
-  //   ParticleAnalysisReport structures
-  sort(particles->begin(), particles->end(), CompareParticleSizes);
+  ParticleAnalyzer analyzer;
+  GetOrderedParticleAnalysisReports(analyzer, *particles);
   return particles;
 }
 
+/**
+ * Get the particle analysis reports for the image, sorted by size, into an
+ * existing vector.
+ * All the particles are found and measured together in one pass over the
+ * image. Reusing the same analyzer and vector for each frame avoids
+ * allocating once they have grown to fit the images.
+ * The particleIndex of each report is the particle's number for
+ * GetParticleAnalysisReport() and ParticleMeasurement(), since the analyzer
+ * numbers particles the same way NI Vision does. That only holds with
+ * 8-connectivity, which is what those functions use.
+ * @param analyzer The analyzer to find the particles with. Its connectivity
+ * and number of threads are used.
+ * @param reports The vector to store the reports in, largest particle first
+ */
+void BinaryImage::GetOrderedParticleAnalysisReports(
+    ParticleAnalyzer &analyzer, vector<ParticleAnalysisReport> &reports) {
+  ImageInfo info;
+  int success = imaqGetImageInfo(m_imaqImage, &info);
+  wpi_setImaqErrorWithContext(success, "Error getting image info");
+  if (StatusIsFatal()) {
+    reports.clear();
+    return;
+  }
+
+  analyzer.Analyze(static_cast<const uint8_t *>(info.imageStart),
+                   info.pixelsPerLine, info.xRes, info.yRes);
+  analyzer.SortByArea();
+  const auto &particles = analyzer.GetReports();
+  double imageArea = (double)info.xRes * info.yRes;
+
+  reports.resize(particles.size());
+  for (size_t i = 0; i < particles.size(); i++) {
+    const ParticleAnalyzer::Report &particle = particles[i];
+    ParticleAnalysisReport &par = reports[i];
+    par.imageWidth = info.xRes;
+    par.imageHeight = info.yRes;
+    par.imageTimestamp = 0;
+    par.particleIndex = particle.index;
+    // IMAQ puts the center of each pixel at its coordinates
+    par.center_mass_x = (int)(particle.centerX - 0.5);
+    par.center_mass_y = (int)(particle.centerY - 0.5);
+    par.center_mass_x_normalized =
+        NormalizeFromRange(par.center_mass_x, info.xRes);
+    par.center_mass_y_normalized =
+        NormalizeFromRange(par.center_mass_y, info.yRes);
+    par.particleArea = particle.area;
+    par.boundingRect.top = particle.top;
+    par.boundingRect.left = particle.left;
+    par.boundingRect.height = particle.height;
+    par.boundingRect.width = particle.width;
+    par.particleToImagePercent = particle.area * 100.0 / imageArea;
+    par.particleQuality =
+        particle.area * 100.0 / (particle.area + particle.holesArea);
+  }
+}
+
 /**
  * Write a binary image to flash.
  * Writes the binary image to flash on the cRIO for later inspection.
@@ -193,36 +242,89 @@ bool BinaryImage::CompareParticleSizes(ParticleAnalysisReport particle1,
 
 BinaryImage *BinaryImage::RemoveSmallObjects(bool connectivity8, int erosions) {
   auto result = new BinaryImage();
-  int success = imaqSizeFilter(result->GetImaqImage(), m_imaqImage,
-                               connectivity8, erosions, IMAQ_KEEP_LARGE, nullptr);
-  wpi_setImaqErrorWithContext(success, "Error in RemoveSmallObjects");
+  RemoveSmallObjects(connectivity8, erosions, result);
   return result;
 }
 
 BinaryImage *BinaryImage::RemoveLargeObjects(bool connectivity8, int erosions) {
   auto result = new BinaryImage();
-  int success = imaqSizeFilter(result->GetImaqImage(), m_imaqImage,
-                               connectivity8, erosions, IMAQ_KEEP_SMALL, nullptr);
-  wpi_setImaqErrorWithContext(success, "Error in RemoveLargeObjects");
+  RemoveLargeObjects(connectivity8, erosions, result);
   return result;
 }
 
 BinaryImage *BinaryImage::ConvexHull(bool connectivity8) {
   auto result = new BinaryImage();
-  int success =
-      imaqConvexHull(result->GetImaqImage(), m_imaqImage, connectivity8);
-  wpi_setImaqErrorWithContext(success, "Error in convex hull operation");
+  ConvexHull(connectivity8, result);
   return result;
 }
 
 BinaryImage *BinaryImage::ParticleFilter(ParticleFilterCriteria2 *criteria,
                                          int criteriaCount) {
   auto result = new BinaryImage();
+  ParticleFilter(criteria, criteriaCount, result);
+  return result;
+}
+
+/**
+ * Remove the particles that are gone after eroding the image, into an
+ * existing image.
+ * @param result The image to store the result in, which may be this image
+ */
+void BinaryImage::RemoveSmallObjects(bool connectivity8, int erosions,
+                                     BinaryImage *result) {
+  if (result == nullptr) {
+    wpi_setWPIError(NullParameter);
+    return;
+  }
+  int success = imaqSizeFilter(result->GetImaqImage(), m_imaqImage,
+                               connectivity8, erosions, IMAQ_KEEP_LARGE, nullptr);
+  wpi_setImaqErrorWithContext(success, "Error in RemoveSmallObjects");
+}
+
+/**
+ * Remove the particles that are left after eroding the image, into an
+ * existing image.
+ * @param result The image to store the result in, which may be this image
+ */
+void BinaryImage::RemoveLargeObjects(bool connectivity8, int erosions,
+                                     BinaryImage *result) {
+  if (result == nullptr) {
+    wpi_setWPIError(NullParameter);
+    return;
+  }
+  int success = imaqSizeFilter(result->GetImaqImage(), m_imaqImage,
+                               connectivity8, erosions, IMAQ_KEEP_SMALL, nullptr);
+  wpi_setImaqErrorWithContext(success, "Error in RemoveLargeObjects");
+}
+
+/**
+ * Fill in each particle to its convex hull, into an existing image.
+ * @param result The image to store the result in, which may be this image
+ */
+void BinaryImage::ConvexHull(bool connectivity8, BinaryImage *result) {
+  if (result == nullptr) {
+    wpi_setWPIError(NullParameter);
+    return;
+  }
+  int success =
+      imaqConvexHull(result->GetImaqImage(), m_imaqImage, connectivity8);
+  wpi_setImaqErrorWithContext(success, "Error in convex hull operation");
+}
+
+/**
+ * Keep the particles that meet the criteria, into an existing image.
+ * @param result The image to store the result in, which may be this image
+ */
+void BinaryImage::ParticleFilter(ParticleFilterCriteria2 *criteria,
+                                 int criteriaCount, BinaryImage *result) {
+  if (result == nullptr) {
+    wpi_setWPIError(NullParameter);
+    return;
+  }
   int numParticles;
   ParticleFilterOptions2 filterOptions = {0, 0, 0, 1};
   int success =
       imaqParticleFilter4(result->GetImaqImage(), m_imaqImage, criteria,
                           criteriaCount, &filterOptions, nullptr, &numParticles);
   wpi_setImaqErrorWithContext(success, "Error in particle filter operation");
-  return result;
 }
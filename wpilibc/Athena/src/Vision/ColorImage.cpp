@@ -87,6 +87,20 @@ BinaryImage *ColorImage::ThresholdHSL(Threshold &t) {
                           t.plane2High, t.plane3Low, t.plane3High);
 }
 
+/**
+ * Perform a threshold in HSL space into an existing BinaryImage, without
+ * allocating.
+ * @param threshold a reference to the Threshold object to use.
+ * @param result The image to store the result in
+ */
+void ColorImage::ThresholdHSL(const Threshold &threshold, BinaryImage *result) {
+  if (result == nullptr) {
+    wpi_setWPIError(NullParameter);
+    return;
+  }
+  ComputeThreshold(IMAQ_HSL, threshold, result);
+}
+
 /**
  * Perform a threshold in HSV space.
  * @param hueLow Low value for hue
@@ -145,6 +159,126 @@ BinaryImage *ColorImage::ThresholdHSI(Threshold &t) {
                           t.plane2High, t.plane3Low, t.plane3High);
 }
 
+/**
+ * Perform a threshold operation into an existing BinaryImage.
+ * @param colorMode The type of colorspace this operation should be performed in
+ * @param result The image to store the result in
+ */
+void ColorImage::ComputeThreshold(ColorMode colorMode,
+                                  const Threshold &threshold,
+                                  BinaryImage *result) {
+  Range range1 = {threshold.plane1Low, threshold.plane1High},
+        range2 = {threshold.plane2Low, threshold.plane2High},
+        range3 = {threshold.plane3Low, threshold.plane3High};
+
+  int success = imaqColorThreshold(result->GetImaqImage(), m_imaqImage, 1,
+                                   colorMode, &range1, &range2, &range3);
+  wpi_setImaqErrorWithContext(success, "ImaqThreshold error");
+}
+
+/**
+ * Get the pixels of this image and of a result of the same size, for the
+ * native kernels, which work on RGB images.
+ * @param result The image to resize and get the pixels of
+ * @returns false if this isn't an RGB image
+ */
+bool ColorImage::GetRGBPixels(ImageBase *result, ImageInfo &source,
+                              ImageInfo &dest) {
+  if (m_imaqImage == nullptr || result == nullptr) {
+    wpi_setWPIError(NullParameter);
+    return false;
+  }
+  if (!imaqGetImageInfo(m_imaqImage, &source) ||
+      source.imageType != IMAQ_IMAGE_RGB)
+    return false;
+
+  int success =
+      imaqSetImageSize(result->GetImaqImage(), source.xRes, source.yRes);
+  wpi_setImaqErrorWithContext(success, "Imaq SetImageSize failed");
+  success = imaqGetImageInfo(result->GetImaqImage(), &dest);
+  wpi_setImaqErrorWithContext(success, "Imaq GetImageInfo failed");
+  return success;
+}
+
+/**
+ * Perform a threshold in RGB space into an existing BinaryImage, without
+ * allocating.
+ * RGB images are thresholded natively, with SIMD where the processor has it.
+ * @param threshold a reference to the Threshold object to use.
+ * @param result The image to store the result in
+ */
+void ColorImage::ThresholdRGB(const Threshold &threshold, BinaryImage *result) {
+  ImageInfo source, dest;
+  if (!GetRGBPixels(result, source, dest)) {
+    if (result != nullptr) ComputeThreshold(IMAQ_RGB, threshold, result);
+    return;
+  }
+  ColorKernels::ThresholdRGB(static_cast<uint8_t *>(source.imageStart),
+                             source.pixelsPerLine,
+                             static_cast<uint8_t *>(dest.imageStart),
+                             dest.pixelsPerLine, source.xRes, source.yRes,
+                             threshold);
+}
+
+/**
+ * Perform a threshold in HSV space into an existing BinaryImage, without
+ * allocating.
+ * The image is converted and thresholded natively in a single pass, with SIMD
+ * where the processor has it. This uses the HSV scale of ColorKernels rather
+ * than the one of IMAQ_HSV that ThresholdHSV() uses, so thresholds tuned with
+ * NI Vision have to be tuned again. Only RGB images are supported.
+ * @param threshold a reference to the Threshold object to use.
+ * @param result The image to store the result in
+ */
+void ColorImage::ThresholdNativeHSV(const Threshold &threshold,
+                                    BinaryImage *result) {
+  ImageInfo source, dest;
+  if (!GetRGBPixels(result, source, dest)) {
+    if (result != nullptr) {
+      wpi_setWPIErrorWithContext(IncompatibleMode,
+                                 "Native HSV threshold needs an RGB image");
+    }
+    return;
+  }
+  ColorKernels::ThresholdHSV(static_cast<uint8_t *>(source.imageStart),
+                             source.pixelsPerLine,
+                             static_cast<uint8_t *>(dest.imageStart),
+                             dest.pixelsPerLine, source.xRes, source.yRes,
+                             threshold);
+}
+
+/**
+ * Extract an RGB or HSV plane into an existing MonoImage, without allocating.
+ * The HSV planes are on the scale of ColorKernels, not that of IMAQ_HSV, and
+ * can only be extracted from RGB images.
+ * @param plane The plane to extract
+ * @param result The image to store the plane in
+ */
+void ColorImage::ExtractNativeColorPlane(ColorKernels::Plane plane,
+                                         MonoImage *result) {
+  ImageInfo source, dest;
+  if (!GetRGBPixels(result, source, dest)) {
+    if (result == nullptr) return;
+    if (plane > ColorKernels::kBluePlane) {
+      wpi_setWPIErrorWithContext(IncompatibleMode,
+                                 "Native HSV planes need an RGB image");
+      return;
+    }
+    int success = imaqExtractColorPlanes(
+        m_imaqImage, IMAQ_RGB,
+        (plane == ColorKernels::kRedPlane) ? result->GetImaqImage() : nullptr,
+        (plane == ColorKernels::kGreenPlane) ? result->GetImaqImage() : nullptr,
+        (plane == ColorKernels::kBluePlane) ? result->GetImaqImage() : nullptr);
+    wpi_setImaqErrorWithContext(success, "Imaq ExtractColorPlanes failed");
+    return;
+  }
+  ColorKernels::ExtractPlane(static_cast<uint8_t *>(source.imageStart),
+                             source.pixelsPerLine,
+                             static_cast<uint8_t *>(dest.imageStart),
+                             dest.pixelsPerLine, source.xRes, source.yRes,
+                             plane);
+}
+
 /**
  * Extract a color plane from the image
  * @param mode The ColorMode to use for the plane extraction
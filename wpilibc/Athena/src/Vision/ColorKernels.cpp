@@ -0,0 +1,586 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "Vision/ColorKernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define COLOR_KERNELS_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define COLOR_KERNELS_NEON
+#endif
+
+// Byte offsets of the channels within a pixel
+static const int kBlue = 0;
+static const int kGreen = 1;
+static const int kRed = 2;
+
+static bool vectorized = true;
+
+namespace {
+
+/**
+ * The bounds of a threshold, clamped to 0-255.
+ */
+struct Bounds {
+  int low[3];
+  int high[3];
+  bool empty;  // no pixel can pass
+  bool hueWraps;
+  uint8_t replaceValue;
+
+  Bounds(const Threshold &t, uint8_t replace, bool hsv) {
+    int lows[3] = {t.plane1Low, t.plane2Low, t.plane3Low};
+    int highs[3] = {t.plane1High, t.plane2High, t.plane3High};
+    empty = false;
+    for (int i = 0; i < 3; i++) {
+      low[i] = std::max(lows[i], 0);
+      high[i] = std::min(highs[i], 255);
+      if (low[i] > 255 || high[i] < 0) empty = true;
+    }
+    hueWraps = hsv && low[0] > high[0];
+    for (int i = hueWraps ? 1 : 0; i < 3; i++) {
+      if (low[i] > high[i]) empty = true;
+    }
+    replaceValue = replace;
+  }
+};
+
+/**
+ * The HSV of a pixel, in the exact integer terms both the scalar and vector
+ * code use. The hue is 256 * x / (6 * delta), where x is 0 to 6 * delta
+ * around the color circle, and the saturation is 255 * delta / max. Gray
+ * pixels have a hue and saturation of 0, so the hue is divided by a delta of
+ * at least 1 and the saturation by a max of at least 1.
+ */
+struct PixelHSV {
+  int x;
+  int delta;
+  int max;
+
+  PixelHSV(int r, int g, int b) {
+    max = std::max(r, std::max(g, b));
+    int min = std::min(r, std::min(g, b));
+    delta = max - min;
+    if (max == r)
+      x = g - b + (g < b ? 6 * delta : 0);
+    else if (max == g)
+      x = 2 * delta + b - r;
+    else
+      x = 4 * delta + r - g;
+  }
+};
+
+}  // namespace
+
+static inline bool ScalarRGB(const uint8_t *pixel, const Bounds &bounds) {
+  return pixel[kRed] >= bounds.low[0] && pixel[kRed] <= bounds.high[0] &&
+         pixel[kGreen] >= bounds.low[1] && pixel[kGreen] <= bounds.high[1] &&
+         pixel[kBlue] >= bounds.low[2] && pixel[kBlue] <= bounds.high[2];
+}
+
+/**
+ * Compare the HSV of a pixel with the bounds by cross multiplying, so the
+ * hue and saturation never have to be divided out.
+ */
+static inline bool ScalarHSV(const uint8_t *pixel, const Bounds &bounds) {
+  PixelHSV hsv(pixel[kRed], pixel[kGreen], pixel[kBlue]);
+  int x256 = 256 * hsv.x, delta6 = 6 * std::max(hsv.delta, 1);
+  bool hueAbove = x256 >= bounds.low[0] * delta6;
+  bool hueBelow = x256 < (bounds.high[0] + 1) * delta6;
+  bool hue = bounds.hueWraps ? hueAbove || hueBelow : hueAbove && hueBelow;
+
+  int delta255 = 255 * hsv.delta;
+  int max = std::max(hsv.max, 1);
+  bool saturation = delta255 >= bounds.low[1] * max &&
+                    delta255 < (bounds.high[1] + 1) * max;
+
+  return hue && saturation && hsv.max >= bounds.low[2] &&
+         hsv.max <= bounds.high[2];
+}
+
+static inline uint8_t ScalarPlane(const uint8_t *pixel,
+                                  ColorKernels::Plane plane) {
+  switch (plane) {
+    case ColorKernels::kRedPlane:
+      return pixel[kRed];
+    case ColorKernels::kGreenPlane:
+      return pixel[kGreen];
+    case ColorKernels::kBluePlane:
+      return pixel[kBlue];
+    default:
+      break;
+  }
+  PixelHSV hsv(pixel[kRed], pixel[kGreen], pixel[kBlue]);
+  if (plane == ColorKernels::kHSVHuePlane) {
+    return 256 * hsv.x / (6 * std::max(hsv.delta, 1));
+  }
+  if (plane == ColorKernels::kHSVValuePlane) return hsv.max;
+  return 255 * hsv.delta / std::max(hsv.max, 1);
+}
+
+#if defined(COLOR_KERNELS_SSE2)
+
+/**
+ * Unpack 4 pixels into floats of each channel.
+ */
+static inline void UnpackSSE(__m128i pixels, __m128 &r, __m128 &g,
+                             __m128 &b) {
+  const __m128i mask = _mm_set1_epi32(0xff);
+  b = _mm_cvtepi32_ps(_mm_and_si128(pixels, mask));
+  g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), mask));
+  r = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask));
+}
+
+/**
+ * PixelHSV for 4 pixels. All of the values are integers below 2^24, so the
+ * float arithmetic is exact.
+ */
+static inline void HSVSSE(__m128 r, __m128 g, __m128 b, __m128 &x,
+                          __m128 &delta, __m128 &max) {
+  max = _mm_max_ps(r, _mm_max_ps(g, b));
+  __m128 min = _mm_min_ps(r, _mm_min_ps(g, b));
+  delta = _mm_sub_ps(max, min);
+
+  __m128 xr = _mm_add_ps(
+      _mm_sub_ps(g, b),
+      _mm_and_ps(_mm_cmplt_ps(g, b), _mm_mul_ps(delta, _mm_set1_ps(6))));
+  __m128 xg = _mm_add_ps(_mm_mul_ps(delta, _mm_set1_ps(2)), _mm_sub_ps(b, r));
+  __m128 xb = _mm_add_ps(_mm_mul_ps(delta, _mm_set1_ps(4)), _mm_sub_ps(r, g));
+  __m128 isRed = _mm_cmpeq_ps(max, r);
+  __m128 isGreen = _mm_cmpeq_ps(max, g);
+  __m128 xgb = _mm_or_ps(_mm_and_ps(isGreen, xg), _mm_andnot_ps(isGreen, xb));
+  x = _mm_or_ps(_mm_and_ps(isRed, xr), _mm_andnot_ps(isRed, xgb));
+}
+
+static inline __m128 HSVMaskSSE(__m128i pixels, const Bounds &bounds) {
+  __m128 r, g, b, x, delta, max;
+  UnpackSSE(pixels, r, g, b);
+  HSVSSE(r, g, b, x, delta, max);
+
+  __m128 x256 = _mm_mul_ps(x, _mm_set1_ps(256));
+  __m128 delta6 = _mm_mul_ps(_mm_max_ps(delta, _mm_set1_ps(1)), _mm_set1_ps(6));
+  __m128 hueAbove =
+      _mm_cmpge_ps(x256, _mm_mul_ps(delta6, _mm_set1_ps(bounds.low[0])));
+  __m128 hueBelow =
+      _mm_cmplt_ps(x256, _mm_mul_ps(delta6, _mm_set1_ps(bounds.high[0] + 1)));
+  __m128 hue = bounds.hueWraps ? _mm_or_ps(hueAbove, hueBelow)
+                               : _mm_and_ps(hueAbove, hueBelow);
+
+  __m128 delta255 = _mm_mul_ps(delta, _mm_set1_ps(255));
+  __m128 max1 = _mm_max_ps(max, _mm_set1_ps(1));
+  __m128 saturation = _mm_and_ps(
+      _mm_cmpge_ps(delta255, _mm_mul_ps(max1, _mm_set1_ps(bounds.low[1]))),
+      _mm_cmplt_ps(delta255,
+                   _mm_mul_ps(max1, _mm_set1_ps(bounds.high[1] + 1))));
+
+  __m128 value =
+      _mm_and_ps(_mm_cmpge_ps(max, _mm_set1_ps(bounds.low[2])),
+                 _mm_cmple_ps(max, _mm_set1_ps(bounds.high[2])));
+  return _mm_and_ps(hue, _mm_and_ps(saturation, value));
+}
+
+/**
+ * Pack the 32 bit masks of 16 pixels into one byte per pixel.
+ */
+static inline __m128i PackMasksSSE(__m128i m0, __m128i m1, __m128i m2,
+                                   __m128i m3) {
+  return _mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3));
+}
+
+static int ThresholdRGBVector(const uint8_t *source, uint8_t *dest, int width,
+                              const Bounds &bounds) {
+  // Each byte is in range when saturating subtraction past either bound is 0.
+  // The alpha byte always is.
+  const __m128i low = _mm_set1_epi32(bounds.low[2] << (8 * kBlue) |
+                                     bounds.low[1] << (8 * kGreen) |
+                                     bounds.low[0] << (8 * kRed));
+  const __m128i high = _mm_set1_epi32(bounds.high[2] << (8 * kBlue) |
+                                      bounds.high[1] << (8 * kGreen) |
+                                      bounds.high[0] << (8 * kRed) |
+                                      static_cast<int>(0xff000000u));
+  const __m128i replace = _mm_set1_epi8(bounds.replaceValue);
+  const __m128i zero = _mm_setzero_si128();
+
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    __m128i masks[4];
+    for (int j = 0; j < 4; j++) {
+      __m128i pixels = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(source + 4 * (i + 4 * j)));
+      __m128i outside = _mm_or_si128(_mm_subs_epu8(low, pixels),
+                                     _mm_subs_epu8(pixels, high));
+      masks[j] = _mm_cmpeq_epi32(outside, zero);
+    }
+    __m128i mask = PackMasksSSE(masks[0], masks[1], masks[2], masks[3]);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i),
+                     _mm_and_si128(mask, replace));
+  }
+  return i;
+}
+
+static int ThresholdHSVVector(const uint8_t *source, uint8_t *dest, int width,
+                              const Bounds &bounds) {
+  const __m128i replace = _mm_set1_epi8(bounds.replaceValue);
+
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    __m128i masks[4];
+    for (int j = 0; j < 4; j++) {
+      __m128i pixels = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(source + 4 * (i + 4 * j)));
+      masks[j] = _mm_castps_si128(HSVMaskSSE(pixels, bounds));
+    }
+    __m128i mask = PackMasksSSE(masks[0], masks[1], masks[2], masks[3]);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i),
+                     _mm_and_si128(mask, replace));
+  }
+  return i;
+}
+
+/**
+ * One plane of 4 pixels, as 32 bit integers.
+ */
+static inline __m128i PlaneSSE(__m128i pixels, ColorKernels::Plane plane) {
+  const __m128i mask = _mm_set1_epi32(0xff);
+  switch (plane) {
+    case ColorKernels::kRedPlane:
+      return _mm_and_si128(_mm_srli_epi32(pixels, 8 * kRed), mask);
+    case ColorKernels::kGreenPlane:
+      return _mm_and_si128(_mm_srli_epi32(pixels, 8 * kGreen), mask);
+    case ColorKernels::kBluePlane:
+      return _mm_and_si128(pixels, mask);
+    default:
+      break;
+  }
+
+  __m128 r, g, b, x, delta, max;
+  UnpackSSE(pixels, r, g, b);
+  HSVSSE(r, g, b, x, delta, max);
+  __m128 result;
+  if (plane == ColorKernels::kHSVHuePlane) {
+    result = _mm_div_ps(
+        _mm_mul_ps(x, _mm_set1_ps(256)),
+        _mm_mul_ps(_mm_max_ps(delta, _mm_set1_ps(1)), _mm_set1_ps(6)));
+  } else if (plane == ColorKernels::kHSVValuePlane) {
+    result = max;
+  } else {
+    result = _mm_div_ps(_mm_mul_ps(delta, _mm_set1_ps(255)),
+                        _mm_max_ps(max, _mm_set1_ps(1)));
+  }
+  // The quotients are far enough from the next integer that the rounded
+  // division truncates to the exact integer quotient
+  return _mm_cvttps_epi32(result);
+}
+
+static int ExtractPlaneVector(const uint8_t *source, uint8_t *dest, int width,
+                              ColorKernels::Plane plane) {
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    __m128i values[4];
+    for (int j = 0; j < 4; j++) {
+      values[j] = PlaneSSE(_mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                               source + 4 * (i + 4 * j))),
+                           plane);
+    }
+    __m128i packed =
+        _mm_packus_epi16(_mm_packs_epi32(values[0], values[1]),
+                         _mm_packs_epi32(values[2], values[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), packed);
+  }
+  return i;
+}
+
+#elif defined(COLOR_KERNELS_NEON)
+
+/**
+ * Widen a quarter of 16 channel bytes to floats.
+ */
+static inline float32x4_t WidenNEON(uint8x16_t channel, int quarter) {
+  uint16x8_t half = vmovl_u8(quarter < 2 ? vget_low_u8(channel)
+                                         : vget_high_u8(channel));
+  uint16x4_t part = (quarter & 1) ? vget_high_u16(half) : vget_low_u16(half);
+  return vcvtq_f32_u32(vmovl_u16(part));
+}
+
+/**
+ * Narrow 16 32 bit values, each 0-255, to bytes.
+ */
+static inline uint8x16_t NarrowNEON(const uint32x4_t values[4]) {
+  uint16x8_t low = vcombine_u16(vmovn_u32(values[0]), vmovn_u32(values[1]));
+  uint16x8_t high = vcombine_u16(vmovn_u32(values[2]), vmovn_u32(values[3]));
+  return vcombine_u8(vmovn_u16(low), vmovn_u16(high));
+}
+
+/**
+ * PixelHSV for 4 pixels. All of the values are integers below 2^24, so the
+ * float arithmetic is exact.
+ */
+static inline void HSVNEON(float32x4_t r, float32x4_t g, float32x4_t b,
+                           float32x4_t &x, float32x4_t &delta,
+                           float32x4_t &max) {
+  max = vmaxq_f32(r, vmaxq_f32(g, b));
+  float32x4_t min = vminq_f32(r, vminq_f32(g, b));
+  delta = vsubq_f32(max, min);
+
+  float32x4_t xr = vsubq_f32(g, b);
+  xr = vbslq_f32(vcltq_f32(g, b), vmlaq_n_f32(xr, delta, 6), xr);
+  float32x4_t xg = vmlaq_n_f32(vsubq_f32(b, r), delta, 2);
+  float32x4_t xb = vmlaq_n_f32(vsubq_f32(r, g), delta, 4);
+  x = vbslq_f32(vceqq_f32(max, r), xr,
+                vbslq_f32(vceqq_f32(max, g), xg, xb));
+}
+
+static inline uint32x4_t HSVMaskNEON(float32x4_t r, float32x4_t g,
+                                     float32x4_t b, const Bounds &bounds) {
+  float32x4_t x, delta, max;
+  HSVNEON(r, g, b, x, delta, max);
+
+  float32x4_t x256 = vmulq_n_f32(x, 256);
+  float32x4_t delta6 = vmulq_n_f32(vmaxq_f32(delta, vdupq_n_f32(1)), 6);
+  uint32x4_t hueAbove = vcgeq_f32(x256, vmulq_n_f32(delta6, bounds.low[0]));
+  uint32x4_t hueBelow =
+      vcltq_f32(x256, vmulq_n_f32(delta6, bounds.high[0] + 1));
+  uint32x4_t hue = bounds.hueWraps ? vorrq_u32(hueAbove, hueBelow)
+                                   : vandq_u32(hueAbove, hueBelow);
+
+  float32x4_t delta255 = vmulq_n_f32(delta, 255);
+  float32x4_t max1 = vmaxq_f32(max, vdupq_n_f32(1));
+  uint32x4_t saturation =
+      vandq_u32(vcgeq_f32(delta255, vmulq_n_f32(max1, bounds.low[1])),
+                vcltq_f32(delta255, vmulq_n_f32(max1, bounds.high[1] + 1)));
+
+  uint32x4_t value = vandq_u32(vcgeq_f32(max, vdupq_n_f32(bounds.low[2])),
+                               vcleq_f32(max, vdupq_n_f32(bounds.high[2])));
+  return vandq_u32(hue, vandq_u32(saturation, value));
+}
+
+static int ThresholdRGBVector(const uint8_t *source, uint8_t *dest, int width,
+                              const Bounds &bounds) {
+  const uint8x16_t replace = vdupq_n_u8(bounds.replaceValue);
+  const uint8x16_t redLow = vdupq_n_u8(bounds.low[0]);
+  const uint8x16_t redHigh = vdupq_n_u8(bounds.high[0]);
+  const uint8x16_t greenLow = vdupq_n_u8(bounds.low[1]);
+  const uint8x16_t greenHigh = vdupq_n_u8(bounds.high[1]);
+  const uint8x16_t blueLow = vdupq_n_u8(bounds.low[2]);
+  const uint8x16_t blueHigh = vdupq_n_u8(bounds.high[2]);
+
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    uint8x16x4_t pixels = vld4q_u8(source + 4 * i);
+    uint8x16_t red = pixels.val[kRed];
+    uint8x16_t green = pixels.val[kGreen];
+    uint8x16_t blue = pixels.val[kBlue];
+    uint8x16_t mask = vandq_u8(vcgeq_u8(red, redLow), vcleq_u8(red, redHigh));
+    mask = vandq_u8(mask, vandq_u8(vcgeq_u8(green, greenLow),
+                                   vcleq_u8(green, greenHigh)));
+    mask = vandq_u8(mask, vandq_u8(vcgeq_u8(blue, blueLow),
+                                   vcleq_u8(blue, blueHigh)));
+    vst1q_u8(dest + i, vandq_u8(mask, replace));
+  }
+  return i;
+}
+
+static int ThresholdHSVVector(const uint8_t *source, uint8_t *dest, int width,
+                              const Bounds &bounds) {
+  const uint8x16_t replace = vdupq_n_u8(bounds.replaceValue);
+
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    uint8x16x4_t pixels = vld4q_u8(source + 4 * i);
+    uint32x4_t masks[4];
+    for (int j = 0; j < 4; j++) {
+      masks[j] = HSVMaskNEON(WidenNEON(pixels.val[kRed], j),
+                             WidenNEON(pixels.val[kGreen], j),
+                             WidenNEON(pixels.val[kBlue], j), bounds);
+    }
+    vst1q_u8(dest + i, vandq_u8(NarrowNEON(masks), replace));
+  }
+  return i;
+}
+
+/**
+ * The integer quotient of exact integer floats. NEON has no division, so the
+ * reciprocal estimate is refined and the quotient corrected by one if needed.
+ */
+static inline uint32x4_t DivideNEON(float32x4_t numerator,
+                                    float32x4_t denominator) {
+  float32x4_t reciprocal = vrecpeq_f32(denominator);
+  reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+  reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+  float32x4_t quotient =
+      vcvtq_f32_u32(vcvtq_u32_f32(vmulq_f32(numerator, reciprocal)));
+
+  // One more if the next integer still fits, one less if this one doesn't
+  float32x4_t next = vaddq_f32(quotient, vdupq_n_f32(1));
+  quotient = vbslq_f32(vcleq_f32(vmulq_f32(next, denominator), numerator),
+                       next, quotient);
+  quotient = vbslq_f32(vcgtq_f32(vmulq_f32(quotient, denominator), numerator),
+                       vsubq_f32(quotient, vdupq_n_f32(1)), quotient);
+  return vcvtq_u32_f32(quotient);
+}
+
+static int ExtractPlaneVector(const uint8_t *source, uint8_t *dest, int width,
+                              ColorKernels::Plane plane) {
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    uint8x16x4_t pixels = vld4q_u8(source + 4 * i);
+    if (plane <= ColorKernels::kBluePlane) {
+      int channel = plane == ColorKernels::kRedPlane
+                        ? kRed
+                        : (plane == ColorKernels::kGreenPlane ? kGreen : kBlue);
+      vst1q_u8(dest + i, pixels.val[channel]);
+      continue;
+    }
+
+    uint32x4_t values[4];
+    for (int j = 0; j < 4; j++) {
+      float32x4_t x, delta, max;
+      HSVNEON(WidenNEON(pixels.val[kRed], j),
+              WidenNEON(pixels.val[kGreen], j),
+              WidenNEON(pixels.val[kBlue], j), x, delta, max);
+      if (plane == ColorKernels::kHSVHuePlane) {
+        values[j] = DivideNEON(
+            vmulq_n_f32(x, 256),
+            vmulq_n_f32(vmaxq_f32(delta, vdupq_n_f32(1)), 6));
+      } else if (plane == ColorKernels::kHSVValuePlane) {
+        values[j] = vcvtq_u32_f32(max);
+      } else {
+        values[j] = DivideNEON(vmulq_n_f32(delta, 255),
+                               vmaxq_f32(max, vdupq_n_f32(1)));
+      }
+    }
+    vst1q_u8(dest + i, NarrowNEON(values));
+  }
+  return i;
+}
+
+#else
+
+static int ThresholdRGBVector(const uint8_t *, uint8_t *, int,
+                              const Bounds &) {
+  return 0;
+}
+
+static int ThresholdHSVVector(const uint8_t *, uint8_t *, int,
+                              const Bounds &) {
+  return 0;
+}
+
+static int ExtractPlaneVector(const uint8_t *, uint8_t *, int,
+                              ColorKernels::Plane) {
+  return 0;
+}
+
+#endif
+
+/**
+ * Threshold an RGB image.
+ * @param source The pixels of the RGB image
+ * @param sourcePixelsPerLine The number of pixels stored for each line of the
+ * source, at least width
+ * @param dest The pixels of the U8 result
+ * @param destPixelsPerLine The number of pixels stored for each line of dest
+ * @param threshold The red, green and blue ranges, inclusive
+ * @param replaceValue The value of pixels in the ranges; the others are 0
+ */
+void ColorKernels::ThresholdRGB(const uint8_t *source, int sourcePixelsPerLine,
+                                uint8_t *dest, int destPixelsPerLine,
+                                int width, int height,
+                                const Threshold &threshold,
+                                uint8_t replaceValue) {
+  Bounds bounds(threshold, replaceValue, false);
+  for (int y = 0; y < height; y++) {
+    const uint8_t *sourceLine = source + 4 * y * sourcePixelsPerLine;
+    uint8_t *destLine = dest + y * destPixelsPerLine;
+    if (bounds.empty) {
+      std::memset(destLine, 0, width);
+      continue;
+    }
+    int x = vectorized ? ThresholdRGBVector(sourceLine, destLine, width, bounds)
+                       : 0;
+    for (; x < width; x++) {
+      destLine[x] = ScalarRGB(sourceLine + 4 * x, bounds) ? replaceValue : 0;
+    }
+  }
+}
+
+/**
+ * Threshold an RGB image in HSV space, converting each pixel as it is
+ * thresholded.
+ * @param source The pixels of the RGB image
+ * @param sourcePixelsPerLine The number of pixels stored for each line of the
+ * source, at least width
+ * @param dest The pixels of the U8 result
+ * @param destPixelsPerLine The number of pixels stored for each line of dest
+ * @param threshold The hue, saturation and value ranges, inclusive
+ * @param replaceValue The value of pixels in the ranges; the others are 0
+ */
+void ColorKernels::ThresholdHSV(const uint8_t *source, int sourcePixelsPerLine,
+                                uint8_t *dest, int destPixelsPerLine,
+                                int width, int height,
+                                const Threshold &threshold,
+                                uint8_t replaceValue) {
+  Bounds bounds(threshold, replaceValue, true);
+  for (int y = 0; y < height; y++) {
+    const uint8_t *sourceLine = source + 4 * y * sourcePixelsPerLine;
+    uint8_t *destLine = dest + y * destPixelsPerLine;
+    if (bounds.empty) {
+      std::memset(destLine, 0, width);
+      continue;
+    }
+    int x = vectorized ? ThresholdHSVVector(sourceLine, destLine, width, bounds)
+                       : 0;
+    for (; x < width; x++) {
+      destLine[x] = ScalarHSV(sourceLine + 4 * x, bounds) ? replaceValue : 0;
+    }
+  }
+}
+
+/**
+ * Extract one RGB or HSV plane of an RGB image.
+ * @param source The pixels of the RGB image
+ * @param sourcePixelsPerLine The number of pixels stored for each line of the
+ * source, at least width
+ * @param dest The pixels of the U8 plane
+ * @param destPixelsPerLine The number of pixels stored for each line of dest
+ */
+void ColorKernels::ExtractPlane(const uint8_t *source, int sourcePixelsPerLine,
+                                uint8_t *dest, int destPixelsPerLine,
+                                int width, int height, Plane plane) {
+  for (int y = 0; y < height; y++) {
+    const uint8_t *sourceLine = source + 4 * y * sourcePixelsPerLine;
+    uint8_t *destLine = dest + y * destPixelsPerLine;
+    int x = vectorized ? ExtractPlaneVector(sourceLine, destLine, width, plane)
+                       : 0;
+    for (; x < width; x++) {
+      destLine[x] = ScalarPlane(sourceLine + 4 * x, plane);
+    }
+  }
+}
+
+/**
+ * @return Whether the kernels were compiled with SSE2 or NEON
+ */
+bool ColorKernels::HasVectorUnit() {
+#if defined(COLOR_KERNELS_SSE2) || defined(COLOR_KERNELS_NEON)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Choose between the vector and the scalar code, to compare them in tests and
+ * benchmarks. The vector code is used by default.
+ */
+void ColorKernels::SetVectorized(bool vector) { vectorized = vector; }
+
+bool ColorKernels::IsVectorized() { return vectorized && HasVectorUnit(); }
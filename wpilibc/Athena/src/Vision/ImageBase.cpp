@@ -7,6 +7,8 @@
 #include "Vision/ImageBase.h"
 #include "nivision.h"
 
+std::atomic<uint64_t> ImageBase::s_imagesCreated(0);
+
 /**
  * Create a new instance of an ImageBase.
  * Imagebase is the base of all the other image classes. The constructor
@@ -15,6 +17,7 @@
  */
 ImageBase::ImageBase(ImageType type) {
   m_imaqImage = imaqCreateImage(type, DEFAULT_BORDER_SIZE);
+  s_imagesCreated++;
 }
 
 /**
@@ -61,3 +64,11 @@ int ImageBase::GetWidth() {
  * @return A pointer to the internal IMAQ Image data structure.
  */
 Image *ImageBase::GetImaqImage() { return m_imaqImage; }
+
+/**
+ * Get the number of images that have been created.
+ * A processing loop that reuses its images, such as from an ImagePool, stops
+ * adding to this once it has all the images it needs.
+ * @return The number of images created since the program started
+ */
+uint64_t ImageBase::GetImagesCreated() { return s_imagesCreated; }
@@ -0,0 +1,84 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "Vision/ImagePool.h"
+
+#include "Utility.h"
+#include "WPIErrors.h"
+
+ImagePool::~ImagePool() {
+  wpi_assertEqual(m_inUse, 0u);
+}
+
+/**
+ * Find the bucket of a class and size, adding one if there isn't one yet.
+ * Must be called with m_mutex held.
+ */
+size_t ImagePool::FindBucket(const std::type_info &type, int width,
+                             int height) {
+  size_t bucket = 0;
+  while (bucket < m_buckets.size() &&
+         (*m_buckets[bucket].type != type || m_buckets[bucket].width != width ||
+          m_buckets[bucket].height != height)) {
+    bucket++;
+  }
+  if (bucket == m_buckets.size()) {
+    m_buckets.push_back(Bucket{&type, width, height, {}});
+  }
+  return bucket;
+}
+
+ImagePool::Entry *ImagePool::AcquireEntry(const std::type_info &type,
+                                          int width, int height,
+                                          ImageBase *(*create)()) {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  m_acquired++;
+  m_inUse++;
+
+  size_t bucket = FindBucket(type, width, height);
+  Entry *entry;
+  if (!m_buckets[bucket].free.empty()) {
+    entry = m_buckets[bucket].free.back();
+    m_buckets[bucket].free.pop_back();
+  } else {
+    entry = new Entry;
+    entry->image.reset(create());
+    entry->bucket = bucket;
+    entry->pool = this;
+    m_entries.emplace_back(entry);
+
+    int success =
+        imaqSetImageSize(entry->image->GetImaqImage(), width, height);
+    wpi_setImaqErrorWithContext(success, "Error sizing a pooled image");
+  }
+  entry->references = 1;
+  return entry;
+}
+
+/**
+ * Give an image back to the pool. An image that was resized while it was out,
+ * such as by being the destination of an IMAQ function, goes to the bucket of
+ * its new size, so Acquire() never hands out an image of the wrong size.
+ */
+void ImagePool::Release(Entry *entry) {
+  int width = 0, height = 0;
+  bool sized =
+      imaqGetImageSize(entry->image->GetImaqImage(), &width, &height) != 0;
+
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  m_inUse--;
+  const Bucket &bucket = m_buckets[entry->bucket];
+  if (sized && (width != bucket.width || height != bucket.height)) {
+    entry->bucket = FindBucket(*bucket.type, width, height);
+  }
+  m_buckets[entry->bucket].free.push_back(entry);
+}
+
+ImagePool::Statistics ImagePool::GetStatistics() {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  return Statistics{m_acquired, m_entries.size(), m_inUse,
+                    m_entries.size() - m_inUse};
+}
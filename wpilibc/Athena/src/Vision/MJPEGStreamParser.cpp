@@ -0,0 +1,105 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "Vision/MJPEGStreamParser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+const size_t MJPEGStreamParser::kMaxHeaderSize;
+const size_t MJPEGStreamParser::kMaxFrameSize;
+
+/**
+ * Parse the next part of the stream.
+ * Parsing stops at the end of a frame, so the caller can take the frame
+ * before feeding the rest of the data.
+ * @param data The bytes read from the stream
+ * @param length The number of bytes in data
+ * @param result Set to kFrameReady when a frame was completed, or kError if
+ * the stream is malformed, in which case the parser must be Reset()
+ * @return The number of bytes consumed
+ */
+size_t MJPEGStreamParser::Feed(const uint8_t *data, size_t length,
+                               Result &result) {
+  result = kNeedMoreData;
+  size_t consumed = 0;
+
+  while (consumed < length) {
+    if (m_state == kHeader) {
+      m_header.push_back(static_cast<char>(data[consumed++]));
+      size_t size = m_header.size();
+      if (size >= 4 && m_header.compare(size - 4, 4, "\r\n\r\n") == 0) {
+        if (!ParseHeader()) {
+          result = kError;
+          return consumed;
+        }
+        m_header.clear();
+        if (m_state == kBody && m_frameLength == 0) {
+          m_state = kHeader;
+          result = kFrameReady;
+          return consumed;
+        }
+      } else if (size > kMaxHeaderSize) {
+        m_error = "Header too long";
+        result = kError;
+        return consumed;
+      }
+    } else {
+      size_t count = std::min(length - consumed, m_frameLength - m_frameRead);
+      std::memcpy(&m_frame[m_frameRead], &data[consumed], count);
+      m_frameRead += count;
+      consumed += count;
+      if (m_frameRead == m_frameLength) {
+        m_state = kHeader;
+        result = kFrameReady;
+        return consumed;
+      }
+    }
+  }
+  return consumed;
+}
+
+/**
+ * Discard any partly parsed header or frame, to start on a new stream.
+ */
+void MJPEGStreamParser::Reset() {
+  m_state = kHeader;
+  m_header.clear();
+  m_frameLength = 0;
+  m_frameRead = 0;
+  m_error.clear();
+}
+
+/**
+ * Look for the Content-Length in a complete header block, and get ready to
+ * read the frame if there is one.
+ */
+bool MJPEGStreamParser::ParseHeader() {
+  static const char kContentLength[] = "content-length:";
+  static const size_t kContentLengthSize = sizeof(kContentLength) - 1;
+
+  auto it = std::search(m_header.begin(), m_header.end(), kContentLength,
+                        kContentLength + kContentLengthSize,
+                        [](char a, char b) { return std::tolower(a) == b; });
+  if (it == m_header.end()) return true;  // not a frame header
+
+  const char *value = &*it + kContentLengthSize;
+  char *end;
+  long frameLength = std::strtol(value, &end, 10);
+  if (end == value || frameLength < 0 ||
+      static_cast<size_t>(frameLength) > kMaxFrameSize) {
+    m_error = "Invalid Content-Length";
+    return false;
+  }
+
+  m_frameLength = frameLength;
+  m_frameRead = 0;
+  m_frame.resize(m_frameLength);
+  m_state = kBody;
+  return true;
+}
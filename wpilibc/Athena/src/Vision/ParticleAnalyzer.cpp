@@ -0,0 +1,424 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "Vision/ParticleAnalyzer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <mutex>
+
+/**
+ * The sum of the squares of 0 to n.
+ */
+static inline int64_t SumOfSquares(int64_t n) {
+  return n * (n + 1) * (2 * n + 1) / 6;
+}
+
+void ParticleAnalyzer::Runs::Clear() {
+  runs.clear();
+  parents.clear();
+  lineStarts.clear();
+}
+
+/**
+ * Find the run that stands for the whole component of a run, which is always
+ * the component's first run.
+ */
+int ParticleAnalyzer::Runs::Find(int run) {
+  while (parents[run] != run) {
+    parents[run] = parents[parents[run]];
+    run = parents[run];
+  }
+  return run;
+}
+
+void ParticleAnalyzer::Runs::Union(int run1, int run2) {
+  int root1 = Find(run1), root2 = Find(run2);
+  if (root1 < root2)
+    parents[root2] = root1;
+  else
+    parents[root1] = root2;
+}
+
+/**
+ * Join the runs of a line with the runs they touch in the line above.
+ * @param above The first run of the line above
+ * @param below The first run of the line
+ * @param end The run after the last run of the line
+ */
+void ParticleAnalyzer::Runs::JoinLines(int above, int below, int end,
+                                       bool connectivity8) {
+  int slack = connectivity8 ? 1 : 0;
+  int i = above, j = below;
+  while (i < below && j < end) {
+    const Run &a = runs[i], &b = runs[j];
+    if (a.x1 + slack >= b.x0 && b.x1 + slack >= a.x0) Union(i, j);
+    // Whichever run ends first can't touch any later run of the other line
+    if (a.x1 < b.x1)
+      i++;
+    else
+      j++;
+  }
+}
+
+/**
+ * Add the runs of a band after the runs so far.
+ */
+void ParticleAnalyzer::Runs::Append(const Runs &band) {
+  int offset = runs.size();
+  runs.insert(runs.end(), band.runs.begin(), band.runs.end());
+  for (int parent : band.parents) parents.push_back(parent + offset);
+  // The band's last line start is the end of its runs
+  for (size_t i = 0; i + 1 < band.lineStarts.size(); i++) {
+    lineStarts.push_back(band.lineStarts[i] + offset);
+  }
+}
+
+/**
+ * @param connectivity8 Whether pixels that only touch diagonally are part of
+ * the same particle. The background is connected the other way.
+ * @param threads The number of threads to analyze each image with
+ */
+ParticleAnalyzer::ParticleAnalyzer(bool connectivity8, int threads)
+    : m_connectivity8(connectivity8) {
+  SetThreads(threads);
+}
+
+ParticleAnalyzer::~ParticleAnalyzer() { StopWorkers(); }
+
+/**
+ * Set the number of threads to analyze each image with, starting the worker
+ * threads now rather than on every image.
+ */
+void ParticleAnalyzer::SetThreads(int threads) {
+  StopWorkers();
+  m_threads = std::max(threads, 1);
+  m_bands.resize(m_threads);
+  for (int i = 1; i < m_threads; i++) {
+    m_workers.emplace_back(&ParticleAnalyzer::Work, this, i);
+  }
+}
+
+void ParticleAnalyzer::StopWorkers() {
+  {
+    std::lock_guard<priority_mutex> lock(m_workMutex);
+    m_stopWorkers = true;
+  }
+  m_workReady.notify_all();
+  for (auto &worker : m_workers) worker.join();
+  m_workers.clear();
+  m_stopWorkers = false;
+}
+
+/**
+ * The loop of a worker thread, which encodes one band of each image.
+ */
+void ParticleAnalyzer::Work(int band) {
+  unsigned int generation = 0;
+  std::unique_lock<priority_mutex> lock(m_workMutex);
+  while (true) {
+    m_workReady.wait(lock, [&] {
+      return m_stopWorkers || m_generation != generation;
+    });
+    if (m_stopWorkers) return;
+    generation = m_generation;
+
+    // Images with fewer lines than threads leave some workers without a band
+    if (band < m_numBands) {
+      lock.unlock();
+      EncodeBand(m_bands[band], m_pixels, m_pixelsPerLine, m_width,
+                 band * m_height / m_numBands,
+                 (band + 1) * m_height / m_numBands, m_connectivity8);
+      lock.lock();
+    }
+    if (--m_pendingWorkers == 0) m_workDone.notify_one();
+  }
+}
+
+/**
+ * Encode the lines of a band as runs, and join the runs within the band.
+ */
+void ParticleAnalyzer::EncodeBand(Band &band, const uint8_t *pixels,
+                                  int pixelsPerLine, int width, int firstLine,
+                                  int endLine, bool connectivity8) {
+  Runs &particles = band.particles;
+  Runs &background = band.background;
+  particles.Clear();
+  background.Clear();
+
+  for (int y = firstLine; y < endLine; y++) {
+    const uint8_t *line = pixels + y * pixelsPerLine;
+    particles.lineStarts.push_back(particles.runs.size());
+    background.lineStarts.push_back(background.runs.size());
+
+    for (int x = 0; x < width;) {
+      bool particle = line[x] != 0;
+      int start = x;
+      if (particle) {
+        while (x < width && line[x] != 0) x++;
+      } else {
+        while (x < width && line[x] == 0) x++;
+      }
+      Runs &runs = particle ? particles : background;
+      runs.parents.push_back(runs.runs.size());
+      runs.runs.push_back({y, start, x - 1});
+    }
+
+    if (y > firstLine) {
+      size_t line = y - firstLine;
+      particles.JoinLines(particles.lineStarts[line - 1],
+                          particles.lineStarts[line], particles.runs.size(),
+                          connectivity8);
+      background.JoinLines(background.lineStarts[line - 1],
+                           background.lineStarts[line],
+                           background.runs.size(), !connectivity8);
+    }
+  }
+  particles.lineStarts.push_back(particles.runs.size());
+  background.lineStarts.push_back(background.runs.size());
+}
+
+/**
+ * Find and measure the particles of a binary image.
+ * @param pixels The image, one byte per pixel. Pixels that aren't 0 are part
+ * of particles.
+ * @param pixelsPerLine The number of pixels stored for each line
+ * @return The number of particles
+ */
+int ParticleAnalyzer::Analyze(const uint8_t *pixels, int pixelsPerLine,
+                              int width, int height) {
+  if (width <= 0 || height <= 0) {
+    m_reports.clear();
+    return 0;
+  }
+
+  int bands = std::min(m_threads, height);
+  if (bands == 1) {
+    EncodeBand(m_image, pixels, pixelsPerLine, width, 0, height,
+               m_connectivity8);
+  } else {
+    {
+      std::lock_guard<priority_mutex> lock(m_workMutex);
+      m_pixels = pixels;
+      m_pixelsPerLine = pixelsPerLine;
+      m_width = width;
+      m_height = height;
+      m_numBands = bands;
+      m_pendingWorkers = m_workers.size();
+      m_generation++;
+    }
+    m_workReady.notify_all();
+    EncodeBand(m_bands[0], pixels, pixelsPerLine, width, 0, height / bands,
+               m_connectivity8);
+    {
+      std::unique_lock<priority_mutex> lock(m_workMutex);
+      m_workDone.wait(lock, [&] { return m_pendingWorkers == 0; });
+    }
+
+    m_image.particles.Clear();
+    m_image.background.Clear();
+    for (int i = 0; i < bands; i++) {
+      const Band &band = m_bands[i];
+      m_image.particles.Append(band.particles);
+      m_image.background.Append(band.background);
+    }
+    m_image.particles.lineStarts.push_back(m_image.particles.runs.size());
+    m_image.background.lineStarts.push_back(m_image.background.runs.size());
+
+    // Join the first line of each band to the last line of the band above
+    for (int i = 1; i < bands; i++) {
+      int line = i * height / bands;
+      for (Runs *runs : {&m_image.particles, &m_image.background}) {
+        runs->JoinLines(runs->lineStarts[line - 1], runs->lineStarts[line],
+                        runs->lineStarts[line + 1],
+                        runs == &m_image.particles ? m_connectivity8
+                                                   : !m_connectivity8);
+      }
+    }
+  }
+
+  Measure(width, height);
+  return m_reports.size();
+}
+
+/**
+ * Sum the measurements of each particle from its runs.
+ */
+void ParticleAnalyzer::Measure(int width, int height) {
+  Runs &particles = m_image.particles;
+  int numRuns = particles.runs.size();
+
+  // Number the particles in the order of their first runs
+  m_particleOfRun.resize(numRuns);
+  int count = 0;
+  for (int i = 0; i < numRuns; i++) {
+    int root = particles.Find(i);
+    m_particleOfRun[i] = root == i ? count++ : m_particleOfRun[root];
+  }
+
+  m_reports.resize(count);
+  m_sums.assign(count, Sums{0, 0, 0, 0, 0});
+  for (int i = 0; i < count; i++) {
+    Report &report = m_reports[i];
+    report.index = i;
+    report.area = 0;
+    report.left = report.top = INT_MAX;
+    // The right and bottom until the end
+    report.width = report.height = -1;
+    report.holesArea = 0;
+  }
+
+  for (int i = 0; i < numRuns; i++) {
+    const Run &run = particles.runs[i];
+    Report &report = m_reports[m_particleOfRun[i]];
+    Sums &sums = m_sums[m_particleOfRun[i]];
+    int64_t length = run.x1 - run.x0 + 1;
+    int64_t sumX = length * (run.x0 + run.x1) / 2;
+    report.area += length;
+    sums.x += sumX;
+    sums.xx += SumOfSquares(run.x1) - SumOfSquares(run.x0 - 1);
+    sums.y += length * run.y;
+    sums.yy += length * run.y * run.y;
+    sums.xy += sumX * run.y;
+    report.left = std::min(report.left, run.x0);
+    report.top = std::min(report.top, run.y);
+    report.width = std::max(report.width, run.x1);
+    report.height = std::max(report.height, run.y);
+  }
+
+  for (int i = 0; i < count; i++) {
+    Report &report = m_reports[i];
+    const Sums &sums = m_sums[i];
+    double area = report.area;
+    report.width = report.width - report.left + 1;
+    report.height = report.height - report.top + 1;
+    report.centerX = sums.x / area + 0.5;
+    report.centerY = sums.y / area + 0.5;
+    report.momentXX = sums.xx - sums.x * (sums.x / area);
+    report.momentYY = sums.yy - sums.y * (sums.y / area);
+    report.momentXY = sums.xy - sums.x * (sums.y / area);
+  }
+
+  MeasureConvexHulls();
+  MeasureHoles(width, height);
+}
+
+/**
+ * Find the convex hull of the corners of the pixels at both ends of each
+ * line of each particle, and measure its area.
+ */
+void ParticleAnalyzer::MeasureConvexHulls() {
+  const Runs &particles = m_image.particles;
+  int numRuns = particles.runs.size();
+  int count = m_reports.size();
+
+  // Sort the runs by particle, keeping them in order within each particle
+  m_particleStarts.assign(count + 1, 0);
+  for (int i = 0; i < numRuns; i++) m_particleStarts[m_particleOfRun[i] + 1]++;
+  for (int i = 0; i < count; i++) {
+    m_particleStarts[i + 1] += m_particleStarts[i];
+  }
+  m_runOrder.resize(numRuns);
+  for (int i = 0; i < numRuns; i++) {
+    m_runOrder[m_particleStarts[m_particleOfRun[i]]++] = i;
+  }
+  // Each start was moved to the next particle's start
+  for (int i = count; i > 0; i--) m_particleStarts[i] = m_particleStarts[i - 1];
+  m_particleStarts[0] = 0;
+
+  for (int i = 0; i < count; i++) {
+    m_points.clear();
+    for (int j = m_particleStarts[i]; j < m_particleStarts[i + 1];) {
+      const Run &first = particles.runs[m_runOrder[j]];
+      int x1 = first.x1;
+      for (j++; j < m_particleStarts[i + 1] &&
+                particles.runs[m_runOrder[j]].y == first.y;
+           j++) {
+        x1 = particles.runs[m_runOrder[j]].x1;
+      }
+      m_points.push_back({first.x0, first.y});
+      m_points.push_back({x1 + 1, first.y});
+      m_points.push_back({first.x0, first.y + 1});
+      m_points.push_back({x1 + 1, first.y + 1});
+    }
+    std::sort(m_points.begin(), m_points.end());
+
+    // Andrew's monotone chain
+    auto cross = [](const Point &o, const Point &a, const Point &b) {
+      return static_cast<int64_t>(a.x - o.x) * (b.y - o.y) -
+             static_cast<int64_t>(a.y - o.y) * (b.x - o.x);
+    };
+    int n = m_points.size(), k = 0;
+    m_hull.resize(2 * n);
+    for (int j = 0; j < n; j++) {
+      while (k >= 2 && cross(m_hull[k - 2], m_hull[k - 1], m_points[j]) <= 0)
+        k--;
+      m_hull[k++] = m_points[j];
+    }
+    for (int j = n - 2, lower = k + 1; j >= 0; j--) {
+      while (k >= lower &&
+             cross(m_hull[k - 2], m_hull[k - 1], m_points[j]) <= 0)
+        k--;
+      m_hull[k++] = m_points[j];
+    }
+
+    int64_t twiceArea = 0;
+    for (int j = 0; j + 1 < k; j++) {
+      twiceArea += static_cast<int64_t>(m_hull[j].x) * m_hull[j + 1].y -
+                   static_cast<int64_t>(m_hull[j + 1].x) * m_hull[j].y;
+    }
+    m_reports[i].convexHullArea = std::abs(twiceArea) / 2.0;
+  }
+}
+
+/**
+ * Add the area of each background component that doesn't touch the edge of
+ * the image to the particle around it.
+ */
+void ParticleAnalyzer::MeasureHoles(int width, int height) {
+  Runs &background = m_image.background;
+  const Runs &particles = m_image.particles;
+  int numRuns = background.runs.size();
+
+  m_backgroundAreas.assign(numRuns, 0);
+  for (int i = 0; i < numRuns; i++) {
+    const Run &run = background.runs[i];
+    int &area = m_backgroundAreas[background.Find(i)];
+    if (area < 0) continue;
+    if (run.y == 0 || run.y == height - 1 || run.x0 == 0 ||
+        run.x1 == width - 1)
+      area = -1;
+    else
+      area += run.x1 - run.x0 + 1;
+  }
+
+  for (int i = 0; i < numRuns; i++) {
+    if (m_backgroundAreas[i] <= 0) continue;
+    // The pixel above the first pixel of a hole is part of the particle
+    // around it, since it would otherwise have come first in the hole.
+    const Run &run = background.runs[i];
+    auto begin = particles.runs.begin() + particles.lineStarts[run.y - 1];
+    auto end = particles.runs.begin() + particles.lineStarts[run.y];
+    auto above = std::lower_bound(
+        begin, end, run.x0,
+        [](const Run &particle, int x) { return particle.x1 < x; });
+    if (above == end) continue;
+    int particle = m_particleOfRun[above - particles.runs.begin()];
+    m_reports[particle].holesArea += m_backgroundAreas[i];
+  }
+}
+
+/**
+ * Sort the reports from the largest particle to the smallest, keeping
+ * particles of the same area in the order they were found.
+ */
+void ParticleAnalyzer::SortByArea() {
+  std::sort(m_reports.begin(), m_reports.end(),
+            [](const Report &a, const Report &b) {
+              return a.area > b.area || (a.area == b.area && a.index < b.index);
+            });
+}
@@ -0,0 +1,300 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "Vision/VisionPipeline.h"
+
+#include "Timer.h"
+#include "WPIErrors.h"
+
+#include <algorithm>
+
+constexpr unsigned int VisionPipeline::kMaxImageSize;
+
+/**
+ * @param camera The camera to capture frames from. It should be open, and is
+ * started and stopped with the pipeline.
+ * @param queueLength The number of frames that can wait for each stage. With
+ * the default of 1, each stage gets the latest frame when it is ready for
+ * one.
+ */
+VisionPipeline::VisionPipeline(std::shared_ptr<USBCamera> camera,
+                               unsigned int queueLength)
+    : m_camera(camera), m_queueLength(std::max(queueLength, 1u)) {
+  m_stages.emplace_back(new Stage("capture", nullptr));
+  m_stages.emplace_back(new Stage("decode", &VisionPipeline::Decode));
+  m_stages.emplace_back(
+      new Stage("publish", [this](Frame &frame) { return Publish(frame); }));
+}
+
+VisionPipeline::~VisionPipeline() { Stop(); }
+
+/**
+ * Add a stage to process each frame after the ones already added.
+ * Stages can't be added while the pipeline is running.
+ * @param name The name of the stage, for its statistics
+ * @param function Called with each frame, on the stage's own thread
+ */
+void VisionPipeline::AddStage(std::string name, StageFunction function) {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  if (m_running) {
+    wpi_setWPIErrorWithContext(IncompatibleState,
+                               "Can't add a stage to a running pipeline");
+    return;
+  }
+  m_stages.emplace(m_stages.end() - 1,
+                   new Stage(name, [function](Frame &frame) {
+                     function(frame);
+                     return true;
+                   }));
+}
+
+/**
+ * Set the function that is called with each frame after the last stage, such
+ * as to send the results to the dashboard.
+ * It is called on the publishing thread, and the frame is only valid until
+ * it returns.
+ */
+void VisionPipeline::SetPublisher(Publisher publisher) {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  if (m_running) {
+    wpi_setWPIErrorWithContext(IncompatibleState,
+                               "Can't set the publisher of a running pipeline");
+    return;
+  }
+  m_publisher = publisher;
+}
+
+/**
+ * Start capturing and processing frames.
+ */
+void VisionPipeline::Start() {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  if (m_running) return;
+  if (!m_camera) {
+    wpi_setWPIErrorWithContext(NullParameter, "camera");
+    return;
+  }
+
+  // Every stage can be working on a frame while every queue is full, and the
+  // latest result is kept, so capture never waits for a frame
+  size_t numFrames =
+      m_stages.size() + (m_stages.size() - 1) * m_queueLength + 1;
+  while (m_frames.size() < numFrames) m_frames.emplace_back(new Frame);
+  m_freeFrames.clear();
+  m_freeFrames.reserve(m_frames.size());
+  for (auto &frame : m_frames) {
+    if (frame.get() != m_latest) m_freeFrames.push_back(frame.get());
+  }
+  for (auto &stage : m_stages) {
+    stage->queue.assign(m_queueLength, nullptr);
+    stage->queueStart = 0;
+    stage->queueSize = 0;
+  }
+
+  m_running = true;
+  m_camera->StartCapture();
+  m_stages[0]->thread = std::thread(&VisionPipeline::Capture, this);
+  for (size_t i = 1; i < m_stages.size(); i++) {
+    m_stages[i]->thread = std::thread(&VisionPipeline::RunStage, this, i);
+  }
+}
+
+/**
+ * Stop capturing and processing frames, and wait for the stages to finish
+ * the frames they are working on.
+ * The latest result is kept.
+ */
+void VisionPipeline::Stop() {
+  {
+    std::lock_guard<priority_mutex> lock(m_mutex);
+    if (!m_running) return;
+    m_running = false;
+  }
+  for (auto &stage : m_stages) stage->frameReady.notify_all();
+  m_frameFreed.notify_all();
+  m_camera->StopCapture();
+  for (auto &stage : m_stages) stage->thread.join();
+}
+
+bool VisionPipeline::IsRunning() {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  return m_running;
+}
+
+/**
+ * @return The number of stages, including capture, decode and publish
+ */
+int VisionPipeline::GetNumStages() {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  return m_stages.size();
+}
+
+/**
+ * @param stage The stage, from 0 for capture to GetNumStages() - 1 for
+ * publish
+ */
+std::string VisionPipeline::GetStageName(int stage) {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  if (stage < 0 || stage >= (int)m_stages.size()) {
+    wpi_setWPIErrorWithContext(ParameterOutOfRange, "stage");
+    return "";
+  }
+  return m_stages[stage]->name;
+}
+
+/**
+ * Get the timing of a stage.
+ * The capture stage's time includes waiting for the camera, so it is the
+ * time between frames.
+ * @param stage The stage, from 0 for capture to GetNumStages() - 1 for
+ * publish
+ */
+VisionPipeline::Statistics VisionPipeline::GetStatistics(int stage) {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  if (stage < 0 || stage >= (int)m_stages.size()) {
+    wpi_setWPIErrorWithContext(ParameterOutOfRange, "stage");
+    return Statistics();
+  }
+  return m_stages[stage]->statistics;
+}
+
+/**
+ * Get the time from when each frame was captured to when it was published.
+ * The dropped and failed counts are of all the frames dropped or failed by
+ * any stage.
+ */
+VisionPipeline::Statistics VisionPipeline::GetLatency() {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  Statistics latency = m_latency;
+  for (auto &stage : m_stages) {
+    latency.dropped += stage->statistics.dropped;
+    latency.failed += stage->statistics.failed;
+  }
+  return latency;
+}
+
+/**
+ * Get the particles found in the last frame that was published.
+ * @param particles Set to the particles of the frame
+ * @param timestamp Set to the FPGA time when the frame was captured
+ * @return false if no frame has been published yet
+ */
+bool VisionPipeline::GetLatestResult(
+    std::vector<ParticleAnalysisReport> &particles, double &timestamp) {
+  std::lock_guard<priority_mutex> lock(m_mutex);
+  if (m_latest == nullptr) return false;
+  particles = m_latest->particles;
+  timestamp = m_latest->timestamp;
+  return true;
+}
+
+void VisionPipeline::AddTime(Statistics &statistics, double &totalTime,
+                             double time) {
+  statistics.frames++;
+  statistics.lastTime = time;
+  statistics.maxTime = std::max(statistics.maxTime, time);
+  totalTime += time;
+  statistics.averageTime = totalTime / statistics.frames;
+}
+
+void VisionPipeline::ReleaseFrame(Frame *frame) {
+  m_freeFrames.push_back(frame);
+  m_frameFreed.notify_one();
+}
+
+/**
+ * Queue a frame for a stage, dropping the oldest frame waiting for it if the
+ * queue is full.
+ */
+void VisionPipeline::PushFrame(Stage &stage, Frame *frame) {
+  size_t capacity = stage.queue.size();
+  if (stage.queueSize == capacity) {
+    ReleaseFrame(stage.queue[stage.queueStart]);
+    stage.queueStart = (stage.queueStart + 1) % capacity;
+    stage.queueSize--;
+    stage.statistics.dropped++;
+  }
+  stage.queue[(stage.queueStart + stage.queueSize) % capacity] = frame;
+  stage.queueSize++;
+  stage.frameReady.notify_one();
+}
+
+void VisionPipeline::Capture() {
+  Stage &stage = *m_stages[0];
+  std::unique_lock<priority_mutex> lock(m_mutex);
+  while (true) {
+    m_frameFreed.wait(lock,
+                      [&] { return !m_freeFrames.empty() || !m_running; });
+    if (!m_running) break;
+    Frame *frame = m_freeFrames.back();
+    m_freeFrames.pop_back();
+    lock.unlock();
+
+    double start = Timer::GetFPGATimestamp();
+    frame->jpegSize = m_camera->GetImageData(frame->jpeg.get(), kMaxImageSize);
+    double end = Timer::GetFPGATimestamp();
+
+    lock.lock();
+    if (frame->jpegSize == 0) {
+      // Don't spin while the camera isn't giving images
+      ReleaseFrame(frame);
+      lock.unlock();
+      Wait(0.01);
+      lock.lock();
+      continue;
+    }
+    frame->number = ++m_frameNumber;
+    frame->timestamp = end;
+    AddTime(stage.statistics, stage.totalTime, end - start);
+    PushFrame(*m_stages[1], frame);
+  }
+}
+
+/**
+ * Decode the frame's JPEG into its image.
+ * @return false if the JPEG couldn't be decoded, to drop the frame
+ */
+bool VisionPipeline::Decode(Frame &frame) {
+  return Priv_ReadJPEGString_C(frame.image.GetImaqImage(), frame.jpeg.get(),
+                               frame.jpegSize) != 0;
+}
+
+bool VisionPipeline::Publish(Frame &frame) {
+  if (m_publisher) m_publisher(frame);
+  return true;
+}
+
+void VisionPipeline::RunStage(size_t index) {
+  Stage &stage = *m_stages[index];
+  bool last = index + 1 == m_stages.size();
+  std::unique_lock<priority_mutex> lock(m_mutex);
+  while (true) {
+    stage.frameReady.wait(lock,
+                          [&] { return stage.queueSize > 0 || !m_running; });
+    if (!m_running) break;
+    Frame *frame = stage.queue[stage.queueStart];
+    stage.queueStart = (stage.queueStart + 1) % stage.queue.size();
+    stage.queueSize--;
+    lock.unlock();
+
+    double start = Timer::GetFPGATimestamp();
+    bool succeeded = stage.function(*frame);
+    double end = Timer::GetFPGATimestamp();
+
+    lock.lock();
+    AddTime(stage.statistics, stage.totalTime, end - start);
+    if (!succeeded) {
+      stage.statistics.failed++;
+      ReleaseFrame(frame);
+    } else if (last) {
+      AddTime(m_latency, m_totalLatency, end - frame->timestamp);
+      if (m_latest != nullptr) ReleaseFrame(m_latest);
+      m_latest = frame;
+    } else {
+      PushFrame(*m_stages[index + 1], frame);
+    }
+  }
+}
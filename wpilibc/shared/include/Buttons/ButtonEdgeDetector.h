@@ -0,0 +1,48 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.
+ */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __BUTTON_EDGE_DETECTOR_H__
+#define __BUTTON_EDGE_DETECTOR_H__
+
+#include "DriverStation.h"
+#include "HAL/cpp/priority_mutex.h"
+#include <vector>
+
+class JoystickButton;
+
+/**
+ * Diffs the button bitmask of each joystick once per Scheduler pass and wakes
+ * only the JoystickButtons whose bits changed.
+ *
+ * This replaces calling Joystick::GetRawButton() for every registered button
+ * on every pass of the Scheduler.  Sticks with no registered buttons are never
+ * read.
+ */
+class ButtonEdgeDetector {
+ public:
+  static ButtonEdgeDetector *GetInstance();
+
+  bool Register(uint32_t stick, uint32_t button, JoystickButton *listener);
+  void Unregister(uint32_t stick, uint32_t button, JoystickButton *listener);
+  void Poll();
+
+ private:
+  ButtonEdgeDetector() = default;
+
+  static const uint32_t kMaxButtons = 32;
+
+  priority_mutex m_listenersLock;
+  std::vector<JoystickButton *> m_listeners[DriverStation::kJoystickPorts]
+                                           [kMaxButtons];
+  uint32_t m_watchedButtons[DriverStation::kJoystickPorts] = {};
+  uint32_t m_lastButtons[DriverStation::kJoystickPorts] = {};
+  // Buttons registered since the last Poll(), woken unconditionally
+  uint32_t m_newButtons[DriverStation::kJoystickPorts] = {};
+  bool m_anyWatched = false;
+};
+
+#endif
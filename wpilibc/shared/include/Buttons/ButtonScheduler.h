@@ -17,11 +17,21 @@ class ButtonScheduler {
   virtual ~ButtonScheduler() = default;
   virtual void Execute() = 0;
   void Start();
+  bool NeedsExecute();
 
  protected:
+  /**
+   * Returns true if Execute() must run every pass even when the trigger has
+   * not changed (for instance to keep restarting a held command).
+   */
+  virtual bool NeedsPolling() const { return false; }
+
   bool m_pressedLast;
   Trigger *m_button;
   Command *m_command;
+
+ private:
+  unsigned m_lastChangeCount;
 };
 
 #endif
@@ -18,6 +18,9 @@ class HeldButtonScheduler : public ButtonScheduler {
   HeldButtonScheduler(bool last, Trigger *button, Command *orders);
   virtual ~HeldButtonScheduler() = default;
   virtual void Execute();
+
+ protected:
+  virtual bool NeedsPolling() const { return m_pressedLast; }
 };
 
 #endif
@@ -12,15 +12,24 @@
 #include "Buttons/Button.h"
 
 class JoystickButton : public Button {
+  friend class ButtonEdgeDetector;
+
  public:
   JoystickButton(GenericHID *joystick, int buttonNumber);
-  virtual ~JoystickButton() = default;
+  virtual ~JoystickButton();
 
   virtual bool Get();
 
+ protected:
+  virtual bool HasChangeNotification() const { return m_stick >= 0; }
+
  private:
+  void ButtonChanged() { NotifyChanged(); }
+
   GenericHID *m_joystick;
   int m_buttonNumber;
+  // Driver station port when attached to the ButtonEdgeDetector, otherwise -1
+  int m_stick = -1;
 };
 
 #endif
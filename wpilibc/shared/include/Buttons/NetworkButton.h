@@ -9,20 +9,35 @@
 #define __NETWORK_BUTTON_H__
 
 #include "Buttons/Button.h"
+#include "tables/ITableListener.h"
+#include <atomic>
 #include <string>
 #include <memory>
 
-class NetworkButton : public Button {
+/**
+ * A Button backed by a boolean field of a NetworkTable.
+ *
+ * The value is cached from a table listener, so Get() never looks the field up
+ * and the Scheduler only evaluates the button when the field changes.
+ */
+class NetworkButton : public Button, public ITableListener {
  public:
   NetworkButton(const std::string &tableName, const std::string &field);
   NetworkButton(std::shared_ptr<ITable> table, const std::string &field);
-  virtual ~NetworkButton() = default;
+  virtual ~NetworkButton();
 
   virtual bool Get();
 
+  virtual void ValueChanged(ITable *source, llvm::StringRef key,
+                            std::shared_ptr<nt::Value> value, bool isNew);
+
+ protected:
+  virtual bool HasChangeNotification() const { return true; }
+
  private:
   std::shared_ptr<ITable> m_netTable;
   std::string m_field;
+  std::atomic<bool> m_pressed{false};
 };
 
 #endif
@@ -9,6 +9,7 @@
 #define __TRIGGER_H__
 
 #include "SmartDashboard/Sendable.h"
+#include <atomic>
 #include <memory>
 
 class Command;
@@ -42,12 +43,26 @@ class Trigger : public Sendable {
   void CancelWhenActive(Command *command);
   void ToggleWhenActive(Command *command);
 
+  bool IsEventDriven() const;
+  unsigned GetChangeCount() const { return m_changeCount; }
+
   virtual void InitTable(std::shared_ptr<ITable> table);
   virtual std::shared_ptr<ITable> GetTable() const;
   virtual std::string GetSmartDashboardType() const;
 
  protected:
+  /**
+   * Subclasses that call NotifyChanged() whenever the value returned by Get()
+   * may have changed should override this to return true. The Scheduler then
+   * only evaluates the trigger's ButtonSchedulers after a change.
+   */
+  virtual bool HasChangeNotification() const { return false; }
+  void NotifyChanged() { m_changeCount++; }
+
   std::shared_ptr<ITable> m_table = nullptr;
+
+ private:
+  std::atomic<unsigned> m_changeCount{0};
 };
 
 #endif
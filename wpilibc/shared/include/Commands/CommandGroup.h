@@ -10,7 +10,7 @@
 
 #include "Commands/Command.h"
 #include "Commands/CommandGroupEntry.h"
-#include <list>
+#include <cstdint>
 #include <vector>
 
 /**
@@ -59,13 +59,26 @@ class CommandGroup : public Command {
   virtual void _End();
 
  private:
-  void CancelConflicts(Command *command);
+  void CompileSchedule();
+  bool Conflicts(int first, int second) const;
+  void CancelConflicts(int index);
 
   /** The commands in this group (stored in entries) */
   std::vector<CommandGroupEntry> m_commands;
 
-  /** The active children in this group (stored in entries) */
-  std::list<CommandGroupEntry> m_children;
+  /**
+   * The subsystems each command requires, as a bitmask over the subsystems
+   * required by the group, m_maskWords words per command. This is built once
+   * the group is locked, so conflicts between commands are found without
+   * comparing their requirement sets.
+   */
+  std::vector<uint64_t> m_requirementMasks;
+  size_t m_maskWords = 0;
+  bool m_scheduleCompiled = false;
+
+  /** The indices in m_commands of the active children, in the order they were
+   * started */
+  std::vector<int> m_children;
 
   /** The current command, -1 signifies that none have been run */
   int m_currentCommandIndex = -1;
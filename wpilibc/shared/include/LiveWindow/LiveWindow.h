@@ -4,9 +4,15 @@
 #include "LiveWindow/LiveWindowSendable.h"
 #include "tables/ITable.h"
 #include "Commands/Scheduler.h"
+#include "HAL/cpp/priority_condition_variable.h"
+#include "HAL/cpp/priority_mutex.h"
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <memory>
+#include <thread>
+#include <utility>
 
 struct LiveWindowComponent {
   std::string subsystem;
@@ -26,10 +32,30 @@ struct LiveWindowComponent {
  * actuators
  * on the LiveWindow.
  *
+ * While LiveWindow is enabled, sensors are updated on a thread of their own
+ * rather than from the robot loop, each at its own update period. Sensors
+ * that publish their numbers with PublishNumber() skip the values that
+ * haven't changed by more than the change epsilon since they were last
+ * published. UpdateTable() is called without LiveWindow's lock held, so
+ * sensors can take locks of their own in it.
+ *
  * @author Brad Miller
  */
 class LiveWindow {
  public:
+  /// Default time between updates of a sensor, in seconds
+  static constexpr double kDefaultUpdatePeriod = 0.05;
+
+  struct UpdateStatistics {
+    uint32_t updates = 0;
+    uint32_t published = 0;   // numbers sent with PublishNumber()
+    uint32_t suppressed = 0;  // numbers not sent because they hadn't changed
+    // Time spent in UpdateTable(), in seconds
+    double lastTime = 0.0;
+    double averageTime = 0.0;
+    double maxTime = 0.0;
+  };
+
   static LiveWindow *GetInstance();
   void Run();
   DEPRECATED(
@@ -63,16 +89,52 @@ class LiveWindow {
   bool IsEnabled() const { return m_enabled; }
   void SetEnabled(bool enabled);
 
+  void SetUpdatePeriod(LiveWindowSendable *component, double seconds);
+  void SetDefaultUpdatePeriod(double seconds);
+  void SetChangeEpsilon(double epsilon);
+  void SetUpdateInBackground(bool background);
+  UpdateStatistics GetUpdateStatistics(LiveWindowSendable *component);
+
+  void PublishNumber(const std::shared_ptr<ITable> &table,
+                     const std::string &key, double value);
+
  protected:
   LiveWindow();
-  virtual ~LiveWindow() = default;
+  virtual ~LiveWindow();
 
  private:
-  void UpdateValues();
+  struct SensorUpdate {
+    std::shared_ptr<LiveWindowSendable> component;
+    double period;  // 0 for the default
+    double nextUpdate;
+    UpdateStatistics statistics;
+    double totalTime;
+  };
+
+  double UpdateValues();
+  void UpdateSensors();
+  void AddSensorUpdate(std::shared_ptr<LiveWindowSendable> component);
+  void StartUpdateThread();
+  void StopUpdateThread();
   void Initialize();
   void InitializeLiveWindowComponents();
 
-  std::vector<std::shared_ptr<LiveWindowSendable>> m_sensors;
+  priority_recursive_mutex m_mutex;
+  std::vector<SensorUpdate> m_sensors;
+  std::map<LiveWindowSendable *, double> m_updatePeriods;
+  double m_defaultUpdatePeriod = kDefaultUpdatePeriod;
+  double m_changeEpsilon = 0.0;
+  // The last number published under each key of each table
+  std::map<std::pair<ITable *, std::string>, double> m_lastValues;
+
+  // Held while sensors are updated, so only one thread updates them at once
+  priority_mutex m_updateMutex;
+  std::atomic<bool> m_updateInBackground{true};
+  bool m_updateThreadRunning = false;
+  // Set when the update periods change, to wake the update thread
+  bool m_updatePeriodsChanged = false;
+  std::thread m_updateThread;
+  priority_condition_variable m_updateCondition;
   std::map<std::shared_ptr<LiveWindowSendable>, LiveWindowComponent> m_components;
 
   std::shared_ptr<ITable> m_liveWindowTable;
@@ -80,7 +142,7 @@ class LiveWindow {
 
   Scheduler *m_scheduler;
 
-  bool m_enabled = false;
+  std::atomic<bool> m_enabled{false};
   bool m_firstTime = true;
 };
 
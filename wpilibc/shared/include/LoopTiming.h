@@ -0,0 +1,130 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.
+ */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+#pragma once
+
+#include "HAL/cpp/priority_mutex.h"
+#include "tables/ITable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Measures how long each phase of the robot main loop takes.
+ *
+ * IterativeRobot brackets each pass of its loop with StartLoop() and
+ * EndLoop(), and the Scheduler and LiveWindow time themselves with a Scope.
+ * A Scope opened inside another one on the same thread, like the Scheduler
+ * running from TeleopPeriodic(), takes its time out of the outer phase, so
+ * each phase only counts its own work and the phases add up to the loop.
+ *
+ * The loop time is the time spent between StartLoop() and EndLoop() less the
+ * time spent waiting for the DS.  When it exceeds the overrun threshold (by
+ * default the 20ms DS packet period) the overrun is counted and logged.
+ * Statistics and a histogram of loop times are published to the
+ * SmartDashboard under "LoopTiming".
+ *
+ * Times are measured with the steady clock rather than the FPGA time, so in
+ * simulation they are the real time the code took, not simulated time.
+ *
+ * The statistics may be read from any thread.  Timing is off by default;
+ * while disabled each Scope costs a single load and branch.
+ */
+class LoopTiming {
+ public:
+  enum Phase {
+    kDSWait,
+    kPeriodic,
+    kScheduler,
+    kLiveWindow,
+    kSmartDashboard,
+    kNumPhases
+  };
+
+  /** Width of a loop time histogram bucket, in seconds */
+  static constexpr double kHistogramBucketWidth = 0.001;
+  /** The last bucket collects every loop that took longer than the others */
+  static const int kHistogramBuckets = 41;
+
+  /**
+   * Times the enclosing block and adds it to a phase of the current loop.
+   */
+  class Scope {
+   public:
+    explicit Scope(Phase phase);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    Phase m_phase;
+    /** Whether timing was enabled when the Scope was opened */
+    bool m_active = false;
+    double m_start = 0.0;
+    /** Time spent in Scopes nested inside this one */
+    double m_nestedTime = 0.0;
+    Scope *m_outer = nullptr;
+  };
+
+  static LoopTiming *GetInstance();
+
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const { return m_enabled; }
+  void SetOverrunThreshold(double seconds);
+  void SetPublishInterval(int loops);
+
+  void StartLoop();
+  void EndLoop();
+  void AddPhaseTime(Phase phase, double seconds);
+
+  double GetLastPhaseTime(Phase phase) const;
+  double GetMaxPhaseTime(Phase phase) const;
+  double GetAveragePhaseTime(Phase phase) const;
+  uint32_t GetLoopCount() const;
+  uint32_t GetOverrunCount() const;
+  uint32_t GetHistogramBucket(int bucket) const;
+
+  void Reset();
+  void Publish();
+  void LogReport() const;
+
+  static std::string GetPhaseName(Phase phase);
+
+ private:
+  LoopTiming() = default;
+  virtual ~LoopTiming() = default;
+
+  /** The steady clock time in seconds */
+  static double Now() {
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  struct PhaseStats {
+    double current = 0.0;
+    double last = 0.0;
+    double max = 0.0;
+    double total = 0.0;
+  };
+
+  std::atomic<bool> m_enabled{false};
+  // Guards everything below
+  mutable priority_mutex m_mutex;
+  bool m_inLoop = false;
+  double m_overrunThreshold = 0.020;
+  int m_publishInterval = 50;
+  double m_loopStart = 0.0;
+  double m_nextOverrunMessageTime = 0.0;
+  PhaseStats m_phases[kNumPhases];
+  uint32_t m_histogram[kHistogramBuckets] = {};
+  uint32_t m_loopCount = 0;
+  uint32_t m_overrunCount = 0;
+  std::shared_ptr<ITable> m_table;
+};
@@ -0,0 +1,87 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.
+ */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "Buttons/ButtonEdgeDetector.h"
+
+#include "Buttons/JoystickButton.h"
+#include <algorithm>
+#include <iterator>
+
+const uint32_t ButtonEdgeDetector::kMaxButtons;
+
+ButtonEdgeDetector *ButtonEdgeDetector::GetInstance() {
+  static ButtonEdgeDetector instance;
+  return &instance;
+}
+
+/**
+ * Start delivering change notifications for a joystick button.
+ * @param stick The joystick port
+ * @param button The button index, beginning at 1
+ * @param listener The button to notify when the bit changes
+ * @return False if the button can't be tracked and has to be polled instead
+ */
+bool ButtonEdgeDetector::Register(uint32_t stick, uint32_t button,
+                                  JoystickButton *listener) {
+  if (stick >= DriverStation::kJoystickPorts || button == 0 ||
+      button > kMaxButtons)
+    return false;
+
+  std::lock_guard<priority_mutex> sync(m_listenersLock);
+  m_listeners[stick][button - 1].push_back(listener);
+  m_watchedButtons[stick] |= 1u << (button - 1);
+  m_newButtons[stick] |= 1u << (button - 1);
+  m_anyWatched = true;
+  return true;
+}
+
+void ButtonEdgeDetector::Unregister(uint32_t stick, uint32_t button,
+                                    JoystickButton *listener) {
+  if (stick >= DriverStation::kJoystickPorts || button == 0 ||
+      button > kMaxButtons)
+    return;
+
+  std::lock_guard<priority_mutex> sync(m_listenersLock);
+  auto &listeners = m_listeners[stick][button - 1];
+  listeners.erase(std::remove(listeners.begin(), listeners.end(), listener),
+                  listeners.end());
+  if (!listeners.empty()) return;
+  m_watchedButtons[stick] &= ~(1u << (button - 1));
+  if (m_watchedButtons[stick] == 0) {
+    m_anyWatched = std::any_of(std::begin(m_watchedButtons),
+                               std::end(m_watchedButtons),
+                               [](uint32_t watched) { return watched != 0; });
+  }
+}
+
+/**
+ * Read the button bitmask of each watched joystick, and notify the listeners
+ * of every bit that changed since the last call.
+ * This is called by the Scheduler at the start of each pass.
+ */
+void ButtonEdgeDetector::Poll() {
+  std::lock_guard<priority_mutex> sync(m_listenersLock);
+  if (!m_anyWatched) return;
+
+  DriverStation &ds = DriverStation::GetInstance();
+  for (uint32_t stick = 0; stick < DriverStation::kJoystickPorts; stick++) {
+    if (m_watchedButtons[stick] == 0) continue;
+
+    uint32_t buttons = ds.GetStickButtons(stick);
+    uint32_t changed =
+        ((buttons ^ m_lastButtons[stick]) | m_newButtons[stick]) &
+        m_watchedButtons[stick];
+    m_lastButtons[stick] = buttons;
+    m_newButtons[stick] = 0;
+
+    for (uint32_t bit = 0; changed != 0; bit++, changed >>= 1) {
+      if (changed & 1) {
+        for (auto listener : m_listeners[stick][bit]) listener->ButtonChanged();
+      }
+    }
+  }
+}
@@ -7,9 +7,31 @@
 
 #include "Buttons/ButtonScheduler.h"
 
+#include "Buttons/Trigger.h"
 #include "Commands/Scheduler.h"
 
 ButtonScheduler::ButtonScheduler(bool last, Trigger *button, Command *orders)
-    : m_pressedLast(last), m_button(button), m_command(orders) {}
+    : m_pressedLast(last),
+      m_button(button),
+      m_command(orders),
+      // Guarantee that the first pass through the Scheduler executes us
+      m_lastChangeCount(button->GetChangeCount() - 1) {}
 
 void ButtonScheduler::Start() { Scheduler::GetInstance()->AddButton(this); }
+
+/**
+ * Determine whether Execute() needs to be called on this pass of the
+ * Scheduler.
+ *
+ * Polled triggers are always executed.  Event driven triggers are only
+ * executed when their change count has moved since the last pass.
+ */
+bool ButtonScheduler::NeedsExecute() {
+  if (!m_button->IsEventDriven()) return true;
+  unsigned changeCount = m_button->GetChangeCount();
+  if (changeCount != m_lastChangeCount) {
+    m_lastChangeCount = changeCount;
+    return true;
+  }
+  return NeedsPolling();
+}
@@ -7,7 +7,34 @@
 
 #include "Buttons/JoystickButton.h"
 
+#include "Buttons/ButtonEdgeDetector.h"
+#include "Joystick.h"
+
+/**
+ * Create a button for triggering commands off a joystick's button.
+ *
+ * If the joystick is a Joystick, the button is driven by the
+ * ButtonEdgeDetector and only evaluated when its bit changes.  Other
+ * GenericHID implementations are polled every Scheduler pass.
+ *
+ * @param joystick The GenericHID object that has the button
+ * @param buttonNumber The button number (see GenericHID::GetRawButton())
+ */
 JoystickButton::JoystickButton(GenericHID *joystick, int buttonNumber)
-    : m_joystick(joystick), m_buttonNumber(buttonNumber) {}
+    : m_joystick(joystick), m_buttonNumber(buttonNumber) {
+  Joystick *stick = dynamic_cast<Joystick *>(joystick);
+  if (stick != nullptr &&
+      ButtonEdgeDetector::GetInstance()->Register(stick->GetPort(),
+                                                  buttonNumber, this)) {
+    m_stick = stick->GetPort();
+  }
+}
+
+JoystickButton::~JoystickButton() {
+  if (m_stick >= 0) {
+    ButtonEdgeDetector::GetInstance()->Unregister(m_stick, m_buttonNumber,
+                                                  this);
+  }
+}
 
 bool JoystickButton::Get() { return m_joystick->GetRawButton(m_buttonNumber); }
@@ -9,17 +9,21 @@
 #include "networktables/NetworkTable.h"
 
 NetworkButton::NetworkButton(const std::string &tableName, const std::string &field)
-    :  // TODO how is this supposed to work???
-      m_netTable(NetworkTable::GetTable(tableName)),
-      m_field(field) {}
+    : NetworkButton(NetworkTable::GetTable(tableName), field) {}
 
 NetworkButton::NetworkButton(std::shared_ptr<ITable> table, const std::string &field)
-    : m_netTable(table), m_field(field) {}
+    : m_netTable(table), m_field(field) {
+  // Immediately notify so the cached value starts out current
+  m_netTable->AddTableListener(m_field, this, true);
+}
+
+NetworkButton::~NetworkButton() { m_netTable->RemoveTableListener(this); }
+
+bool NetworkButton::Get() { return m_pressed; }
 
-bool NetworkButton::Get() {
-  /*if (m_netTable->isConnected())
-          return m_netTable->GetBoolean(m_field.c_str());
-  else
-          return false;*/
-  return m_netTable->GetBoolean(m_field, false);
+void NetworkButton::ValueChanged(ITable *source, llvm::StringRef key,
+                                 std::shared_ptr<nt::Value> value, bool isNew) {
+  // A deleted field reports no value, and counts as released.
+  bool pressed = value && value->IsBoolean() && value->GetBoolean();
+  if (m_pressed.exchange(pressed) != pressed) NotifyChanged();
 }
@@ -50,6 +50,16 @@ void Trigger::ToggleWhenActive(Command *command) {
   tbs->Start();
 }
 
+/**
+ * Returns true if the state of this trigger can only change when
+ * NotifyChanged() is called, so polling it every Scheduler pass is
+ * unnecessary.  A trigger published to the SmartDashboard can be pressed from
+ * the dashboard at any time, so it is always polled.
+ */
+bool Trigger::IsEventDriven() const {
+  return HasChangeNotification() && m_table == nullptr;
+}
+
 std::string Trigger::GetSmartDashboardType() const { return "Button"; }
 
 void Trigger::InitTable(std::shared_ptr<ITable> table) {
@@ -8,6 +8,8 @@
 #include "Commands/CommandGroup.h"
 #include "WPIErrors.h"
 
+#include <algorithm>
+
 /**
  * Creates a new {@link CommandGroup CommandGroup} with the given name.
  * @param name the name for this command group
@@ -40,11 +42,8 @@ void CommandGroup::AddSequential(Command *command) {
 
   m_commands.push_back(
       CommandGroupEntry(command, CommandGroupEntry::kSequence_InSequence));
-  // Iterate through command->GetRequirements() and call Requires() on each
-  // required subsystem
-  Command::SubsystemSet requirements = command->GetRequirements();
-  auto iter = requirements.begin();
-  for (; iter != requirements.end(); iter++) Requires(*iter);
+  // Call Requires() on each subsystem the command requires
+  for (Subsystem *subsystem : command->m_requirements) Requires(subsystem);
 }
 
 /**
@@ -84,11 +83,8 @@ void CommandGroup::AddSequential(Command *command, double timeout) {
 
   m_commands.push_back(CommandGroupEntry(
       command, CommandGroupEntry::kSequence_InSequence, timeout));
-  // Iterate through command->GetRequirements() and call Requires() on each
-  // required subsystem
-  Command::SubsystemSet requirements = command->GetRequirements();
-  auto iter = requirements.begin();
-  for (; iter != requirements.end(); iter++) Requires(*iter);
+  // Call Requires() on each subsystem the command requires
+  for (Subsystem *subsystem : command->m_requirements) Requires(subsystem);
 }
 
 /**
@@ -127,11 +123,8 @@ void CommandGroup::AddParallel(Command *command) {
 
   m_commands.push_back(
       CommandGroupEntry(command, CommandGroupEntry::kSequence_BranchChild));
-  // Iterate through command->GetRequirements() and call Requires() on each
-  // required subsystem
-  Command::SubsystemSet requirements = command->GetRequirements();
-  auto iter = requirements.begin();
-  for (; iter != requirements.end(); iter++) Requires(*iter);
+  // Call Requires() on each subsystem the command requires
+  for (Subsystem *subsystem : command->m_requirements) Requires(subsystem);
 }
 
 /**
@@ -182,17 +175,18 @@ void CommandGroup::AddParallel(Command *command, double timeout) {
 
   m_commands.push_back(CommandGroupEntry(
       command, CommandGroupEntry::kSequence_BranchChild, timeout));
-  // Iterate through command->GetRequirements() and call Requires() on each
-  // required subsystem
-  Command::SubsystemSet requirements = command->GetRequirements();
-  auto iter = requirements.begin();
-  for (; iter != requirements.end(); iter++) Requires(*iter);
+  // Call Requires() on each subsystem the command requires
+  for (Subsystem *subsystem : command->m_requirements) Requires(subsystem);
 }
 
-void CommandGroup::_Initialize() { m_currentCommandIndex = -1; }
+void CommandGroup::_Initialize() {
+  // The group is locked once it has been started, so its commands can't
+  // change from here on
+  if (!m_scheduleCompiled) CompileSchedule();
+  m_currentCommandIndex = -1;
+}
 
 void CommandGroup::_Execute() {
-  CommandGroupEntry entry;
   Command *cmd = nullptr;
   bool firstRun = false;
 
@@ -202,6 +196,8 @@ void CommandGroup::_Execute() {
   }
 
   while ((unsigned)m_currentCommandIndex < m_commands.size()) {
+    const CommandGroupEntry &entry = m_commands[m_currentCommandIndex];
+
     if (cmd != nullptr) {
       if (entry.IsTimedOut()) cmd->_Cancel();
 
@@ -216,15 +212,12 @@ void CommandGroup::_Execute() {
       }
     }
 
-    entry = m_commands[m_currentCommandIndex];
-    cmd = nullptr;
-
     switch (entry.m_state) {
       case CommandGroupEntry::kSequence_InSequence:
         cmd = entry.m_command;
         if (firstRun) {
           cmd->StartRunning();
-          CancelConflicts(cmd);
+          CancelConflicts(m_currentCommandIndex);
           firstRun = false;
         }
         break;
@@ -235,28 +228,28 @@ void CommandGroup::_Execute() {
         break;
 
       case CommandGroupEntry::kSequence_BranchChild:
-        m_currentCommandIndex++;
-        CancelConflicts(entry.m_command);
+        CancelConflicts(m_currentCommandIndex);
         entry.m_command->StartRunning();
-        m_children.push_back(entry);
+        m_children.push_back(m_currentCommandIndex);
+        m_currentCommandIndex++;
         break;
     }
   }
 
-  // Run Children
-  auto iter = m_children.begin();
-  for (; iter != m_children.end();) {
-    entry = *iter;
+  // Run Children, keeping the ones that haven't finished in order
+  size_t kept = 0;
+  for (size_t i = 0; i < m_children.size(); i++) {
+    const CommandGroupEntry &entry = m_commands[m_children[i]];
     Command *child = entry.m_command;
     if (entry.IsTimedOut()) child->_Cancel();
 
     if (!child->Run()) {
       child->Removed();
-      iter = m_children.erase(iter);
     } else {
-      iter++;
+      m_children[kept++] = m_children[i];
     }
   }
+  m_children.resize(kept);
 }
 
 void CommandGroup::_End() {
@@ -269,9 +262,8 @@ void CommandGroup::_End() {
     cmd->Removed();
   }
 
-  auto iter = m_children.begin();
-  for (; iter != m_children.end(); iter++) {
-    Command *cmd = iter->m_command;
+  for (int child : m_children) {
+    Command *cmd = m_commands[child].m_command;
     cmd->_Cancel();
     cmd->Removed();
   }
@@ -306,33 +298,67 @@ bool CommandGroup::IsInterruptible() const {
     if (!cmd->IsInterruptible()) return false;
   }
 
-  auto iter = m_children.cbegin();
-  for (; iter != m_children.cend(); iter++) {
-    if (!iter->m_command->IsInterruptible()) return false;
+  for (int child : m_children) {
+    if (!m_commands[child].m_command->IsInterruptible()) return false;
   }
 
   return true;
 }
 
-void CommandGroup::CancelConflicts(Command *command) {
-  auto childIter = m_children.begin();
-  for (; childIter != m_children.end();) {
-    Command *child = childIter->m_command;
-    bool erased = false;
-
-    Command::SubsystemSet requirements = command->GetRequirements();
-    auto requirementIter = requirements.begin();
-    for (; requirementIter != requirements.end(); requirementIter++) {
-      if (child->DoesRequire(*requirementIter)) {
-        child->_Cancel();
-        child->Removed();
-        childIter = m_children.erase(childIter);
-        erased = true;
-        break;
-      }
+/**
+ * Build the requirement bitmasks for the group's commands. Each subsystem the
+ * group requires, which includes everything its commands require, is given a
+ * bit.
+ */
+void CommandGroup::CompileSchedule() {
+  std::vector<Subsystem *> subsystems(m_requirements.begin(),
+                                      m_requirements.end());
+
+  m_maskWords = (subsystems.size() + 63) / 64;
+  m_requirementMasks.assign(m_commands.size() * m_maskWords, 0);
+  for (size_t i = 0; i < m_commands.size(); i++) {
+    uint64_t *mask = m_requirementMasks.data() + i * m_maskWords;
+    for (Subsystem *subsystem : m_commands[i].m_command->m_requirements) {
+      size_t bit = std::find(subsystems.begin(), subsystems.end(), subsystem) -
+                   subsystems.begin();
+      mask[bit / 64] |= 1ull << (bit % 64);
+    }
+  }
+
+  m_children.reserve(m_commands.size());
+  m_scheduleCompiled = true;
+}
+
+/**
+ * @return whether the commands at the two indices require any of the same
+ * subsystems
+ */
+bool CommandGroup::Conflicts(int first, int second) const {
+  const uint64_t *firstMask = m_requirementMasks.data() + first * m_maskWords;
+  const uint64_t *secondMask =
+      m_requirementMasks.data() + second * m_maskWords;
+  for (size_t word = 0; word < m_maskWords; word++) {
+    if (firstMask[word] & secondMask[word]) return true;
+  }
+  return false;
+}
+
+/**
+ * Cancel the children that require any of the subsystems the command at the
+ * given index requires.
+ */
+void CommandGroup::CancelConflicts(int index) {
+  size_t kept = 0;
+  for (size_t i = 0; i < m_children.size(); i++) {
+    if (Conflicts(index, m_children[i])) {
+      Command *child = m_commands[m_children[i]].m_command;
+      child->_Cancel();
+      child->Removed();
+    } else {
+      m_children[kept++] = m_children[i];
     }
-    if (!erased) childIter++;
   }
+  m_children.resize(kept);
 }
 
 int CommandGroup::GetSize() const { return m_children.size(); }
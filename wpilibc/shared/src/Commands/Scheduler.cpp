@@ -7,9 +7,11 @@
 
 #include "Commands/Scheduler.h"
 
+#include "Buttons/ButtonEdgeDetector.h"
 #include "Buttons/ButtonScheduler.h"
 #include "Commands/Subsystem.h"
 #include "HLUsageReporting.h"
+#include "LoopTiming.h"
 #include "WPIErrors.h"
 #include <iostream>
 #include <set>
@@ -98,7 +100,8 @@ void Scheduler::ProcessCommandAddition(Command *command) {
  * {@link Command} system.  The loop has five stages:
  *
  * <ol>
- * <li> Poll the Buttons </li>
+ * <li> Poll the Buttons (only those whose triggers changed, or that can't
+ * report changes) </li>
  * <li> Execute/Remove the Commands </li>
  * <li> Send values to SmartDashboard </li>
  * <li> Add Commands </li>
@@ -106,14 +109,19 @@ void Scheduler::ProcessCommandAddition(Command *command) {
  * </ol>
  */
 void Scheduler::Run() {
+  LoopTiming::Scope timing(LoopTiming::kScheduler);
+
   // Get button input (going backwards preserves button priority)
   {
     if (!m_enabled) return;
 
+    // Wake the joystick buttons whose bits changed since the last pass
+    ButtonEdgeDetector::GetInstance()->Poll();
+
     std::lock_guard<priority_mutex> sync(m_buttonsLock);
     auto rButtonIter = m_buttons.rbegin();
     for (; rButtonIter != m_buttons.rend(); rButtonIter++) {
-      (*rButtonIter)->Execute();
+      if ((*rButtonIter)->NeedsExecute()) (*rButtonIter)->Execute();
     }
   }
 
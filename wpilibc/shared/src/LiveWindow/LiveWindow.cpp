@@ -1,8 +1,16 @@
 #include "LiveWindow/LiveWindow.h"
+#include "LoopTiming.h"
+#include "Timer.h"
+#include "WPIErrors.h"
 #include "networktables/NetworkTable.h"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <sstream>
 
+// The statistics of the sensor being updated on this thread, if any
+static thread_local LiveWindow::UpdateStatistics *updatingStatistics = nullptr;
+
 /**
  * Get an instance of the LiveWindow main class
  * This is a singleton to guarantee that there is only a single instance
@@ -23,6 +31,8 @@ LiveWindow::LiveWindow() : m_scheduler(Scheduler::GetInstance()) {
   m_statusTable = m_liveWindowTable->GetSubTable("~STATUS~");
 }
 
+LiveWindow::~LiveWindow() { StopUpdateThread(); }
+
 /**
  * Change the enabled status of LiveWindow
  * If it changes to enabled, start livewindow running otherwise stop it
@@ -30,6 +40,11 @@ LiveWindow::LiveWindow() : m_scheduler(Scheduler::GetInstance()) {
 void LiveWindow::SetEnabled(bool enabled) {
   if (m_enabled == enabled) return;
   if (enabled) {
+    {
+      // The tables may have been changed while LiveWindow was disabled
+      std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+      m_lastValues.clear();
+    }
     if (m_firstTime) {
       InitializeLiveWindowComponents();
       m_firstTime = false;
@@ -39,7 +54,9 @@ void LiveWindow::SetEnabled(bool enabled) {
     for (auto& elem : m_components) {
       elem.first->StartLiveWindowMode();
     }
+    if (m_updateInBackground) StartUpdateThread();
   } else {
+    StopUpdateThread();
     for (auto& elem : m_components) {
       elem.first->StopLiveWindowMode();
     }
@@ -141,11 +158,8 @@ void LiveWindow::AddSensor(std::string type, int channel,
   types.copy(cc, types.size());
   cc[types.size()] = '\0';
   AddSensor("Ungrouped", cc, component);
-  std::shared_ptr<LiveWindowSendable> component_stl(
-      component, NullDeleter<LiveWindowSendable>());
-  if (std::find(m_sensors.begin(), m_sensors.end(), component_stl) ==
-      m_sensors.end())
-    m_sensors.push_back(component_stl);
+  AddSensorUpdate(std::shared_ptr<LiveWindowSendable>(
+      component, NullDeleter<LiveWindowSendable>()));
 }
 
 /**
@@ -179,22 +193,209 @@ void LiveWindow::AddActuator(std::string type, int module, int channel,
 }
 
 /**
- * Tell all the sensors to update (send) their values
+ * Set how often a sensor is updated.
+ * Components can call this when they are created to declare their own rate,
+ * and robot programs can call it to change it.
+ * @param component The sensor
+ * @param seconds The time between updates, greater than 0
+ */
+void LiveWindow::SetUpdatePeriod(LiveWindowSendable *component,
+                                 double seconds) {
+  if (!(seconds > 0.0)) {
+    wpi_setGlobalWPIErrorWithContext(ParameterOutOfRange,
+                                     "Update period must be positive");
+    return;
+  }
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_updatePeriods[component] = seconds;
+  for (auto &sensor : m_sensors) {
+    if (sensor.component.get() == component) {
+      sensor.period = seconds;
+      sensor.nextUpdate = 0.0;
+    }
+  }
+  m_updatePeriodsChanged = true;
+  m_updateCondition.notify_all();
+}
+
+/**
+ * Set how often the sensors without an update period of their own are
+ * updated.
+ * @param seconds The time between updates, greater than 0
+ */
+void LiveWindow::SetDefaultUpdatePeriod(double seconds) {
+  if (!(seconds > 0.0)) {
+    wpi_setGlobalWPIErrorWithContext(ParameterOutOfRange,
+                                     "Update period must be positive");
+    return;
+  }
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_defaultUpdatePeriod = seconds;
+  m_updatePeriodsChanged = true;
+  m_updateCondition.notify_all();
+}
+
+/**
+ * Set how much a number has to change by to be published again.
+ * With the default of 0, only numbers that are exactly the same are skipped.
+ */
+void LiveWindow::SetChangeEpsilon(double epsilon) {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  m_changeEpsilon = epsilon;
+}
+
+/**
+ * Set whether the sensors are updated on a thread of their own, which is the
+ * default, or from Run() in the robot loop.
+ */
+void LiveWindow::SetUpdateInBackground(bool background) {
+  if (m_updateInBackground.exchange(background) == background) return;
+  if (!m_enabled) return;
+  if (background)
+    StartUpdateThread();
+  else
+    StopUpdateThread();
+}
+
+/**
+ * Get how many times a sensor has been updated, how many of its numbers were
+ * published or skipped, and how long its updates take.
+ */
+LiveWindow::UpdateStatistics LiveWindow::GetUpdateStatistics(
+    LiveWindowSendable *component) {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  for (auto &sensor : m_sensors) {
+    if (sensor.component.get() == component) return sensor.statistics;
+  }
+  return UpdateStatistics();
+}
+
+/**
+ * Put a number in a sensor's table, unless it is within the change epsilon
+ * of the number last published under the same key.
+ * Sensors call this from UpdateTable().
+ */
+void LiveWindow::PublishNumber(const std::shared_ptr<ITable> &table,
+                               const std::string &key, double value) {
+  if (table == nullptr) return;
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  auto last = m_lastValues.find(std::make_pair(table.get(), key));
+  if (last != m_lastValues.end() &&
+      std::fabs(value - last->second) <= m_changeEpsilon) {
+    if (updatingStatistics != nullptr) updatingStatistics->suppressed++;
+    return;
+  }
+  if (last != m_lastValues.end())
+    last->second = value;
+  else
+    m_lastValues[std::make_pair(table.get(), key)] = value;
+  if (updatingStatistics != nullptr) updatingStatistics->published++;
+  table->PutNumber(key, value);
+}
+
+void LiveWindow::AddSensorUpdate(
+    std::shared_ptr<LiveWindowSendable> component) {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  for (auto &sensor : m_sensors) {
+    if (sensor.component.get() == component.get()) return;
+  }
+  auto period = m_updatePeriods.find(component.get());
+  m_sensors.push_back(SensorUpdate{
+      component, period != m_updatePeriods.end() ? period->second : 0.0, 0.0,
+      UpdateStatistics(), 0.0});
+}
+
+/**
+ * Tell the sensors that are due for an update to update (send) their values
  * Actuators are handled through callbacks on their value changing from the
  * SmartDashboard widgets.
+ * Each sensor is updated with the lock released, since UpdateTable() may take
+ * locks of its own that other threads hold while calling into LiveWindow.
+ * @return The time when the next sensor is due
  */
-void LiveWindow::UpdateValues() {
-  for (auto& elem : m_sensors) {
-    elem->UpdateTable();
+double LiveWindow::UpdateValues() {
+  std::lock_guard<priority_mutex> updating(m_updateMutex);
+  std::unique_lock<priority_recursive_mutex> lock(m_mutex);
+  double now = Timer::GetFPGATimestamp();
+  double next = now + m_defaultUpdatePeriod;
+  // Sensors are only ever appended, so the indexes stay valid while unlocked
+  for (size_t i = 0; i < m_sensors.size(); i++) {
+    if (m_sensors[i].nextUpdate <= now) {
+      std::shared_ptr<LiveWindowSendable> component = m_sensors[i].component;
+      lock.unlock();
+      UpdateStatistics counts;
+      updatingStatistics = &counts;
+      double start = Timer::GetFPGATimestamp();
+      component->UpdateTable();
+      double time = Timer::GetFPGATimestamp() - start;
+      updatingStatistics = nullptr;
+      lock.lock();
+
+      SensorUpdate &sensor = m_sensors[i];
+      UpdateStatistics &statistics = sensor.statistics;
+      statistics.updates++;
+      statistics.published += counts.published;
+      statistics.suppressed += counts.suppressed;
+      statistics.lastTime = time;
+      statistics.maxTime = std::max(statistics.maxTime, time);
+      sensor.totalTime += time;
+      statistics.averageTime = sensor.totalTime / statistics.updates;
+
+      // Keep to the period, but don't try to catch up on missed updates
+      double period =
+          sensor.period > 0.0 ? sensor.period : m_defaultUpdatePeriod;
+      sensor.nextUpdate += period;
+      if (sensor.nextUpdate <= now) sensor.nextUpdate = now + period;
+    }
+    next = std::min(next, m_sensors[i].nextUpdate);
+  }
+  return next;
+}
+
+/**
+ * Update the sensors as they come due, until the update thread is stopped.
+ */
+void LiveWindow::UpdateSensors() {
+  std::unique_lock<priority_recursive_mutex> lock(m_mutex);
+  while (m_updateThreadRunning) {
+    m_updatePeriodsChanged = false;
+    lock.unlock();
+    double next = UpdateValues();
+    lock.lock();
+    double wait = next - Timer::GetFPGATimestamp();
+    if (wait > 0.0) {
+      m_updateCondition.wait_for(
+          lock, std::chrono::microseconds(static_cast<int64_t>(wait * 1e6)),
+          [&] { return !m_updateThreadRunning || m_updatePeriodsChanged; });
+    }
+  }
+}
+
+void LiveWindow::StartUpdateThread() {
+  std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+  if (m_updateThreadRunning) return;
+  m_updateThreadRunning = true;
+  m_updateThread = std::thread(&LiveWindow::UpdateSensors, this);
+}
+
+void LiveWindow::StopUpdateThread() {
+  {
+    std::lock_guard<priority_recursive_mutex> lock(m_mutex);
+    if (!m_updateThreadRunning) return;
+    m_updateThreadRunning = false;
   }
+  m_updateCondition.notify_all();
+  m_updateThread.join();
 }
 
 /**
- * This method is called periodically to cause the sensors to send new values
- * to the SmartDashboard.
+ * This method is called periodically from the robot loop. Unless the sensors
+ * are updated in the background, it causes the sensors that are due to send
+ * new values to the SmartDashboard.
  */
 void LiveWindow::Run() {
-  if (m_enabled) {
+  if (m_enabled && !m_updateInBackground) {
+    LoopTiming::Scope timing(LoopTiming::kLiveWindow);
     UpdateValues();
   }
 }
@@ -221,7 +422,7 @@ void LiveWindow::InitializeLiveWindowComponents() {
     table->PutString("Subsystem", subsystem);
     component->InitTable(table);
     if (c.isSensor) {
-      m_sensors.push_back(component);
+      AddSensorUpdate(component);
     }
   }
 }
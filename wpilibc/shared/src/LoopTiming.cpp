@@ -0,0 +1,279 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.
+ */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "LoopTiming.h"
+
+#include "networktables/NetworkTable.h"
+#include "Log.hpp"
+#include <vector>
+
+constexpr double LoopTiming::kHistogramBucketWidth;
+const int LoopTiming::kHistogramBuckets;
+
+// Minimum time between two overrun messages in the log
+const double OVERRUN_MESSAGE_INTERVAL = 1.0;
+
+// The innermost Scope open on this thread
+static thread_local LoopTiming::Scope *currentScope = nullptr;
+
+LoopTiming::Scope::Scope(Phase phase) : m_phase(phase) {
+  if (!GetInstance()->IsEnabled()) return;
+  m_active = true;
+  m_start = Now();
+  m_outer = currentScope;
+  currentScope = this;
+}
+
+LoopTiming::Scope::~Scope() {
+  if (!m_active) return;
+  currentScope = m_outer;
+  double elapsed = Now() - m_start;
+  if (m_outer != nullptr) m_outer->m_nestedTime += elapsed;
+  GetInstance()->AddPhaseTime(m_phase, elapsed - m_nestedTime);
+}
+
+LoopTiming *LoopTiming::GetInstance() {
+  static LoopTiming instance;
+  return &instance;
+}
+
+/**
+ * Turn loop timing on or off.
+ * Statistics are kept across calls; use Reset() to clear them.
+ */
+void LoopTiming::SetEnabled(bool enabled) {
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  m_enabled = enabled;
+  m_inLoop = false;
+}
+
+/**
+ * Set the loop time above which a loop is counted as an overrun.
+ * @param seconds The threshold, by default the DS packet period of 20ms
+ */
+void LoopTiming::SetOverrunThreshold(double seconds) {
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  m_overrunThreshold = seconds;
+}
+
+/**
+ * Set how often the statistics are published to the SmartDashboard.
+ * @param loops The number of loops between publishes, or 0 to never publish
+ */
+void LoopTiming::SetPublishInterval(int loops) {
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  m_publishInterval = loops;
+}
+
+/**
+ * Mark the start of a pass through the main loop.
+ */
+void LoopTiming::StartLoop() {
+  if (!m_enabled) return;
+  double now = Now();
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  m_loopStart = now;
+  m_inLoop = true;
+}
+
+/**
+ * Mark the end of a pass through the main loop.
+ *
+ * This folds the phase times accumulated since StartLoop() into the
+ * statistics, counts an overrun if the loop took longer than the threshold and
+ * periodically publishes the statistics.  The wait for DS data has to be timed
+ * before this is called to be counted in the loop.
+ */
+void LoopTiming::EndLoop() {
+  if (!m_enabled) return;
+
+  // Publishing is timed as part of the loop it happens in, so do it before
+  // the phase times are folded in.  What it publishes is up to the last loop.
+  bool publish;
+  {
+    std::lock_guard<priority_mutex> sync(m_mutex);
+    if (!m_inLoop) return;
+    publish = m_publishInterval > 0 &&
+              (m_loopCount + 1) % m_publishInterval == 0;
+  }
+  if (publish) {
+    Scope publishing(kSmartDashboard);
+    Publish();
+  }
+
+  double now = Now();
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  if (!m_inLoop) return;
+  m_inLoop = false;
+
+  double loopTime = now - m_loopStart - m_phases[kDSWait].current;
+  m_loopCount++;
+
+  for (auto &phase : m_phases) {
+    phase.last = phase.current;
+    phase.total += phase.current;
+    if (phase.current > phase.max) phase.max = phase.current;
+    phase.current = 0.0;
+  }
+
+  int bucket = static_cast<int>(loopTime / kHistogramBucketWidth);
+  if (bucket >= kHistogramBuckets) bucket = kHistogramBuckets - 1;
+  m_histogram[bucket]++;
+
+  if (loopTime > m_overrunThreshold) {
+    m_overrunCount++;
+    if (now > m_nextOverrunMessageTime) {
+      Log().Get(logWARNING)
+          << "Loop overrun: " << loopTime * 1000.0 << "ms (periodic "
+          << m_phases[kPeriodic].last * 1000.0 << "ms, scheduler "
+          << m_phases[kScheduler].last * 1000.0 << "ms, LiveWindow "
+          << m_phases[kLiveWindow].last * 1000.0 << "ms)";
+      m_nextOverrunMessageTime = now + OVERRUN_MESSAGE_INTERVAL;
+    }
+  }
+}
+
+/**
+ * Add time to a phase of the current loop.
+ * Called by Scope; a phase may be entered several times in one loop.
+ */
+void LoopTiming::AddPhaseTime(Phase phase, double seconds) {
+  if (!m_enabled || phase < 0 || phase >= kNumPhases) return;
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  m_phases[phase].current += seconds;
+}
+
+/**
+ * @return The time spent in the phase during the last complete loop, in
+ * seconds
+ */
+double LoopTiming::GetLastPhaseTime(Phase phase) const {
+  if (phase < 0 || phase >= kNumPhases) return 0.0;
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  return m_phases[phase].last;
+}
+
+/**
+ * @return The longest time spent in the phase in a single loop, in seconds
+ */
+double LoopTiming::GetMaxPhaseTime(Phase phase) const {
+  if (phase < 0 || phase >= kNumPhases) return 0.0;
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  return m_phases[phase].max;
+}
+
+/**
+ * @return The average time spent in the phase per loop, in seconds
+ */
+double LoopTiming::GetAveragePhaseTime(Phase phase) const {
+  if (phase < 0 || phase >= kNumPhases) return 0.0;
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  if (m_loopCount == 0) return 0.0;
+  return m_phases[phase].total / m_loopCount;
+}
+
+/**
+ * @return The number of loops timed since the last Reset()
+ */
+uint32_t LoopTiming::GetLoopCount() const {
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  return m_loopCount;
+}
+
+/**
+ * @return The number of those loops that took longer than the overrun
+ * threshold
+ */
+uint32_t LoopTiming::GetOverrunCount() const {
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  return m_overrunCount;
+}
+
+/**
+ * @param bucket The histogram bucket, each kHistogramBucketWidth wide
+ * @return The number of loops whose time fell into the bucket
+ */
+uint32_t LoopTiming::GetHistogramBucket(int bucket) const {
+  if (bucket < 0 || bucket >= kHistogramBuckets) return 0;
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  return m_histogram[bucket];
+}
+
+/**
+ * Clear all statistics.
+ */
+void LoopTiming::Reset() {
+  std::lock_guard<priority_mutex> sync(m_mutex);
+  for (auto &phase : m_phases) phase = PhaseStats();
+  for (auto &count : m_histogram) count = 0;
+  m_loopCount = 0;
+  m_overrunCount = 0;
+}
+
+/**
+ * Send the statistics to the "LoopTiming" table of the SmartDashboard.
+ */
+void LoopTiming::Publish() {
+  if (m_table == nullptr) {
+    m_table = NetworkTable::GetTable("SmartDashboard")->GetSubTable("LoopTiming");
+  }
+
+  for (int i = 0; i < kNumPhases; i++) {
+    Phase phase = static_cast<Phase>(i);
+    std::string name = GetPhaseName(phase);
+    m_table->PutNumber(name + " Last (ms)", GetLastPhaseTime(phase) * 1000.0);
+    m_table->PutNumber(name + " Max (ms)", GetMaxPhaseTime(phase) * 1000.0);
+    m_table->PutNumber(name + " Average (ms)",
+                       GetAveragePhaseTime(phase) * 1000.0);
+  }
+  m_table->PutNumber("Loops", GetLoopCount());
+  m_table->PutNumber("Overruns", GetOverrunCount());
+
+  std::vector<double> histogram(kHistogramBuckets);
+  for (int i = 0; i < kHistogramBuckets; i++)
+    histogram[i] = GetHistogramBucket(i);
+  m_table->PutValue("Histogram", nt::Value::MakeDoubleArray(histogram));
+}
+
+/**
+ * Print the statistics and the non-empty histogram buckets to the log.
+ */
+void LoopTiming::LogReport() const {
+  Log log;
+  std::ostringstream &os = log.Get(logINFO);
+  os << "Loop timing over " << GetLoopCount() << " loops, "
+     << GetOverrunCount() << " overruns";
+  for (int i = 0; i < kNumPhases; i++) {
+    Phase phase = static_cast<Phase>(i);
+    os << "\n  " << GetPhaseName(phase) << ": average "
+       << GetAveragePhaseTime(phase) * 1000.0 << "ms, max "
+       << GetMaxPhaseTime(phase) * 1000.0 << "ms";
+  }
+  for (int i = 0; i < kHistogramBuckets; i++) {
+    uint32_t count = GetHistogramBucket(i);
+    if (count == 0) continue;
+    os << "\n  " << i * kHistogramBucketWidth * 1000.0
+       << (i == kHistogramBuckets - 1 ? "+" : "") << "ms: " << count;
+  }
+}
+
+std::string LoopTiming::GetPhaseName(Phase phase) {
+  switch (phase) {
+    case kDSWait:
+      return "DS Wait";
+    case kPeriodic:
+      return "Periodic";
+    case kScheduler:
+      return "Scheduler";
+    case kLiveWindow:
+      return "LiveWindow";
+    case kSmartDashboard:
+      return "SmartDashboard";
+    default:
+      return "Unknown";
+  }
+}
@@ -11,7 +11,10 @@
 #include "HAL/cpp/Semaphore.hpp"
 #include "HAL/cpp/priority_mutex.h"
 #include "HAL/cpp/priority_condition_variable.h"
+#include "simulation/SimFloatInput.h"
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 
 struct HALControlWord;
 class AnalogInput;
@@ -29,8 +32,11 @@ class DriverStation : public SensorBase, public RobotStateInterface {
   static void ReportError(std::string error);
 
   static const uint32_t kJoystickPorts = 6;
+  /// The battery voltage below which the roboRIO browns out.
+  static constexpr float kBrownoutVoltage = 6.8;
 
   float GetStickAxis(uint32_t stick, uint32_t axis);
+  void GetStickAxes(uint32_t stick, HALJoystickAxes &axes) const;
   int GetStickPOV(uint32_t stick, uint32_t pov);
   uint32_t GetStickButtons(uint32_t stick) const;
   bool GetStickButton(uint32_t stick, uint8_t button);
@@ -58,6 +64,8 @@ class DriverStation : public SensorBase, public RobotStateInterface {
   Alliance GetAlliance() const;
   uint32_t GetLocation() const;
   void WaitForData();
+  /** The number of DS packets received; changes whenever new data arrives */
+  uint32_t GetPacketCount() const { return m_packetCount; }
   double GetMatchTime() const;
   float GetBatteryVoltage() const;
 
@@ -99,6 +107,7 @@ class DriverStation : public SensorBase, public RobotStateInterface {
   HALJoystickPOVs m_joystickPOVs[kJoystickPorts];
   HALJoystickButtons m_joystickButtons[kJoystickPorts];
   HALJoystickDescriptor m_joystickDescriptor[kJoystickPorts];
+  std::atomic<uint32_t> m_packetCount{0};
   mutable Semaphore m_newControlData{Semaphore::kEmpty};
   mutable priority_condition_variable m_packetDataAvailableCond;
   priority_mutex m_packetDataAvailableMutex;
@@ -109,4 +118,5 @@ class DriverStation : public SensorBase, public RobotStateInterface {
   bool m_userInTeleop = false;
   bool m_userInTest = false;
   double m_nextMessageTime = 0;
+  std::unique_ptr<SimFloatInput> m_batteryVoltage;
 };
@@ -63,6 +63,8 @@ public:
 	double GetPeriod();
 	double GetLoopsPerSec();
 
+	void EnableLoopTiming(bool enabled, double overrunThreshold = 0.020);
+
 protected:
 	virtual ~IterativeRobot() = default;
 	IterativeRobot() = default;
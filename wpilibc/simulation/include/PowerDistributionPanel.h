@@ -0,0 +1,43 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2014. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+#pragma once
+
+#include "simulation/SimFloatInput.h"
+#include "SensorBase.h"
+#include "LiveWindow/LiveWindowSendable.h"
+
+#include <memory>
+
+/**
+ * Class for getting voltage, current and power from the simulated PDP.
+ *
+ * The currents come from dc_motor plugins given a pdp_channel, and the
+ * voltage from the battery they share.
+ */
+class PowerDistributionPanel : public SensorBase, public LiveWindowSendable {
+ public:
+  static const uint8_t kNumChannels = 16;
+
+  PowerDistributionPanel();
+  PowerDistributionPanel(uint8_t module);
+
+  double GetVoltage() const;
+  double GetCurrent(uint8_t channel) const;
+  double GetTotalCurrent() const;
+  double GetTotalPower() const;
+
+  void UpdateTable() override;
+  void StartLiveWindowMode() override;
+  void StopLiveWindowMode() override;
+  std::string GetSmartDashboardType() const override;
+  void InitTable(std::shared_ptr<ITable> subTable) override;
+  std::shared_ptr<ITable> GetTable() const override;
+
+ private:
+  std::shared_ptr<ITable> m_table = nullptr;
+  std::unique_ptr<SimFloatInput> m_voltage;
+  std::unique_ptr<SimFloatInput> m_currents[kNumChannels];
+};
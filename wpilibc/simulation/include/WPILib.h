@@ -51,6 +51,7 @@
 #include "GenericHID.h"
 #include "Joystick.h"
 #include "PIDController.h"
+#include "PowerDistributionPanel.h"
 #include "RobotDrive.h"
 #include "LiveWindow/LiveWindow.h"
 
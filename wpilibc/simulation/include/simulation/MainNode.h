@@ -3,6 +3,7 @@
 #define _SIM_MAIN_NODE_H
 
 #include "simulation/gz_msgs/msgs.h"
+#include "simulation/gz_msgs/shared_frame.h"
 #include <gazebo/transport/transport.hh>
 #include <gazebo/gazebo_client.hh>
 
@@ -36,6 +37,15 @@ public:
 		return GetInstance()->main->Subscribe(topic, fp, _latching);
 	}
 
+	/**
+	 * The shared memory frame, for exchanging values with the simulator
+	 * without a message per value. Devices use it for the signals it has,
+	 * and their topics for the rest.
+	 */
+	static frc_sim::FrameReader* Frames() {
+		return &GetInstance()->frames;
+	}
+
 	transport::NodePtr main;
 private:
 	MainNode() {
@@ -43,7 +53,12 @@ private:
 		main = transport::NodePtr(new transport::Node());
 		main->Init("frc");
 		gazebo::transport::run();
+		if (frames.Open()) {
+			std::cout << "Using the simulator's shared memory frame" << std::endl;
+		}
 	}
+
+	frc_sim::FrameReader frames;
 };
 
 #endif
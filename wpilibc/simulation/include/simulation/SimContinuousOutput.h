@@ -18,6 +18,7 @@ class SimContinuousOutput {
 private:
 	transport::PublisherPtr pub;
 	float speed;
+	int frameIndex;
 
 public:
 	SimContinuousOutput(std::string topic);
@@ -19,6 +19,7 @@ public:
 
 private:
 	bool value;
+	int frameIndex, sensorIndex;
     transport::SubscriberPtr sub;
     void callback(const msgs::ConstBoolPtr &msg);
 };
@@ -19,10 +19,19 @@ public:
 	double GetPosition();
 	double GetVelocity();
 
+	/**
+	 * Get the position and velocity, both taken at the same physics step when
+	 * they come from the shared memory frame or the sensor frame. Read
+	 * from their own topics, they may be a step apart.
+	 */
+	void GetSnapshot(double *position, double *velocity);
+
 private:
 	void sendCommand(std::string cmd);
 
 	double position, velocity;
+	int posIndex, velIndex;
+	int posSensor, velSensor;
 	transport::SubscriberPtr posSub, velSub;
 	transport::PublisherPtr commandPub;
 	void positionCallback(const msgs::ConstFloat64Ptr &msg);
@@ -10,7 +10,11 @@ using namespace gazebo;
 
 class SimFloatInput {
 public:
-	SimFloatInput(std::string topic);
+	/**
+	 * @param topic The signal's topic under ~/simulator.
+	 * @param initial The value until the first reading arrives.
+	 */
+	SimFloatInput(std::string topic, double initial = 0);
 
 	/**
 	 * @return The value of the potentiometer.
@@ -19,6 +23,7 @@ public:
 
 private:
 	double value;
+	int frameIndex, sensorIndex;
     transport::SubscriberPtr sub;
     void callback(const msgs::ConstFloat64Ptr &msg);
 };
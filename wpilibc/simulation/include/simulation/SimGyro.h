@@ -20,6 +20,8 @@ private:
     void sendCommand(std::string cmd);
 
     double position, velocity;
+    int posIndex, velIndex;
+    int posSensor, velSensor;
     transport::SubscriberPtr posSub, velSub;
     transport::PublisherPtr commandPub;
     void positionCallback(const msgs::ConstFloat64Ptr &msg);
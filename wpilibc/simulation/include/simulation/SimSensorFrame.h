@@ -0,0 +1,70 @@
+
+#ifndef _SIM_SENSOR_FRAME_H
+#define _SIM_SENSOR_FRAME_H
+
+#include "simulation/gz_msgs/msgs.h"
+#include <gazebo/transport/transport.hh>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace gazebo;
+
+/**
+ * Splits the gazebo.msgs.SensorFrame the simulator's sensor_frame plugin
+ * publishes each physics step back into the readings of each sensor.
+ *
+ * All readings come from the same step, and a new frame replaces all of
+ * them at once, so values read together belong together.
+ */
+class SimSensorFrame {
+public:
+	static SimSensorFrame* GetInstance();
+
+	/**
+	 * Read a sensor topic from the frame from now on.
+	 *
+	 * The first call waits briefly for the layout of the frame, but only if
+	 * the simulator has a sensor_frame plugin advertising one, so robot
+	 * programs in worlds without it don't wait at all.
+	 *
+	 * @return The index of the reading, or -1 if the frame doesn't have it
+	 *         and the topic should be subscribed to instead.
+	 */
+	int Bind(std::string topic);
+
+	/**
+	 * @return A reading from the latest frame.
+	 */
+	double Get(int index);
+
+	/**
+	 * Get several readings, all from the latest frame, for values that only
+	 * make sense together, like a position and its velocity.
+	 */
+	void Get(const int *indices, double *values, int count);
+
+	/**
+	 * @return The simulation time the latest frame was taken at.
+	 */
+	double GetTime();
+
+private:
+	SimSensorFrame();
+	void WaitForLayout();
+
+	std::mutex m_mutex;
+	std::condition_variable m_layoutReceived;
+	std::once_flag m_layoutChecked;
+	std::vector<std::string> m_names;
+	std::vector<double> m_values;
+	double m_time = 0;
+
+	transport::SubscriberPtr m_layoutSub, m_frameSub;
+	void layoutCallback(const msgs::ConstSensorFrameLayoutPtr &msg);
+	void frameCallback(const msgs::ConstSensorFramePtr &msg);
+};
+
+#endif
@@ -24,6 +24,7 @@ const double JOYSTICK_UNPLUGGED_MESSAGE_INTERVAL = 1.0;
   else Log().Get(level)
 
 const uint32_t DriverStation::kJoystickPorts;
+constexpr float DriverStation::kBrownoutVoltage;
 
 /**
  * DriverStation constructor.
@@ -45,6 +46,9 @@ DriverStation::DriverStation() {
   // It will signal when new packet data is available.
   HALSetNewDataSem(m_packetDataAvailableCond.native_handle());
 
+  // Published by the dc_motor plugins' battery model, when a world has one
+  m_batteryVoltage.reset(new SimFloatInput("pdp/voltage", 12.5));
+
   AddToSingletonList();
 
 }
@@ -92,6 +96,7 @@ void DriverStation::GetData() {
     HALGetJoystickButtons(stick, &m_joystickButtons[stick]);
     HALGetJoystickDescriptor(stick, &m_joystickDescriptor[stick]);
   }
+  m_packetCount++;
   m_newControlData.give();
 }
 
@@ -101,11 +106,7 @@ void DriverStation::GetData() {
  * @return The battery voltage in Volts.
  */
 float DriverStation::GetBatteryVoltage() const {
-  int32_t status = 0;
-  float voltage = getVinVoltage(&status);
-  wpi_setErrorWithContext(status, "getVinVoltage");
-
-  return voltage;
+  return m_batteryVoltage->Get();
 }
 
 /**
@@ -259,6 +260,23 @@ float DriverStation::GetStickAxis(uint32_t stick, uint32_t axis) {
   }
 }
 
+/**
+ * Copy all of the axes of a joystick, as received in the last packet.
+ * Unlike GetStickAxis() this doesn't report missing axes; callers should check
+ * the count.
+ *
+ * @param stick The joystick to read.
+ * @param axes Filled in with the raw axis values and the number of axes.
+ */
+void DriverStation::GetStickAxes(uint32_t stick, HALJoystickAxes &axes) const {
+  if (stick >= kJoystickPorts) {
+    wpi_setWPIError(BadJoystickIndex);
+    axes.count = 0;
+    return;
+  }
+  axes = m_joystickAxes[stick];
+}
+
 /**
  * Get the state of a POV on the joystick.
  *
@@ -400,10 +418,11 @@ bool DriverStation::IsSysActive() const {
 }
 
 /**
- * @return always false in simulation
+ * @return Whether the simulated battery voltage has sagged below
+ * kBrownoutVoltage
  */
 bool DriverStation::IsSysBrownedOut() const {
-  return false;
+  return GetBatteryVoltage() < kBrownoutVoltage;
 }
 
 /**
@@ -333,8 +333,11 @@ double Encoder::PIDGet()
 
 void Encoder::UpdateTable() {
 	if (m_table != nullptr) {
-        m_table->PutNumber("Speed", GetRate());
-        m_table->PutNumber("Distance", GetDistance());
+        // Read together, so the speed and distance shown are of the same step
+        double position, velocity;
+        impl->GetSnapshot(&position, &velocity);
+        m_table->PutNumber("Speed", m_distancePerPulse * velocity);
+        m_table->PutNumber("Distance", m_distancePerPulse * position);
         m_table->PutNumber("Distance per Tick", m_reverseDirection ? -m_distancePerPulse : m_distancePerPulse);
 	}
 }
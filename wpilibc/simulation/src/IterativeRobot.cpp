@@ -8,6 +8,7 @@
 #include "DriverStation.h"
 #include "SmartDashboard/SmartDashboard.h"
 #include "LiveWindow/LiveWindow.h"
+#include "LoopTiming.h"
 #include "networktables/NetworkTable.h"
 
 //not sure what this is used for yet.
@@ -68,10 +69,14 @@ double IterativeRobot::GetLoopsPerSec()
  * control system in 2008 and earlier, with a primary (slow) loop that is
  * called periodically, and a "fast loop" (a.k.a. "spin loop") that is
  * called as fast as possible with no delay between calls.
+ *
+ * Each pass is timed by LoopTiming when it is enabled, see
+ * EnableLoopTiming().
  */
 void IterativeRobot::StartCompetition()
 {
 	LiveWindow *lw = LiveWindow::GetInstance();
+	LoopTiming *timing = LoopTiming::GetInstance();
 	// first and one-time initialization
 	SmartDashboard::init();
 	NetworkTable::GetTable("LiveWindow")->GetSubTable("~STATUS~")->PutBoolean("LW Enabled", false);
@@ -81,6 +86,7 @@ void IterativeRobot::StartCompetition()
 	lw->SetEnabled(false);
 	while (true)
 	{
+		timing->StartLoop();
 		// Call the appropriate function depending upon the current robot mode
 		if (IsDisabled())
 		{
@@ -99,6 +105,7 @@ void IterativeRobot::StartCompetition()
 			if (NextPeriodReady())
 			{
 				// TODO: HALNetworkCommunicationObserveUserProgramDisabled();
+				LoopTiming::Scope periodic(LoopTiming::kPeriodic);
 				DisabledPeriodic();
 			}
 		}
@@ -119,6 +126,7 @@ void IterativeRobot::StartCompetition()
 			if (NextPeriodReady())
 			{
 				// TODO: HALNetworkCommunicationObserveUserProgramAutonomous();
+				LoopTiming::Scope periodic(LoopTiming::kPeriodic);
 				AutonomousPeriodic();
 			}
 		}
@@ -139,6 +147,7 @@ void IterativeRobot::StartCompetition()
             if (NextPeriodReady())
             {
                 // TODO: HALNetworkCommunicationObserveUserProgramTest();
+                LoopTiming::Scope periodic(LoopTiming::kPeriodic);
                 TestPeriodic();
             }
         }
@@ -160,14 +169,39 @@ void IterativeRobot::StartCompetition()
 			if (NextPeriodReady())
 			{
 				// TODO: HALNetworkCommunicationObserveUserProgramTeleop();
+				LoopTiming::Scope periodic(LoopTiming::kPeriodic);
 				TeleopPeriodic();
 			}
 		}
 		// wait for driver station data so the loop doesn't hog the CPU
-		m_ds.WaitForData();
+		{
+			LoopTiming::Scope waiting(LoopTiming::kDSWait);
+			m_ds.WaitForData();
+		}
+		timing->EndLoop();
 	}
 }
 
+/**
+ * Turn on timing of the main loop.
+ *
+ * The time spent waiting for DS data, in the Periodic() functions, in the
+ * Scheduler and in the LiveWindow is measured every loop.  Loops whose work,
+ * not counting the wait for DS data, takes longer than the overrun threshold
+ * are counted and logged, and the statistics are published to the
+ * "LoopTiming" table of the SmartDashboard.
+ *
+ * @param enabled True to measure the loop
+ * @param overrunThreshold The loop time, in seconds, above which a loop is an
+ * overrun.  The default is the DS packet period.
+ */
+void IterativeRobot::EnableLoopTiming(bool enabled, double overrunThreshold)
+{
+	LoopTiming *timing = LoopTiming::GetInstance();
+	timing->SetOverrunThreshold(overrunThreshold);
+	timing->SetEnabled(enabled);
+}
+
 /**
  * Determine if the periodic functions should be called.
  *
@@ -7,6 +7,7 @@
 
 #include "Joystick.h"
 #include "DriverStation.h"
+#include "Timer.h"
 //#include "NetworkCommunication/UsageReporting.h"
 #include "WPIErrors.h"
 #include <math.h>
@@ -22,6 +23,18 @@ const uint32_t Joystick::kDefaultTopButton;
 static Joystick *joysticks[DriverStation::kJoystickPorts];
 static bool joySticksInitialized = false;
 
+// Every raw int8 axis value converted to [-1, 1] the same way as
+// DriverStation::GetStickAxis()
+static struct RawAxisTable {
+  float values[256];
+  RawAxisTable() {
+    for (int i = 0; i < 256; i++) {
+      int8_t value = static_cast<int8_t>(i);
+      values[i] = value < 0 ? value / 128.0f : value / 127.0f;
+    }
+  }
+} rawAxisTable;
+
 /**
  * Construct an instance of a joystick.
  * The joystick index is the usb port on the drivers station.
@@ -59,6 +72,7 @@ Joystick::Joystick(uint32_t port, uint32_t numAxisTypes,
       m_port(port),
       m_axes(numAxisTypes),
       m_buttons(numButtonTypes) {
+  for (auto &lookup : m_axisLookup) lookup = rawAxisTable.values;
   if (!joySticksInitialized) {
     for (auto& joystick : joysticks) joystick = nullptr;
     joySticksInitialized = true;
@@ -122,13 +136,171 @@ float Joystick::GetThrottle() const {
 /**
  * Get the value of the axis.
  *
+ * The axes are converted and shaped once per DS packet, so this is only a
+ * table lookup.  Any dead-band, expo or slew rate set for the axis has been
+ * applied.
+ *
  * @param axis The axis to read, starting at 0.
  * @return The value of the axis.
  */
 float Joystick::GetRawAxis(uint32_t axis) const {
+  {
+    std::lock_guard<priority_mutex> sync(m_axisMutex);
+    UpdateAxes();
+    if (axis < m_axisCount) return m_axisValues[axis];
+  }
+  // Let the DriverStation report the missing axis
   return m_ds.GetStickAxis(m_port, axis);
 }
 
+/**
+ * Refresh the shaped axis values if a DS packet arrived since the last call.
+ * Must be called with m_axisMutex held.
+ *
+ * The slew rate limits are applied over the time since the last refresh, so
+ * they hold however often the axes are read and however regularly packets
+ * arrive.
+ */
+void Joystick::UpdateAxes() const {
+  uint32_t packet = m_ds.GetPacketCount();
+  if (packet == m_axisPacket) return;
+
+  HALJoystickAxes axes;
+  m_ds.GetStickAxes(m_port, axes);
+  // The first packet sets the axes outright
+  bool first = m_axisPacket == 0;
+  double now = Timer::GetFPGATimestamp();
+  float elapsed = now - m_axisTime;
+  m_axisTime = now;
+  m_axisPacket = packet;
+  m_axisCount = axes.count < kMaxJoystickAxes ? axes.count : kMaxJoystickAxes;
+
+  for (uint32_t i = 0; i < m_axisCount; i++) {
+    uint8_t index = static_cast<uint8_t>(static_cast<int8_t>(axes.axes[i]));
+    float value = m_axisLookup[i][index];
+    float slewRate = m_axisShaping[i].slewRate;
+    if (slewRate > 0.0f && !first) {
+      float maxChange = slewRate * elapsed;
+      float last = m_axisValues[i];
+      if (value > last + maxChange)
+        value = last + maxChange;
+      else if (value < last - maxChange)
+        value = last - maxChange;
+    }
+    m_axisValues[i] = value;
+  }
+}
+
+/**
+ * Rebuild the lookup table of an axis from its shaping parameters.
+ * Axes without shaping share the plain conversion table.
+ * Must be called with m_axisMutex held.
+ */
+void Joystick::BuildAxisTable(uint32_t axis) {
+  const AxisShaping &shaping = m_axisShaping[axis];
+  if (shaping.deadband == 0.0f && shaping.expo == 0.0f) {
+    m_axisTables[axis].clear();
+    m_axisLookup[axis] = rawAxisTable.values;
+    return;
+  }
+
+  m_axisTables[axis].resize(256);
+  for (int i = 0; i < 256; i++) {
+    float value = rawAxisTable.values[i];
+    float magnitude = fabs(value);
+    if (magnitude <= shaping.deadband) {
+      magnitude = 0.0f;
+    } else {
+      // Rescale so the output still spans [0, 1] outside the dead-band
+      magnitude = (magnitude - shaping.deadband) / (1.0f - shaping.deadband);
+    }
+    magnitude = (1.0f - shaping.expo) * magnitude +
+                shaping.expo * magnitude * magnitude * magnitude;
+    m_axisTables[axis][i] = value < 0.0f ? -magnitude : magnitude;
+  }
+  m_axisLookup[axis] = m_axisTables[axis].data();
+}
+
+/**
+ * Set the dead-band of a raw axis.
+ * Values whose magnitude is within the dead-band read as 0, and the remaining
+ * range is rescaled to still reach 1.
+ *
+ * @param axis The axis, starting at 0.
+ * @param deadband The dead-band, from 0 (none) to less than 1.
+ */
+void Joystick::SetAxisDeadband(uint32_t axis, float deadband) {
+  if (axis >= kMaxJoystickAxes) {
+    wpi_setWPIError(BadJoystickAxis);
+    return;
+  }
+  if (deadband < 0.0f || deadband >= 1.0f) {
+    wpi_setWPIErrorWithContext(ParameterOutOfRange, "deadband");
+    return;
+  }
+  std::lock_guard<priority_mutex> sync(m_axisMutex);
+  m_axisShaping[axis].deadband = deadband;
+  BuildAxisTable(axis);
+}
+
+/**
+ * Set the expo curve of a raw axis.
+ * The output is blended between linear and cubic: (1 - expo) * x + expo * x^3,
+ * which gives finer control around the center.
+ *
+ * @param axis The axis, starting at 0.
+ * @param expo The amount of cubic response, from 0 (linear) to 1 (cubic).
+ */
+void Joystick::SetAxisExpo(uint32_t axis, float expo) {
+  if (axis >= kMaxJoystickAxes) {
+    wpi_setWPIError(BadJoystickAxis);
+    return;
+  }
+  if (expo < 0.0f || expo > 1.0f) {
+    wpi_setWPIErrorWithContext(ParameterOutOfRange, "expo");
+    return;
+  }
+  std::lock_guard<priority_mutex> sync(m_axisMutex);
+  m_axisShaping[axis].expo = expo;
+  BuildAxisTable(axis);
+}
+
+/**
+ * Limit how quickly a raw axis can change.
+ * The limit is applied as each DS packet is processed, so the axis lags
+ * behind the stick when it is moved faster than the rate.
+ *
+ * @param axis The axis, starting at 0.
+ * @param rate The maximum change per second, or 0 for no limit.
+ */
+void Joystick::SetAxisSlewRate(uint32_t axis, float rate) {
+  if (axis >= kMaxJoystickAxes) {
+    wpi_setWPIError(BadJoystickAxis);
+    return;
+  }
+  if (rate < 0.0f) {
+    wpi_setWPIErrorWithContext(ParameterOutOfRange, "rate");
+    return;
+  }
+  std::lock_guard<priority_mutex> sync(m_axisMutex);
+  m_axisShaping[axis].slewRate = rate;
+}
+
+/**
+ * Whether a raw axis has a dead-band or expo curve set.
+ *
+ * RobotDrive uses this to leave out its own squaring of the axis, which would
+ * shape the input a second time.
+ *
+ * @param axis The axis, starting at 0.
+ */
+bool Joystick::IsAxisShaped(uint32_t axis) const {
+  if (axis >= kMaxJoystickAxes) return false;
+  std::lock_guard<priority_mutex> sync(m_axisMutex);
+  return m_axisShaping[axis].deadband != 0.0f ||
+         m_axisShaping[axis].expo != 0.0f;
+}
+
 /**
  * For the current joystick, return the axis determined by the argument.
  *
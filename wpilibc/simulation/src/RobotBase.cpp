@@ -7,7 +7,9 @@
 #include "RobotBase.h"
 #include "RobotState.h"
 #include "Utility.h"
+#include "networktables/NetworkTable.h"
 
+#include <cstdlib>
 #include <cstring>
 
 RobotBase* RobotBase::m_instance = nullptr;
@@ -34,6 +36,12 @@ RobotBase &RobotBase::getInstance()
 RobotBase::RobotBase() : m_ds(DriverStation::GetInstance())
 {
 	RobotState::SetImplementation(DriverStation::GetInstance());
+	// Simulations running side by side, like frc_batch_runner's, each need a
+	// NetworkTables port and persistent file of their own
+	const char *ntPort = std::getenv("FRCSIM_NT_PORT");
+	if (ntPort != nullptr) NetworkTable::SetPort(std::atoi(ntPort));
+	const char *ntFile = std::getenv("FRCSIM_NT_PERSISTENT_FILE");
+	if (ntFile != nullptr) NetworkTable::SetPersistentFilename(ntFile);
 	transport::SubscriberPtr time_pub = MainNode::Subscribe("time", &wpilib::internal::time_callback);
 }
 
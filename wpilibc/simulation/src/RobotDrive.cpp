@@ -19,6 +19,32 @@
 
 const int32_t RobotDrive::kMaxNumberOfMotors;
 
+/**
+ * Square a joystick input (while preserving the sign) to increase fine control
+ * while permitting full power.
+ *
+ * A Joystick axis with a dead-band or expo curve has already been shaped by
+ * the Joystick, and is passed through unchanged rather than squared again.
+ */
+static float SquareStickInput(GenericHID &stick, uint32_t axis, float value)
+{
+	Joystick *joystick = dynamic_cast<Joystick *>(&stick);
+	if (joystick != nullptr && joystick->IsAxisShaped(axis))
+	{
+		return value;
+	}
+	value = std::max(-1.0f, std::min(value, 1.0f));
+	return value >= 0.0 ? value * value : -(value * value);
+}
+
+/** SquareStickInput() for the axis a Joystick maps an axis type to. */
+static float SquareStickAxis(GenericHID &stick, Joystick::AxisType type, float value)
+{
+	Joystick *joystick = dynamic_cast<Joystick *>(&stick);
+	uint32_t axis = joystick != nullptr ? joystick->GetAxisChannel(type) : 0;
+	return SquareStickInput(stick, axis, value);
+}
+
 /*
  * Driving functions
  * These functions provide an interface to multiple motors that is used for C programming
@@ -246,12 +272,19 @@ void RobotDrive::TankDrive(GenericHID *leftStick, GenericHID *rightStick, bool s
 		wpi_setWPIError(NullParameter);
 		return;
 	}
-	TankDrive(leftStick->GetY(), rightStick->GetY(), squaredInputs);
+	TankDrive(*leftStick, *rightStick, squaredInputs);
 }
 
 void RobotDrive::TankDrive(GenericHID &leftStick, GenericHID &rightStick, bool squaredInputs)
 {
-	TankDrive(leftStick.GetY(), rightStick.GetY(), squaredInputs);
+	float leftValue = leftStick.GetY();
+	float rightValue = rightStick.GetY();
+	if (squaredInputs)
+	{
+		leftValue = SquareStickAxis(leftStick, Joystick::kYAxis, leftValue);
+		rightValue = SquareStickAxis(rightStick, Joystick::kYAxis, rightValue);
+	}
+	TankDrive(leftValue, rightValue, false);
 }
 
 /**
@@ -271,13 +304,20 @@ void RobotDrive::TankDrive(GenericHID *leftStick, uint32_t leftAxis,
 		wpi_setWPIError(NullParameter);
 		return;
 	}
-	TankDrive(leftStick->GetRawAxis(leftAxis), rightStick->GetRawAxis(rightAxis), squaredInputs);
+	TankDrive(*leftStick, leftAxis, *rightStick, rightAxis, squaredInputs);
 }
 
 void RobotDrive::TankDrive(GenericHID &leftStick, uint32_t leftAxis,
 		GenericHID &rightStick, uint32_t rightAxis, bool squaredInputs)
 {
-	TankDrive(leftStick.GetRawAxis(leftAxis), rightStick.GetRawAxis(rightAxis), squaredInputs);
+	float leftValue = leftStick.GetRawAxis(leftAxis);
+	float rightValue = rightStick.GetRawAxis(rightAxis);
+	if (squaredInputs)
+	{
+		leftValue = SquareStickInput(leftStick, leftAxis, leftValue);
+		rightValue = SquareStickInput(rightStick, rightAxis, rightValue);
+	}
+	TankDrive(leftValue, rightValue, false);
 }
 
 
@@ -332,8 +372,7 @@ void RobotDrive::TankDrive(float leftValue, float rightValue, bool squaredInputs
  */
 void RobotDrive::ArcadeDrive(GenericHID *stick, bool squaredInputs)
 {
-	// simply call the full-featured ArcadeDrive with the appropriate values
-	ArcadeDrive(stick->GetY(), stick->GetX(), squaredInputs);
+	ArcadeDrive(*stick, squaredInputs);
 }
 
 /**
@@ -347,8 +386,15 @@ void RobotDrive::ArcadeDrive(GenericHID *stick, bool squaredInputs)
  */
 void RobotDrive::ArcadeDrive(GenericHID &stick, bool squaredInputs)
 {
+	float moveValue = stick.GetY();
+	float rotateValue = stick.GetX();
+	if (squaredInputs)
+	{
+		moveValue = SquareStickAxis(stick, Joystick::kYAxis, moveValue);
+		rotateValue = SquareStickAxis(stick, Joystick::kXAxis, rotateValue);
+	}
 	// simply call the full-featured ArcadeDrive with the appropriate values
-	ArcadeDrive(stick.GetY(), stick.GetX(), squaredInputs);
+	ArcadeDrive(moveValue, rotateValue, false);
 }
 
 /**
@@ -365,10 +411,7 @@ void RobotDrive::ArcadeDrive(GenericHID* moveStick, uint32_t moveAxis,
 								GenericHID* rotateStick, uint32_t rotateAxis,
 								bool squaredInputs)
 {
-	float moveValue = moveStick->GetRawAxis(moveAxis);
-	float rotateValue = rotateStick->GetRawAxis(rotateAxis);
-
-	ArcadeDrive(moveValue, rotateValue, squaredInputs);
+	ArcadeDrive(*moveStick, moveAxis, *rotateStick, rotateAxis, squaredInputs);
 }
 
 /**
@@ -388,8 +431,13 @@ void RobotDrive::ArcadeDrive(GenericHID &moveStick, uint32_t moveAxis,
 {
 	float moveValue = moveStick.GetRawAxis(moveAxis);
 	float rotateValue = rotateStick.GetRawAxis(rotateAxis);
+	if (squaredInputs)
+	{
+		moveValue = SquareStickInput(moveStick, moveAxis, moveValue);
+		rotateValue = SquareStickInput(rotateStick, rotateAxis, rotateValue);
+	}
 
-	ArcadeDrive(moveValue, rotateValue, squaredInputs);
+	ArcadeDrive(moveValue, rotateValue, false);
 }
 
 /**
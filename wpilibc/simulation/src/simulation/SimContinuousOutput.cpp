@@ -8,12 +8,20 @@
 #include "simulation/SimContinuousOutput.h"
 #include "simulation/MainNode.h"
 
-SimContinuousOutput::SimContinuousOutput(std::string topic) {
-    pub = MainNode::Advertise<msgs::Float64>("~/simulator/"+topic);
+SimContinuousOutput::SimContinuousOutput(std::string topic) : speed(0) {
+	frameIndex = MainNode::Frames()->BindOutput(topic);
+	if (frameIndex < 0) {
+		pub = MainNode::Advertise<msgs::Float64>("~/simulator/"+topic);
+	}
 	std::cout << "Initialized ~/simulator/"+topic << std::endl;
 }
 
 void SimContinuousOutput::Set(float speed) {
+	this->speed = speed;
+	if (frameIndex >= 0) {
+		MainNode::Frames()->SetOutput(frameIndex, speed);
+		return;
+	}
 	msgs::Float64 msg;
 	msg.set_data(speed);
 	pub->Publish(msg);
@@ -7,13 +7,24 @@
 
 #include "simulation/SimDigitalInput.h"
 #include "simulation/MainNode.h"
+#include "simulation/SimSensorFrame.h"
 
 SimDigitalInput::SimDigitalInput(std::string topic) {
-    sub = MainNode::Subscribe("~/simulator/"+topic, &SimDigitalInput::callback, this);
+	frameIndex = MainNode::Frames()->BindInput(topic);
+	sensorIndex = frameIndex < 0 ? SimSensorFrame::GetInstance()->Bind(topic) : -1;
+	if (frameIndex < 0 && sensorIndex < 0) {
+		sub = MainNode::Subscribe("~/simulator/"+topic, &SimDigitalInput::callback, this);
+	}
 	std::cout << "Initialized ~/simulator/"+topic << std::endl;
 }
 
 bool SimDigitalInput::Get() {
+	if (frameIndex >= 0) {
+		return MainNode::Frames()->GetInput(frameIndex) != 0;
+	}
+	if (sensorIndex >= 0) {
+		return SimSensorFrame::GetInstance()->Get(sensorIndex) != 0;
+	}
 	return value;
 }
 
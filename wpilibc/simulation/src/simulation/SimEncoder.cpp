@@ -1,14 +1,23 @@
 
 #include "simulation/SimEncoder.h"
 #include "simulation/MainNode.h"
+#include "simulation/SimSensorFrame.h"
 
 SimEncoder::SimEncoder(std::string topic) {
 	commandPub = MainNode::Advertise<msgs::GzString>("~/simulator/"+topic+"/control");
 
-	posSub = MainNode::Subscribe("~/simulator/"+topic+"/position",
+	posIndex = MainNode::Frames()->BindInput(topic+"/position");
+	posSensor = posIndex < 0 ? SimSensorFrame::GetInstance()->Bind(topic+"/position") : -1;
+	if (posIndex < 0 && posSensor < 0) {
+		posSub = MainNode::Subscribe("~/simulator/"+topic+"/position",
 		                 &SimEncoder::positionCallback, this);
-	velSub = MainNode::Subscribe("~/simulator/"+topic+"/velocity",
+	}
+	velIndex = MainNode::Frames()->BindInput(topic+"/velocity");
+	velSensor = velIndex < 0 ? SimSensorFrame::GetInstance()->Bind(topic+"/velocity") : -1;
+	if (velIndex < 0 && velSensor < 0) {
+		velSub = MainNode::Subscribe("~/simulator/"+topic+"/velocity",
 		                 &SimEncoder::velocityCallback, this);
+	}
 
 	if (commandPub->WaitForConnection(gazebo::common::Time(5.0))) { // Wait up to five seconds.
 		std::cout << "Initialized ~/simulator/" + topic << std::endl;
@@ -30,14 +39,43 @@ void SimEncoder::Stop() {
 }
 
 double SimEncoder::GetPosition() {
+	if (posIndex >= 0) {
+		return MainNode::Frames()->GetInput(posIndex);
+	}
+	if (posSensor >= 0) {
+		return SimSensorFrame::GetInstance()->Get(posSensor);
+	}
 	return position;
 }
 
 double SimEncoder::GetVelocity() {
+	if (velIndex >= 0) {
+		return MainNode::Frames()->GetInput(velIndex);
+	}
+	if (velSensor >= 0) {
+		return SimSensorFrame::GetInstance()->Get(velSensor);
+	}
 	return velocity;
 }
 
 
+void SimEncoder::GetSnapshot(double *position, double *velocity) {
+	double values[2];
+	if (posIndex >= 0 && velIndex >= 0) {
+		int indices[] = {posIndex, velIndex};
+		MainNode::Frames()->GetInputs(indices, values, 2);
+	} else if (posSensor >= 0 && velSensor >= 0) {
+		int indices[] = {posSensor, velSensor};
+		SimSensorFrame::GetInstance()->Get(indices, values, 2);
+	} else {
+		values[0] = GetPosition();
+		values[1] = GetVelocity();
+	}
+	*position = values[0];
+	*velocity = values[1];
+}
+
+
 void SimEncoder::sendCommand(std::string cmd) {
 	msgs::GzString msg;
 	msg.set_data(cmd);
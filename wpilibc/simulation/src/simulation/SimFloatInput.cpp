@@ -7,13 +7,24 @@
 
 #include "simulation/SimFloatInput.h"
 #include "simulation/MainNode.h"
+#include "simulation/SimSensorFrame.h"
 
-SimFloatInput::SimFloatInput(std::string topic) {
-    sub = MainNode::Subscribe("~/simulator/"+topic, &SimFloatInput::callback, this);
+SimFloatInput::SimFloatInput(std::string topic, double initial) : value(initial) {
+	frameIndex = MainNode::Frames()->BindInput(topic);
+	sensorIndex = frameIndex < 0 ? SimSensorFrame::GetInstance()->Bind(topic) : -1;
+	if (frameIndex < 0 && sensorIndex < 0) {
+		sub = MainNode::Subscribe("~/simulator/"+topic, &SimFloatInput::callback, this);
+	}
 	std::cout << "Initialized ~/simulator/"+topic << std::endl;
 }
 
 double SimFloatInput::Get() {
+	if (frameIndex >= 0) {
+		return MainNode::Frames()->GetInput(frameIndex);
+	}
+	if (sensorIndex >= 0) {
+		return SimSensorFrame::GetInstance()->Get(sensorIndex);
+	}
 	return value;
 }
 
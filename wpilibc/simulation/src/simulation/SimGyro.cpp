@@ -1,14 +1,23 @@
 
 #include "simulation/SimGyro.h"
 #include "simulation/MainNode.h"
+#include "simulation/SimSensorFrame.h"
 
 SimGyro::SimGyro(std::string topic) {
     commandPub = MainNode::Advertise<msgs::GzString>("~/simulator/"+topic+"/control");
   
-    posSub = MainNode::Subscribe("~/simulator/"+topic+"/position",
-                                 &SimGyro::positionCallback, this);
-    velSub = MainNode::Subscribe("~/simulator/"+topic+"/velocity",
-                                 &SimGyro::velocityCallback, this);
+    posIndex = MainNode::Frames()->BindInput(topic+"/position");
+    posSensor = posIndex < 0 ? SimSensorFrame::GetInstance()->Bind(topic+"/position") : -1;
+    if (posIndex < 0 && posSensor < 0) {
+        posSub = MainNode::Subscribe("~/simulator/"+topic+"/position",
+                                     &SimGyro::positionCallback, this);
+    }
+    velIndex = MainNode::Frames()->BindInput(topic+"/velocity");
+    velSensor = velIndex < 0 ? SimSensorFrame::GetInstance()->Bind(topic+"/velocity") : -1;
+    if (velIndex < 0 && velSensor < 0) {
+        velSub = MainNode::Subscribe("~/simulator/"+topic+"/velocity",
+                                     &SimGyro::velocityCallback, this);
+    }
 
     if (commandPub->WaitForConnection(gazebo::common::Time(5.0))) { // Wait up to five seconds.
 		std::cout << "Initialized ~/simulator/" + topic << std::endl;
@@ -22,10 +31,22 @@ void SimGyro::Reset() {
 }
 
 double SimGyro::GetAngle() {
+    if (posIndex >= 0) {
+        return MainNode::Frames()->GetInput(posIndex);
+    }
+    if (posSensor >= 0) {
+        return SimSensorFrame::GetInstance()->Get(posSensor);
+    }
     return position;
 }
 
 double SimGyro::GetVelocity() {
+    if (velIndex >= 0) {
+        return MainNode::Frames()->GetInput(velIndex);
+    }
+    if (velSensor >= 0) {
+        return SimSensorFrame::GetInstance()->Get(velSensor);
+    }
     return velocity;
 }
 
@@ -0,0 +1,77 @@
+
+#include "simulation/SimSensorFrame.h"
+#include "simulation/MainNode.h"
+#include "simulation/gz_msgs/shared_frame.h"
+
+SimSensorFrame* SimSensorFrame::GetInstance() {
+	static SimSensorFrame instance;
+	return &instance;
+}
+
+SimSensorFrame::SimSensorFrame() {
+	m_layoutSub = MainNode::Subscribe("~/simulator/sensors/layout",
+		                 &SimSensorFrame::layoutCallback, this, true);
+	m_frameSub = MainNode::Subscribe("~/simulator/sensors",
+		                 &SimSensorFrame::frameCallback, this);
+}
+
+int SimSensorFrame::Bind(std::string topic) {
+	std::call_once(m_layoutChecked, [this] { WaitForLayout(); });
+	std::string key = frc_sim::SignalKey(topic);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (size_t i = 0; i < m_names.size(); i++) {
+		if (m_names[i] == key) return i;
+	}
+	return -1;
+}
+
+void SimSensorFrame::WaitForLayout() {
+	// Only a sensor_frame plugin advertises the layout. Without one there's
+	// nothing to wait for, and devices go straight to their own topics.
+	std::string layoutTopic =
+		MainNode::GetInstance()->main->DecodeTopicName("~/simulator/sensors/layout");
+	bool advertised = false;
+	for (const std::string &advertisedTopic :
+	     transport::getAdvertisedTopics(msgs::SensorFrameLayout().GetTypeName())) {
+		if (advertisedTopic == layoutTopic) advertised = true;
+	}
+	if (!advertised) return;
+
+	// The latched layout arrives shortly after subscribing
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_layoutReceived.wait_for(lock, std::chrono::seconds(1),
+	                          [this] { return !m_names.empty(); });
+	if (!m_names.empty()) {
+		std::cout << "Reading sensors from ~/simulator/sensors" << std::endl;
+	}
+}
+
+double SimSensorFrame::Get(int index) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return (size_t)index < m_values.size() ? m_values[index] : 0;
+}
+
+void SimSensorFrame::Get(const int *indices, double *values, int count) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (int i = 0; i < count; i++) {
+		values[i] = (size_t)indices[i] < m_values.size() ? m_values[indices[i]] : 0;
+	}
+}
+
+double SimSensorFrame::GetTime() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_time;
+}
+
+void SimSensorFrame::layoutCallback(const msgs::ConstSensorFrameLayoutPtr &msg) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// Sensors are only ever added, so indices already handed out stay valid
+	m_names.assign(msg->names().begin(), msg->names().end());
+	m_layoutReceived.notify_all();
+}
+
+void SimSensorFrame::frameCallback(const msgs::ConstSensorFramePtr &msg) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_values.assign(msg->values().begin(), msg->values().end());
+	m_time = msg->time();
+}
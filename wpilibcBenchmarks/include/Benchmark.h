@@ -0,0 +1,108 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace benchmark {
+
+/**
+ * Passed to each benchmark to time it.
+ *
+ * The code being measured goes in a KeepRunning() loop, and anything before
+ * the loop is setup that isn't counted:
+ *
+ * @code
+ * BENCHMARK(Encoder_Get) {
+ *   Encoder encoder(0, 1);
+ *   while (state.KeepRunning()) {
+ *     benchmark::DoNotOptimize(encoder.Get());
+ *   }
+ * }
+ * @endcode
+ *
+ * The runner calls the benchmark with more and more iterations until one
+ * run takes long enough to time reliably.
+ */
+class State {
+ public:
+  explicit State(uint64_t iterations) : m_iterations(iterations) {}
+
+  bool KeepRunning() {
+    if (m_remaining != 0) {
+      m_remaining--;
+      return true;
+    }
+    if (!m_started && m_iterations != 0) {
+      m_started = true;
+      m_remaining = m_iterations - 1;
+      ResumeTiming();
+      return true;
+    }
+    PauseTiming();
+    return false;
+  }
+
+  /** Stop counting time and allocations, to do per-iteration setup. */
+  void PauseTiming();
+  void ResumeTiming();
+
+  /** Mark the run as failed, so its time isn't reported. */
+  void SkipWithError(const std::string &message);
+
+  uint64_t Iterations() const { return m_iterations; }
+  std::chrono::nanoseconds Elapsed() const { return m_elapsed; }
+  uint64_t Allocations() const { return m_allocations; }
+  uint64_t AllocatedBytes() const { return m_allocatedBytes; }
+  bool Failed() const { return !m_error.empty(); }
+  const std::string &Error() const { return m_error; }
+
+ private:
+  uint64_t m_iterations;
+  uint64_t m_remaining = 0;
+  bool m_started = false;
+  bool m_timing = false;
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::nanoseconds m_elapsed{0};
+  uint64_t m_startAllocations = 0;
+  uint64_t m_startAllocatedBytes = 0;
+  uint64_t m_allocations = 0;
+  uint64_t m_allocatedBytes = 0;
+  std::string m_error;
+};
+
+typedef void (*Function)(State &state);
+
+/** Adds a benchmark to the list the runner picks from. */
+class Registrar {
+ public:
+  Registrar(const char *name, Function function);
+};
+
+/**
+ * Keep the compiler from throwing away a result the benchmark doesn't
+ * otherwise use.
+ */
+template <typename T>
+inline void DoNotOptimize(const T &value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+/** The number of operator new calls, on any thread, so far. */
+uint64_t AllocationCount();
+uint64_t AllocatedBytes();
+
+}  // namespace benchmark
+
+#define BENCHMARK(name)                                             \
+  static void name##_Benchmark(benchmark::State &state);            \
+  static benchmark::Registrar name##_Registrar(#name,               \
+                                               name##_Benchmark);   \
+  static void name##_Benchmark(benchmark::State &state)
@@ -0,0 +1,26 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "AnalogInput.h"
+#include "Benchmark.h"
+#include "HALDesktop.hpp"
+
+BENCHMARK(AnalogInput_GetVoltage) {
+  AnalogInput input(0);
+  hal::desktop::SetAnalogInput(0, 2.5);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(input.GetVoltage());
+  }
+}
+
+BENCHMARK(AnalogInput_GetAverageVoltage) {
+  AnalogInput input(0);
+  hal::desktop::SetAnalogInput(0, 2.5);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(input.GetAverageVoltage());
+  }
+}
@@ -0,0 +1,308 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "HAL/HAL.hpp"
+#include "HALDesktop.hpp"
+
+/*
+ * Every operator new in the program is counted, so a benchmark can report
+ * how much the code it measures allocates. The array and nothrow forms all
+ * end up here. Allocations made with malloc() directly, as the C parts of the
+ * HAL do, aren't seen.
+ */
+static std::atomic<uint64_t> allocationCount{0};
+static std::atomic<uint64_t> allocatedBytes{0};
+
+void *operator new(std::size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  void *memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) throw std::bad_alloc();
+  return memory;
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+namespace benchmark {
+
+uint64_t AllocationCount() {
+  return allocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocatedBytes() {
+  return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void State::PauseTiming() {
+  if (!m_timing) return;
+  auto now = std::chrono::steady_clock::now();
+  m_elapsed += now - m_start;
+  m_allocations += benchmark::AllocationCount() - m_startAllocations;
+  m_allocatedBytes += benchmark::AllocatedBytes() - m_startAllocatedBytes;
+  m_timing = false;
+}
+
+void State::ResumeTiming() {
+  if (m_timing) return;
+  m_timing = true;
+  m_startAllocations = benchmark::AllocationCount();
+  m_startAllocatedBytes = benchmark::AllocatedBytes();
+  m_start = std::chrono::steady_clock::now();
+}
+
+void State::SkipWithError(const std::string &message) {
+  m_error = message;
+  m_remaining = 0;
+}
+
+struct Registered {
+  std::string name;
+  Function function;
+};
+
+static std::vector<Registered> &GetRegistered() {
+  static std::vector<Registered> registered;
+  return registered;
+}
+
+Registrar::Registrar(const char *name, Function function) {
+  GetRegistered().push_back({name, function});
+}
+
+}  // namespace benchmark
+
+using benchmark::State;
+
+struct Result {
+  std::string name;
+  uint64_t iterations = 0;
+  double nsPerOp = 0;
+  double allocationsPerOp = 0;
+  double bytesPerOp = 0;
+  std::string error;
+};
+
+struct Options {
+  std::string filter;
+  double minTime = 0.5;
+  int repetitions = 5;
+  std::string jsonFile;
+  bool list = false;
+};
+
+static const uint64_t kMaxIterations = 1000000000;
+
+/**
+ * Run a benchmark once, with the desktop HAL put back to its power on state
+ * so benchmarks can't see each other's inputs.
+ */
+static State RunOnce(benchmark::Function function, uint64_t iterations) {
+  hal::desktop::Reset();
+  State state(iterations);
+  function(state);
+  return state;
+}
+
+/**
+ * Find an iteration count that takes at least the minimum time, then time
+ * that many iterations a few times and report the median, which is less
+ * upset by the odd context switch than the mean.
+ */
+static Result Measure(const benchmark::Registered &benchmark,
+                      const Options &options) {
+  Result result;
+  result.name = benchmark.name;
+
+  std::chrono::duration<double> minTime(options.minTime);
+  uint64_t iterations = 1;
+  while (true) {
+    State state = RunOnce(benchmark.function, iterations);
+    if (state.Failed()) {
+      result.error = state.Error();
+      return result;
+    }
+    std::chrono::duration<double> elapsed = state.Elapsed();
+    if (elapsed >= minTime || iterations >= kMaxIterations) break;
+
+    // Aim a little past the minimum time, but don't grow by more than 100x on
+    // the strength of a run too short to time well.
+    double next = elapsed.count() > 0
+                      ? iterations * 1.4 * minTime.count() / elapsed.count()
+                      : iterations * 100.0;
+    next = std::min(next, iterations * 100.0);
+    next = std::max(next, iterations + 1.0);
+    iterations = std::min((uint64_t)next, kMaxIterations);
+  }
+
+  std::vector<State> runs;
+  for (int i = 0; i < options.repetitions; i++) {
+    runs.push_back(RunOnce(benchmark.function, iterations));
+    if (runs.back().Failed()) {
+      result.error = runs.back().Error();
+      return result;
+    }
+  }
+  std::sort(runs.begin(), runs.end(), [](const State &a, const State &b) {
+    return a.Elapsed() < b.Elapsed();
+  });
+  const State &median = runs[runs.size() / 2];
+
+  result.iterations = iterations;
+  result.nsPerOp = (double)median.Elapsed().count() / iterations;
+  result.allocationsPerOp = (double)median.Allocations() / iterations;
+  result.bytesPerOp = (double)median.AllocatedBytes() / iterations;
+  return result;
+}
+
+static void PrintTable(const std::vector<Result> &results) {
+  std::printf("%-40s %12s %12s %12s %12s\n", "Benchmark", "Iterations",
+              "ns/op", "allocs/op", "bytes/op");
+  for (const Result &result : results) {
+    if (!result.error.empty()) {
+      std::printf("%-40s ERROR: %s\n", result.name.c_str(),
+                  result.error.c_str());
+      continue;
+    }
+    std::printf("%-40s %12llu %12.1f %12.2f %12.1f\n", result.name.c_str(),
+                (unsigned long long)result.iterations, result.nsPerOp,
+                result.allocationsPerOp, result.bytesPerOp);
+  }
+}
+
+static void WriteJsonString(std::FILE *file, const std::string &value) {
+  std::fputc('"', file);
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      std::fprintf(file, "\\%c", c);
+    } else if ((unsigned char)c < 0x20) {
+      std::fprintf(file, "\\u%04x", c);
+    } else {
+      std::fputc(c, file);
+    }
+  }
+  std::fputc('"', file);
+}
+
+/**
+ * Write the results as JSON, one object per benchmark, for tools that track
+ * them from build to build.
+ */
+static void WriteJson(std::FILE *file, const std::vector<Result> &results,
+                      const Options &options) {
+  std::fprintf(file, "{\n  \"context\": {\"min_time\": %g, \"repetitions\": %d},\n",
+               options.minTime, options.repetitions);
+  std::fprintf(file, "  \"benchmarks\": [");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result &result = results[i];
+    std::fprintf(file, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+    WriteJsonString(file, result.name);
+    if (!result.error.empty()) {
+      std::fprintf(file, ", \"error\": ");
+      WriteJsonString(file, result.error);
+    } else {
+      std::fprintf(file,
+                   ", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                   "\"allocs_per_op\": %.4f, \"bytes_per_op\": %.2f",
+                   (unsigned long long)result.iterations, result.nsPerOp,
+                   result.allocationsPerOp, result.bytesPerOp);
+    }
+    std::fprintf(file, "}");
+  }
+  std::fprintf(file, "\n  ]\n}\n");
+}
+
+static bool ParseArguments(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    std::string value;
+    size_t equals = arg.find('=');
+    if (equals != std::string::npos) value = arg.substr(equals + 1);
+    std::string flag = arg.substr(0, equals);
+
+    if (flag == "--filter") {
+      options.filter = value;
+    } else if (flag == "--min_time") {
+      options.minTime = std::atof(value.c_str());
+    } else if (flag == "--repetitions") {
+      options.repetitions = std::max(1, std::atoi(value.c_str()));
+    } else if (flag == "--json") {
+      options.jsonFile = value;
+    } else if (flag == "--list") {
+      options.list = true;
+    } else {
+      std::fprintf(stderr,
+                   "Usage: %s [--filter=<substring>] [--min_time=<seconds>]\n"
+                   "          [--repetitions=<n>] [--json=<file>|-] [--list]\n",
+                   argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!ParseArguments(argc, argv, options)) return 2;
+
+  std::vector<benchmark::Registered> selected;
+  for (const auto &registered : benchmark::GetRegistered()) {
+    if (registered.name.find(options.filter) != std::string::npos)
+      selected.push_back(registered);
+  }
+  std::sort(selected.begin(), selected.end(),
+            [](const benchmark::Registered &a, const benchmark::Registered &b) {
+              return a.name < b.name;
+            });
+  if (options.list) {
+    for (const auto &registered : selected)
+      std::printf("%s\n", registered.name.c_str());
+    return 0;
+  }
+
+  if (!HALInitialize()) {
+    std::fprintf(stderr, "FATAL ERROR: HAL could not be initialized\n");
+    return 1;
+  }
+  // Nothing moves the clock but the benchmarks, so the notifiers that
+  // PIDControllers and the like start don't fire in the middle of a run.
+  hal::desktop::SetManualClock(true);
+
+  std::vector<Result> results;
+  bool failed = false;
+  for (const auto &registered : selected) {
+    results.push_back(Measure(registered, options));
+    failed = failed || !results.back().error.empty();
+  }
+
+  bool jsonToStdout = options.jsonFile == "-";
+  if (!jsonToStdout) PrintTable(results);
+  if (!options.jsonFile.empty()) {
+    std::FILE *file =
+        jsonToStdout ? stdout : std::fopen(options.jsonFile.c_str(), "w");
+    if (file == nullptr) {
+      std::fprintf(stderr, "Couldn't open %s: %s\n", options.jsonFile.c_str(),
+                   std::strerror(errno));
+      return 1;
+    }
+    WriteJson(file, results, options);
+    if (!jsonToStdout) std::fclose(file);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "DriverStation.h"
+#include "Benchmark.h"
+#include "HALDesktop.hpp"
+
+#include <chrono>
+#include <thread>
+
+/**
+ * Send the driver station task a packet and wait until it's copied it. The
+ * task may not be waiting for packets yet, so keep sending until it is.
+ */
+static void SendPacket(DriverStation &ds) {
+  uint32_t packetCount = ds.GetPacketCount();
+  while (ds.GetPacketCount() == packetCount) {
+    hal::desktop::NotifyNewData();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+BENCHMARK(DriverStation_GetStickAxis) {
+  DriverStation &ds = DriverStation::GetInstance();
+  HALJoystickAxes axes = {};
+  axes.count = 6;
+  for (int i = 0; i < axes.count; i++) axes.axes[i] = i * 20;
+  hal::desktop::SetJoystickAxes(0, axes);
+  SendPacket(ds);
+
+  uint32_t axis = 0;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(ds.GetStickAxis(0, axis));
+    axis = (axis + 1) % 6;
+  }
+}
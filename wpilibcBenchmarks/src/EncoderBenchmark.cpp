@@ -0,0 +1,32 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "Encoder.h"
+#include "Benchmark.h"
+
+BENCHMARK(Encoder_Get_4X) {
+  Encoder encoder(0, 1, false, Encoder::k4X);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(encoder.Get());
+  }
+}
+
+/** 1X and 2X encoders are counted by an FPGA counter instead. */
+BENCHMARK(Encoder_Get_1X) {
+  Encoder encoder(0, 1, false, Encoder::k1X);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(encoder.Get());
+  }
+}
+
+BENCHMARK(Encoder_GetRate) {
+  Encoder encoder(0, 1, false, Encoder::k4X);
+  encoder.SetDistancePerPulse(0.01);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(encoder.GetRate());
+  }
+}
@@ -0,0 +1,31 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "ErrorBase.h"
+#include "Benchmark.h"
+
+/** The path every HAL call takes after it returns a good status. */
+BENCHMARK(ErrorBase_SetError_NoError) {
+  ErrorBase object;
+  while (state.KeepRunning()) {
+    object.SetError(0, "", __FILE__, __FUNCTION__, __LINE__);
+  }
+}
+
+/**
+ * A failing call made every loop. The same error isn't reported again within
+ * a second, and the clock doesn't move, so only the one before the loop is.
+ */
+BENCHMARK(ErrorBase_SetError_Repeated) {
+  ErrorBase object;
+  object.SetError(-1, "benchmark error", __FILE__, __FUNCTION__, __LINE__);
+  while (state.KeepRunning()) {
+    object.SetError(-1, "benchmark error", __FILE__, __FUNCTION__, __LINE__);
+  }
+  object.ClearError();
+  ErrorBase::GetGlobalError().Clear();
+}
@@ -0,0 +1,63 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "Notifier.h"
+#include "Benchmark.h"
+#include "HALDesktop.hpp"
+
+#include <atomic>
+
+static void CountCall(void *param) {
+  static_cast<std::atomic<uint64_t> *>(param)->fetch_add(1);
+}
+
+/** Scheduling and cancelling, which reprograms the alarm both times. */
+BENCHMARK(Notifier_StartStop) {
+  std::atomic<uint64_t> calls{0};
+  Notifier notifier(CountCall, &calls);
+  while (state.KeepRunning()) {
+    notifier.StartPeriodic(0.02);
+    notifier.Stop();
+  }
+}
+
+/**
+ * The full trip of a periodic notifier: the alarm fires, the queue is
+ * processed, the handler is called and the notifier is rescheduled. Each step
+ * of the clock makes exactly one of them due.
+ */
+BENCHMARK(Notifier_Dispatch) {
+  std::atomic<uint64_t> calls{0};
+  Notifier notifier(CountCall, &calls);
+  notifier.StartPeriodic(0.001);
+  while (state.KeepRunning()) {
+    hal::desktop::StepTime(1000);
+  }
+  // The expiration times are kept in floating point seconds, so a call can
+  // slip to the next microsecond and into the next step.
+  hal::desktop::StepTime(1000);
+  notifier.Stop();
+  if (calls < state.Iterations()) {
+    state.SkipWithError("the notifier fired fewer times than the clock stepped");
+  }
+}
+
+/** Several notifiers due at different times, as with a few PIDControllers. */
+BENCHMARK(Notifier_Dispatch_Queue) {
+  std::atomic<uint64_t> calls{0};
+  Notifier first(CountCall, &calls);
+  Notifier second(CountCall, &calls);
+  Notifier third(CountCall, &calls);
+  Notifier fourth(CountCall, &calls);
+  first.StartPeriodic(0.001);
+  second.StartPeriodic(0.002);
+  third.StartPeriodic(0.005);
+  fourth.StartPeriodic(0.01);
+  while (state.KeepRunning()) {
+    hal::desktop::StepTime(1000);
+  }
+}
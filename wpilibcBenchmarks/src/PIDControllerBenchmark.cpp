@@ -0,0 +1,64 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "PIDController.h"
+#include "PIDOutput.h"
+#include "PIDSource.h"
+#include "Benchmark.h"
+
+class RampSource : public PIDSource {
+ public:
+  double PIDGet() override {
+    m_value = m_value > 9.9 ? 0.0 : m_value + 0.1;
+    return m_value;
+  }
+
+ private:
+  double m_value = 0.0;
+};
+
+class NullOutput : public PIDOutput {
+ public:
+  void PIDWrite(float output) override { benchmark::DoNotOptimize(output); }
+};
+
+/**
+ * Calls Calculate() directly, rather than waiting for the control loop's
+ * notifier, which doesn't fire since the benchmarks keep the clock still.
+ */
+class BenchmarkPIDController : public PIDController {
+ public:
+  using PIDController::PIDController;
+  using PIDController::Calculate;
+};
+
+BENCHMARK(PIDController_Calculate) {
+  RampSource source;
+  NullOutput output;
+  BenchmarkPIDController controller(0.1, 0.01, 0.001, &source, &output);
+  controller.SetInputRange(0.0, 10.0);
+  controller.SetSetpoint(5.0);
+  controller.SetToleranceBuffer(10);
+  controller.Enable();
+  while (state.KeepRunning()) {
+    controller.Calculate();
+  }
+  controller.Disable();
+}
+
+BENCHMARK(PIDController_Calculate_Rate) {
+  RampSource source;
+  source.SetPIDSourceType(PIDSourceType::kRate);
+  NullOutput output;
+  BenchmarkPIDController controller(0.1, 0.0, 0.0, 0.05, &source, &output);
+  controller.SetSetpoint(5.0);
+  controller.Enable();
+  while (state.KeepRunning()) {
+    controller.Calculate();
+  }
+  controller.Disable();
+}
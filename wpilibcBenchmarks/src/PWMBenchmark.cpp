@@ -0,0 +1,39 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "PWM.h"
+#include "Talon.h"
+#include "Benchmark.h"
+
+/** Makes SetSpeed(), which the speed controllers wrap, callable directly. */
+class BenchmarkPWM : public PWM {
+ public:
+  explicit BenchmarkPWM(uint32_t channel) : PWM(channel) {
+    SetBounds(2.037, 1.539, 1.513, 1.487, .989);
+  }
+
+  using PWM::SetSpeed;
+};
+
+BENCHMARK(PWM_SetSpeed) {
+  BenchmarkPWM pwm(0);
+  float speed = 0.0f;
+  while (state.KeepRunning()) {
+    pwm.SetSpeed(speed);
+    speed = speed > 0.99f ? -1.0f : speed + 0.01f;
+  }
+}
+
+/** The same, through a speed controller and its motor safety feed. */
+BENCHMARK(Talon_Set) {
+  Talon talon(0);
+  float speed = 0.0f;
+  while (state.KeepRunning()) {
+    talon.Set(speed);
+    speed = speed > 0.99f ? -1.0f : speed + 0.01f;
+  }
+}
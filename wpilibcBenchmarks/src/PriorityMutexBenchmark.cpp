@@ -0,0 +1,47 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "HAL/cpp/mutex_profiler.h"
+#include "HAL/cpp/priority_mutex.h"
+#include "Benchmark.h"
+
+/*
+ * An uncontended lock and unlock, the common case for the wpilibc locks.
+ * Comparing the first two gives the cost of the profiler's hooks while it's
+ * disabled, or of nothing when it isn't built in. The profiled one is only
+ * built with -PmutexProfiling.
+ */
+
+/** The pthread mutex under priority_mutex, without the profiler's hooks. */
+BENCHMARK(PriorityMutex_LockUnlock_Pthread) {
+  priority_mutex mutex;
+  while (state.KeepRunning()) {
+    pthread_mutex_lock(mutex.native_handle());
+    pthread_mutex_unlock(mutex.native_handle());
+  }
+}
+
+BENCHMARK(PriorityMutex_LockUnlock) {
+  priority_mutex mutex;
+  while (state.KeepRunning()) {
+    mutex.lock();
+    mutex.unlock();
+  }
+}
+
+#ifdef FRC_MUTEX_PROFILING
+BENCHMARK(PriorityMutex_LockUnlock_Profiled) {
+  hal::mutex_profiler::SetEnabled(true);
+  priority_mutex mutex;
+  while (state.KeepRunning()) {
+    mutex.lock();
+    mutex.unlock();
+  }
+  hal::mutex_profiler::SetEnabled(false);
+  hal::mutex_profiler::Reset();
+}
+#endif
@@ -0,0 +1,58 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "Commands/Command.h"
+#include "Commands/Scheduler.h"
+#include "Benchmark.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * A command that never finishes and does nothing, so only the scheduling is
+ * measured.
+ */
+class IdleCommand : public Command {
+ public:
+  IdleCommand() { SetRunWhenDisabled(true); }
+
+ protected:
+  void Initialize() override {}
+  void Execute() override {}
+  bool IsFinished() override { return false; }
+  void End() override {}
+  void Interrupted() override {}
+};
+
+/**
+ * A pass of the scheduler with ten commands running, about what a competition
+ * robot has.
+ */
+BENCHMARK(Scheduler_Run) {
+  Scheduler *scheduler = Scheduler::GetInstance();
+  scheduler->SetEnabled(true);
+  std::vector<std::unique_ptr<IdleCommand>> commands;
+  for (int i = 0; i < 10; i++) {
+    commands.push_back(std::make_unique<IdleCommand>());
+    commands.back()->Start();
+  }
+  // The first pass starts the commands.
+  scheduler->Run();
+
+  while (state.KeepRunning()) {
+    scheduler->Run();
+  }
+  scheduler->RemoveAll();
+}
+
+BENCHMARK(Scheduler_Run_Empty) {
+  Scheduler *scheduler = Scheduler::GetInstance();
+  scheduler->SetEnabled(true);
+  while (state.KeepRunning()) {
+    scheduler->Run();
+  }
+}
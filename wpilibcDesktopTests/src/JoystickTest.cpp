@@ -0,0 +1,159 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "DriverStation.h"
+#include "Joystick.h"
+#include "RobotDrive.h"
+#include "SpeedController.h"
+#include "HALDesktop.hpp"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+
+static const uint32_t kPort = 2;
+static const double kEpsilon = 1e-5;
+
+/** A motor controller that only remembers what it was set to */
+class FakeSpeedController : public SpeedController {
+ public:
+  void Set(float speed, uint8_t syncGroup = 0) override { m_speed = speed; }
+  float Get() const override { return m_speed; }
+  void SetInverted(bool isInverted) override {}
+  void Disable() override { m_speed = 0.0f; }
+  bool GetInverted() const override { return false; }
+  void PIDWrite(float output) override { Set(output); }
+
+ private:
+  float m_speed = 0.0f;
+};
+
+class JoystickTest : public testing::Test {
+ protected:
+  virtual void SetUp() override {
+    hal::desktop::SetManualClock(true);
+    hal::desktop::Reset();
+  }
+
+  virtual void TearDown() override { hal::desktop::SetManualClock(false); }
+
+  /**
+   * Send the driver station task a packet with the given axes and wait until
+   * it's copied it. The task may not be waiting for packets yet, so keep
+   * sending until it is.
+   */
+  void SendAxes(std::initializer_list<int8_t> values) {
+    HALJoystickAxes axes = {};
+    for (int8_t value : values) axes.axes[axes.count++] = value;
+    hal::desktop::SetJoystickAxes(kPort, axes);
+
+    DriverStation &ds = DriverStation::GetInstance();
+    uint32_t packetCount = ds.GetPacketCount();
+    while (ds.GetPacketCount() == packetCount) {
+      hal::desktop::NotifyNewData();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+};
+
+TEST_F(JoystickTest, UnshapedAxisMatchesDriverStation) {
+  Joystick stick(kPort);
+  SendAxes({64, -64, 127, -128});
+
+  EXPECT_NEAR(64 / 127.0, stick.GetRawAxis(0), kEpsilon);
+  EXPECT_NEAR(-64 / 128.0, stick.GetRawAxis(1), kEpsilon);
+  EXPECT_FLOAT_EQ(1.0f, stick.GetRawAxis(2));
+  EXPECT_FLOAT_EQ(-1.0f, stick.GetRawAxis(3));
+  EXPECT_FALSE(stick.IsAxisShaped(0));
+}
+
+TEST_F(JoystickTest, MissingAxisReadsZero) {
+  Joystick stick(kPort);
+  SendAxes({64});
+
+  EXPECT_FLOAT_EQ(0.0f, stick.GetRawAxis(3));
+}
+
+TEST_F(JoystickTest, DeadbandIsRescaled) {
+  Joystick stick(kPort);
+  stick.SetAxisDeadband(0, 0.1f);
+  SendAxes({6, 127});
+
+  EXPECT_TRUE(stick.IsAxisShaped(0));
+  EXPECT_FALSE(stick.IsAxisShaped(1));
+  EXPECT_FLOAT_EQ(0.0f, stick.GetRawAxis(0));
+  EXPECT_FLOAT_EQ(1.0f, stick.GetRawAxis(1));
+
+  SendAxes({64, 127});
+  EXPECT_NEAR((64 / 127.0 - 0.1) / 0.9, stick.GetRawAxis(0), kEpsilon);
+  SendAxes({127, 127});
+  EXPECT_FLOAT_EQ(1.0f, stick.GetRawAxis(0));
+}
+
+TEST_F(JoystickTest, ExpoIsCubic) {
+  Joystick stick(kPort);
+  stick.SetAxisExpo(0, 1.0f);
+  SendAxes({-64});
+
+  double value = -64 / 128.0;
+  EXPECT_TRUE(stick.IsAxisShaped(0));
+  EXPECT_NEAR(value * value * value, stick.GetRawAxis(0), kEpsilon);
+}
+
+/**
+ * The slew rate is per second of real time, however many packets arrive in
+ * that time.
+ */
+TEST_F(JoystickTest, SlewRateFollowsTime) {
+  Joystick stick(kPort);
+  stick.SetAxisSlewRate(0, 1.0f);
+  SendAxes({0});
+  EXPECT_FLOAT_EQ(0.0f, stick.GetRawAxis(0));
+
+  hal::desktop::StepTime(100000);
+  SendAxes({127});
+  EXPECT_NEAR(0.1, stick.GetRawAxis(0), kEpsilon);
+
+  // A second packet in the same instant can't move the axis any further
+  SendAxes({127});
+  EXPECT_NEAR(0.1, stick.GetRawAxis(0), kEpsilon);
+
+  hal::desktop::StepTime(50000);
+  SendAxes({127});
+  EXPECT_NEAR(0.15, stick.GetRawAxis(0), kEpsilon);
+  EXPECT_FALSE(stick.IsAxisShaped(0));
+}
+
+TEST_F(JoystickTest, RobotDriveSquaresUnshapedAxes) {
+  FakeSpeedController left, right;
+  RobotDrive drive(left, right);
+  drive.SetSafetyEnabled(false);
+  Joystick stick(kPort);
+  SendAxes({0, 64});
+
+  drive.TankDrive(stick, stick, true);
+  double value = 64 / 127.0;
+  EXPECT_NEAR(value * value, left.Get(), kEpsilon);
+}
+
+/**
+ * An axis the Joystick already shapes is passed straight through, rather than
+ * being squared on top of its expo curve.
+ */
+TEST_F(JoystickTest, RobotDriveDoesNotSquareShapedAxes) {
+  FakeSpeedController left, right;
+  RobotDrive drive(left, right);
+  drive.SetSafetyEnabled(false);
+  Joystick stick(kPort);
+  stick.SetAxisExpo(1, 0.5f);
+  SendAxes({0, 64});
+
+  drive.TankDrive(stick, stick, true);
+  EXPECT_FLOAT_EQ(stick.GetY(), left.Get());
+  drive.TankDrive(stick, 1, stick, 1, true);
+  EXPECT_FLOAT_EQ(stick.GetY(), left.Get());
+}
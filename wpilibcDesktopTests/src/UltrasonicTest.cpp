@@ -0,0 +1,80 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "Ultrasonic.h"
+#include "HALDesktop.hpp"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+
+static const uint32_t kPingChannel = 6;
+static const uint32_t kEchoChannel = 7;
+
+class UltrasonicTest : public testing::Test {
+ protected:
+  virtual void SetUp() override {
+    hal::desktop::SetManualClock(true);
+    hal::desktop::Reset();
+    m_pingPeriod = Ultrasonic::GetPingPeriod();
+  }
+
+  virtual void TearDown() override {
+    Ultrasonic::SetPingPeriod(m_pingPeriod);
+    hal::desktop::SetManualClock(false);
+  }
+
+  /**
+   * Wait for the automatic mode task to ping, then answer with an echo of the
+   * given length.  The clock only moves with the echo, so the ping pulse lasts
+   * until then.
+   */
+  bool Echo(uint64_t microseconds) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!hal::desktop::IsPulsing(kPingChannel)) {
+      if (std::chrono::steady_clock::now() > deadline) return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    hal::desktop::SetDigitalInput(kEchoChannel, true);
+    hal::desktop::StepTime(microseconds);
+    hal::desktop::SetDigitalInput(kEchoChannel, false);
+    return true;
+  }
+
+  double m_pingPeriod;
+};
+
+TEST_F(UltrasonicTest, PingPeriodMustBePositive) {
+  Ultrasonic::SetPingPeriod(0.05);
+  Ultrasonic::SetPingPeriod(0.0);
+  EXPECT_DOUBLE_EQ(0.05, Ultrasonic::GetPingPeriod());
+  Ultrasonic::SetPingPeriod(-1.0);
+  EXPECT_DOUBLE_EQ(0.05, Ultrasonic::GetPingPeriod());
+}
+
+TEST_F(UltrasonicTest, EchoIsAddedToTheHistory) {
+  Ultrasonic::SetPingPeriod(0.01);
+  Ultrasonic ultrasonic(kPingChannel, kEchoChannel);
+  Ultrasonic::SetAutomaticMode(true);
+
+  // Three 5ms echoes, so the median filter has a full window
+  for (int i = 0; i < 3; i++) ASSERT_TRUE(Echo(5000));
+
+  Ultrasonic::RangeSample samples[Ultrasonic::kHistorySize];
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  int count;
+  while ((count = ultrasonic.GetRangeHistory(samples, 3)) < 3 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  Ultrasonic::SetAutomaticMode(false);
+
+  ASSERT_EQ(3, count);
+  // Sound travels 1130 ft/s, and the echo covers the range there and back
+  EXPECT_NEAR(0.005 * 1130.0 * 12.0 / 2.0, samples[0].rangeInches, 0.01);
+  EXPECT_GT(samples[0].timestamp, samples[1].timestamp);
+}
@@ -0,0 +1,131 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "V4L2Capture.h"
+#include "gtest/gtest.h"
+
+#include <unistd.h>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * A minimal JPEG: an APP0 marker and a scan with size bytes of data.
+ */
+static std::vector<uint8_t> MakeJpeg(int number, size_t size) {
+  std::vector<uint8_t> jpeg = {0xff, 0xd8, 0xff, 0xe0, 0x00, 0x04,
+                               static_cast<uint8_t>(number), 0x00,
+                               0xff, 0xda, 0x00, 0x04, 0x00, 0x00};
+  for (size_t i = 0; i < size; i++) jpeg.push_back((i * 7 + number) % 0xfe);
+  jpeg.push_back(0xff);
+  jpeg.push_back(0xd9);
+  return jpeg;
+}
+
+/**
+ * Writes the frames of a fake camera device to a temporary file.
+ */
+class FakeDeviceFile {
+ public:
+  explicit FakeDeviceFile(const std::vector<std::vector<uint8_t>> &frames) {
+    char path[] = "/tmp/V4L2CaptureTestXXXXXX";
+    int fd = mkstemp(path);
+    for (auto &frame : frames) write(fd, frame.data(), frame.size());
+    close(fd);
+    m_path = path;
+  }
+
+  ~FakeDeviceFile() { unlink(m_path.c_str()); }
+
+  const std::string &GetPath() const { return m_path; }
+
+ private:
+  std::string m_path;
+};
+
+TEST(V4L2CaptureTest, JpegSize) {
+  std::vector<uint8_t> jpeg = MakeJpeg(1, 100);
+  EXPECT_EQ(jpeg.size(), V4L2Capture::GetJpegSize(jpeg.data(), jpeg.size()));
+
+  // Anything after the end of the image isn't part of it
+  std::vector<uint8_t> padded = jpeg;
+  padded.resize(jpeg.size() + 50, 0);
+  EXPECT_EQ(jpeg.size(),
+            V4L2Capture::GetJpegSize(padded.data(), padded.size()));
+}
+
+/**
+ * A JPEG cut off anywhere isn't read past its end. Each one is copied into a
+ * buffer of its own size, so a sanitizer catches reads past it.
+ */
+TEST(V4L2CaptureTest, TruncatedJpegSize) {
+  std::vector<uint8_t> jpeg = MakeJpeg(1, 20);
+  for (size_t size = 0; size < jpeg.size(); size++) {
+    std::vector<uint8_t> truncated(jpeg.begin(), jpeg.begin() + size);
+    EXPECT_EQ(0u, V4L2Capture::GetJpegSize(truncated.data(), size))
+        << size << " bytes";
+  }
+}
+
+TEST(V4L2CaptureTest, FakeJpegFrames) {
+  std::vector<std::vector<uint8_t>> jpegs = {MakeJpeg(1, 500),
+                                             MakeJpeg(2, 70)};
+  FakeDeviceFile file(jpegs);
+  V4L2Capture capture(file.GetPath());
+  V4L2Capture::Settings settings;
+  settings.fps = 0;
+  capture.ApplySettings(settings);
+  capture.Open();
+  ASSERT_TRUE(capture.IsFakeDevice());
+  capture.Start();
+
+  for (unsigned int i = 0; i < 2 * jpegs.size(); i++) {
+    V4L2Capture::Frame frame;
+    ASSERT_TRUE(capture.AcquireFrame(frame));
+    EXPECT_EQ(jpegs[i % jpegs.size()],
+              std::vector<uint8_t>(frame.data, frame.data + frame.size));
+    capture.ReleaseFrame(frame.data);
+  }
+  EXPECT_EQ(0, capture.GetError().GetCode());
+}
+
+/**
+ * Waiting for a frame doesn't hold the lock, so another thread can give back
+ * its frame in the meantime.
+ */
+TEST(V4L2CaptureTest, WaitDoesNotBlockRelease) {
+  FakeDeviceFile file({MakeJpeg(1, 100)});
+  V4L2Capture capture(file.GetPath());
+  V4L2Capture::Settings settings;
+  settings.fps = 2;
+  capture.ApplySettings(settings);
+  capture.Open();
+  capture.Start();
+
+  V4L2Capture::Frame first;
+  ASSERT_TRUE(capture.AcquireFrame(first));
+  auto waiting = std::async(std::launch::async, [&capture] {
+    V4L2Capture::Frame frame;
+    bool acquired = capture.AcquireFrame(frame);
+    if (acquired) capture.ReleaseFrame(frame.data);
+    return acquired;
+  });
+
+  // The next frame is due in half a second
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  auto start = std::chrono::steady_clock::now();
+  capture.ReleaseFrame(first.data);
+  EXPECT_TRUE(capture.IsActive());
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(100));
+
+  EXPECT_TRUE(waiting.get());
+  EXPECT_EQ(0, capture.GetError().GetCode());
+}
@@ -0,0 +1,209 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <Vision/AxisCamera.h>
+#include <Vision/MJPEGStreamParser.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+
+static const std::string kStreamHeader =
+    "HTTP/1.0 200 OK\r\n"
+    "Content-Type: multipart/x-mixed-replace; boundary=myboundary\r\n\r\n";
+
+/**
+ * The bytes of a fake frame; the first byte is the frame number.
+ */
+static std::vector<uint8_t> MakeFrame(int number, size_t size) {
+  std::vector<uint8_t> frame(size);
+  frame[0] = number;
+  for (size_t i = 1; i < size; i++) frame[i] = (i * 7 + number) & 0xff;
+  return frame;
+}
+
+static std::string MakePart(const std::vector<uint8_t> &frame) {
+  return "--myboundary\r\nContent-Type: image/jpeg\r\nContent-Length: " +
+         std::to_string(frame.size()) + "\r\n\r\n" +
+         std::string(frame.begin(), frame.end()) + "\r\n";
+}
+
+/**
+ * Serves an endless MJPEG stream of numbered frames on a local port, like an
+ * Axis camera, and accepts parameter updates. Every stream connection is
+ * dropped after m_framesPerConnection frames.
+ */
+class FakeAxisCamera {
+ public:
+  explicit FakeAxisCamera(int framesPerConnection)
+      : m_framesPerConnection(framesPerConnection) {
+    m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    bind(m_listenSocket, (struct sockaddr *)&address, sizeof(address));
+    listen(m_listenSocket, 4);
+
+    socklen_t size = sizeof(address);
+    getsockname(m_listenSocket, (struct sockaddr *)&address, &size);
+    m_port = ntohs(address.sin_port);
+
+    m_acceptThread = std::thread(&FakeAxisCamera::Accept, this);
+  }
+
+  ~FakeAxisCamera() {
+    m_done = true;
+    shutdown(m_listenSocket, SHUT_RDWR);
+    close(m_listenSocket);
+    m_acceptThread.join();
+    for (auto &thread : m_connectionThreads) thread.join();
+  }
+
+  std::string GetHost() const {
+    return "127.0.0.1:" + std::to_string(m_port);
+  }
+
+  int GetStreamConnections() const { return m_streamConnections; }
+
+ private:
+  void Accept() {
+    while (!m_done) {
+      int connection = accept(m_listenSocket, nullptr, nullptr);
+      if (connection < 0) return;
+      m_connectionThreads.emplace_back(&FakeAxisCamera::Serve, this,
+                                       connection);
+    }
+  }
+
+  void Serve(int connection) {
+    std::string request;
+    char c;
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.find("\n\n") == std::string::npos &&
+           recv(connection, &c, 1, 0) == 1) {
+      request += c;
+    }
+
+    if (request.find("GET /mjpg/video.mjpg") == 0) {
+      m_streamConnections++;
+      Send(connection, kStreamHeader);
+      for (int i = 0; i < m_framesPerConnection && !m_done; i++) {
+        // Vary the size, and send in small pieces to split headers and frames
+        std::string part = MakePart(MakeFrame(m_frameNumber++, 1000 + i * 37));
+        for (size_t sent = 0; sent < part.size(); sent += 333) {
+          if (!Send(connection, part.substr(sent, 333))) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+    } else {
+      Send(connection, "HTTP/1.0 200 OK\r\n\r\n");
+    }
+    close(connection);
+  }
+
+  bool Send(int connection, const std::string &data) {
+    return send(connection, data.data(), data.size(), MSG_NOSIGNAL) ==
+           static_cast<ssize_t>(data.size());
+  }
+
+  int m_framesPerConnection;
+  int m_listenSocket;
+  int m_port;
+  std::atomic<bool> m_done{false};
+  std::atomic<int> m_frameNumber{0};
+  std::atomic<int> m_streamConnections{0};
+  std::thread m_acceptThread;
+  std::vector<std::thread> m_connectionThreads;
+};
+
+/**
+ * Feeding the stream a byte at a time yields the same frames as feeding it in
+ * one piece.
+ */
+TEST(MJPEGStreamParserTest, SplitAnywhere) {
+  std::vector<uint8_t> frame1 = MakeFrame(1, 500), frame2 = MakeFrame(2, 70);
+  std::string stream = kStreamHeader + MakePart(frame1) + MakePart(frame2);
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(stream.data());
+
+  for (size_t pieceSize : {size_t(1), size_t(7), stream.size()}) {
+    MJPEGStreamParser parser;
+    std::vector<std::vector<uint8_t>> frames;
+    for (size_t offset = 0; offset < stream.size();) {
+      size_t length = std::min(pieceSize, stream.size() - offset);
+      MJPEGStreamParser::Result result;
+      offset += parser.Feed(data + offset, length, result);
+      ASSERT_NE(MJPEGStreamParser::kError, result);
+      if (result == MJPEGStreamParser::kFrameReady) {
+        frames.push_back(parser.GetFrame());
+      }
+    }
+
+    ASSERT_EQ(2u, frames.size()) << "piece size " << pieceSize;
+    EXPECT_EQ(frame1, frames[0]);
+    EXPECT_EQ(frame2, frames[1]);
+  }
+}
+
+TEST(MJPEGStreamParserTest, BadContentLength) {
+  std::string stream = "--myboundary\r\nContent-Length: junk\r\n\r\n";
+  MJPEGStreamParser parser;
+  MJPEGStreamParser::Result result;
+  parser.Feed(reinterpret_cast<const uint8_t *>(stream.data()), stream.size(),
+              result);
+  EXPECT_EQ(MJPEGStreamParser::kError, result);
+}
+
+/**
+ * Frames from the camera arrive with their exact length.
+ */
+TEST(AxisCameraTest, ReceivesFrames) {
+  FakeAxisCamera server(1000);
+  AxisCamera camera(server.GetHost());
+
+  char *image = nullptr;
+  unsigned int imageSize = 0, imageBufferSize = 0;
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(camera.WaitForImage(3.0)) << "No image from the camera";
+    ASSERT_EQ(1, camera.CopyJPEG(&image, imageSize, imageBufferSize));
+
+    ASSERT_GE(imageSize, 1000u);
+    std::vector<uint8_t> received(image, image + imageSize);
+    EXPECT_EQ(MakeFrame(received[0], imageSize), received);
+  }
+  delete[] image;
+}
+
+/**
+ * When the camera drops the connection, the stream is restarted.
+ */
+TEST(AxisCameraTest, Reconnects) {
+  FakeAxisCamera server(3);
+  AxisCamera camera(server.GetHost());
+
+  int images = 0;
+  char *image = nullptr;
+  unsigned int imageSize = 0, imageBufferSize = 0;
+  while (images < 12 && camera.WaitForImage(3.0)) {
+    camera.CopyJPEG(&image, imageSize, imageBufferSize);
+    images++;
+  }
+  delete[] image;
+
+  EXPECT_EQ(12, images);
+  EXPECT_GE(server.GetStreamConnections(), 4);
+}
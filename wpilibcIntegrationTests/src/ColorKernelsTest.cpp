@@ -0,0 +1,248 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <Vision/ColorKernels.h>
+#include <Vision/BinaryImage.h>
+#include <Vision/HSLImage.h>
+#include <Vision/RGBImage.h>
+#include <WPIErrors.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "gtest/gtest.h"
+
+// An odd width with a padded line, to cover the scalar end of each line
+static const int kWidth = 37;
+static const int kHeight = 5;
+static const int kPixelsPerLine = 40;
+
+/**
+ * An RGB image of random pixels, with runs of gray and of pixels that share
+ * their largest channel, since those take the edge cases of the HSV
+ * conversion.
+ */
+static std::vector<uint8_t> MakePixels(int pixelsPerLine, int height,
+                                       unsigned int seed) {
+  std::vector<uint8_t> pixels(4 * pixelsPerLine * height);
+  std::srand(seed);
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    int kind = std::rand() % 4;
+    uint8_t value = std::rand();
+    for (int c = 0; c < 3; c++) {
+      pixels[i + c] = kind == 0 ? value : (kind == 1 && c != 0 ? value
+                                                               : std::rand());
+    }
+    pixels[i + 3] = std::rand();
+  }
+  return pixels;
+}
+
+class ColorKernelsTest : public testing::Test {
+ protected:
+  virtual void TearDown() override { ColorKernels::SetVectorized(true); }
+
+  std::vector<uint8_t> m_pixels = MakePixels(kPixelsPerLine, kHeight, 1);
+};
+
+/**
+ * The vector and scalar code give the same result for every pixel.
+ */
+TEST_F(ColorKernelsTest, VectorMatchesScalar) {
+  std::vector<Threshold> thresholds = {Threshold(20, 200, 0, 255, 50, 180),
+                                       Threshold(200, 30, 40, 255, 10, 255),
+                                       Threshold(0, 255, 0, 255, 0, 255)};
+  for (auto &threshold : thresholds) {
+    std::vector<uint8_t> vector(kPixelsPerLine * kHeight, 99),
+        scalar(kPixelsPerLine * kHeight, 99);
+
+    ColorKernels::SetVectorized(true);
+    ColorKernels::ThresholdRGB(m_pixels.data(), kPixelsPerLine, vector.data(),
+                               kPixelsPerLine, kWidth, kHeight, threshold, 7);
+    ColorKernels::SetVectorized(false);
+    ColorKernels::ThresholdRGB(m_pixels.data(), kPixelsPerLine, scalar.data(),
+                               kPixelsPerLine, kWidth, kHeight, threshold, 7);
+    EXPECT_EQ(scalar, vector);
+
+    ColorKernels::SetVectorized(true);
+    ColorKernels::ThresholdHSV(m_pixels.data(), kPixelsPerLine, vector.data(),
+                               kPixelsPerLine, kWidth, kHeight, threshold, 7);
+    ColorKernels::SetVectorized(false);
+    ColorKernels::ThresholdHSV(m_pixels.data(), kPixelsPerLine, scalar.data(),
+                               kPixelsPerLine, kWidth, kHeight, threshold, 7);
+    EXPECT_EQ(scalar, vector);
+
+    // The padding at the end of each line is left alone
+    EXPECT_EQ(99, vector[kPixelsPerLine - 1]);
+  }
+
+  for (ColorKernels::Plane plane :
+       {ColorKernels::kRedPlane, ColorKernels::kGreenPlane,
+        ColorKernels::kBluePlane, ColorKernels::kHSVHuePlane,
+        ColorKernels::kHSVSaturationPlane, ColorKernels::kHSVValuePlane}) {
+    std::vector<uint8_t> vector(kPixelsPerLine * kHeight),
+        scalar(kPixelsPerLine * kHeight);
+    ColorKernels::SetVectorized(true);
+    ColorKernels::ExtractPlane(m_pixels.data(), kPixelsPerLine, vector.data(),
+                               kPixelsPerLine, kWidth, kHeight, plane);
+    ColorKernels::SetVectorized(false);
+    ColorKernels::ExtractPlane(m_pixels.data(), kPixelsPerLine, scalar.data(),
+                               kPixelsPerLine, kWidth, kHeight, plane);
+    EXPECT_EQ(scalar, vector) << "plane " << plane;
+  }
+}
+
+/**
+ * The fused HSV threshold gives the same result as thresholding each of the
+ * extracted HSV planes.
+ */
+TEST_F(ColorKernelsTest, ThresholdHSVMatchesPlanes) {
+  std::vector<uint8_t> hue(kPixelsPerLine * kHeight),
+      saturation(kPixelsPerLine * kHeight), value(kPixelsPerLine * kHeight);
+  ColorKernels::ExtractPlane(m_pixels.data(), kPixelsPerLine, hue.data(),
+                             kPixelsPerLine, kWidth, kHeight,
+                             ColorKernels::kHSVHuePlane);
+  ColorKernels::ExtractPlane(m_pixels.data(), kPixelsPerLine,
+                             saturation.data(), kPixelsPerLine, kWidth,
+                             kHeight, ColorKernels::kHSVSaturationPlane);
+  ColorKernels::ExtractPlane(m_pixels.data(), kPixelsPerLine, value.data(),
+                             kPixelsPerLine, kWidth, kHeight,
+                             ColorKernels::kHSVValuePlane);
+
+  for (int hueLow = 0; hueLow < 256; hueLow += 51) {
+    for (int hueHigh = 25; hueHigh < 256; hueHigh += 51) {
+      Threshold threshold(hueLow, hueHigh, 30, 220, 40, 250);
+      std::vector<uint8_t> result(kPixelsPerLine * kHeight);
+      ColorKernels::ThresholdHSV(m_pixels.data(), kPixelsPerLine,
+                                 result.data(), kPixelsPerLine, kWidth,
+                                 kHeight, threshold);
+
+      for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+          int i = y * kPixelsPerLine + x;
+          bool hueIn = hueLow <= hueHigh
+                           ? hue[i] >= hueLow && hue[i] <= hueHigh
+                           : hue[i] >= hueLow || hue[i] <= hueHigh;
+          bool in = hueIn && saturation[i] >= 30 && saturation[i] <= 220 &&
+                    value[i] >= 40 && value[i] <= 250;
+          ASSERT_EQ(in ? 1 : 0, result[i]) << "pixel " << x << ", " << y;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * The native HSV scale: hue goes from 0 to 255 once around the color circle,
+ * and saturation and value from 0 to 255.
+ */
+TEST_F(ColorKernelsTest, KnownColors) {
+  // Blue, green, red, alpha
+  std::vector<uint8_t> pixels = {0,   0,   255, 0, 0,   255, 0,   0,
+                                 255, 0,   0,   0, 128, 128, 128, 0,
+                                 0,   0,   0,   0, 0,   255, 255, 0};
+  std::vector<uint8_t> plane(6);
+  ColorKernels::ExtractPlane(pixels.data(), 6, plane.data(), 6, 6, 1,
+                             ColorKernels::kHSVHuePlane);
+  // Red, green, blue, gray, black, yellow
+  EXPECT_EQ((std::vector<uint8_t>{0, 85, 170, 0, 0, 42}), plane);
+  ColorKernels::ExtractPlane(pixels.data(), 6, plane.data(), 6, 6, 1,
+                             ColorKernels::kHSVSaturationPlane);
+  EXPECT_EQ((std::vector<uint8_t>{255, 255, 255, 0, 0, 255}), plane);
+  ColorKernels::ExtractPlane(pixels.data(), 6, plane.data(), 6, 6, 1,
+                             ColorKernels::kHSVValuePlane);
+  EXPECT_EQ((std::vector<uint8_t>{255, 255, 255, 128, 0, 255}), plane);
+}
+
+/**
+ * The native HSV scale differs from that of IMAQ_HSV, so it isn't used as a
+ * stand-in for images that aren't RGB.
+ */
+TEST_F(ColorKernelsTest, NativeHSVNeedsRGB) {
+  HSLImage image;
+  BinaryImage binary;
+  image.ThresholdNativeHSV(Threshold(0, 255, 0, 255, 0, 255), &binary);
+  EXPECT_EQ(wpi_error_value_IncompatibleMode, image.GetError().GetCode());
+}
+
+/**
+ * Time a function over a number of frames, in milliseconds per frame.
+ */
+template <typename F>
+static double TimeFrames(int frames, F function) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) function();
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+/**
+ * Compare the native kernels with the NI Vision library at common camera
+ * sizes.
+ */
+TEST_F(ColorKernelsTest, Benchmark) {
+  const int kFrames = 50;
+  struct Size {
+    int width;
+    int height;
+  };
+
+  for (Size size : {Size{320, 240}, Size{640, 480}}) {
+    std::vector<uint8_t> pixels = MakePixels(size.width, size.height, 2);
+    std::vector<uint8_t> result(size.width * size.height);
+    Threshold threshold(20, 60, 100, 255, 80, 255);
+
+    RGBImage image;
+    imaqArrayToImage(image.GetImaqImage(), pixels.data(), size.width,
+                     size.height);
+    BinaryImage binary;
+    MonoImage mono;
+    Range hue = {20, 60}, saturation = {100, 255}, value = {80, 255};
+
+    std::cout << size.width << "x" << size.height << " ms/frame:" << std::endl;
+    double imaqHSV = TimeFrames(kFrames, [&] {
+      imaqColorThreshold(binary.GetImaqImage(), image.GetImaqImage(), 1,
+                         IMAQ_HSV, &hue, &saturation, &value);
+    });
+    double imaqPlane = TimeFrames(kFrames, [&] {
+      imaqExtractColorPlanes(image.GetImaqImage(), IMAQ_HSV,
+                             mono.GetImaqImage(), nullptr, nullptr);
+    });
+
+    for (bool vectorized : {false, true}) {
+      if (vectorized && !ColorKernels::HasVectorUnit()) continue;
+      ColorKernels::SetVectorized(vectorized);
+      double rgb = TimeFrames(kFrames, [&] {
+        ColorKernels::ThresholdRGB(pixels.data(), size.width, result.data(),
+                                   size.width, size.width, size.height,
+                                   threshold);
+      });
+      double hsv = TimeFrames(kFrames, [&] {
+        ColorKernels::ThresholdHSV(pixels.data(), size.width, result.data(),
+                                   size.width, size.width, size.height,
+                                   threshold);
+      });
+      double plane = TimeFrames(kFrames, [&] {
+        ColorKernels::ExtractPlane(pixels.data(), size.width, result.data(),
+                                   size.width, size.width, size.height,
+                                   ColorKernels::kHSVHuePlane);
+      });
+      std::cout << "  " << (vectorized ? "vector" : "scalar")
+                << " RGB threshold " << rgb << ", HSV threshold " << hsv
+                << ", hue plane " << plane << std::endl;
+    }
+
+    // Through ColorImage, including getting the image info
+    ColorKernels::SetVectorized(true);
+    double colorImage = TimeFrames(kFrames, [&] {
+      image.ThresholdNativeHSV(threshold, &binary);
+    });
+    std::cout << "  ColorImage::ThresholdNativeHSV " << colorImage
+              << ", imaq HSV threshold " << imaqHSV << ", imaq hue plane "
+              << imaqPlane << std::endl;
+  }
+}
@@ -0,0 +1,194 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "HAL/cpp/HandleTable.hpp"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace wpilib {
+namespace testing {
+
+struct FakePort {
+  int value = 0;
+};
+
+typedef hal::HandleTable<FakePort, 8, hal::HandleType::Counter> CounterTable;
+typedef hal::HandleTable<FakePort, 8, hal::HandleType::Encoder> EncoderTable;
+
+TEST(HandleTableTest, AllocateAndFree) {
+  CounterTable table;
+  std::set<uint8_t> indices;
+  std::vector<uint32_t> handles;
+  for (int i = 0; i < 8; i++) {
+    uint32_t handle = table.Allocate();
+    ASSERT_NE(CounterTable::kInvalidHandle, handle);
+    indices.insert(CounterTable::GetIndex(handle));
+    table.Get(handle)->value = i;
+    handles.push_back(handle);
+  }
+  EXPECT_EQ(8u, indices.size()) << "Each handle should get its own slot.";
+  EXPECT_EQ(CounterTable::kInvalidHandle, table.Allocate())
+      << "The table should be full.";
+
+  for (int i = 0; i < 8; i++) EXPECT_EQ(i, table.Get(handles[i])->value);
+
+  void *pointer = CounterTable::HandleToPointer(handles[3]);
+  EXPECT_EQ(handles[3], CounterTable::PointerToHandle(pointer));
+  EXPECT_TRUE(table.Free(pointer));
+  uint32_t handle = table.Allocate();
+  EXPECT_EQ(CounterTable::GetIndex(handles[3]), CounterTable::GetIndex(handle));
+  EXPECT_NE(handles[3], handle) << "A reused slot needs a new generation.";
+  EXPECT_EQ(0, table.Get(handle)->value) << "A reused slot should be reset.";
+}
+
+TEST(HandleTableTest, InvalidHandlesRejected) {
+  CounterTable counters;
+  EncoderTable encoders;
+  uint32_t counter = counters.Allocate();
+  uint32_t encoder = encoders.Allocate();
+
+  EXPECT_EQ(nullptr, counters.Get(encoder)) << "Wrong handle type accepted.";
+  EXPECT_EQ(nullptr, encoders.Get(counter)) << "Wrong handle type accepted.";
+  EXPECT_EQ(nullptr, counters.Get(CounterTable::kInvalidHandle));
+  EXPECT_EQ(nullptr, counters.Get(counter + 1)) << "Unallocated slot accepted.";
+
+  int32_t status = 0;
+  EXPECT_NE(nullptr,
+            counters.Get(CounterTable::HandleToPointer(counter), &status));
+  EXPECT_EQ(0, status);
+  EXPECT_TRUE(counters.Free(counter));
+  EXPECT_FALSE(counters.Free(counter)) << "Double free accepted.";
+  EXPECT_EQ(nullptr,
+            counters.Get(CounterTable::HandleToPointer(counter), &status));
+  EXPECT_EQ(HAL_HANDLE_ERROR, status);
+}
+
+/**
+ * Allocate, free and look up handles at random, including stale ones and
+ * random values, and check that only live handles are ever accepted.
+ */
+TEST(HandleTableTest, UseAfterFreeFuzz) {
+  CounterTable table;
+  std::mt19937 random(1234);
+  std::vector<uint32_t> live;
+  std::vector<uint32_t> freed;
+
+  for (int i = 0; i < 200000; i++) {
+    switch (random() % 4) {
+      case 0: {
+        uint32_t handle = table.Allocate();
+        if (live.size() == 8) {
+          ASSERT_EQ(CounterTable::kInvalidHandle, handle);
+        } else {
+          ASSERT_NE(CounterTable::kInvalidHandle, handle);
+          table.Get(handle)->value = handle;
+          live.push_back(handle);
+        }
+        break;
+      }
+      case 1:
+        if (!live.empty()) {
+          size_t which = random() % live.size();
+          ASSERT_TRUE(table.Free(live[which]));
+          freed.push_back(live[which]);
+          live.erase(live.begin() + which);
+        }
+        break;
+      case 2:
+        if (!freed.empty()) {
+          uint32_t handle = freed[random() % freed.size()];
+          ASSERT_EQ(nullptr, table.Get(handle)) << "Freed handle accepted.";
+          ASSERT_FALSE(table.Free(handle)) << "Freed handle freed again.";
+        }
+        break;
+      case 3: {
+        uint32_t handle = random();
+        bool isLive = false;
+        for (uint32_t l : live) isLive |= l == handle;
+        ASSERT_EQ(isLive, table.Get(handle) != nullptr);
+        break;
+      }
+    }
+    for (uint32_t handle : live) {
+      ASSERT_NE(nullptr, table.Get(handle));
+      ASSERT_EQ(handle, (uint32_t)table.Get(handle)->value);
+    }
+  }
+}
+
+/**
+ * Threads allocating and freeing at once never get the same slot.
+ */
+TEST(HandleTableTest, ConcurrentAllocateFree) {
+  CounterTable table;
+  std::vector<std::thread> threads;
+  std::atomic<bool> failed{false};
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 20000; i++) {
+        uint32_t handle = table.Allocate();
+        if (handle == CounterTable::kInvalidHandle) continue;
+        table.Get(handle)->value = t;
+        std::this_thread::yield();
+        if (table.Get(handle)->value != t) failed = true;
+        if (!table.Free(handle)) failed = true;
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_FALSE(failed);
+  for (int i = 0; i < 8; i++) {
+    EXPECT_NE(CounterTable::kInvalidHandle, table.Allocate())
+        << "Slots were lost from the free list.";
+  }
+}
+
+/**
+ * The cost of validating a handle on every call, against casting a pointer.
+ */
+TEST(HandleTableTest, Benchmark) {
+  static constexpr int kCalls = 10000000;
+  CounterTable table;
+  std::vector<void *> handles;
+  std::vector<FakePort> ports(8);
+  std::vector<void *> pointers;
+  for (int i = 0; i < 8; i++) {
+    handles.push_back(CounterTable::HandleToPointer(table.Allocate()));
+    pointers.push_back(&ports[i]);
+  }
+
+  volatile int sink = 0;
+  int32_t status = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kCalls; i++) {
+    FakePort *port = (FakePort *)pointers[i & 7];
+    sink = sink + port->value;
+  }
+  auto middle = std::chrono::steady_clock::now();
+  for (int i = 0; i < kCalls; i++) {
+    FakePort *port = table.Get(handles[i & 7], &status);
+    if (port == nullptr) continue;
+    sink = sink + port->value;
+  }
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_EQ(0, status);
+
+  typedef std::chrono::duration<double, std::nano> nanoseconds;
+  std::cout << "Pointer cast " << nanoseconds(middle - start).count() / kCalls
+            << " ns, validated handle "
+            << nanoseconds(end - middle).count() / kCalls << " ns per call"
+            << std::endl;
+}
+
+}  // namespace testing
+}  // namespace wpilib
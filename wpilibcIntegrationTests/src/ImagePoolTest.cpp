@@ -0,0 +1,101 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <Vision/BinaryImage.h>
+#include <Vision/ImagePool.h>
+#include "gtest/gtest.h"
+
+/**
+ * Released images are handed out again, to requests of the same class and
+ * size only.
+ */
+TEST(ImagePoolTest, ReusesImages) {
+  ImagePool pool;
+  BinaryImage *first;
+  {
+    ImagePool::Ref<BinaryImage> image = pool.Acquire<BinaryImage>(320, 240);
+    first = image.Get();
+    EXPECT_EQ(320, image->GetWidth());
+    EXPECT_EQ(240, image->GetHeight());
+  }
+  EXPECT_EQ(first, pool.Acquire<BinaryImage>(320, 240).Get());
+  EXPECT_NE(first, pool.Acquire<BinaryImage>(160, 120).Get());
+  EXPECT_NE(static_cast<ImageBase *>(first),
+            pool.Acquire<MonoImage>(320, 240).Get());
+
+  ImagePool::Statistics statistics = pool.GetStatistics();
+  EXPECT_EQ(4u, statistics.acquired);
+  EXPECT_EQ(3u, statistics.created);
+  EXPECT_EQ(0u, statistics.inUse);
+  EXPECT_EQ(3u, statistics.free);
+}
+
+/**
+ * An image that was resized while it was out goes back to the bucket of its
+ * new size, so an image of the old size is never handed out at the new one.
+ */
+TEST(ImagePoolTest, ResizedImages) {
+  ImagePool pool;
+  BinaryImage *resized;
+  {
+    ImagePool::Ref<BinaryImage> image = pool.Acquire<BinaryImage>(320, 240);
+    resized = image.Get();
+    ASSERT_TRUE(imaqSetImageSize(image->GetImaqImage(), 640, 480));
+  }
+
+  ImagePool::Ref<BinaryImage> small = pool.Acquire<BinaryImage>(320, 240);
+  EXPECT_NE(resized, small.Get());
+  EXPECT_EQ(320, small->GetWidth());
+  EXPECT_EQ(240, small->GetHeight());
+
+  ImagePool::Ref<BinaryImage> large = pool.Acquire<BinaryImage>(640, 480);
+  EXPECT_EQ(resized, large.Get());
+  EXPECT_EQ(640, large->GetWidth());
+  EXPECT_EQ(2u, pool.GetStatistics().created);
+}
+
+/**
+ * An image only goes back to the pool when its last reference is gone.
+ */
+TEST(ImagePoolTest, ReferenceCounting) {
+  ImagePool pool;
+  ImagePool::Ref<BinaryImage> image = pool.Acquire<BinaryImage>(320, 240);
+  ImagePool::Ref<BinaryImage> copy = image;
+  EXPECT_EQ(2, image.GetReferenceCount());
+
+  image.Reset();
+  EXPECT_FALSE(image);
+  EXPECT_EQ(1, copy.GetReferenceCount());
+  EXPECT_NE(copy.Get(), pool.Acquire<BinaryImage>(320, 240).Get());
+  EXPECT_EQ(1u, pool.GetStatistics().inUse);
+
+  ImagePool::Ref<BinaryImage> moved = std::move(copy);
+  EXPECT_FALSE(copy);
+  EXPECT_EQ(1, moved.GetReferenceCount());
+  moved = ImagePool::Ref<BinaryImage>();
+  EXPECT_EQ(0u, pool.GetStatistics().inUse);
+}
+
+/**
+ * A loop that acquires the same images every frame only creates them in the
+ * first frame.
+ */
+TEST(ImagePoolTest, NoImagesCreatedInSteadyState) {
+  ImagePool pool;
+  pool.Reserve<BinaryImage>(320, 240, 2);
+  uint64_t created = ImageBase::GetImagesCreated();
+
+  for (int frame = 0; frame < 100; frame++) {
+    ImagePool::Ref<BinaryImage> threshold =
+        pool.Acquire<BinaryImage>(320, 240);
+    ImagePool::Ref<BinaryImage> filtered = pool.Acquire<BinaryImage>(320, 240);
+    ImagePool::Ref<MonoImage> plane = pool.Acquire<MonoImage>(320, 240);
+  }
+  // Only the MonoImage, which wasn't reserved
+  EXPECT_EQ(created + 1, ImageBase::GetImagesCreated());
+  EXPECT_EQ(3u, pool.GetStatistics().created);
+}
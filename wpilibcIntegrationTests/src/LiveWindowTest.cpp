@@ -0,0 +1,116 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <LiveWindow/LiveWindow.h>
+#include <Timer.h>
+#include <WPIErrors.h>
+#include <atomic>
+#include <mutex>
+#include "networktables/NetworkTable.h"
+#include "gtest/gtest.h"
+
+/**
+ * A sensor that publishes a number that never changes and one that changes
+ * on every update.
+ */
+class FakeSensor : public LiveWindowSendable {
+ public:
+  void UpdateTable() override {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    LiveWindow *liveWindow = LiveWindow::GetInstance();
+    liveWindow->PublishNumber(m_table, "Constant", 1.0);
+    liveWindow->PublishNumber(m_table, "Count", ++m_count);
+  }
+
+  void StartLiveWindowMode() override {}
+  void StopLiveWindowMode() override {}
+  void InitTable(std::shared_ptr<ITable>) override {}
+  std::shared_ptr<ITable> GetTable() const override { return m_table; }
+  std::string GetSmartDashboardType() const override { return "FakeSensor"; }
+
+  std::atomic<int> m_count{0};
+  // Held while updating, like a sensor that guards its own state
+  std::mutex m_mutex;
+
+ private:
+  std::shared_ptr<ITable> m_table = NetworkTable::GetTable("LiveWindowTest");
+};
+
+/**
+ * Sensors are updated at their own rate without Run() being called, and
+ * numbers that haven't changed aren't published again.
+ */
+TEST(LiveWindowTest, BackgroundUpdates) {
+  // LiveWindow keeps the sensor for the rest of the program
+  static FakeSensor sensor;
+  LiveWindow *liveWindow = LiveWindow::GetInstance();
+  liveWindow->AddSensor("FakeSensor", 0, &sensor);
+  liveWindow->SetUpdatePeriod(&sensor, 0.01);
+
+  liveWindow->SetEnabled(true);
+  Wait(0.5);
+  liveWindow->SetEnabled(false);
+
+  int count = sensor.m_count;
+  EXPECT_GT(count, 25);
+  EXPECT_LT(count, 75);
+
+  LiveWindow::UpdateStatistics statistics =
+      liveWindow->GetUpdateStatistics(&sensor);
+  EXPECT_EQ((uint32_t)count, statistics.updates);
+  // The constant is only published the first time
+  EXPECT_EQ((uint32_t)count + 1, statistics.published);
+  EXPECT_EQ((uint32_t)count - 1, statistics.suppressed);
+  EXPECT_GE(statistics.maxTime, statistics.averageTime);
+
+  // Nothing is updated while LiveWindow is disabled
+  Wait(0.1);
+  EXPECT_EQ(count, sensor.m_count);
+}
+
+/**
+ * A thread that holds a sensor's lock while calling into LiveWindow doesn't
+ * deadlock with the update thread, which doesn't hold LiveWindow's lock while
+ * it updates the sensor.
+ */
+TEST(LiveWindowTest, UpdateWithoutLock) {
+  static FakeSensor sensor;
+  LiveWindow *liveWindow = LiveWindow::GetInstance();
+  liveWindow->AddSensor("FakeSensor", 1, &sensor);
+  liveWindow->SetUpdatePeriod(&sensor, 0.001);
+
+  liveWindow->SetEnabled(true);
+  double end = Timer::GetFPGATimestamp() + 0.3;
+  while (Timer::GetFPGATimestamp() < end) {
+    std::lock_guard<std::mutex> lock(sensor.m_mutex);
+    liveWindow->GetUpdateStatistics(&sensor);
+  }
+  liveWindow->SetEnabled(false);
+  EXPECT_GT(sensor.m_count, 0);
+}
+
+/**
+ * Periods that aren't positive are reported and ignored.
+ */
+TEST(LiveWindowTest, RejectsBadPeriods) {
+  static FakeSensor sensor;
+  LiveWindow *liveWindow = LiveWindow::GetInstance();
+  for (double period : {0.0, -1.0}) {
+    ErrorBase::GetGlobalError().Clear();
+    liveWindow->SetUpdatePeriod(&sensor, period);
+    EXPECT_NE(std::string::npos,
+              ErrorBase::GetGlobalError().GetMessage().find(
+                  wpi_error_s_ParameterOutOfRange));
+
+    ErrorBase::GetGlobalError().Clear();
+    liveWindow->SetDefaultUpdatePeriod(period);
+    EXPECT_NE(std::string::npos,
+              ErrorBase::GetGlobalError().GetMessage().find(
+                  wpi_error_s_ParameterOutOfRange));
+  }
+  ErrorBase::GetGlobalError().Clear();
+}
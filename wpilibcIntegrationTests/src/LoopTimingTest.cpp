@@ -0,0 +1,102 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <LoopTiming.h>
+#include <Timer.h>
+#include "gtest/gtest.h"
+
+static const double kPhaseTime = 0.010;
+static const double kTolerance = 0.004;
+
+class LoopTimingTest : public testing::Test {
+ protected:
+  virtual void SetUp() override {
+    m_timing = LoopTiming::GetInstance();
+    m_timing->SetPublishInterval(0);
+    m_timing->SetOverrunThreshold(0.020);
+    m_timing->Reset();
+    m_timing->SetEnabled(true);
+  }
+
+  virtual void TearDown() override {
+    m_timing->SetEnabled(false);
+    m_timing->Reset();
+    m_timing->SetPublishInterval(50);
+  }
+
+  /** The number of loops that took between from and to seconds */
+  uint32_t CountLoops(double from, double to) {
+    uint32_t count = 0;
+    for (int i = 0; i < LoopTiming::kHistogramBuckets; i++) {
+      double bucketStart = i * LoopTiming::kHistogramBucketWidth;
+      if (bucketStart >= from && bucketStart < to)
+        count += m_timing->GetHistogramBucket(i);
+    }
+    return count;
+  }
+
+  LoopTiming *m_timing;
+};
+
+/**
+ * The Scheduler runs inside a Periodic() function, and its time should only
+ * be counted once.
+ */
+TEST_F(LoopTimingTest, NestedPhaseIsNotCountedTwice) {
+  m_timing->StartLoop();
+  {
+    LoopTiming::Scope periodic(LoopTiming::kPeriodic);
+    Wait(kPhaseTime);
+    {
+      LoopTiming::Scope scheduler(LoopTiming::kScheduler);
+      Wait(kPhaseTime);
+    }
+  }
+  m_timing->EndLoop();
+
+  EXPECT_EQ(1u, m_timing->GetLoopCount());
+  EXPECT_NEAR(kPhaseTime, m_timing->GetLastPhaseTime(LoopTiming::kPeriodic),
+              kTolerance);
+  EXPECT_NEAR(kPhaseTime, m_timing->GetLastPhaseTime(LoopTiming::kScheduler),
+              kTolerance);
+}
+
+/**
+ * The wait for DS data belongs to the loop it happens in, but isn't work and
+ * doesn't make the loop an overrun.
+ */
+TEST_F(LoopTimingTest, DSWaitIsNotAnOverrun) {
+  m_timing->StartLoop();
+  {
+    LoopTiming::Scope periodic(LoopTiming::kPeriodic);
+    Wait(kPhaseTime);
+  }
+  {
+    LoopTiming::Scope waiting(LoopTiming::kDSWait);
+    Wait(2 * kPhaseTime);
+  }
+  m_timing->EndLoop();
+
+  EXPECT_EQ(1u, m_timing->GetLoopCount());
+  EXPECT_EQ(0u, m_timing->GetOverrunCount());
+  EXPECT_NEAR(2 * kPhaseTime, m_timing->GetLastPhaseTime(LoopTiming::kDSWait),
+              kTolerance);
+  EXPECT_EQ(1u, CountLoops(kPhaseTime - kTolerance, kPhaseTime + kTolerance));
+}
+
+TEST_F(LoopTimingTest, SlowLoopIsAnOverrun) {
+  m_timing->StartLoop();
+  {
+    LoopTiming::Scope periodic(LoopTiming::kPeriodic);
+    Wait(3 * kPhaseTime);
+  }
+  m_timing->EndLoop();
+
+  EXPECT_EQ(1u, m_timing->GetOverrunCount());
+  EXPECT_EQ(1u, CountLoops(3 * kPhaseTime - kTolerance,
+                           3 * kPhaseTime + kTolerance));
+}
@@ -0,0 +1,144 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <MotorSafety.h>
+#include <MotorSafetyHelper.h>
+#include <Timer.h>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+
+static const double kExpiration = 0.1;
+
+/**
+ * A motor that only records when the MotorSafetyHelper stops it.
+ */
+class MockSafeMotor : public MotorSafety {
+ public:
+  MockSafeMotor() : m_safetyHelper(this) {
+    m_safetyHelper.SetExpiration(kExpiration);
+  }
+
+  void Set() {
+    m_stopTime = 0.0;
+    m_safetyHelper.Feed();
+  }
+
+  double GetStopTime() const { return m_stopTime; }
+
+  void SetExpiration(float timeout) override {
+    m_safetyHelper.SetExpiration(timeout);
+  }
+  float GetExpiration() const override {
+    return m_safetyHelper.GetExpiration();
+  }
+  bool IsAlive() const override { return m_safetyHelper.IsAlive(); }
+  void StopMotor() override {
+    if (m_stopTime == 0.0) m_stopTime = Timer::GetFPGATimestamp();
+  }
+  void SetSafetyEnabled(bool enabled) override {
+    m_safetyHelper.SetSafetyEnabled(enabled);
+  }
+  bool IsSafetyEnabled() const override {
+    return m_safetyHelper.IsSafetyEnabled();
+  }
+  void GetDescription(std::ostringstream &desc) const override {
+    desc << "MockSafeMotor";
+  }
+
+ private:
+  MotorSafetyHelper m_safetyHelper;
+  std::atomic<double> m_stopTime{0.0};
+};
+
+class MotorSafetyTest : public testing::Test {
+ protected:
+  virtual void TearDown() override { MotorSafetyHelper::SetCheckPeriod(0.0); }
+
+  /**
+   * Feed the motor for a while, then stop feeding it and return the time
+   * between the expiration and the motor being stopped.
+   */
+  double MeasureStopLatency(MockSafeMotor &motor) {
+    motor.SetSafetyEnabled(true);
+    for (int i = 0; i < 20; i++) {
+      motor.Set();
+      Wait(0.01);
+    }
+    double expireTime = Timer::GetFPGATimestamp() + kExpiration;
+    motor.Set();
+    Wait(kExpiration + 0.25);
+    motor.SetSafetyEnabled(false);
+
+    EXPECT_NE(0.0, motor.GetStopTime()) << "Motor was never stopped";
+    return motor.GetStopTime() - expireTime;
+  }
+};
+
+/**
+ * A motor that is fed more often than its expiration must not be stopped.
+ */
+TEST_F(MotorSafetyTest, FedMotorIsNotStopped) {
+  MockSafeMotor motor;
+  motor.SetSafetyEnabled(true);
+  for (int i = 0; i < 50; i++) {
+    motor.Set();
+    EXPECT_TRUE(motor.IsAlive());
+    Wait(kExpiration / 4);
+  }
+  motor.SetSafetyEnabled(false);
+
+  EXPECT_EQ(0.0, motor.GetStopTime()) << "Fed motor was stopped";
+}
+
+/**
+ * With only the DriverStation task checking every fourth packet, the motor
+ * stops within about 80ms of expiring.
+ */
+TEST_F(MotorSafetyTest, StopLatencyDriverStation) {
+  MockSafeMotor motor;
+  double latency = MeasureStopLatency(motor);
+
+  std::cout << "Stop latency with DS checks: " << latency * 1000.0 << "ms"
+            << std::endl;
+  EXPECT_GE(latency, 0.0);
+  EXPECT_LE(latency, 0.1);
+}
+
+/**
+ * The dedicated check thread stops the motor within a couple of check periods.
+ */
+TEST_F(MotorSafetyTest, StopLatencyWatchdogThread) {
+  MotorSafetyHelper::SetCheckPeriod(0.005);
+  MockSafeMotor motor;
+  double latency = MeasureStopLatency(motor);
+
+  std::cout << "Stop latency with 5ms checks: " << latency * 1000.0 << "ms"
+            << std::endl;
+  EXPECT_GE(latency, 0.0);
+  EXPECT_LE(latency, 0.015);
+}
+
+/**
+ * Many idle motors must not slow down the check of an expired one.
+ */
+TEST_F(MotorSafetyTest, StopLatencyManyMotors) {
+  MotorSafetyHelper::SetCheckPeriod(0.005);
+  std::vector<std::unique_ptr<MockSafeMotor>> idleMotors;
+  for (int i = 0; i < 500; i++) {
+    idleMotors.emplace_back(new MockSafeMotor);
+  }
+  MockSafeMotor motor;
+  double latency = MeasureStopLatency(motor);
+
+  std::cout << "Stop latency with 5ms checks and 500 motors: "
+            << latency * 1000.0 << "ms" << std::endl;
+  EXPECT_GE(latency, 0.0);
+  EXPECT_LE(latency, 0.015);
+}
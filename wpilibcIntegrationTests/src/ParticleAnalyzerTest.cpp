@@ -0,0 +1,195 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <Vision/BinaryImage.h>
+#include <Vision/ParticleAnalyzer.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+/**
+ * Make an image from lines of text, with '#' for particle pixels.
+ */
+static std::vector<uint8_t> MakeImage(const std::vector<std::string> &lines) {
+  std::vector<uint8_t> pixels;
+  for (auto &line : lines) {
+    for (char c : line) pixels.push_back(c == '#');
+  }
+  return pixels;
+}
+
+TEST(ParticleAnalyzerTest, Shapes) {
+  std::vector<std::string> lines = {"..........",
+                                    ".####...#.",
+                                    ".#..#..#..",
+                                    ".####.#...",
+                                    "..........",
+                                    "###......#"};
+  std::vector<uint8_t> pixels = MakeImage(lines);
+
+  ParticleAnalyzer analyzer;
+  ASSERT_EQ(4, analyzer.Analyze(pixels.data(), 10, 10, 6));
+  auto &reports = analyzer.GetReports();
+
+  // A square ring around a hole of 2 pixels
+  EXPECT_EQ(0, reports[0].index);
+  EXPECT_EQ(10, reports[0].area);
+  EXPECT_EQ(1, reports[0].left);
+  EXPECT_EQ(1, reports[0].top);
+  EXPECT_EQ(4, reports[0].width);
+  EXPECT_EQ(3, reports[0].height);
+  EXPECT_DOUBLE_EQ(3.0, reports[0].centerX);
+  EXPECT_DOUBLE_EQ(2.5, reports[0].centerY);
+  EXPECT_DOUBLE_EQ(12.0, reports[0].convexHullArea);
+  EXPECT_EQ(2, reports[0].holesArea);
+  EXPECT_NEAR(0.0, reports[0].momentXY, 1e-9);
+
+  // A diagonal line, joined by its corners
+  EXPECT_EQ(3, reports[1].area);
+  EXPECT_EQ(6, reports[1].left);
+  EXPECT_EQ(3, reports[1].width);
+  EXPECT_DOUBLE_EQ(7.5, reports[1].centerX);
+  EXPECT_DOUBLE_EQ(2.0, reports[1].momentXX);
+  EXPECT_DOUBLE_EQ(2.0, reports[1].momentYY);
+  EXPECT_DOUBLE_EQ(-2.0, reports[1].momentXY);
+  EXPECT_DOUBLE_EQ(5.0, reports[1].convexHullArea);
+  EXPECT_EQ(0, reports[1].holesArea);
+
+  EXPECT_EQ(3, reports[2].area);
+  EXPECT_DOUBLE_EQ(3.0, reports[2].convexHullArea);
+  EXPECT_EQ(1, reports[3].area);
+
+  // With 4-connectivity the diagonal line is 3 particles
+  analyzer.SetConnectivity8(false);
+  ASSERT_EQ(6, analyzer.Analyze(pixels.data(), 10, 10, 6));
+  EXPECT_EQ(2, analyzer.GetReports()[0].holesArea);
+
+  // Opening the ring joins the hole to the rest of the background
+  lines[2] = ".#.....#..";
+  pixels = MakeImage(lines);
+  analyzer.SetConnectivity8(true);
+  ASSERT_EQ(4, analyzer.Analyze(pixels.data(), 10, 10, 6));
+  EXPECT_EQ(0, analyzer.GetReports()[0].holesArea);
+}
+
+TEST(ParticleAnalyzerTest, SortByArea) {
+  std::vector<uint8_t> pixels = MakeImage({"#.##.#", "..##.."});
+  ParticleAnalyzer analyzer;
+  ASSERT_EQ(3, analyzer.Analyze(pixels.data(), 6, 6, 2));
+  analyzer.SortByArea();
+  auto &reports = analyzer.GetReports();
+  EXPECT_EQ(4, reports[0].area);
+  EXPECT_EQ(1, reports[0].index);
+  EXPECT_EQ(0, reports[1].index);
+  EXPECT_EQ(2, reports[2].index);
+}
+
+/**
+ * Splitting the image into bands for threads gives the same particles, on a
+ * noisy image with particles that cross the bands. Each analyzer first
+ * analyzes an image with fewer lines than threads, so the image after it
+ * reuses workers that were left without a band.
+ */
+TEST(ParticleAnalyzerTest, ThreadsMatchOneThread) {
+  const int kWidth = 97, kHeight = 61, kPixelsPerLine = 100;
+  std::vector<uint8_t> pixels(kPixelsPerLine * kHeight);
+  std::srand(3);
+  for (auto &pixel : pixels) pixel = std::rand() % 5 < 2;
+
+  for (bool connectivity8 : {true, false}) {
+    ParticleAnalyzer single(connectivity8, 1);
+    int count = single.Analyze(pixels.data(), kPixelsPerLine, kWidth, kHeight);
+    ASSERT_GT(count, 10);
+
+    for (int threads : {2, 3, 8, 100}) {
+      ParticleAnalyzer parallel(connectivity8, threads);
+      parallel.Analyze(pixels.data(), kPixelsPerLine, kWidth, 2);
+      ASSERT_EQ(count, parallel.Analyze(pixels.data(), kPixelsPerLine, kWidth,
+                                        kHeight));
+      for (int i = 0; i < count; i++) {
+        auto &a = single.GetReports()[i];
+        auto &b = parallel.GetReports()[i];
+        ASSERT_EQ(a.area, b.area) << threads << " threads, particle " << i;
+        EXPECT_EQ(a.left, b.left);
+        EXPECT_EQ(a.top, b.top);
+        EXPECT_EQ(a.width, b.width);
+        EXPECT_EQ(a.height, b.height);
+        EXPECT_DOUBLE_EQ(a.centerX, b.centerX);
+        EXPECT_DOUBLE_EQ(a.centerY, b.centerY);
+        EXPECT_DOUBLE_EQ(a.convexHullArea, b.convexHullArea);
+        EXPECT_EQ(a.holesArea, b.holesArea);
+      }
+    }
+  }
+}
+
+/**
+ * The reports measured natively match the ones measured by NI Vision for the
+ * particle of the same number.
+ */
+TEST(ParticleAnalyzerTest, MatchesImaq) {
+  const int kWidth = 64, kHeight = 48;
+  std::vector<uint8_t> pixels(kWidth * kHeight);
+  std::srand(5);
+  for (auto &pixel : pixels) pixel = std::rand() % 3 == 0;
+
+  BinaryImage image;
+  ASSERT_TRUE(
+      imaqArrayToImage(image.GetImaqImage(), pixels.data(), kWidth, kHeight));
+  ParticleAnalyzer analyzer;
+  std::vector<ParticleAnalysisReport> reports;
+  image.GetOrderedParticleAnalysisReports(analyzer, reports);
+  ASSERT_EQ(image.GetNumberParticles(), static_cast<int>(reports.size()));
+  ASSERT_GT(reports.size(), 10u);
+
+  for (auto &report : reports) {
+    ParticleAnalysisReport imaq =
+        image.GetParticleAnalysisReport(report.particleIndex);
+    ASSERT_EQ(imaq.particleArea, report.particleArea)
+        << "particle " << report.particleIndex;
+    EXPECT_EQ(imaq.boundingRect.left, report.boundingRect.left);
+    EXPECT_EQ(imaq.boundingRect.top, report.boundingRect.top);
+    EXPECT_EQ(imaq.boundingRect.width, report.boundingRect.width);
+    EXPECT_EQ(imaq.boundingRect.height, report.boundingRect.height);
+    EXPECT_NEAR(imaq.center_mass_x, report.center_mass_x, 1);
+    EXPECT_NEAR(imaq.center_mass_y, report.center_mass_y, 1);
+    EXPECT_NEAR(imaq.particleToImagePercent, report.particleToImagePercent,
+                1e-6);
+    EXPECT_NEAR(imaq.particleQuality, report.particleQuality, 1e-6);
+  }
+}
+
+/**
+ * Report the time to analyze a camera sized image.
+ */
+TEST(ParticleAnalyzerTest, Benchmark) {
+  const int kWidth = 640, kHeight = 480, kFrames = 20;
+  std::vector<uint8_t> pixels(kWidth * kHeight);
+  // Blocks of particles, like a thresholded camera image
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      pixels[y * kWidth + x] = ((x / 16) * 7 + (y / 16) * 3) % 5 == 0;
+    }
+  }
+
+  for (int threads : {1, 2, 4}) {
+    ParticleAnalyzer analyzer(true, threads);
+    analyzer.Analyze(pixels.data(), kWidth, kWidth, kHeight);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFrames; i++) {
+      analyzer.Analyze(pixels.data(), kWidth, kWidth, kHeight);
+    }
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count() /
+                kFrames;
+    std::cout << threads << " thread(s): " << analyzer.GetReports().size()
+              << " particles in " << ms << " ms/frame" << std::endl;
+  }
+}
@@ -0,0 +1,218 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include "HAL/cpp/priority_condition_variable.h"
+#include "HAL/cpp/priority_event.h"
+#include "HAL/cpp/priority_mutex.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace wpilib {
+namespace testing {
+
+static void ShortSleep(unsigned long time = 10) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(time));
+}
+
+TEST(PriorityEventTest, EventReleasesOneWaiter) {
+  priority_event event;
+  std::atomic<int> woken{0};
+  std::thread waiter1([&] { event.wait(); woken++; });
+  std::thread waiter2([&] { event.wait(); woken++; });
+  ShortSleep();
+  EXPECT_EQ(0, woken);
+
+  event.set();
+  ShortSleep();
+  EXPECT_EQ(1, woken) << "Only one thread should've been released.";
+  event.set();
+  ShortSleep();
+  EXPECT_EQ(2, woken) << "Both threads should've been released.";
+  waiter1.join();
+  waiter2.join();
+}
+
+TEST(PriorityEventTest, EventStaysSetUntilTaken) {
+  priority_event event;
+  EXPECT_FALSE(event.try_wait());
+  event.set();
+  event.set();
+  EXPECT_TRUE(event.try_wait());
+  EXPECT_FALSE(event.try_wait()) << "Sets shouldn't add up.";
+
+  event.set();
+  EXPECT_TRUE(event.wait_for(std::chrono::milliseconds(0)));
+  EXPECT_FALSE(event.wait_for(std::chrono::milliseconds(20)));
+  event.set();
+  event.reset();
+  EXPECT_FALSE(event.try_wait());
+}
+
+TEST(PriorityEventTest, BroadcastWakesAllWaiters) {
+  priority_broadcast broadcast;
+  std::atomic<int> woken{0};
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < 4; i++) {
+    waiters.emplace_back([&] { broadcast.wait(0); woken++; });
+  }
+  ShortSleep();
+  EXPECT_EQ(0, woken);
+
+  broadcast.notify_all();
+  for (auto &waiter : waiters) waiter.join();
+  EXPECT_EQ(4, woken);
+  EXPECT_EQ(1u, broadcast.generation());
+
+  // A notification between reading the generation and waiting isn't missed
+  uint32_t generation = broadcast.generation();
+  broadcast.notify_all();
+  EXPECT_TRUE(broadcast.wait_for(generation, std::chrono::milliseconds(0)));
+  EXPECT_FALSE(broadcast.wait_for(broadcast.generation(),
+                                  std::chrono::milliseconds(20)));
+}
+
+TEST(PriorityEventTest, ConditionWithPriorityMutex) {
+  priority_condition cond;
+  priority_mutex mutex;
+  bool ready = false;
+  std::atomic<bool> done{false};
+
+  std::thread waiter([&] {
+    std::unique_lock<priority_mutex> lock(mutex);
+    cond.wait(lock, [&] { return ready; });
+    EXPECT_TRUE(lock.owns_lock());
+    done = true;
+  });
+  ShortSleep();
+  EXPECT_TRUE(mutex.try_lock()) << "The condition failed to unlock the lock.";
+  mutex.unlock();
+
+  cond.notify_all();
+  ShortSleep();
+  EXPECT_FALSE(done) << "The waiter didn't pay attention to its predicate.";
+  {
+    std::lock_guard<priority_mutex> lock(mutex);
+    ready = true;
+  }
+  cond.notify_one();
+  waiter.join();
+  EXPECT_TRUE(done);
+
+  std::unique_lock<priority_mutex> lock(mutex);
+  EXPECT_EQ(std::cv_status::timeout,
+            cond.wait_for(lock, std::chrono::milliseconds(20)));
+  EXPECT_FALSE(cond.wait_until(
+      lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(20),
+      [] { return false; }));
+  EXPECT_TRUE(lock.owns_lock());
+}
+
+/**
+ * One thread notifies the given number of waiters over and over, the way the
+ * driver station task wakes WaitForData() callers for each packet, and waits
+ * for them all to see each notification before sending the next.
+ * @return The average time per round in microseconds
+ */
+template <typename Wait, typename Notify>
+static double TimeRounds(int numWaiters, Wait wait, Notify notify) {
+  static constexpr int kRounds = 2000;
+  std::atomic<int> round{0};
+  std::atomic<int> seen{0};
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < numWaiters; i++) {
+    waiters.emplace_back([&] {
+      for (int r = 1; r <= kRounds; r++) {
+        wait([&] { return round.load() >= r; });
+        seen++;
+      }
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 1; r <= kRounds; r++) {
+    notify([&] { round = r; });
+    while (seen.load() < numWaiters * r) std::this_thread::yield();
+  }
+  auto end = std::chrono::steady_clock::now();
+  for (auto &waiter : waiters) waiter.join();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         kRounds;
+}
+
+TEST(PriorityEventTest, Benchmark) {
+  for (int numWaiters = 1; numWaiters <= 16; numWaiters *= 2) {
+    priority_mutex mutex;
+    priority_condition_variable oldCond;
+    double oldTime = TimeRounds(
+        numWaiters,
+        [&](std::function<bool()> p) {
+          std::unique_lock<priority_mutex> lock(mutex);
+          oldCond.wait(lock, p);
+        },
+        [&](std::function<void()> advance) {
+          std::lock_guard<priority_mutex> lock(mutex);
+          advance();
+          oldCond.notify_all();
+        });
+
+    priority_condition newCond;
+    double newTime = TimeRounds(
+        numWaiters,
+        [&](std::function<bool()> p) {
+          std::unique_lock<priority_mutex> lock(mutex);
+          newCond.wait(lock, p);
+        },
+        [&](std::function<void()> advance) {
+          std::lock_guard<priority_mutex> lock(mutex);
+          advance();
+          newCond.notify_all();
+        });
+
+    priority_broadcast broadcast;
+    double broadcastTime = TimeRounds(
+        numWaiters,
+        [&](std::function<bool()> p) {
+          uint32_t generation = broadcast.generation();
+          while (!p()) generation = broadcast.wait(generation);
+        },
+        [&](std::function<void()> advance) {
+          advance();
+          broadcast.notify_all();
+        });
+
+    std::cout << numWaiters << " waiters: priority_condition_variable "
+              << oldTime << " us, priority_condition " << newTime
+              << " us, priority_broadcast " << broadcastTime << " us per round"
+              << std::endl;
+  }
+
+  // Notifying with nobody waiting, as the driver station task does when no
+  // code is in WaitForData()
+  static constexpr int kNotifies = 100000;
+  priority_condition_variable oldCond;
+  priority_broadcast broadcast;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kNotifies; i++) oldCond.notify_all();
+  auto middle = std::chrono::steady_clock::now();
+  for (int i = 0; i < kNotifies; i++) broadcast.notify_all();
+  auto end = std::chrono::steady_clock::now();
+  typedef std::chrono::duration<double, std::nano> nanoseconds;
+  std::cout << "No waiters: priority_condition_variable "
+            << nanoseconds(middle - start).count() / kNotifies
+            << " ns, priority_broadcast "
+            << nanoseconds(end - middle).count() / kNotifies
+            << " ns per notify" << std::endl;
+}
+
+}  // namespace testing
+}  // namespace wpilib
@@ -0,0 +1,176 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <V4L2Camera.h>
+#include <linux/videodev2.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+/**
+ * A minimal JPEG: an APP0 marker and a scan with size bytes of data.
+ */
+static std::vector<uint8_t> MakeJpeg(int number, size_t size) {
+  std::vector<uint8_t> jpeg = {0xff, 0xd8, 0xff, 0xe0, 0x00, 0x04,
+                               static_cast<uint8_t>(number), 0x00,
+                               0xff, 0xda, 0x00, 0x04, 0x00, 0x00};
+  for (size_t i = 0; i < size; i++) jpeg.push_back((i * 7 + number) % 0xfe);
+  jpeg.push_back(0xff);
+  jpeg.push_back(0xd9);
+  return jpeg;
+}
+
+/**
+ * Writes the frames of a fake camera device to a temporary file.
+ */
+class FakeDeviceFile {
+ public:
+  explicit FakeDeviceFile(const std::vector<std::vector<uint8_t>> &frames) {
+    char path[] = "/tmp/V4L2CameraTestXXXXXX";
+    int fd = mkstemp(path);
+    for (auto &frame : frames) write(fd, frame.data(), frame.size());
+    close(fd);
+    m_path = path;
+  }
+
+  ~FakeDeviceFile() { unlink(m_path.c_str()); }
+
+  const std::string &GetPath() const { return m_path; }
+
+ private:
+  std::string m_path;
+};
+
+class V4L2CameraTest : public testing::Test {
+ protected:
+  std::vector<std::vector<uint8_t>> m_jpegs = {
+      MakeJpeg(1, 500), MakeJpeg(2, 70), MakeJpeg(3, 1234)};
+};
+
+/**
+ * JPEG frames are lent out from the file in order, without being copied, and
+ * start over at the end of the file.
+ */
+TEST_F(V4L2CameraTest, FakeJpegFrames) {
+  FakeDeviceFile file(m_jpegs);
+  V4L2Camera camera(file.GetPath());
+  camera.SetFPS(0);
+  camera.OpenCamera();
+  ASSERT_TRUE(camera.IsFakeDevice());
+  camera.StartCapture();
+
+  const uint8_t *first = nullptr;
+  for (unsigned int i = 0; i < 2 * m_jpegs.size(); i++) {
+    unsigned int size = 0;
+    const uint8_t *data = camera.AcquireImageData(size);
+    ASSERT_NE(nullptr, data);
+    const std::vector<uint8_t> &expected = m_jpegs[i % m_jpegs.size()];
+    EXPECT_EQ(expected, std::vector<uint8_t>(data, data + size));
+
+    if (i == 0) {
+      first = data;
+    } else if (i == m_jpegs.size()) {
+      EXPECT_EQ(first, data);
+    }
+    camera.ReleaseImageData(data);
+  }
+  EXPECT_EQ(0, camera.GetError().GetCode());
+}
+
+TEST_F(V4L2CameraTest, GetImageDataCopies) {
+  FakeDeviceFile file(m_jpegs);
+  V4L2Camera camera(file.GetPath());
+  camera.SetFPS(0);
+  camera.OpenCamera();
+  camera.StartCapture();
+
+  std::vector<uint8_t> buffer(2000);
+  unsigned int size = camera.GetImageData(buffer.data(), buffer.size());
+  buffer.resize(size);
+  EXPECT_EQ(m_jpegs[0], buffer);
+
+  // The second frame doesn't fit
+  std::vector<uint8_t> small(10);
+  EXPECT_EQ(0u, camera.GetImageData(small.data(), small.size()));
+}
+
+/**
+ * A file that isn't JPEG holds YUYV frames of the camera's size.
+ */
+TEST_F(V4L2CameraTest, FakeYuyvFrames) {
+  std::vector<uint8_t> yuyv1(4 * 2 * 2, 10), yuyv2(4 * 2 * 2, 20);
+  FakeDeviceFile file({yuyv1, yuyv2});
+  V4L2Camera camera(file.GetPath(), false);
+  camera.SetFPS(0);
+  camera.SetSize(4, 2);
+  camera.OpenCamera();
+  camera.StartCapture();
+
+  V4L2Camera::Frame frame;
+  ASSERT_TRUE(camera.AcquireFrame(frame, false));
+  EXPECT_EQ(static_cast<uint32_t>(V4L2_PIX_FMT_YUYV), frame.pixelFormat);
+  EXPECT_EQ(4u, frame.width);
+  EXPECT_EQ(2u, frame.height);
+  EXPECT_EQ(yuyv1, std::vector<uint8_t>(frame.data, frame.data + frame.size));
+  camera.ReleaseFrame(frame);
+
+  ASSERT_TRUE(camera.AcquireFrame(frame, false));
+  EXPECT_EQ(yuyv2, std::vector<uint8_t>(frame.data, frame.data + frame.size));
+  camera.ReleaseFrame(frame);
+
+  // YUYV frames can't be sent as JPEG data
+  unsigned int size = 0;
+  EXPECT_EQ(nullptr, camera.AcquireImageData(size));
+}
+
+/**
+ * A frame that is still lent out when the camera is closed stays valid until
+ * it is released.
+ */
+TEST_F(V4L2CameraTest, ReleaseAfterClose) {
+  FakeDeviceFile file(m_jpegs);
+  V4L2Camera camera(file.GetPath());
+  camera.SetFPS(0);
+  camera.OpenCamera();
+  camera.StartCapture();
+
+  unsigned int size = 0;
+  const uint8_t *data = camera.AcquireImageData(size);
+  ASSERT_NE(nullptr, data);
+  camera.CloseCamera();
+  EXPECT_EQ(m_jpegs[0], std::vector<uint8_t>(data, data + size));
+  camera.ReleaseImageData(data);
+  EXPECT_EQ(0, camera.GetError().GetCode());
+}
+
+/**
+ * Frames are played back at the set frame rate.
+ */
+TEST_F(V4L2CameraTest, FrameRate) {
+  FakeDeviceFile file(m_jpegs);
+  V4L2Camera camera(file.GetPath());
+  camera.SetFPS(100);
+  camera.OpenCamera();
+  camera.StartCapture();
+
+  unsigned int size = 0;
+  camera.ReleaseImageData(camera.AcquireImageData(size));
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 20; i++) {
+    camera.ReleaseImageData(camera.AcquireImageData(size));
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "20 frames at 100 fps took " << elapsed << " s" << std::endl;
+  EXPECT_NEAR(0.2, elapsed, 0.05);
+}
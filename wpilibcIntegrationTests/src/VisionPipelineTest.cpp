@@ -0,0 +1,201 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <Vision/VisionPipeline.h>
+#include <Timer.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "gtest/gtest.h"
+
+static const int kImageWidth = 32;
+static const int kImageHeight = 24;
+
+/**
+ * Make a JPEG of a red image with NI Vision, the way a camera would send it.
+ */
+static std::vector<uint8_t> MakeJpeg() {
+  const char *fileName = "/tmp/VisionPipelineTest.jpg";
+  RGBImage image;
+  imaqSetImageSize(image.GetImaqImage(), kImageWidth, kImageHeight);
+  PixelValue red;
+  red.rgb = {0, 0, 255, 0};
+  imaqFillImage(image.GetImaqImage(), red, nullptr);
+  imaqWriteJPEGFile(image.GetImaqImage(), fileName, 750, nullptr);
+
+  std::ifstream file(fileName, std::ios::binary);
+  std::vector<uint8_t> jpeg((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+  std::remove(fileName);
+  return jpeg;
+}
+
+/**
+ * A camera that sends the same JPEG every few milliseconds. Every brokenEvery
+ * frames it sends a cut off one instead, if brokenEvery isn't 0.
+ */
+class FakeCamera : public USBCamera {
+ public:
+  FakeCamera(double period, int brokenEvery = 0)
+      : USBCamera("fake", true),
+        m_period(period),
+        m_brokenEvery(brokenEvery),
+        m_jpeg(MakeJpeg()) {}
+
+  void StartCapture() override {}
+  void StopCapture() override {}
+
+  unsigned int GetImageData(void *buffer, unsigned int) override {
+    Wait(m_period);
+    unsigned int size = m_jpeg.size();
+    if (m_brokenEvery != 0 && ++m_frames % m_brokenEvery == 0) size /= 2;
+    std::memcpy(buffer, m_jpeg.data(), size);
+    return size;
+  }
+
+ private:
+  double m_period;
+  int m_brokenEvery;
+  int m_frames = 0;
+  std::vector<uint8_t> m_jpeg;
+};
+
+/**
+ * The frames from the camera are decoded before the stages get them.
+ */
+TEST(VisionPipelineTest, DecodesFrames) {
+  auto camera = std::make_shared<FakeCamera>(0.005);
+  VisionPipeline pipeline(camera);
+  std::atomic<int> checked(0);
+  pipeline.AddStage("check", [&](VisionPipeline::Frame &frame) {
+    int width = 0, height = 0;
+    imaqGetImageSize(frame.image.GetImaqImage(), &width, &height);
+    EXPECT_EQ(kImageWidth, width);
+    EXPECT_EQ(kImageHeight, height);
+    PixelValue pixel;
+    Point center = {kImageWidth / 2, kImageHeight / 2};
+    ASSERT_TRUE(imaqGetPixel(frame.image.GetImaqImage(), center, &pixel));
+    EXPECT_GT(pixel.rgb.R, 200);
+    EXPECT_LT(pixel.rgb.G, 50);
+    EXPECT_LT(pixel.rgb.B, 50);
+    checked++;
+  });
+
+  pipeline.Start();
+  Wait(0.2);
+  pipeline.Stop();
+  EXPECT_GT(checked, 5);
+  EXPECT_EQ(0u, pipeline.GetStatistics(1).failed);
+}
+
+/**
+ * Frames that can't be decoded are counted and dropped, and don't reach the
+ * stages after decoding.
+ */
+TEST(VisionPipelineTest, DropsBrokenFrames) {
+  VisionPipeline pipeline(std::make_shared<FakeCamera>(0.005, 3));
+  std::atomic<int> checked(0);
+  pipeline.AddStage("check", [&](VisionPipeline::Frame &frame) {
+    int width = 0, height = 0;
+    imaqGetImageSize(frame.image.GetImaqImage(), &width, &height);
+    EXPECT_EQ(kImageWidth, width);
+    checked++;
+  });
+
+  pipeline.Start();
+  Wait(0.3);
+  pipeline.Stop();
+
+  VisionPipeline::Statistics decode = pipeline.GetStatistics(1);
+  EXPECT_GT(decode.failed, 3u);
+  EXPECT_LT(decode.failed, decode.frames);
+  // Only the frames that were decoded reach the next stage, though the last
+  // of them may still be waiting for it
+  VisionPipeline::Statistics check = pipeline.GetStatistics(2);
+  EXPECT_GE(decode.frames - decode.failed, check.frames + check.dropped);
+  EXPECT_LE(decode.frames - decode.failed, check.frames + check.dropped + 1);
+  EXPECT_EQ(decode.failed, pipeline.GetLatency().failed);
+  EXPECT_GT(checked, 5);
+  // Decoding errors aren't set on the pipeline from its threads
+  EXPECT_EQ(0, pipeline.GetError().GetCode());
+}
+
+/**
+ * Frames reach the publisher in the order they were captured, with the
+ * results of each stage.
+ */
+TEST(VisionPipelineTest, FramesInOrder) {
+  VisionPipeline pipeline(std::make_shared<FakeCamera>(0.002));
+  pipeline.AddStage("number", [](VisionPipeline::Frame &frame) {
+    frame.particles.resize(1);
+    frame.particles[0].particleIndex = frame.number;
+  });
+  pipeline.AddStage("check", [](VisionPipeline::Frame &frame) {
+    EXPECT_EQ(1u, frame.particles.size());
+    EXPECT_EQ((int)frame.number, frame.particles[0].particleIndex);
+  });
+
+  uint64_t lastNumber = 0;
+  double lastTimestamp = 0.0;
+  std::atomic<int> published(0);
+  pipeline.SetPublisher([&](const VisionPipeline::Frame &frame) {
+    EXPECT_GT(frame.number, lastNumber);
+    EXPECT_GE(frame.timestamp, lastTimestamp);
+    lastNumber = frame.number;
+    lastTimestamp = frame.timestamp;
+    published++;
+  });
+
+  ASSERT_EQ(5, pipeline.GetNumStages());
+  EXPECT_EQ("capture", pipeline.GetStageName(0));
+  EXPECT_EQ("number", pipeline.GetStageName(2));
+  EXPECT_EQ("publish", pipeline.GetStageName(4));
+
+  pipeline.Start();
+  Wait(0.2);
+  pipeline.Stop();
+  EXPECT_GT(published, 20);
+
+  std::vector<ParticleAnalysisReport> particles;
+  double timestamp;
+  ASSERT_TRUE(pipeline.GetLatestResult(particles, timestamp));
+  ASSERT_EQ(1u, particles.size());
+  EXPECT_EQ((int)lastNumber, particles[0].particleIndex);
+  EXPECT_EQ(lastTimestamp, timestamp);
+
+  VisionPipeline::Statistics latency = pipeline.GetLatency();
+  EXPECT_EQ((uint64_t)published, latency.frames);
+  EXPECT_GE(latency.maxTime, latency.averageTime);
+}
+
+/**
+ * A slow stage gets the latest frame, with the frames it had no time for
+ * dropped, and doesn't hold up the stages before it.
+ */
+TEST(VisionPipelineTest, SlowStageDropsFrames) {
+  VisionPipeline pipeline(std::make_shared<FakeCamera>(0.002));
+  pipeline.AddStage("slow", [](VisionPipeline::Frame &) { Wait(0.02); });
+  pipeline.Start();
+  Wait(0.3);
+  pipeline.Stop();
+
+  VisionPipeline::Statistics capture = pipeline.GetStatistics(0);
+  VisionPipeline::Statistics slow = pipeline.GetStatistics(2);
+  EXPECT_GT(capture.frames, 3 * slow.frames);
+  EXPECT_GT(slow.dropped, 0u);
+  EXPECT_GE(slow.averageTime, 0.02);
+  EXPECT_EQ(0u, pipeline.GetStatistics(3).dropped);
+
+  // The pipeline starts again with the frames it already has
+  pipeline.Start();
+  Wait(0.1);
+  pipeline.Stop();
+  EXPECT_GT(pipeline.GetStatistics(2).frames, slow.frames);
+}
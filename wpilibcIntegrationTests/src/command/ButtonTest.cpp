@@ -0,0 +1,47 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project.                                                               */
+/*----------------------------------------------------------------------------*/
+
+#include <Buttons/NetworkButton.h>
+#include <Timer.h>
+#include "networktables/NetworkTable.h"
+#include "gtest/gtest.h"
+
+static const double kListenerTime = 0.1;
+
+/**
+ * The button follows the field through the table listener.
+ */
+TEST(ButtonTest, NetworkButtonFollowsField) {
+  auto table = NetworkTable::GetTable("ButtonTest");
+  table->PutBoolean("follows", false);
+  NetworkButton button(table, "follows");
+  Wait(kListenerTime);
+  EXPECT_FALSE(button.Get());
+
+  table->PutBoolean("follows", true);
+  Wait(kListenerTime);
+  EXPECT_TRUE(button.Get());
+
+  table->PutBoolean("follows", false);
+  Wait(kListenerTime);
+  EXPECT_FALSE(button.Get());
+}
+
+/**
+ * A field that's deleted comes to the listener without a value, which should
+ * release the button rather than crash.
+ */
+TEST(ButtonTest, NetworkButtonReleasedWithoutValue) {
+  auto table = NetworkTable::GetTable("ButtonTest");
+  table->PutBoolean("deleted", true);
+  NetworkButton button(table, "deleted");
+  Wait(kListenerTime);
+  ASSERT_TRUE(button.Get());
+
+  button.ValueChanged(table.get(), "deleted", nullptr, false);
+  EXPECT_FALSE(button.Get());
+}
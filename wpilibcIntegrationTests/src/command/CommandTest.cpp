@@ -97,6 +97,48 @@ TEST_F(CommandTest, ParallelCommands) {
 }
 // END CommandParallelGroupTest
 
+TEST_F(CommandTest, ParallelChildCanceledByConflictingCommand) {
+  ASubsystem subsystemA("subsystemA");
+  ASubsystem subsystemB("subsystemB");
+  MockCommand childA;
+  childA.Requires(&subsystemA);
+  MockCommand childB;
+  childB.Requires(&subsystemB);
+  MockCommand first;
+  MockCommand second;
+  second.Requires(&subsystemA);
+  CommandGroup commandGroup;
+
+  commandGroup.AddParallel(&childA);
+  commandGroup.AddParallel(&childB);
+  commandGroup.AddSequential(&first);
+  commandGroup.AddSequential(&second);
+
+  commandGroup.Start();
+  Scheduler::GetInstance()->Run();
+  Scheduler::GetInstance()->Run();
+  AssertCommandState(childA, 1, 1, 1, 0, 0);
+  AssertCommandState(childB, 1, 1, 1, 0, 0);
+  AssertCommandState(first, 1, 1, 1, 0, 0);
+  EXPECT_EQ(2, commandGroup.GetSize());
+  first.SetHasFinished(true);
+  Scheduler::GetInstance()->Run();
+  // second requires subsystemA, so childA is interrupted when it starts
+  AssertCommandState(childA, 1, 1, 1, 0, 1);
+  AssertCommandState(childB, 1, 2, 2, 0, 0);
+  AssertCommandState(first, 1, 2, 2, 1, 0);
+  AssertCommandState(second, 1, 1, 1, 0, 0);
+  EXPECT_EQ(1, commandGroup.GetSize());
+  second.SetHasFinished(true);
+  childB.SetHasFinished(true);
+  Scheduler::GetInstance()->Run();
+  AssertCommandState(childB, 1, 3, 3, 1, 0);
+  AssertCommandState(second, 1, 2, 2, 1, 0);
+  EXPECT_EQ(0, commandGroup.GetSize());
+
+  TeardownScheduler();
+}
+
 // CommandScheduleTest ported from CommandScheduleTest.java
 TEST_F(CommandTest, RunAndTerminate) {
   MockCommand command;
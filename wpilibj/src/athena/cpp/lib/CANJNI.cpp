@@ -16,6 +16,26 @@ TLogLevel canJNILogLevel = logERROR;
     if (level > canJNILogLevel) ; \
     else Log().Get(level)
 
+// Format CAN frame data as hex bytes for the debug log, without going
+// through a stream. out must hold at least 3 * 8 + 1 characters.
+static const char *formatCANData(const uint8_t *data, uint8_t dataSize,
+                                 char *out) {
+  static const char kHex[] = "0123456789abcdef";
+  char *p = out;
+  for (int i = 0; i < dataSize && i < 8; i++) {
+    *p++ = kHex[data[i] >> 4];
+    *p++ = kHex[data[i] & 0xf];
+    *p++ = ' ';
+  }
+  *p = '\0';
+  return out;
+}
+
+// readStreamSession fills the Java buffer directly, so the layout of
+// tCANStreamMessage is part of the Java API (see CANJNI.java)
+static_assert(sizeof(tCANStreamMessage) == 20,
+              "tCANStreamMessage layout doesn't match CANJNI.java");
+
 extern "C" {
 
 /*
@@ -37,14 +57,8 @@ JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommunica
     {
         if(dataBuffer)
         {
-            std::ostringstream str;
-            str << std::setfill('0') << std::hex;
-            for(int i = 0; i < dataSize; i++)
-            {
-                str << std::setw(2) << (int)dataBuffer[i] << ' ';
-            }
-
-            Log().Get(logDEBUG) << "Data: " << str.str();
+            char str[3 * 8 + 1];
+            Log().Get(logDEBUG) << "Data: " << formatCANData(dataBuffer, dataSize, str);
         }
         else
         {
@@ -61,8 +75,6 @@ JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommunica
     CheckCANStatus(env, status, messageID);
 }
 
-static uint8_t buffer[8];
-
 /*
  * Class:     edu_wpi_first_wpilibj_can_CANJNI
  * Method:    FRCNetworkCommunicationCANSessionMuxReceiveMessage
@@ -76,6 +88,9 @@ JNIEXPORT jobject JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommun
     uint32_t *messageIDPtr = (uint32_t *)env->GetDirectBufferAddress(messageID);
     uint32_t *timeStampPtr = (uint32_t *)env->GetDirectBufferAddress(timeStamp);
 
+    // The returned buffer wraps this, so it stays valid until the same thread
+    // receives again
+    static thread_local uint8_t buffer[8];
     uint8_t dataSize = 0;
 
     int32_t status = 0;
@@ -85,14 +100,8 @@ JNIEXPORT jobject JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommun
 
     if(logDEBUG <= canJNILogLevel)
     {
-        std::ostringstream str;
-        str << std::setfill('0') << std::hex;
-        for(int i = 0; i < dataSize; i++)
-        {
-            str << std::setw(2) << (int)buffer[i] << ' ';
-        }
-
-        Log().Get(logDEBUG) << "Data: " << str.str();
+        char str[3 * 8 + 1];
+        Log().Get(logDEBUG) << "Data: " << formatCANData(buffer, dataSize, str);
     }
 
     CANJNI_LOG(logDEBUG) << "Timestamp: " << *timeStampPtr;
@@ -102,4 +111,105 @@ JNIEXPORT jobject JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommun
     return env->NewDirectByteBuffer(buffer, dataSize);
 }
 
+/*
+ * Class:     edu_wpi_first_wpilibj_can_CANJNI
+ * Method:    FRCNetworkCommunicationCANSessionMuxReceiveMessageInto
+ * Signature: (Ljava/nio/IntBuffer;ILjava/nio/ByteBuffer;Ljava/nio/IntBuffer;)I
+ */
+JNIEXPORT jint JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommunicationCANSessionMuxReceiveMessageInto
+	(JNIEnv * env, jclass, jobject messageID, jint messageIDMask, jobject data, jobject timeStamp)
+{
+    CANJNI_LOG(logDEBUG) << "Calling CANJNI FRCNetworkCommunicationCANSessionMuxReceiveMessageInto";
+
+    uint32_t *messageIDPtr = (uint32_t *)env->GetDirectBufferAddress(messageID);
+    uint32_t *timeStampPtr = (uint32_t *)env->GetDirectBufferAddress(timeStamp);
+    uint8_t *dataBuffer = (uint8_t *)env->GetDirectBufferAddress(data);
+    if (env->GetDirectBufferCapacity(data) < 8) {
+        ThrowIllegalArgumentException(env, "data buffer must hold 8 bytes");
+        return 0;
+    }
+
+    uint8_t dataSize = 0;
+
+    int32_t status = 0;
+    FRC_NetworkCommunication_CANSessionMux_receiveMessage(messageIDPtr, messageIDMask, dataBuffer, &dataSize, timeStampPtr, &status);
+
+    CANJNI_LOG(logDEBUG) << "Message ID " << std::hex << *messageIDPtr;
+
+    if(logDEBUG <= canJNILogLevel)
+    {
+        char str[3 * 8 + 1];
+        Log().Get(logDEBUG) << "Data: " << formatCANData(dataBuffer, dataSize, str);
+    }
+
+    CANJNI_LOG(logDEBUG) << "Timestamp: " << *timeStampPtr;
+    CANJNI_LOG(logDEBUG) << "Status: " << status;
+
+    if (!CheckCANStatus(env, status, *messageIDPtr)) return 0;
+    return dataSize;
+}
+
+/*
+ * Class:     edu_wpi_first_wpilibj_can_CANJNI
+ * Method:    FRCNetworkCommunicationCANSessionMuxOpenStreamSession
+ * Signature: (III)I
+ */
+JNIEXPORT jint JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommunicationCANSessionMuxOpenStreamSession
+	(JNIEnv * env, jclass, jint messageID, jint messageIDMask, jint maxMessages)
+{
+    CANJNI_LOG(logDEBUG) << "Calling CANJNI FRCNetworkCommunicationCANSessionMuxOpenStreamSession";
+
+    uint32_t sessionHandle = 0;
+    int32_t status = 0;
+    FRC_NetworkCommunication_CANSessionMux_openStreamSession(&sessionHandle, messageID, messageIDMask, maxMessages, &status);
+
+    CANJNI_LOG(logDEBUG) << "Session Handle: " << sessionHandle;
+    CANJNI_LOG(logDEBUG) << "Status: " << status;
+
+    CheckCANStatus(env, status, messageID);
+    return sessionHandle;
+}
+
+/*
+ * Class:     edu_wpi_first_wpilibj_can_CANJNI
+ * Method:    FRCNetworkCommunicationCANSessionMuxCloseStreamSession
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommunicationCANSessionMuxCloseStreamSession
+	(JNIEnv *, jclass, jint sessionHandle)
+{
+    CANJNI_LOG(logDEBUG) << "Calling CANJNI FRCNetworkCommunicationCANSessionMuxCloseStreamSession";
+
+    FRC_NetworkCommunication_CANSessionMux_closeStreamSession(sessionHandle);
+}
+
+/*
+ * Class:     edu_wpi_first_wpilibj_can_CANJNI
+ * Method:    FRCNetworkCommunicationCANSessionMuxReadStreamSession
+ * Signature: (ILjava/nio/ByteBuffer;I)I
+ */
+JNIEXPORT jint JNICALL Java_edu_wpi_first_wpilibj_can_CANJNI_FRCNetworkCommunicationCANSessionMuxReadStreamSession
+	(JNIEnv * env, jclass, jint sessionHandle, jobject messages, jint messagesToRead)
+{
+    CANJNI_LOG(logDEBUG) << "Calling CANJNI FRCNetworkCommunicationCANSessionMuxReadStreamSession";
+
+    tCANStreamMessage *messageBuffer = (tCANStreamMessage *)env->GetDirectBufferAddress(messages);
+    jlong capacity = env->GetDirectBufferCapacity(messages);
+    if (messageBuffer == nullptr || messagesToRead < 0 ||
+        capacity < (jlong)messagesToRead * (jlong)sizeof(tCANStreamMessage)) {
+        ThrowIllegalArgumentException(env, "messages buffer is too small");
+        return 0;
+    }
+
+    uint32_t messagesRead = 0;
+    int32_t status = 0;
+    FRC_NetworkCommunication_CANSessionMux_readStreamSession(sessionHandle, messageBuffer, messagesToRead, &messagesRead, &status);
+
+    CANJNI_LOG(logDEBUG) << "Messages Read: " << messagesRead;
+    CANJNI_LOG(logDEBUG) << "Status: " << status;
+
+    if (!CheckCANStatus(env, status, 0)) return 0;
+    return messagesRead;
+}
+
 }  // extern "C"
@@ -1,5 +1,6 @@
 #include <jni.h>
-#include <assert.h>
+#include <pthread.h>
+#include <atomic>
 #include <functional>
 #include <stdio.h>
 #include "Log.hpp"
@@ -14,43 +15,86 @@ TLogLevel notifierJNILogLevel = logWARNING;
     if (level > notifierJNILogLevel) ; \
     else Log().Get(level)
 
-// These two are used to pass information to the notifierHandler without using
-// up function parameters.
-// See below for more information.
-static jobject func_global;
-static jmethodID mid_global;
+// Everything the notifierHandler needs to call the Java handler of one
+// notifier. The HAL passes it back to us as the handler parameter, so any
+// number of notifiers can exist at the same time.
+struct NotifierJNIContext {
+  void *notifier;
+  jobject func;
+  jmethodID mid;
+};
+
+// The JNIEnv of the HAL interrupt thread. The thread lives as long as the
+// notifiers, so it is attached to the JVM on the first callback and stays
+// attached, as a daemon so it doesn't keep the JVM from exiting. The env is
+// kept in a thread specific key whose destructor detaches the thread when it
+// exits.
+static pthread_key_t notifierEnvKey;
+static pthread_once_t notifierEnvKeyOnce = PTHREAD_ONCE_INIT;
+
+static void detachNotifierThread(void *) {
+  jvm->DetachCurrentThread();
+  NOTIFIERJNI_LOG(logDEBUG) << "Detached notifier thread from the JVM";
+}
+
+static void createNotifierEnvKey() {
+  pthread_key_create(&notifierEnvKey, detachNotifierThread);
+}
+
+// Returns nullptr if the thread can't be attached.
+static JNIEnv *getNotifierEnv() {
+  pthread_once(&notifierEnvKeyOnce, createNotifierEnvKey);
+  JNIEnv *env = (JNIEnv *)pthread_getspecific(notifierEnvKey);
+  if (env != nullptr) return env;
+
+  jint rs = jvm->GetEnv((void **)&env, JNI_VERSION_1_8);
+  if (rs == JNI_OK) return env;  // attached by someone else, who detaches it
+  if (rs == JNI_EDETACHED)
+    rs = jvm->AttachCurrentThreadAsDaemon((void **)&env, NULL);
+  if (rs != JNI_OK) {
+    NOTIFIERJNI_LOG(logERROR) << "Failed to attach notifier thread to the JVM: "
+                              << rs;
+    return nullptr;
+  }
+  NOTIFIERJNI_LOG(logDEBUG) << "Attached notifier thread to the JVM";
+  pthread_setspecific(notifierEnvKey, env);
+  return env;
+}
 
-// The arguments are unused by the HAL Notifier; they just satisfy a particular
-// function signature.
+// Set by setAttachEachCall() to attach and detach the interrupt thread around
+// every call, as this used to, so the latency test can compare the two.
+static std::atomic<bool> attachEachCall(false);
+
+// The mask is unused; param is the NotifierJNIContext of the notifier.
 void notifierHandler(uint32_t mask, void* param) {
-  jobject handler_obj = func_global;
-  jmethodID mid = mid_global;
-
-	NOTIFIERJNI_LOG(logDEBUG) << "Calling NOTIFIERJNI notifierHandler";
-
-	//Because this is a callback in a new thread we must attach it to the JVM.
-	JNIEnv *env;
-  jint rs;
-  // Check to see if we are already part of a JVM thread or if we need to attach
-  // ourselves.
-  int getEnvStat = jvm->GetEnv((void **)&env, JNI_VERSION_1_8);
-  if (getEnvStat == JNI_EDETACHED) {
-    rs = jvm->AttachCurrentThread((void**)&env, NULL);
-    assert (rs == JNI_OK);
+  NotifierJNIContext *context = (NotifierJNIContext *)param;
+
+	NOTIFIERJNI_LOG(logDEBUG) << "Calling NOTIFIERJNI notifierHandler, object is: "
+	                          << context->func;
+
+  if (attachEachCall) {
+    pthread_once(&notifierEnvKeyOnce, createNotifierEnvKey);
+    if (pthread_getspecific(notifierEnvKey) != nullptr) {
+      pthread_setspecific(notifierEnvKey, nullptr);
+      jvm->DetachCurrentThread();
+    }
+    JNIEnv *env;
+    if (jvm->AttachCurrentThread((void **)&env, NULL) != JNI_OK) return;
+    env->CallVoidMethod(context->func, context->mid);
+    if (env->ExceptionCheck()) {
+      env->ExceptionDescribe();
+    }
+    jvm->DetachCurrentThread();
+    return;
   }
-	NOTIFIERJNI_LOG(logDEBUG) << "Attached to thread. Object is: " << handler_obj;
 
-  // Actuall call the user function.
-	env->CallVoidMethod(handler_obj, mid);
+  JNIEnv *env = getNotifierEnv();
+  if (env == nullptr) return;
+	env->CallVoidMethod(context->func, context->mid);
 	if (env->ExceptionCheck()) {
 		env->ExceptionDescribe();
 	}
 
-  // Only detach if we needed to attach oursleves in the first place.
-  if (getEnvStat == JNI_EDETACHED) {
-    rs = jvm->DetachCurrentThread();
-    assert (rs == JNI_OK);
-  }
 	NOTIFIERJNI_LOG(logDEBUG) << "Leaving NOTIFIERJNI notifierHandler";
 }
 
@@ -67,28 +111,20 @@ JNIEXPORT jlong JNICALL Java_edu_wpi_first_wpilibj_hal_NotifierJNI_initializeNot
 	NOTIFIERJNI_LOG(logDEBUG) << "Calling NOTIFIERJNI initializeNotifier";
 
   jclass cls = env->GetObjectClass(func);
-  jmethodID mid = env->GetMethodID(cls, "run", "()V");
-
-  // In order to pass the user's Runnable to the notifierHandler, we have to use
-  // something other than the function arguments (because the function arguments
-  // are dictated by the callback format). As such, we instead use a couple of
-  // global variables to pass around the object reference.
-  // This is not ideal, but the only other option that came to mind was to use
-  // lambda function captures, but, unfortunately, it turns out that using
-  // captures in a lambda changes the function signature such that it can no
-  // long be used as a standared C-style function pointer.
+
   // Need to set as global ref to avoid seg faults when referring to it later.
-  func_global = env->NewGlobalRef(func);
-  mid_global = mid;
+  NotifierJNIContext *context = new NotifierJNIContext;
+  context->func = env->NewGlobalRef(func);
+  context->mid = env->GetMethodID(cls, "run", "()V");
 
 	int32_t status = 0;
-	void *notifierPtr = initializeNotifier(notifierHandler, &status);
+	context->notifier = initializeNotifier(notifierHandler, context, &status);
 
-	NOTIFIERJNI_LOG(logDEBUG) << "Notifier Ptr = " << notifierPtr;
+	NOTIFIERJNI_LOG(logDEBUG) << "Notifier Ptr = " << context->notifier;
 	NOTIFIERJNI_LOG(logDEBUG) << "Status = " << status;
 
 	CheckStatus(env, status);
-	return (jlong)notifierPtr;
+	return (jlong)context;
 }
 
 /*
@@ -103,8 +139,13 @@ JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_hal_NotifierJNI_cleanNotifier
 
 	NOTIFIERJNI_LOG(logDEBUG) << "Notifier Ptr = " << (void*)notifierPtr;
 
+  // The interrupt manager is disabled and deleted by cleanNotifier, so the
+  // handler won't be called with the context any more
+  NotifierJNIContext *context = (NotifierJNIContext *)notifierPtr;
   int32_t status = 0;
-  cleanNotifier((void*)notifierPtr, &status);
+  cleanNotifier(context->notifier, &status);
+  env->DeleteGlobalRef(context->func);
+  delete context;
 	NOTIFIERJNI_LOG(logDEBUG) << "Status = " << status;
 	CheckStatus(env, status);
 }
@@ -123,10 +164,22 @@ JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_hal_NotifierJNI_updateNotifier
 
   NOTIFIERJNI_LOG(logDEBUG) << "triggerTime Ptr = " << &triggerTime;
 
+  NotifierJNIContext *context = (NotifierJNIContext *)notifierPtr;
   int32_t status = 0;
-  updateNotifierAlarm((void*)notifierPtr, (uint32_t)triggerTime, &status);
+  updateNotifierAlarm(context->notifier, (uint32_t)triggerTime, &status);
 	NOTIFIERJNI_LOG(logDEBUG) << "Status = " << status;
 	CheckStatus(env, status);
 }
 
+/*
+ * Class:     edu_wpi_first_wpilibj_hal_NotifierJNI
+ * Method:    setAttachEachCall
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_hal_NotifierJNI_setAttachEachCall
+  (JNIEnv *, jclass, jboolean attach)
+{
+  attachEachCall = attach;
+}
+
 }  // extern "C"
@@ -0,0 +1,196 @@
+#include <jni.h>
+#include <assert.h>
+#include <string.h>
+#include <vector>
+#include "Log.hpp"
+
+#include "edu_wpi_first_wpilibj_hal_SensorBatchJNI.h"
+
+#include "HAL/Analog.hpp"
+#include "HAL/Digital.hpp"
+#include "HAL/Errors.hpp"
+#include "HALUtil.h"
+
+// set the logging level
+TLogLevel sensorBatchJNILogLevel = logWARNING;
+
+#define SENSORBATCHJNI_LOG(level) \
+    if (level > sensorBatchJNILogLevel) ; \
+    else Log().Get(level)
+
+// Must match the field types in SensorBatchJNI.java
+enum SensorBatchField {
+  kAnalogValue = 0,
+  kAnalogAverageValue,
+  kAnalogVoltage,
+  kAnalogAverageVoltage,
+  kAccumulatorValue,
+  kDIO,
+  kCounter,
+  kCounterPeriod,
+  kEncoder,
+  kEncoderPeriod,
+  kEncoderStopped,
+  kEncoderDirection,
+  kCounterStopped,
+  kCounterDirection,
+  kNumFields
+};
+
+// Each entry of the buffer is an 8 byte value followed by the 4 byte status
+// and 4 bytes of padding, in native byte order. Integer fields are stored as
+// a 64 bit integer and floating point fields as a double.
+static const int kEntrySize = 16;
+
+struct SensorBatchEntry {
+  void *handle;
+  SensorBatchField field;
+};
+
+struct SensorBatch {
+  std::vector<SensorBatchEntry> entries;
+};
+
+static inline void storeInteger(jbyte *entry, int64_t value) {
+  memcpy(entry, &value, sizeof(value));
+}
+
+static inline void storeDouble(jbyte *entry, double value) {
+  memcpy(entry, &value, sizeof(value));
+}
+
+extern "C" {
+
+/*
+ * Class:     edu_wpi_first_wpilibj_hal_SensorBatchJNI
+ * Method:    initializeSensorBatch
+ * Signature: ([J[I)J
+ */
+JNIEXPORT jlong JNICALL Java_edu_wpi_first_wpilibj_hal_SensorBatchJNI_initializeSensorBatch
+  (JNIEnv *env, jclass, jlongArray handles, jintArray fields)
+{
+	SENSORBATCHJNI_LOG(logDEBUG) << "Calling SENSORBATCHJNI initializeSensorBatch";
+
+  jsize count = env->GetArrayLength(handles);
+  if (env->GetArrayLength(fields) != count) {
+    ThrowIllegalArgumentException(env, "handles and fields differ in length");
+    return 0;
+  }
+
+  std::vector<jlong> handleValues(count);
+  std::vector<jint> fieldValues(count);
+  env->GetLongArrayRegion(handles, 0, count, handleValues.data());
+  env->GetIntArrayRegion(fields, 0, count, fieldValues.data());
+
+  SensorBatch *batch = new SensorBatch;
+  batch->entries.reserve(count);
+  for (jsize i = 0; i < count; i++) {
+    // A handle of 0 is a sensor that has been freed; it's kept so the other
+    // entries keep their index, and reads as a handle error.
+    if (fieldValues[i] < 0 || fieldValues[i] >= kNumFields) {
+      delete batch;
+      ThrowIllegalArgumentException(env, "invalid sensor batch entry");
+      return 0;
+    }
+    batch->entries.push_back(
+        {(void *)handleValues[i], (SensorBatchField)fieldValues[i]});
+  }
+
+	SENSORBATCHJNI_LOG(logDEBUG) << "Entries = " << count;
+	SENSORBATCHJNI_LOG(logDEBUG) << "Batch Ptr = " << batch;
+  return (jlong)batch;
+}
+
+/*
+ * Class:     edu_wpi_first_wpilibj_hal_SensorBatchJNI
+ * Method:    freeSensorBatch
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_hal_SensorBatchJNI_freeSensorBatch
+  (JNIEnv *, jclass, jlong batchPtr)
+{
+	SENSORBATCHJNI_LOG(logDEBUG) << "Calling SENSORBATCHJNI freeSensorBatch";
+	SENSORBATCHJNI_LOG(logDEBUG) << "Batch Ptr = " << (void*)batchPtr;
+  delete (SensorBatch *)batchPtr;
+}
+
+/*
+ * Class:     edu_wpi_first_wpilibj_hal_SensorBatchJNI
+ * Method:    readSensorBatch
+ * Signature: (JLjava/nio/ByteBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_edu_wpi_first_wpilibj_hal_SensorBatchJNI_readSensorBatch
+  (JNIEnv *env, jclass, jlong batchPtr, jobject buffer)
+{
+	//SENSORBATCHJNI_LOG(logDEBUG) << "Calling SENSORBATCHJNI readSensorBatch";
+  SensorBatch *batch = (SensorBatch *)batchPtr;
+  jbyte *data = (jbyte *)env->GetDirectBufferAddress(buffer);
+  jlong capacity = env->GetDirectBufferCapacity(buffer);
+  if (data == nullptr ||
+      capacity < (jlong)batch->entries.size() * kEntrySize) {
+    ThrowIllegalArgumentException(env,
+                                  "buffer must be direct and hold every entry");
+    return;
+  }
+
+  for (auto &entry : batch->entries) {
+    int32_t status = 0;
+    if (entry.handle == nullptr) {
+      storeInteger(data, 0);
+      status = HAL_HANDLE_ERROR;
+      memcpy(data + 8, &status, sizeof(status));
+      data += kEntrySize;
+      continue;
+    }
+    switch (entry.field) {
+      case kAnalogValue:
+        storeInteger(data, getAnalogValue(entry.handle, &status));
+        break;
+      case kAnalogAverageValue:
+        storeInteger(data, getAnalogAverageValue(entry.handle, &status));
+        break;
+      case kAnalogVoltage:
+        storeDouble(data, getAnalogVoltage(entry.handle, &status));
+        break;
+      case kAnalogAverageVoltage:
+        storeDouble(data, getAnalogAverageVoltage(entry.handle, &status));
+        break;
+      case kAccumulatorValue:
+        storeInteger(data, getAccumulatorValue(entry.handle, &status));
+        break;
+      case kDIO:
+        storeInteger(data, getDIO(entry.handle, &status));
+        break;
+      case kCounter:
+        storeInteger(data, getCounter(entry.handle, &status));
+        break;
+      case kCounterPeriod:
+        storeDouble(data, getCounterPeriod(entry.handle, &status));
+        break;
+      case kEncoder:
+        storeInteger(data, getEncoder(entry.handle, &status));
+        break;
+      case kEncoderPeriod:
+        storeDouble(data, getEncoderPeriod(entry.handle, &status));
+        break;
+      case kEncoderStopped:
+        storeInteger(data, getEncoderStopped(entry.handle, &status));
+        break;
+      case kEncoderDirection:
+        storeInteger(data, getEncoderDirection(entry.handle, &status));
+        break;
+      case kCounterStopped:
+        storeInteger(data, getCounterStopped(entry.handle, &status));
+        break;
+      case kCounterDirection:
+        storeInteger(data, getCounterDirection(entry.handle, &status));
+        break;
+      default:
+        break;
+    }
+    memcpy(data + 8, &status, sizeof(status));
+    data += kEntrySize;
+  }
+}
+
+}  // extern "C"
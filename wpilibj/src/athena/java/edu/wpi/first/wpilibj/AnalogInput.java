@@ -41,10 +41,10 @@ public class AnalogInput extends SensorBase implements PIDSource, LiveWindowSend
 
   private static final int kAccumulatorSlot = 1;
   private static Resource channels = new Resource(kAnalogInputChannels);
-  private long m_port;
+  long m_port; // package visible for SensorBatch
   private int m_channel;
   private static final int[] kAccumulatorChannels = {0, 1};
-  private long m_accumulatorOffset;
+  long m_accumulatorOffset; // package visible for SensorBatch
   protected PIDSourceType m_pidSource = PIDSourceType.kDisplacement;
 
   /**
@@ -79,6 +79,7 @@ public class AnalogInput extends SensorBase implements PIDSource, LiveWindowSend
   public void free() {
     channels.free(m_channel);
     m_channel = 0;
+    m_port = 0;
     m_accumulatorOffset = 0;
   }
 
@@ -9,6 +9,7 @@ package edu.wpi.first.wpilibj;
 
 import java.nio.ByteBuffer;
 import java.nio.ByteOrder;
+import java.nio.IntBuffer;
 
 import edu.wpi.first.wpilibj.can.CANJNI;
 import edu.wpi.first.wpilibj.can.CANMessageNotFoundException;
@@ -37,6 +38,14 @@ public class CANJaguar implements MotorSafety, PIDOutput, CANSpeedController {
       | CANJNI.CAN_MSGID_DTYPE_M;
   private static final int kSendMessagePeriod = 20;
 
+  // Reused by every getMessage() call, which synchronizes on m_receiveData
+  private final ByteBuffer m_receiveData =
+      ByteBuffer.allocateDirect(kMaxMessageDataSize).order(ByteOrder.nativeOrder());
+  private final IntBuffer m_receiveMessageID =
+      ByteBuffer.allocateDirect(4).order(ByteOrder.nativeOrder()).asIntBuffer();
+  private final IntBuffer m_receiveTimeStamp =
+      ByteBuffer.allocateDirect(4).order(ByteOrder.nativeOrder()).asIntBuffer();
+
   // Control Mode tags
   private static class EncoderTag {
   };
@@ -1996,20 +2005,18 @@ public class CANJaguar implements MotorSafety, PIDOutput, CANSpeedController {
     messageID |= m_deviceNumber;
     messageID &= CANJNI.CAN_MSGID_FULL_M;
 
-    ByteBuffer targetedMessageID = ByteBuffer.allocateDirect(4);
-    targetedMessageID.order(ByteOrder.LITTLE_ENDIAN);
-    targetedMessageID.asIntBuffer().put(0, messageID);
-
-    ByteBuffer timeStamp = ByteBuffer.allocateDirect(4);
+    synchronized (m_receiveData) {
+      m_receiveMessageID.put(0, messageID);
 
-    // Get the data.
-    ByteBuffer dataBuffer =
-        CANJNI.FRCNetworkCommunicationCANSessionMuxReceiveMessage(targetedMessageID.asIntBuffer(),
-            messageMask, timeStamp);
+      // Get the data.
+      int dataSize =
+          CANJNI.FRCNetworkCommunicationCANSessionMuxReceiveMessageInto(m_receiveMessageID,
+              messageMask, m_receiveData, m_receiveTimeStamp);
 
-    if (data != null) {
-      for (int i = 0; i < dataBuffer.capacity(); i++) {
-        data[i] = dataBuffer.get(i);
+      if (data != null) {
+        for (int i = 0; i < dataSize; i++) {
+          data[i] = m_receiveData.get(i);
+        }
       }
     }
   }
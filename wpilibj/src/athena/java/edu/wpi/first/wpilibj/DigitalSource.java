@@ -48,6 +48,7 @@ public abstract class DigitalSource extends InterruptableSensorBase {
     channels.free(m_channel);
     DIOJNI.freeDIO(m_port);
     m_channel = 0;
+    m_port = 0;
   }
 
   /**
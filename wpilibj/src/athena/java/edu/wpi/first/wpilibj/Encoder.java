@@ -48,11 +48,11 @@ public class Encoder extends SensorBase implements CounterBase, PIDSource, LiveW
    * The index source
    */
   protected DigitalSource m_indexSource = null; // Index on some encoders
-  private long m_encoder;
+  long m_encoder; // package visible for SensorBatch
   private int m_index;
   private double m_distancePerPulse; // distance of travel for each encoder
   // tick
-  private Counter m_counter; // Counter object for 1x and 2x encoding
+  Counter m_counter; // Counter object for 1x and 2x encoding
   private EncodingType m_encodingType = EncodingType.k4X;
   private int m_encodingScale; // 1x, 2x, or 4x, per the encodingType
   private boolean m_allocatedA;
@@ -374,6 +374,7 @@ public class Encoder extends SensorBase implements CounterBase, PIDSource, LiveW
       m_counter = null;
     } else {
       EncoderJNI.freeEncoder(m_encoder);
+      m_encoder = 0;
     }
   }
 
@@ -0,0 +1,301 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved. */
+/* Open Source Software - may be modified and shared by FRC teams. The code */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project. */
+/*----------------------------------------------------------------------------*/
+package edu.wpi.first.wpilibj;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+
+import edu.wpi.first.wpilibj.hal.HALUtil;
+import edu.wpi.first.wpilibj.hal.SensorBatchJNI;
+
+/**
+ * Reads many sensors with a single call into the HAL.
+ *
+ * Every sensor read through its own class, such as AnalogInput.getValue(),
+ * is a separate call through JNI. A robot reading many sensors each loop can
+ * instead add them to a SensorBatch once, call update() at the start of the
+ * loop and then get the values of that update from the batch.
+ *
+ * Errors don't throw; each entry has its own HAL status, see getStatus(). A
+ * sensor freed after it was added reads as HALUtil.HANDLE_ERROR.
+ *
+ * update() checks whether each sensor was freed before it reads them, but
+ * not atomically with the read: a sensor must not be freed by another thread
+ * while an update() is running.
+ */
+public class SensorBatch {
+  private final ArrayList<Object> m_sensors = new ArrayList<Object>();
+  private final ArrayList<Integer> m_fields = new ArrayList<Integer>();
+  // The HAL pointers the native batch was created with
+  private long[] m_handles = new long[0];
+  // The accumulator offset of each entry as of the last update(), 0 for
+  // entries that aren't accumulators
+  private long[] m_offsets = new long[0];
+  private long m_batch = 0;
+  private ByteBuffer m_buffer;
+  private int m_count = 0; // The number of entries read by the last update()
+
+  private synchronized int add(Object sensor, int field) {
+    m_sensors.add(sensor);
+    m_fields.add(field);
+    return m_sensors.size() - 1;
+  }
+
+  /**
+   * The current HAL pointer of a sensor, which is 0 once it has been freed.
+   */
+  private static long handleOf(Object sensor) {
+    if (sensor instanceof AnalogInput) {
+      return ((AnalogInput) sensor).m_port;
+    } else if (sensor instanceof DigitalSource) {
+      return ((DigitalSource) sensor).m_port;
+    } else if (sensor instanceof Counter) {
+      return ((Counter) sensor).m_counter;
+    } else {
+      return ((Encoder) sensor).m_encoder;
+    }
+  }
+
+  /**
+   * Add the raw value of an analog input, read with getLong().
+   *
+   * @return The index of the entry
+   */
+  public int addAnalogValue(AnalogInput input) {
+    return add(input, SensorBatchJNI.kAnalogValue);
+  }
+
+  /**
+   * Add the averaged raw value of an analog input, read with getLong().
+   *
+   * @return The index of the entry
+   */
+  public int addAnalogAverageValue(AnalogInput input) {
+    return add(input, SensorBatchJNI.kAnalogAverageValue);
+  }
+
+  /**
+   * Add the voltage of an analog input, read with getDouble().
+   *
+   * @return The index of the entry
+   */
+  public int addAnalogVoltage(AnalogInput input) {
+    return add(input, SensorBatchJNI.kAnalogVoltage);
+  }
+
+  /**
+   * Add the averaged voltage of an analog input, read with getDouble().
+   *
+   * @return The index of the entry
+   */
+  public int addAnalogAverageVoltage(AnalogInput input) {
+    return add(input, SensorBatchJNI.kAnalogAverageVoltage);
+  }
+
+  /**
+   * Add the accumulated value of an analog input, as returned by
+   * AnalogInput.getAccumulatorValue(), read with getLong().
+   *
+   * @return The index of the entry
+   */
+  public int addAccumulatorValue(AnalogInput input) {
+    return add(input, SensorBatchJNI.kAccumulatorValue);
+  }
+
+  /**
+   * Add the value of a digital input, read with getBoolean().
+   *
+   * @return The index of the entry
+   */
+  public int addDigitalInput(DigitalInput input) {
+    return add(input, SensorBatchJNI.kDIO);
+  }
+
+  /**
+   * Add the count of a counter, read with getLong().
+   *
+   * @return The index of the entry
+   */
+  public int addCounter(Counter counter) {
+    return add(counter, SensorBatchJNI.kCounter);
+  }
+
+  /**
+   * Add the period of a counter in seconds, read with getDouble().
+   *
+   * @return The index of the entry
+   */
+  public int addCounterPeriod(Counter counter) {
+    return add(counter, SensorBatchJNI.kCounterPeriod);
+  }
+
+  /**
+   * Add whether a counter has stopped, as returned by Counter.getStopped(),
+   * read with getBoolean().
+   *
+   * @return The index of the entry
+   */
+  public int addCounterStopped(Counter counter) {
+    return add(counter, SensorBatchJNI.kCounterStopped);
+  }
+
+  /**
+   * Add the last direction a counter changed in, as returned by
+   * Counter.getDirection(), read with getBoolean().
+   *
+   * @return The index of the entry
+   */
+  public int addCounterDirection(Counter counter) {
+    return add(counter, SensorBatchJNI.kCounterDirection);
+  }
+
+  /**
+   * Add the raw count of an encoder, as returned by Encoder.getRaw(), read
+   * with getLong().
+   *
+   * @return The index of the entry
+   */
+  public int addEncoderRaw(Encoder encoder) {
+    if (encoder.m_counter != null) {
+      return addCounter(encoder.m_counter);
+    }
+    return add(encoder, SensorBatchJNI.kEncoder);
+  }
+
+  /**
+   * Add the period of an encoder in seconds, read with getDouble().
+   *
+   * @return The index of the entry
+   */
+  public int addEncoderPeriod(Encoder encoder) {
+    if (encoder.m_counter != null) {
+      return addCounterPeriod(encoder.m_counter);
+    }
+    return add(encoder, SensorBatchJNI.kEncoderPeriod);
+  }
+
+  /**
+   * Add whether an encoder has stopped, as returned by Encoder.getStopped(),
+   * read with getBoolean().
+   *
+   * @return The index of the entry
+   */
+  public int addEncoderStopped(Encoder encoder) {
+    if (encoder.m_counter != null) {
+      return addCounterStopped(encoder.m_counter);
+    }
+    return add(encoder, SensorBatchJNI.kEncoderStopped);
+  }
+
+  /**
+   * Add the last direction an encoder changed in, as returned by
+   * Encoder.getDirection(), read with getBoolean().
+   *
+   * @return The index of the entry
+   */
+  public int addEncoderDirection(Encoder encoder) {
+    if (encoder.m_counter != null) {
+      return addCounterDirection(encoder.m_counter);
+    }
+    return add(encoder, SensorBatchJNI.kEncoderDirection);
+  }
+
+  /**
+   * Read all of the sensors of the batch.
+   *
+   * The native batch is recreated when sensors were added, or when a sensor
+   * was freed since the last update, so a freed sensor is never read.
+   */
+  public synchronized void update() {
+    int count = m_sensors.size();
+    boolean changed = m_batch == 0 || m_handles.length != count;
+    for (int i = 0; !changed && i < count; i++) {
+      changed = handleOf(m_sensors.get(i)) != m_handles[i];
+    }
+
+    if (changed) {
+      free();
+      m_handles = new long[count];
+      int[] fields = new int[count];
+      for (int i = 0; i < count; i++) {
+        m_handles[i] = handleOf(m_sensors.get(i));
+        fields[i] = m_fields.get(i);
+      }
+      m_batch = SensorBatchJNI.initializeSensorBatch(m_handles, fields);
+      if (m_buffer == null || m_buffer.capacity() < count * SensorBatchJNI.kEntrySize) {
+        m_buffer = ByteBuffer.allocateDirect(count * SensorBatchJNI.kEntrySize);
+        // set the byte order
+        m_buffer.order(ByteOrder.nativeOrder());
+      }
+      m_offsets = new long[count];
+    }
+
+    SensorBatchJNI.readSensorBatch(m_batch, m_buffer);
+    for (int i = 0; i < count; i++) {
+      if (m_fields.get(i) == SensorBatchJNI.kAccumulatorValue) {
+        m_offsets[i] = ((AnalogInput) m_sensors.get(i)).m_accumulatorOffset;
+      }
+    }
+    m_count = count;
+  }
+
+  /**
+   * @return The integer value of an entry as of the last update(), or 0 if it
+   *         hasn't been read by an update() yet
+   */
+  public synchronized long getLong(int entry) {
+    if (!wasRead(entry)) {
+      return 0;
+    }
+    return m_buffer.getLong(entry * SensorBatchJNI.kEntrySize) + m_offsets[entry];
+  }
+
+  /**
+   * @return The floating point value of an entry as of the last update(), or
+   *         0 if it hasn't been read by an update() yet
+   */
+  public synchronized double getDouble(int entry) {
+    if (!wasRead(entry)) {
+      return 0.0;
+    }
+    return m_buffer.getDouble(entry * SensorBatchJNI.kEntrySize);
+  }
+
+  /**
+   * @return The value of a digital input entry as of the last update()
+   */
+  public boolean getBoolean(int entry) {
+    return getLong(entry) != 0;
+  }
+
+  /**
+   * @return The HAL status of reading an entry in the last update(), 0 if the
+   *         read succeeded, or HALUtil.INCOMPATIBLE_STATE if the entry hasn't
+   *         been read by an update() yet
+   */
+  public synchronized int getStatus(int entry) {
+    if (!wasRead(entry)) {
+      return HALUtil.INCOMPATIBLE_STATE;
+    }
+    return m_buffer.getInt(entry * SensorBatchJNI.kEntrySize + 8);
+  }
+
+  private boolean wasRead(int entry) {
+    return entry >= 0 && entry < m_count;
+  }
+
+  /**
+   * Free the native batch. It is recreated by the next update().
+   */
+  public synchronized void free() {
+    if (m_batch != 0) {
+      SensorBatchJNI.freeSensorBatch(m_batch);
+      m_batch = 0;
+    }
+  }
+}
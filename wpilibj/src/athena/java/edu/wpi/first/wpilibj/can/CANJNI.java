@@ -499,6 +499,47 @@ public class CANJNI extends JNIWrapper {
   public static native void FRCNetworkCommunicationCANSessionMuxSendMessage(int messageID,
       ByteBuffer data, int periodMs);
 
+  /**
+   * Receive a message. The returned buffer wraps native memory that is reused
+   * by the next receive on the same thread, so copy the data out right away.
+   * FRCNetworkCommunicationCANSessionMuxReceiveMessageInto() avoids allocating
+   * the buffer.
+   */
   public static native ByteBuffer FRCNetworkCommunicationCANSessionMuxReceiveMessage(
       IntBuffer messageID, int messageIDMask, ByteBuffer timeStamp);
+
+  /**
+   * Receive a message into a reusable direct buffer of at least 8 bytes.
+   *
+   * @return The number of data bytes received
+   */
+  public static native int FRCNetworkCommunicationCANSessionMuxReceiveMessageInto(
+      IntBuffer messageID, int messageIDMask, ByteBuffer data, IntBuffer timeStamp);
+
+  /* Layout of a message read by readStreamSession, in native byte order */
+  public static final int CAN_STREAM_MESSAGE_SIZE = 20;
+  public static final int CAN_STREAM_MESSAGE_ID_OFFSET = 0;
+  public static final int CAN_STREAM_TIMESTAMP_OFFSET = 4;
+  public static final int CAN_STREAM_DATA_OFFSET = 8;
+  public static final int CAN_STREAM_DATA_SIZE_OFFSET = 16;
+
+  /**
+   * Start queueing all messages matching the ID and mask, up to maxMessages.
+   *
+   * @return The session handle
+   */
+  public static native int FRCNetworkCommunicationCANSessionMuxOpenStreamSession(int messageID,
+      int messageIDMask, int maxMessages);
+
+  public static native void FRCNetworkCommunicationCANSessionMuxCloseStreamSession(
+      int sessionHandle);
+
+  /**
+   * Read queued messages of a stream session into a direct buffer holding
+   * messagesToRead messages of CAN_STREAM_MESSAGE_SIZE bytes each.
+   *
+   * @return The number of messages read
+   */
+  public static native int FRCNetworkCommunicationCANSessionMuxReadStreamSession(
+      int sessionHandle, ByteBuffer messages, int messagesToRead);
 }
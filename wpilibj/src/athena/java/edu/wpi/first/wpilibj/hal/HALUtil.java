@@ -9,6 +9,7 @@ public class HALUtil extends JNIWrapper {
   public static final int ANALOG_TRIGGER_PULSE_OUTPUT_ERROR = -1011;
   public static final int NO_AVAILABLE_RESOURCES = -104;
   public static final int PARAMETER_OUT_OF_RANGE = -1028;
+  public static final int HANDLE_ERROR = -1098;
 
   // public static final int SEMAPHORE_WAIT_FOREVER = -1;
   // public static final int SEMAPHORE_Q_PRIORITY = 0x01;
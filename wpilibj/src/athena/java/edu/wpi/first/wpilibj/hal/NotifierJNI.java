@@ -11,9 +11,15 @@ import java.lang.Runtime;
  */
 public class NotifierJNI extends JNIWrapper {
   /**
-   * Initializes the notifier to call the run() function of a Runnable.
+   * Initializes a notifier to call the run() function of a Runnable.
    *
-   * Should be called after initializeNotifierJVM().
+   * Each notifier keeps its own Runnable, so several may exist at once. The
+   * Runnable is called from the HAL interrupt thread, which is attached to the
+   * JVM once, as a daemon, rather than on every call. All notifiers share
+   * the FPGA alarm, which the HAL sets for the earliest trigger time; a
+   * Runnable is only called once its own trigger time has passed.
+   *
+   * @return The notifier handle, to be freed with cleanNotifier()
    */
   public static native long initializeNotifier(Runnable func);
 
@@ -26,4 +32,11 @@ public class NotifierJNI extends JNIWrapper {
    * Sets the notifier to call the callback in another triggerTime microseconds.
    */
   public static native void updateNotifierAlarm(long notifierPtr, int triggerTime);
+
+  /**
+   * Attaches the HAL interrupt thread to the JVM and detaches it again around
+   * every call, as it was before it stayed attached. For measuring the
+   * difference only.
+   */
+  public static native void setAttachEachCall(boolean attach);
 }
@@ -0,0 +1,53 @@
+package edu.wpi.first.wpilibj.hal;
+
+import java.nio.ByteBuffer;
+
+/**
+ * The SensorBatchJNI class reads many HAL sensors in a single JNI call.
+ *
+ * This class is not meant for direct use by teams. Instead, the
+ * edu.wpi.first.wpilibj.SensorBatch class should be used.
+ */
+public class SensorBatchJNI extends JNIWrapper {
+  // Field types. Each takes the HAL pointer of the sensor named in its prefix,
+  // or 0 for a freed sensor, which reads as HALUtil.HANDLE_ERROR.
+  public static final int kAnalogValue = 0;
+  public static final int kAnalogAverageValue = 1;
+  public static final int kAnalogVoltage = 2;
+  public static final int kAnalogAverageVoltage = 3;
+  public static final int kAccumulatorValue = 4;
+  public static final int kDIO = 5;
+  public static final int kCounter = 6;
+  public static final int kCounterPeriod = 7;
+  public static final int kEncoder = 8;
+  public static final int kEncoderPeriod = 9;
+  public static final int kEncoderStopped = 10;
+  public static final int kEncoderDirection = 11;
+  public static final int kCounterStopped = 12;
+  public static final int kCounterDirection = 13;
+
+  /**
+   * Size in bytes of each entry of the buffer: an 8 byte value, then a 4 byte
+   * status and 4 bytes of padding, all in native byte order. Voltages and
+   * periods are doubles, everything else is a long.
+   */
+  public static final int kEntrySize = 16;
+
+  /**
+   * Creates a batch reading the given fields of the given HAL pointers, in
+   * order.
+   */
+  public static native long initializeSensorBatch(long[] handles, int[] fields);
+
+  /**
+   * Deletes the batch object when we are done with it.
+   */
+  public static native void freeSensorBatch(long batchPtr);
+
+  /**
+   * Reads every entry of the batch into a direct buffer of at least
+   * kEntrySize bytes per entry. Errors are stored in the entries' status
+   * rather than thrown.
+   */
+  public static native void readSensorBatch(long batchPtr, ByteBuffer buffer);
+}
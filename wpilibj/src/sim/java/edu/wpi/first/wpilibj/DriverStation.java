@@ -7,6 +7,7 @@
 package edu.wpi.first.wpilibj;
 
 import edu.wpi.first.wpilibj.simulation.MainNode;
+import edu.wpi.first.wpilibj.simulation.SimFloatInput;
 import gazebo.msgs.GzDriverStation;
 import gazebo.msgs.GzDriverStation.DriverStation.State;
 import gazebo.msgs.GzJoystick.Joystick;
@@ -73,6 +74,7 @@ public class DriverStation implements RobotState.Interface {
     private boolean m_newControlData;
     private GzDriverStation.DriverStation state;
     private Joystick joysticks[] = new Joystick[6];
+    private SimFloatInput batteryVoltage;
 
     /**
      * Gets an instance of the DriverStation
@@ -116,6 +118,9 @@ public class DriverStation implements RobotState.Interface {
 				}
 			);
         }
+
+        // Published by the dc_motor plugins' battery model, when a world has one
+        batteryVoltage = new SimFloatInput("simulator/pdp/voltage", 12.5);
     }
 
     /**
@@ -146,7 +151,7 @@ public class DriverStation implements RobotState.Interface {
      * @return The battery voltage.
      */
     public double getBatteryVoltage() {
-    	return 12.0; // 12 volts all the time!
+    	return batteryVoltage.get();
     }
 
     /**
@@ -53,6 +53,16 @@ public abstract class RobotBase {
 //        if (getBooleanProperty(ERRORS_TO_DRIVERSTATION_PROP, true)) {
 //            Utility.sendErrorStreamToDriverStation(true);
 //        }
+        // Simulations running side by side, like frc_batch_runner's, each
+        // need a NetworkTables port and persistent file of their own
+        String ntPort = System.getenv("FRCSIM_NT_PORT");
+        if (ntPort != null) {
+            NetworkTable.setPort(Integer.parseInt(ntPort));
+        }
+        String ntFile = System.getenv("FRCSIM_NT_PERSISTENT_FILE");
+        if (ntFile != null) {
+            NetworkTable.setPersistentFilename(ntFile);
+        }
         NetworkTable.setServerMode();//must be before b
         m_ds = DriverStation.getInstance();
         NetworkTable.getTable("");  // forces network tables to initialize
@@ -10,6 +10,15 @@ public class SimFloatInput {
 	private double value;
 	
 	public SimFloatInput(String topic) {
+		this(topic, 0);
+	}
+
+	/**
+	 * @param topic The signal's topic.
+	 * @param initial The value until the first reading arrives.
+	 */
+	public SimFloatInput(String topic, double initial) {
+		value = initial;
     	MainNode.subscribe(topic, Msgs.Float64(),
 			new SubscriberCallback<Float64>() {
     			@Override public void callback(Float64 msg) {
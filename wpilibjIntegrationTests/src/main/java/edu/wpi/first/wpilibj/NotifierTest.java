@@ -0,0 +1,216 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2015. All Rights Reserved. */
+/* Open Source Software - may be modified and shared by FRC teams. The code */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project. */
+/*----------------------------------------------------------------------------*/
+package edu.wpi.first.wpilibj;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.logging.Logger;
+
+import org.junit.Test;
+
+import edu.wpi.first.wpilibj.hal.NotifierJNI;
+import edu.wpi.first.wpilibj.test.AbstractComsSetup;
+import edu.wpi.first.wpilibj.test.TestBench;
+
+/**
+ * Measures how long it takes from a notifier alarm firing until the Java
+ * handler runs. The numbers are printed so they can be compared between
+ * builds.
+ */
+public class NotifierTest extends AbstractComsSetup {
+  private static final Logger logger = Logger.getLogger(NotifierTest.class.getName());
+  private static final int PERIOD = 5000;
+  private static final int TICKS = 400;
+  private static final long MAX_AVERAGE_LATENCY = 500;
+
+  @Override
+  protected Logger getClassLogger() {
+    return logger;
+  }
+
+  /**
+   * Reschedules itself one period after each call and records how late each
+   * call was.
+   */
+  private static class LatencyRecorder implements Runnable {
+    final int m_period;
+    long m_notifier;
+    long m_triggerTime;
+    long m_totalLatency = 0;
+    long m_maxLatency = 0;
+    int m_ticks = 0;
+
+    LatencyRecorder(int period) {
+      m_period = period;
+    }
+
+    public synchronized void run() {
+      long now = Utility.getFPGATime();
+      if (m_ticks >= TICKS || now < m_triggerTime) {
+        return;
+      }
+      long latency = now - m_triggerTime;
+      m_totalLatency += latency;
+      m_maxLatency = Math.max(m_maxLatency, latency);
+      m_ticks++;
+      if (m_ticks < TICKS) {
+        m_triggerTime = now + m_period;
+        NotifierJNI.updateNotifierAlarm(m_notifier, (int) m_triggerTime);
+      }
+    }
+
+    synchronized void start() {
+      m_triggerTime = Utility.getFPGATime() + m_period;
+      NotifierJNI.updateNotifierAlarm(m_notifier, (int) m_triggerTime);
+    }
+  }
+
+  /**
+   * Runs TICKS ticks of one notifier and returns its average latency.
+   */
+  private static long measureLatency(String name) {
+    LatencyRecorder recorder = new LatencyRecorder(PERIOD);
+    recorder.m_notifier = NotifierJNI.initializeNotifier(recorder);
+    recorder.start();
+    Timer.delay(TICKS * PERIOD * 1.5e-6);
+    NotifierJNI.cleanNotifier(recorder.m_notifier);
+
+    synchronized (recorder) {
+      assertEquals("Not every tick was handled", TICKS, recorder.m_ticks);
+      long average = recorder.m_totalLatency / recorder.m_ticks;
+      TestBench.out().println("Notifier JNI tick latency, " + name + ": average "
+          + average + "us, max " + recorder.m_maxLatency + "us");
+      return average;
+    }
+  }
+
+  /**
+   * Compares the latency with the interrupt thread attached to the JVM on
+   * every tick, as it used to be, against staying attached.
+   */
+  @Test
+  public void testJNIHandlerLatency() {
+    NotifierJNI.setAttachEachCall(true);
+    try {
+      measureLatency("attached each tick");
+    } finally {
+      NotifierJNI.setAttachEachCall(false);
+    }
+    long average = measureLatency("attached once");
+    assertTrue("Average latency " + average + "us is too high",
+        average < MAX_AVERAGE_LATENCY);
+  }
+
+  /**
+   * A handler may free another notifier that is due at the same time, and the
+   * last one, from the interrupt thread.
+   */
+  @Test
+  public void testHandlerFreesNotifiers() {
+    final AtomicInteger calls = new AtomicInteger();
+    final long[] notifiers = new long[2];
+    Runnable freeBoth = new Runnable() {
+      public void run() {
+        if (calls.incrementAndGet() == 1) {
+          NotifierJNI.cleanNotifier(notifiers[0]);
+          NotifierJNI.cleanNotifier(notifiers[1]);
+        }
+      }
+    };
+    notifiers[0] = NotifierJNI.initializeNotifier(freeBoth);
+    notifiers[1] = NotifierJNI.initializeNotifier(freeBoth);
+    int triggerTime = (int) (Utility.getFPGATime() + PERIOD);
+    NotifierJNI.updateNotifierAlarm(notifiers[0], triggerTime);
+    NotifierJNI.updateNotifierAlarm(notifiers[1], triggerTime);
+    Timer.delay(PERIOD * 10e-6);
+    assertEquals("A freed notifier was called", 1, calls.get());
+
+    // The alarm kept after the last one was freed is reused
+    LatencyRecorder recorder = new LatencyRecorder(PERIOD);
+    recorder.m_notifier = NotifierJNI.initializeNotifier(recorder);
+    recorder.start();
+    Timer.delay(PERIOD * 10e-6);
+    NotifierJNI.cleanNotifier(recorder.m_notifier);
+    synchronized (recorder) {
+      assertTrue("A new notifier wasn't called", recorder.m_ticks > 0);
+    }
+  }
+
+  /**
+   * HAL notifiers share the FPGA alarm. Each must still be called at its own
+   * trigger time, and freeing one must not stop the others.
+   */
+  @Test
+  public void testHALNotifiersShareTheAlarm() {
+    LatencyRecorder fast = new LatencyRecorder(PERIOD);
+    LatencyRecorder slow = new LatencyRecorder(3 * PERIOD);
+    fast.m_notifier = NotifierJNI.initializeNotifier(fast);
+    slow.m_notifier = NotifierJNI.initializeNotifier(slow);
+    fast.start();
+    slow.start();
+    Timer.delay(1.0);
+    NotifierJNI.cleanNotifier(fast.m_notifier);
+
+    int slowTicks;
+    synchronized (slow) {
+      slowTicks = slow.m_ticks;
+    }
+    Timer.delay(0.5);
+    NotifierJNI.cleanNotifier(slow.m_notifier);
+
+    synchronized (fast) {
+      assertEquals("The fast notifier missed ticks", 1.0e6 / PERIOD, fast.m_ticks,
+          1.0e6 / PERIOD / 10);
+      assertTrue("The fast notifier was late",
+          fast.m_totalLatency / fast.m_ticks < MAX_AVERAGE_LATENCY);
+    }
+    synchronized (slow) {
+      assertTrue("The slow notifier stopped with the fast one", slow.m_ticks > slowTicks);
+      assertTrue("The slow notifier was late",
+          slow.m_totalLatency / slow.m_ticks < MAX_AVERAGE_LATENCY);
+    }
+  }
+
+  /**
+   * Many Java Notifiers share one HAL notifier; all of them must keep running.
+   */
+  @Test
+  public void testMultiplexedNotifiers() {
+    final int count = 20;
+    final AtomicInteger[] calls = new AtomicInteger[count];
+    Notifier[] notifiers = new Notifier[count];
+    for (int i = 0; i < count; i++) {
+      final AtomicInteger counter = calls[i] = new AtomicInteger();
+      notifiers[i] = new Notifier(new Runnable() {
+        public void run() {
+          counter.incrementAndGet();
+        }
+      });
+    }
+
+    long start = Utility.getFPGATime();
+    for (Notifier notifier : notifiers) {
+      notifier.startPeriodic(PERIOD * 1e-6);
+    }
+    Timer.delay(1.0);
+    for (Notifier notifier : notifiers) {
+      notifier.stop();
+    }
+    long elapsed = Utility.getFPGATime() - start;
+
+    long expected = elapsed / PERIOD;
+    int total = 0;
+    for (AtomicInteger counter : calls) {
+      assertEquals("A notifier missed ticks", expected, counter.get(), expected / 10 + 1);
+      total += counter.get();
+    }
+    TestBench.out().println(count + " multiplexed notifiers: " + total + " calls in "
+        + elapsed / 1000 + "ms");
+  }
+}
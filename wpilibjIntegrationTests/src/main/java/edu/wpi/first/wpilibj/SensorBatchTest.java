@@ -0,0 +1,119 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2016. All Rights Reserved. */
+/* Open Source Software - may be modified and shared by FRC teams. The code */
+/* must be accompanied by the FIRST BSD license file in the root directory of */
+/* the project. */
+/*----------------------------------------------------------------------------*/
+package edu.wpi.first.wpilibj;
+
+import static org.junit.Assert.assertEquals;
+
+import java.util.logging.Logger;
+
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+
+import edu.wpi.first.wpilibj.fixtures.AnalogCrossConnectFixture;
+import edu.wpi.first.wpilibj.fixtures.FakeEncoderFixture;
+import edu.wpi.first.wpilibj.hal.HALUtil;
+import edu.wpi.first.wpilibj.test.AbstractComsSetup;
+import edu.wpi.first.wpilibj.test.TestBench;
+
+/**
+ * Tests that a SensorBatch reads the same values as the sensors' own classes
+ */
+public class SensorBatchTest extends AbstractComsSetup {
+  private static final Logger logger = Logger.getLogger(SensorBatchTest.class.getName());
+
+  private FakeEncoderFixture m_encoder;
+  private SensorBatch m_batch;
+
+  @Override
+  protected Logger getClassLogger() {
+    return logger;
+  }
+
+  @Before
+  public void setUp() {
+    Integer[] ports = TestBench.getInstance().getEncoderDIOCrossConnectCollection().iterator()
+        .next();
+    m_encoder = new FakeEncoderFixture(ports[0], ports[1], ports[2], ports[3]);
+    m_encoder.setup();
+    m_batch = new SensorBatch();
+  }
+
+  @After
+  public void tearDown() {
+    m_batch.free();
+    if (m_encoder != null) {
+      m_encoder.teardown();
+    }
+  }
+
+  /**
+   * Entries that haven't been read yet read as 0 rather than throwing
+   */
+  @Test
+  public void testEntryBeforeUpdate() {
+    int raw = m_batch.addEncoderRaw(m_encoder.getEncoder());
+    assertEquals(0, m_batch.getLong(raw));
+    assertEquals(0.0, m_batch.getDouble(raw), 0.0);
+    assertEquals(HALUtil.INCOMPATIBLE_STATE, m_batch.getStatus(raw));
+
+    m_batch.update();
+    int period = m_batch.addEncoderPeriod(m_encoder.getEncoder());
+    assertEquals(0, m_batch.getStatus(raw));
+    assertEquals(HALUtil.INCOMPATIBLE_STATE, m_batch.getStatus(period));
+  }
+
+  @Test
+  public void testEncoderMatchesEncoder() {
+    Encoder encoder = m_encoder.getEncoder();
+    int raw = m_batch.addEncoderRaw(encoder);
+    int stopped = m_batch.addEncoderStopped(encoder);
+    int direction = m_batch.addEncoderDirection(encoder);
+
+    m_encoder.getFakeEncoderSource().setCount(100);
+    m_encoder.getFakeEncoderSource().setForward(true);
+    m_encoder.getFakeEncoderSource().execute();
+    m_batch.update();
+
+    assertEquals(0, m_batch.getStatus(raw));
+    assertEquals(encoder.getRaw(), m_batch.getLong(raw));
+    assertEquals(encoder.getStopped(), m_batch.getBoolean(stopped));
+    assertEquals(encoder.getDirection(), m_batch.getBoolean(direction));
+  }
+
+  /**
+   * A freed encoder reports a handle error instead of being read
+   */
+  @Test
+  public void testFreedEncoder() {
+    int raw = m_batch.addEncoderRaw(m_encoder.getEncoder());
+    m_batch.update();
+    assertEquals(0, m_batch.getStatus(raw));
+
+    m_encoder.teardown();
+    m_encoder = null;
+    m_batch.update();
+    assertEquals(HALUtil.HANDLE_ERROR, m_batch.getStatus(raw));
+    assertEquals(0, m_batch.getLong(raw));
+  }
+
+  /**
+   * A freed analog input reports a handle error too
+   */
+  @Test
+  public void testFreedAnalogInput() {
+    AnalogCrossConnectFixture analogIO = TestBench.getAnalogCrossConnectFixture();
+    analogIO.setup();
+    int value = m_batch.addAnalogValue(analogIO.getInput());
+    m_batch.update();
+    assertEquals(0, m_batch.getStatus(value));
+
+    analogIO.teardown();
+    m_batch.update();
+    assertEquals(HALUtil.HANDLE_ERROR, m_batch.getStatus(value));
+  }
+}
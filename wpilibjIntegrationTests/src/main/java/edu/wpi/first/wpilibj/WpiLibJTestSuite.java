@@ -21,7 +21,8 @@ import edu.wpi.first.wpilibj.test.AbstractTestSuite;
 @SuiteClasses({AnalogCrossConnectTest.class, AnalogPotentiometerTest.class,
     BuiltInAccelerometerTest.class, CANTalonTest.class, CounterTest.class,
     DIOCrossConnectTest.class, EncoderTest.class, GyroTest.class, MotorEncoderTest.class,
-    MotorInvertingTest.class, PCMTest.class, PDPTest.class, PIDTest.class, PreferencesTest.class,
-    RelayCrossConnectTest.class, SampleTest.class, TimerTest.class})
+    MotorInvertingTest.class, NotifierTest.class, PCMTest.class, PDPTest.class, PIDTest.class,
+    PreferencesTest.class, RelayCrossConnectTest.class, SampleTest.class, SensorBatchTest.class,
+    TimerTest.class})
 public class WpiLibJTestSuite extends AbstractTestSuite {
 }